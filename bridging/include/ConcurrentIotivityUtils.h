@@ -65,6 +65,7 @@ namespace OC
                 bool m_threadStarted;
                 bool m_shutDownOCProcessThread;
                 static const int OCPROCESS_SLEEP_MICROSECONDS = 200000;
+                static const uint32_t OCPROCESS_MAX_WAIT_MILLISECONDS = 1000;
 
                 // Fetches work item from queue and processes it.
                 void processWorkQueue()
@@ -94,9 +95,12 @@ namespace OC
                             std::lock_guard<std::mutex> lock(m_iotivityApiCallMutex);
                             OCProcess();
                         }
-                        // Hopefully it's enough for other threads to be scheduled
-                        // instead of the spin here. OCProcess is very lightweight though.
-                        usleep(OCPROCESS_SLEEP_MICROSECONDS);
+                        // Sleep until the stack has something to process. Fall back to
+                        // polling if the stack handles received messages on its own thread.
+                        if (OC_STACK_OK != OCWaitForProcess(OCPROCESS_MAX_WAIT_MILLISECONDS))
+                        {
+                            usleep(OCPROCESS_SLEEP_MICROSECONDS);
+                        }
                     }
                 }
 
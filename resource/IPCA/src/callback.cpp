@@ -33,7 +33,8 @@ extern OCFFramework ocfFramework;
 Callback::Callback(AppPtr app) :
     m_app(app),
     m_stopCalled(false),
-    m_expiredCallbacksInProgress(0)
+    m_expiredCallbacksInProgress(0),
+    m_callbackExecutor(OC::CallbackExecution::ThreadPool, 0)
 {
 }
 
@@ -383,9 +384,7 @@ void Callback::CallCloseHandleComplete(IPCACloseHandleComplete closeHandleComple
 {
     if (closeHandleComplete != nullptr)
     {
-        std::thread callbackThread = std::thread(closeHandleComplete,
-                                                 const_cast<void*>(context));
-        callbackThread.detach();
+        m_callbackExecutor.post(std::bind(closeHandleComplete, const_cast<void*>(context)));
     }
 }
 
@@ -528,39 +527,34 @@ void Callback::CompleteAndRemoveExpiredCallbackInfo(std::vector<CallbackInfo::Pt
     {
         if (cbInfo->getCallback != nullptr)
         {
-            std::thread thrd;
             switch(cbInfo->type)
             {
                 case CallbackType_GetPropertiesComplete:
-                    thrd = std::thread(cbInfo->getCallback,
+                    m_callbackExecutor.post(std::bind(cbInfo->getCallback,
                                 IPCA_REQUEST_TIMEOUT,
                                 const_cast<void*>(cbInfo->callbackContext),
-                                nullptr);
-                    thrd.detach();
+                                nullptr));
                     break;
 
                 case CallbackType_SetPropertiesComplete:
-                    thrd = std::thread(cbInfo->setCallback,
+                    m_callbackExecutor.post(std::bind(cbInfo->setCallback,
                                 IPCA_REQUEST_TIMEOUT,
                                 const_cast<void*>(cbInfo->callbackContext),
-                                nullptr);
-                    thrd.detach();
+                                nullptr));
                     break;
 
                 case CallbackType_CreateResourceComplete:
-                    thrd = std::thread(cbInfo->createResourceCallback,
+                    m_callbackExecutor.post(std::bind(cbInfo->createResourceCallback,
                                 IPCA_REQUEST_TIMEOUT,
                                 const_cast<void*>(cbInfo->callbackContext),
                                 nullptr,
-                                nullptr);
-                    thrd.detach();
+                                nullptr));
                     break;
 
                 case CallbackType_DeleteResourceComplete:
-                    thrd = std::thread(cbInfo->deleteResourceCallback,
+                    m_callbackExecutor.post(std::bind(cbInfo->deleteResourceCallback,
                                 IPCA_REQUEST_TIMEOUT,
-                                const_cast<void*>(cbInfo->callbackContext));
-                    thrd.detach();
+                                const_cast<void*>(cbInfo->callbackContext)));
                     break;
 
                 default:
@@ -668,12 +662,11 @@ void Callback::DeviceDiscoveryCallback(
             if ((cbInfo->device->GetDeviceId().compare(deviceInfo.deviceId) == 0) &&
                 (SetCallbackInProgress(cbInfo->mapKey) == true))
             {
-                std::thread exec(
+                m_callbackExecutor.post(cbInfo.get(), std::bind(
                         cbInfo->resourceChangeCallback,
                         IPCA_DEVICE_APPEAR_OFFLINE,
                         const_cast<void*>(cbInfo->callbackContext),
-                        nullptr);
-                exec.detach();
+                        nullptr));
                 ClearCallbackInProgress(cbInfo->mapKey);
             }
         }
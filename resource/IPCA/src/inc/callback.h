@@ -227,6 +227,9 @@ class Callback
         // Number of expired callbacks in progress.
         size_t m_expiredCallbacksInProgress;
 
+        // Runs the callbacks to app which are not made from an OCF callback.
+        OC::CallbackExecutor m_callbackExecutor;
+
         // Indicate that callback is in progress for callbackInfo matching mapKey.
         // Return false if the callback is already cancelled by app.
         bool SetCallbackInProgress(size_t mapKey);
@@ -35,6 +35,7 @@
 
 #include "OCPlatform.h"
 #include "OCApi.h"
+#include "CallbackExecutor.h"
 #include "OCProvisioningManager.hpp"
 #include "experimental/logger.h"
 
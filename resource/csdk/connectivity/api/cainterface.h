@@ -225,12 +225,57 @@ CAResult_t CAGetNetworkInformation(CAEndpoint_t **info, size_t *size);
  */
 CATransportAdapter_t CAGetSelectedNetwork(void);
 
+/** Maximum number of threads sending the messages of an adapter. */
+#define CA_MAX_SEND_THREADS 16
+
+/**
+ * Set the number of threads sending the messages of an adapter, before CAInitialize().
+ * Messages to an endpoint are always sent by the same thread, in the order they were
+ * sent, while other endpoints are served by the other threads. Each adapter has its
+ * own threads, so a slow adapter does not delay the messages of the others. The IP and
+ * TCP adapters get as many threads for the (D)TLS encryption and the socket writes.
+ *
+ * @param[in]   adapter         a single adapter, or ::CA_DEFAULT_ADAPTER for the threads
+ *                              shared by multicast over several adapters.
+ * @param[in]   threadCount     number of threads, 1 by default, at most
+ *                              ::CA_MAX_SEND_THREADS.
+ * @return   ::CA_STATUS_OK, ::CA_STATUS_INVALID_PARAM, ::CA_NOT_SUPPORTED if the adapter
+ *           is not built, or ::CA_STATUS_FAILED if already initialized.
+ */
+CAResult_t CASetSendQueueThreads(CATransportAdapter_t adapter, uint32_t threadCount);
+
 /**
  * To Handle the Request or Response.
  * @return   ::CA_STATUS_OK or ::CA_STATUS_NOT_INITIALIZED
  */
 CAResult_t CAHandleRequestResponse(void);
 
+/**
+ * To Handle a batch of Requests or Responses.
+ * @param[in]   maxMessages     maximum number of messages to handle, 0 to handle every
+ *                              message currently queued.
+ * @param[in]   timeoutMs       time in milliseconds to wait for a message when nothing is
+ *                              queued, 0 to return immediately.
+ * @param[out]  handledCount    optional, number of messages handled.
+ * @return   ::CA_STATUS_OK or ::CA_STATUS_NOT_INITIALIZED
+ */
+CAResult_t CAHandleRequestResponseBatch(uint32_t maxMessages, uint32_t timeoutMs,
+                                        uint32_t *handledCount);
+
+/**
+ * Block until there is a Request or Response to handle, CAWakeUpRequestResponseWait()
+ * is called or the timeout elapses.
+ * @param[in]   timeoutMs       time in milliseconds to wait, 0 to return immediately.
+ * @return   ::CA_STATUS_OK or ::CA_NOT_SUPPORTED or ::CA_STATUS_NOT_INITIALIZED
+ */
+CAResult_t CAWaitForRequestResponse(uint32_t timeoutMs);
+
+/**
+ * Wake up the callers blocked in CAWaitForRequestResponse().
+ * @return   ::CA_STATUS_OK or ::CA_STATUS_NOT_INITIALIZED
+ */
+CAResult_t CAWakeUpRequestResponseWait(void);
+
 #ifdef RA_ADAPTER
 /**
  * Set Remote Access information for XMPP Client.
@@ -250,6 +295,16 @@ CAResult_t CASetRAInfo(const CARAInfo_t *caraInfo);
  */
 CAResult_t CASetProxyUri(const char *uri);
 
+/**
+ * Get the counters of the pool PDUs and their scratch buffers are allocated from.
+ *
+ * @param[out] hits       number of allocations served by the pool.
+ * @param[out] misses     number of allocations that fell back to the heap.
+ *
+ * @return  ::CA_STATUS_OK or ::CA_STATUS_INVALID_PARAM
+ */
+CAResult_t CAGetPDUPoolStats(uint32_t *hits, uint32_t *misses);
+
 #ifdef IP_ADAPTER
 /**
  * This function return zone id related from ifindex and address.
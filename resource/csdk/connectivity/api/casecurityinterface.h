@@ -183,6 +183,23 @@ typedef void (*CAgetPkixInfoHandler)(PkiInfo_t * inf);
  */
 CAResult_t CAregisterPkixInfoHandler(CAgetPkixInfoHandler getPkixInfoHandler);
 
+/**
+ * Notify that the info returned by the PKIX info callback changed.
+ * Certificates, key and CRL are parsed once and kept until this is called.
+ */
+void CAnotifyPkixInfoChanged(void);
+
+/**
+ * Get (D)TLS session resumption counters.
+ * Sessions established with certificates are cached by peer address on the client
+ * side and with session tickets or a session cache on the server side.
+ *
+ * @param[out]  fullHandshakes      number of handshakes done without resumption.
+ * @param[out]  resumedHandshakes   number of handshakes resuming a session.
+ * @return  ::CA_STATUS_OK or appropriate error code.
+ */
+CAResult_t CAgetSecureSessionStats(uint32_t *fullHandshakes, uint32_t *resumedHandshakes);
+
 /**
  * Select the cipher suite for dtls handshake.
  *
@@ -0,0 +1,195 @@
+/******************************************************************
+ *
+ * Copyright 2017 Open Connectivity Foundation All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+/**
+ * @file
+ *
+ * This file contains the APIs for a hash map indexing existing objects.
+ *
+ * The map does not store keys. Each entry keeps the hash of the key it was added
+ * with and a pointer to the indexed data, and lookups compare a key against the
+ * data itself through the match function given at creation. The key therefore
+ * normally lives inside the data (a URI, a token, an address ...).
+ */
+
+#ifndef U_HASHMAP_H_
+#define U_HASHMAP_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * Computes the hash of a key.
+ * @param[in] key       key to hash.
+ * @return hash value of the key.
+ */
+typedef uint32_t (*u_hashmap_hash_func)(const void *key);
+
+/**
+ * Checks whether data stored in the map matches a key.
+ * @param[in] key       key looked up.
+ * @param[in] data      data stored in the map.
+ * @return true if data was added with a key equal to key.
+ */
+typedef bool (*u_hashmap_match_func)(const void *key, const void *data);
+
+/**
+ * Called for each data of the map by u_hashmap_foreach().
+ * @param[in] data      data stored in the map.
+ * @param[in] ctx       context given to u_hashmap_foreach().
+ * @return true to continue the iteration, false to stop it.
+ */
+typedef bool (*u_hashmap_visit_func)(void *data, void *ctx);
+
+typedef struct u_hashmap_entry_t u_hashmap_entry_t;
+
+/**
+ * hash map structure.
+ *
+ * @note
+ * Members should be treated as private and not accessed directly. Instead
+ * all access should be through the defined u_hashmap_*() functions.
+ */
+typedef struct u_hashmap_t
+{
+    u_hashmap_entry_t **buckets;
+    size_t bucketCount;
+    size_t length;
+    u_hashmap_hash_func hash;
+    u_hashmap_match_func match;
+} u_hashmap_t;
+
+/**
+ * API to create a hash map.
+ * @param[in] hash      function computing the hash of a key.
+ * @param[in] match     function comparing a key with stored data.
+ * @return  u_hashmap_t if Success, NULL otherwise.
+ */
+u_hashmap_t *u_hashmap_create(u_hashmap_hash_func hash, u_hashmap_match_func match);
+
+/**
+ * Deletes the hash map. The indexed data is not freed.
+ * @param[in] map       pointer to the u_hashmap pointer, set to NULL.
+ */
+void u_hashmap_free(u_hashmap_t **map);
+
+/**
+ * Add data to the hash map.
+ * If data matching the key is already stored, it is replaced.
+ * @param[in] map       pointer of hash map.
+ * @param[in] key       key of the data, must match data with the map match function.
+ * @param[in] data      pointer of data.
+ * @return true if success, false otherwise.
+ */
+bool u_hashmap_put(u_hashmap_t *map, const void *key, void *data);
+
+/**
+ * Returns the data matching a key.
+ * @param[in] map       pointer of hash map.
+ * @param[in] key       key to look up.
+ * @return pointer of data if found or NULL pointer otherwise.
+ */
+void *u_hashmap_get(const u_hashmap_t *map, const void *key);
+
+/**
+ * Remove the data matching a key from the hash map.
+ * @param[in] map       pointer of hash map.
+ * @param[in] key       key to look up.
+ * @return pointer of the removed data if found or NULL pointer otherwise.
+ */
+void *u_hashmap_remove(u_hashmap_t *map, const void *key);
+
+/**
+ * Remove a specific data from the hash map.
+ * Unlike u_hashmap_remove(), only an entry pointing to data is removed.
+ * @param[in] map       pointer of hash map.
+ * @param[in] key       key data was added with.
+ * @param[in] data      pointer of data.
+ * @return true if data was found and removed, false otherwise.
+ */
+bool u_hashmap_remove_data(u_hashmap_t *map, const void *key, const void *data);
+
+/**
+ * Returns the number of data in the hash map.
+ * @param[in] map       pointer of hash map.
+ * @return number of data in the hash map.
+ */
+size_t u_hashmap_length(const u_hashmap_t *map);
+
+/**
+ * Removes all data from the hash map. The indexed data is not freed.
+ * @param[in] map       pointer of hash map.
+ */
+void u_hashmap_clear(u_hashmap_t *map);
+
+/**
+ * Calls visit for each data of the hash map, in no particular order.
+ * The map must not be modified during the iteration.
+ * @param[in] map       pointer of hash map.
+ * @param[in] visit     function called for each data.
+ * @param[in] ctx       context passed to visit.
+ */
+void u_hashmap_foreach(const u_hashmap_t *map, u_hashmap_visit_func visit, void *ctx);
+
+/**
+ * Computes a hash of a byte buffer (32 bit FNV-1a).
+ * @param[in] data      buffer to hash.
+ * @param[in] size      size of the buffer.
+ * @param[in] seed      hash to continue from, ::U_HASHMAP_HASH_SEED to start a new hash.
+ * @return hash value.
+ */
+uint32_t u_hashmap_hash_bytes(const void *data, size_t size, uint32_t seed);
+
+/** Initial value for u_hashmap_hash_bytes(). */
+#define U_HASHMAP_HASH_SEED (2166136261u)
+
+/**
+ * Hash function for NUL terminated string keys.
+ * @param[in] key       string.
+ * @return hash value.
+ */
+uint32_t u_hashmap_hash_string(const void *key);
+
+/**
+ * Hash function for pointer keys.
+ * @param[in] key       pointer.
+ * @return hash value.
+ */
+uint32_t u_hashmap_hash_pointer(const void *key);
+
+/**
+ * Match function for maps indexing data by its own address.
+ * @param[in] key       pointer looked up.
+ * @param[in] data      data stored in the map.
+ * @return true if key and data are the same pointer.
+ */
+bool u_hashmap_match_pointer(const void *key, const void *data);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* U_HASHMAP_H_ */
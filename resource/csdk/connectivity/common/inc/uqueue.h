@@ -65,6 +65,8 @@ typedef struct u_queue_t
 {
     /** Head of the queue. */
     u_queue_element *element;
+    /** Tail of the queue, used to append in constant time. */
+    u_queue_element *tail;
     /** Number of messages in Queue. */
     uint32_t count;
 } u_queue_t;
@@ -125,6 +127,16 @@ CAResult_t u_queue_reset(u_queue_t *queue);
  */
 u_queue_message_t *u_queue_get_head(u_queue_t *queue);
 
+/**
+ * Moves messages from the head of one queue to the tail of another, preserving order.
+ * Only the queue elements are relinked, no message is copied or reallocated.
+ * @param dest pointer to the queue receiving the messages.
+ * @param src pointer to the queue the messages are taken from.
+ * @param maxCount maximum number of messages to move, 0 to move all of them.
+ * @return number of messages moved.
+ */
+uint32_t u_queue_move_elements(u_queue_t *dest, u_queue_t *src, uint32_t maxCount);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif /* __cplusplus */
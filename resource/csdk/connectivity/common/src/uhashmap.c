@@ -0,0 +1,302 @@
+/******************************************************************
+ *
+ * Copyright 2017 Open Connectivity Foundation All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include "uhashmap.h"
+#include "experimental/logger.h"
+#include "oic_malloc.h"
+
+#define TAG "OIC_UHASHMAP"
+
+/**
+ * Number of buckets allocated with the first entry, must be a power of two.
+ */
+#define U_HASHMAP_DEFAULT_BUCKETS 16
+
+/**
+ * FNV-1a prime.
+ */
+#define U_HASHMAP_HASH_PRIME (16777619u)
+
+struct u_hashmap_entry_t
+{
+    /** Hash of the key the data was added with. */
+    uint32_t hash;
+    /** Indexed data. */
+    void *data;
+    /** Next entry of the same bucket. */
+    u_hashmap_entry_t *next;
+};
+
+static size_t u_hashmap_bucket_index(const u_hashmap_t *map, uint32_t hash)
+{
+    return (size_t) hash & (map->bucketCount - 1);
+}
+
+/**
+ * Grow the bucket array once the map holds more entries than buckets.
+ * A failed resize is not an error, the map stays usable with longer chains.
+ */
+static void u_hashmap_grow(u_hashmap_t *map)
+{
+    size_t newCount = map->bucketCount ? map->bucketCount * 2 : U_HASHMAP_DEFAULT_BUCKETS;
+    u_hashmap_entry_t **buckets =
+        (u_hashmap_entry_t **) OICCalloc(newCount, sizeof(u_hashmap_entry_t *));
+    if (!buckets)
+    {
+        OIC_LOG(DEBUG, TAG, "Memory allocation failed, keeping current buckets");
+        return;
+    }
+
+    for (size_t i = 0; i < map->bucketCount; i++)
+    {
+        u_hashmap_entry_t *entry = map->buckets[i];
+        while (entry)
+        {
+            u_hashmap_entry_t *next = entry->next;
+            size_t index = (size_t) entry->hash & (newCount - 1);
+            entry->next = buckets[index];
+            buckets[index] = entry;
+            entry = next;
+        }
+    }
+
+    OICFree(map->buckets);
+    map->buckets = buckets;
+    map->bucketCount = newCount;
+}
+
+u_hashmap_t *u_hashmap_create(u_hashmap_hash_func hash, u_hashmap_match_func match)
+{
+    if (!hash || !match)
+    {
+        OIC_LOG(DEBUG, TAG, "Invalid hash or match function");
+        return NULL;
+    }
+
+    u_hashmap_t *map = (u_hashmap_t *) OICCalloc(1, sizeof(u_hashmap_t));
+    if (!map)
+    {
+        OIC_LOG(DEBUG, TAG, "Out of memory");
+        return NULL;
+    }
+
+    map->hash = hash;
+    map->match = match;
+    return map;
+}
+
+void u_hashmap_free(u_hashmap_t **map)
+{
+    if (!map || !(*map))
+    {
+        return;
+    }
+
+    u_hashmap_clear(*map);
+    OICFree((*map)->buckets);
+    OICFree(*map);
+
+    *map = NULL;
+}
+
+bool u_hashmap_put(u_hashmap_t *map, const void *key, void *data)
+{
+    if (!map || !data)
+    {
+        return false;
+    }
+
+    uint32_t hash = map->hash(key);
+
+    if (map->bucketCount)
+    {
+        for (u_hashmap_entry_t *entry = map->buckets[u_hashmap_bucket_index(map, hash)];
+             entry; entry = entry->next)
+        {
+            if (entry->hash == hash && map->match(key, entry->data))
+            {
+                entry->data = data;
+                return true;
+            }
+        }
+    }
+
+    if (map->length >= map->bucketCount)
+    {
+        u_hashmap_grow(map);
+        if (!map->bucketCount)
+        {
+            return false;
+        }
+    }
+
+    u_hashmap_entry_t *entry = (u_hashmap_entry_t *) OICMalloc(sizeof(u_hashmap_entry_t));
+    if (!entry)
+    {
+        OIC_LOG(DEBUG, TAG, "Out of memory");
+        return false;
+    }
+
+    size_t index = u_hashmap_bucket_index(map, hash);
+    entry->hash = hash;
+    entry->data = data;
+    entry->next = map->buckets[index];
+    map->buckets[index] = entry;
+    map->length++;
+
+    return true;
+}
+
+void *u_hashmap_get(const u_hashmap_t *map, const void *key)
+{
+    if (!map || !map->length)
+    {
+        return NULL;
+    }
+
+    uint32_t hash = map->hash(key);
+    for (u_hashmap_entry_t *entry = map->buckets[u_hashmap_bucket_index(map, hash)];
+         entry; entry = entry->next)
+    {
+        if (entry->hash == hash && map->match(key, entry->data))
+        {
+            return entry->data;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * Unlink the first entry matching key, and data if data is not NULL.
+ */
+static void *u_hashmap_unlink(u_hashmap_t *map, const void *key, const void *data)
+{
+    if (!map || !map->length)
+    {
+        return NULL;
+    }
+
+    uint32_t hash = map->hash(key);
+    u_hashmap_entry_t **link = &map->buckets[u_hashmap_bucket_index(map, hash)];
+    while (*link)
+    {
+        u_hashmap_entry_t *entry = *link;
+        if (entry->hash == hash && (data ? (entry->data == data) : map->match(key, entry->data)))
+        {
+            void *removed = entry->data;
+            *link = entry->next;
+            OICFree(entry);
+            map->length--;
+            return removed;
+        }
+        link = &entry->next;
+    }
+    return NULL;
+}
+
+void *u_hashmap_remove(u_hashmap_t *map, const void *key)
+{
+    return u_hashmap_unlink(map, key, NULL);
+}
+
+bool u_hashmap_remove_data(u_hashmap_t *map, const void *key, const void *data)
+{
+    if (!data)
+    {
+        return false;
+    }
+    return NULL != u_hashmap_unlink(map, key, data);
+}
+
+size_t u_hashmap_length(const u_hashmap_t *map)
+{
+    return map ? map->length : 0;
+}
+
+void u_hashmap_clear(u_hashmap_t *map)
+{
+    if (!map)
+    {
+        return;
+    }
+
+    for (size_t i = 0; i < map->bucketCount; i++)
+    {
+        u_hashmap_entry_t *entry = map->buckets[i];
+        while (entry)
+        {
+            u_hashmap_entry_t *next = entry->next;
+            OICFree(entry);
+            entry = next;
+        }
+        map->buckets[i] = NULL;
+    }
+    map->length = 0;
+}
+
+void u_hashmap_foreach(const u_hashmap_t *map, u_hashmap_visit_func visit, void *ctx)
+{
+    if (!map || !visit)
+    {
+        return;
+    }
+
+    for (size_t i = 0; i < map->bucketCount; i++)
+    {
+        for (u_hashmap_entry_t *entry = map->buckets[i]; entry; entry = entry->next)
+        {
+            if (!visit(entry->data, ctx))
+            {
+                return;
+            }
+        }
+    }
+}
+
+uint32_t u_hashmap_hash_bytes(const void *data, size_t size, uint32_t seed)
+{
+    const uint8_t *bytes = (const uint8_t *) data;
+    uint32_t hash = seed;
+    for (size_t i = 0; bytes && i < size; i++)
+    {
+        hash ^= bytes[i];
+        hash *= U_HASHMAP_HASH_PRIME;
+    }
+    return hash;
+}
+
+uint32_t u_hashmap_hash_string(const void *key)
+{
+    const char *string = (const char *) key;
+    return u_hashmap_hash_bytes(string, string ? strlen(string) : 0, U_HASHMAP_HASH_SEED);
+}
+
+uint32_t u_hashmap_hash_pointer(const void *key)
+{
+    uintptr_t value = (uintptr_t) key;
+    return u_hashmap_hash_bytes(&value, sizeof(value), U_HASHMAP_HASH_SEED);
+}
+
+bool u_hashmap_match_pointer(const void *key, const void *data)
+{
+    return key == data;
+}
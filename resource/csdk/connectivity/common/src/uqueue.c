@@ -48,6 +48,7 @@ u_queue_t *u_queue_create(void)
 
     queuePtr->count = NO_MESSAGES;
     queuePtr->element = NULL;
+    queuePtr->tail = NULL;
 
     return queuePtr;
 }
@@ -55,7 +56,6 @@ u_queue_t *u_queue_create(void)
 CAResult_t u_queue_add_element(u_queue_t *queue, u_queue_message_t *message)
 {
     u_queue_element *element = NULL;
-    u_queue_element *ptr = NULL;
 
     if (NULL == queue)
     {
@@ -79,16 +79,10 @@ CAResult_t u_queue_add_element(u_queue_t *queue, u_queue_message_t *message)
     element->message = message;
     element->next = NULL;
 
-    ptr = queue->element;
-
-    if (NULL != ptr)
+    if (NULL != queue->tail)
     {
-        while (NULL != ptr->next)
-        {
-            ptr = ptr->next;
-        }
-
-        ptr->next = element;
+        queue->tail->next = element;
+        queue->tail = element;
         queue->count++;
 
         OIC_LOG_V(DEBUG, TAG, "Queue Count : %d", queue->count);
@@ -105,6 +99,7 @@ CAResult_t u_queue_add_element(u_queue_t *queue, u_queue_message_t *message)
         }
 
         queue->element = element;
+        queue->tail = element;
         queue->count++;
         OIC_LOG_V(DEBUG, TAG, "Queue Count : %d", queue->count);
     }
@@ -131,6 +126,10 @@ u_queue_message_t *u_queue_get_element(u_queue_t *queue)
     }
 
     queue->element = element->next;
+    if (NULL == queue->element)
+    {
+        queue->tail = NULL;
+    }
     queue->count--;
 
     message = element->message;
@@ -163,6 +162,10 @@ CAResult_t u_queue_remove_element(u_queue_t *queue)
     OICFree(remove);
 
     queue->element = next;
+    if (NULL == next)
+    {
+        queue->tail = NULL;
+    }
     queue->count--;
 
     return CA_STATUS_OK;
@@ -245,3 +248,58 @@ u_queue_message_t *u_queue_get_head(u_queue_t *queue)
     return queue->element->message;
 }
 
+uint32_t u_queue_move_elements(u_queue_t *dest, u_queue_t *src, uint32_t maxCount)
+{
+    if (NULL == dest || NULL == src)
+    {
+        OIC_LOG(DEBUG, TAG, "QueueMoveElements FAIL, Invalid Queue");
+        return NO_MESSAGES;
+    }
+
+    if (NULL == src->element || dest == src)
+    {
+        return NO_MESSAGES;
+    }
+
+    u_queue_element *first = src->element;
+    u_queue_element *last = NULL;
+    uint32_t moved = 0;
+
+    if (NO_MESSAGES == maxCount || maxCount >= src->count)
+    {
+        // take the whole chain without walking it
+        last = src->tail;
+        moved = src->count;
+    }
+    else
+    {
+        last = first;
+        moved = 1;
+        while (moved < maxCount)
+        {
+            last = last->next;
+            moved++;
+        }
+    }
+
+    src->element = last->next;
+    if (NULL == src->element)
+    {
+        src->tail = NULL;
+    }
+    src->count -= moved;
+    last->next = NULL;
+
+    if (NULL != dest->tail)
+    {
+        dest->tail->next = first;
+    }
+    else
+    {
+        dest->element = first;
+    }
+    dest->tail = last;
+    dest->count += moved;
+
+    return moved;
+}
@@ -77,6 +77,23 @@ void CAsetSslAdapterCallbacks(CAPacketReceivedCallback recvCallback,
  * @param[in]   credTypesCallback    callback to get credential types.
  */
 void CAsetCredentialTypesCallback(CAgetCredentialTypesHandler credTypesCallback);
+
+/**
+ * Note that the PKIX info returned by the PKIX info callback changed.
+ * The parsed certificates, key and CRL are loaded again on the next handshake.
+ */
+void CAsetPkixInfoChanged(void);
+
+/**
+ * Get the number of completed handshakes, and how many of them resumed a session.
+ *
+ * @param[out] fullHandshakes      handshakes done without resumption.
+ * @param[out] resumedHandshakes   handshakes resuming a cached session or a ticket.
+ *
+ * @retval  ::CA_STATUS_OK for success, otherwise some error value
+ */
+CAResult_t CAgetSslSessionStats(uint32_t *fullHandshakes, uint32_t *resumedHandshakes);
+
 /**
  * Register callback to get credential types.
  * @param[in]  typesCallback    callback to get credential types.
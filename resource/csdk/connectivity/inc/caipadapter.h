@@ -53,6 +53,14 @@ CAResult_t CAInitializeIP(CARegisterConnectivityCallback registerCallback,
                           CAAdapterChangeCallback netCallback,
                           CAErrorHandleCallback errorCallback, ca_thread_pool_t handle);
 
+/**
+ * Set the number of threads sending IP data, before the adapter is started.
+ * Data to an endpoint is always sent by the same thread.
+ * @param[in] threadCount           Number of threads, 1 by default.
+ * @return  ::CA_STATUS_OK or Appropriate error code.
+ */
+CAResult_t CAIPSetSendThreadCount(uint32_t threadCount);
+
 /**
  * Start IP Interface adapter.
  * @return  ::CA_STATUS_OK or Appropriate error code.
@@ -136,6 +136,29 @@ void CAIPSendData(CAEndpoint_t *endpoint,
                   size_t dataLength,
                   bool isMulticast);
 
+/**
+ * Datagram passed to CAIPSendDataBatch().
+ */
+typedef struct
+{
+    CAEndpoint_t *endpoint;     /**< destination, updated as by CAIPSendData() */
+    const void *data;           /**< data to send */
+    size_t dataLength;          /**< length of data in bytes */
+    bool isMulticast;           /**< whether data is sent to the multicast groups */
+} CAIPSendItem_t;
+
+/**
+ * API to send several UDP datagrams at once.
+ *
+ * Behaves like calling CAIPSendData() for each item in order. Where sendmmsg()
+ * is available, consecutive datagrams leaving through the same socket, including
+ * the copies of a multicast datagram for each interface, are sent with one call.
+ *
+ * @param[in]  items             datagrams to send.
+ * @param[in]  count             number of items.
+ */
+void CAIPSendDataBatch(CAIPSendItem_t *items, size_t count);
+
 /**
  * Get IP adapter connection state.
  *
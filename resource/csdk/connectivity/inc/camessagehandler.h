@@ -92,12 +92,48 @@ void CATerminateMessageHandler(void);
  */
 void CAHandleRequestResponseCallbacks(void);
 
+/**
+ * Handler for receiving a batch of requests and responses in single thread model.
+ * All messages of the batch are detached from the receive queue under a single
+ * lock acquisition and their callbacks are then called in arrival order.
+ * @param[in] maxMessages   maximum number of messages to handle, 0 for all queued messages.
+ * @param[in] timeoutMs     time in milliseconds to wait for a message if the receive queue
+ *                          is empty, 0 to return immediately.
+ * @return  number of messages handled.
+ */
+uint32_t CAHandleRequestResponseCallbacksBatch(uint32_t maxMessages, uint32_t timeoutMs);
+
+/**
+ * Block until received data is waiting to be handled by the single thread model
+ * handler, CAWakeUpReceivedDataWait() is called or the timeout elapses.
+ * @param[in] timeoutMs     time in milliseconds to wait, 0 to return immediately.
+ * @return  ::CA_STATUS_OK, or ::CA_NOT_SUPPORTED when received data is handled by the
+ *          receive thread, or ::CA_STATUS_NOT_INITIALIZED.
+ */
+CAResult_t CAWaitForReceivedData(uint32_t timeoutMs);
+
+/**
+ * Wake up every caller blocked in CAWaitForReceivedData().
+ * If nobody is waiting, the next wait returns immediately.
+ */
+void CAWakeUpReceivedDataWait(void);
+
 /**
  * Setting the Callback funtion for network state change callback.
  * @param[in] nwMonitorHandler    callback for network state change.
  */
 void CASetNetworkMonitorCallback(CANetworkMonitorCallback nwMonitorHandler);
 
+/**
+ * Set the number of send threads of an adapter, before the message handler is initialized.
+ * @param[in] adapter       adapter of the send queue, ::CA_DEFAULT_ADAPTER for the queue
+ *                          shared by multicast over several adapters.
+ * @param[in] threadCount   number of threads, 1 to ::CA_MAX_SEND_THREADS.
+ * @return  ::CA_STATUS_OK, ::CA_STATUS_INVALID_PARAM or ::CA_NOT_SUPPORTED if the adapter
+ *          is not built.
+ */
+CAResult_t CASetSendThreadCount(CATransportAdapter_t adapter, uint32_t threadCount);
+
 #if defined(WITH_BWT) || defined(TCP_ADAPTER)
 /**
  * Add the data to the send queue thread.
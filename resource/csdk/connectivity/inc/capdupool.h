@@ -0,0 +1,104 @@
+/* ****************************************************************
+ *
+ * Copyright 2017 Open Connectivity Foundation All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+/**
+ * @file
+ *
+ * This file contains a pool of fixed size buffers for PDUs and the scratch
+ * buffers used while building and parsing them.
+ *
+ * The buffers are statically allocated and handed out from a lock free stack,
+ * so any thread may take and return them. Requests the pool cannot serve,
+ * because it is empty or the request is too big, fall back to the heap, and
+ * CAPDUPoolFree() releases both kinds.
+ */
+
+#ifndef CA_PDU_POOL_H_
+#define CA_PDU_POOL_H_
+
+#include "cacommon.h"
+#ifndef WITH_UPSTREAM_LIBCOAP
+#include "coap/config.h"
+#endif
+#include <coap/coap.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * Size of the pooled buffers, enough for a PDU of COAP_MAX_PDU_SIZE bytes.
+ */
+#define CA_PDU_POOL_BUFFER_SIZE (sizeof(coap_pdu_t) + COAP_MAX_PDU_SIZE)
+
+/**
+ * Number of pooled buffers. 0 disables the pool.
+ */
+#ifndef CA_PDU_POOL_COUNT
+#ifdef WITH_ARDUINO
+#define CA_PDU_POOL_COUNT 0
+#else
+#define CA_PDU_POOL_COUNT 32
+#endif
+#endif
+
+/**
+ * Usage counters of the pool.
+ */
+typedef struct
+{
+    uint32_t hits;      /**< Allocations served by the pool. */
+    uint32_t misses;    /**< Allocations that fell back to the heap. */
+} CAPDUPoolStats_t;
+
+/**
+ * Allocate a buffer. The memory is not initialized.
+ *
+ * @param[in]   size    Size of the buffer.
+ *
+ * @return  buffer, NULL if out of memory.
+ */
+void *CAPDUPoolAlloc(size_t size);
+
+/**
+ * Release a buffer returned by CAPDUPoolAlloc() or allocated with OICMalloc().
+ *
+ * @param[in]   buffer  Buffer to release, may be NULL.
+ */
+void CAPDUPoolFree(void *buffer);
+
+/**
+ * Get the usage counters of the pool.
+ *
+ * @param[out]  stats   Counters since the last CAPDUPoolResetStats().
+ */
+void CAPDUPoolGetStats(CAPDUPoolStats_t *stats);
+
+/**
+ * Reset the usage counters of the pool.
+ */
+void CAPDUPoolResetStats(void);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* CA_PDU_POOL_H_ */
@@ -41,9 +41,15 @@ extern "C"
 /** Thread function to be invoked. **/
 typedef void (*CAThreadTask)(void *threadData);
 
+/** Thread function to be invoked with several queued data at once. **/
+typedef void (*CAThreadBatchTask)(void **threadData, uint32_t count);
+
 /** Data destroy function. **/
 typedef void (*CADataDestroyFunction)(void *data, uint32_t size);
 
+/** maximum number of data handed to a batch task at once. **/
+#define CA_QUEUEING_THREAD_MAX_BATCH 32
+
 typedef struct
 {
     /** Thread pool of the thread started. **/
@@ -60,6 +66,12 @@ typedef struct
     bool isStop;
     /** Que on which the thread is operating. **/
     u_queue_t *dataQueue;
+
+    /** Function to be invoked with several data at once, NULL if unused. **/
+    CAThreadBatchTask batchTask;
+
+    /** Maximum number of data passed to batchTask. **/
+    uint32_t batchSize;
 } CAQueueingThread_t;
 
 /**
@@ -73,6 +85,19 @@ typedef struct
 CAResult_t CAQueueingThreadInitialize(CAQueueingThread_t *thread, ca_thread_pool_t handle,
                                       CAThreadTask task, CADataDestroyFunction destroy);
 
+/**
+ * Let the queuing thread hand all data queued at once to a batch task, instead of
+ * calling the task of CAQueueingThreadInitialize() for each data.
+ * Must be called before the thread is started.
+ * @param[in]   thread       thread data for each thread.
+ * @param[in]   task         function to be called with the queued data, NULL to disable.
+ * @param[in]   maxCount     maximum number of data per call,
+ *                           at most ::CA_QUEUEING_THREAD_MAX_BATCH.
+ * @return  CA_STATUS_OK or ERROR CODES (CAResult_t error codes in cacommon.h).
+ */
+CAResult_t CAQueueingThreadSetBatchTask(CAQueueingThread_t *thread, CAThreadBatchTask task,
+                                        uint32_t maxCount);
+
 /**
  * Start the queuing thread.
  * @param[in]   thread        thread data that needs to be started.
@@ -105,6 +130,75 @@ CAResult_t CAQueueingThreadStop(CAQueueingThread_t *thread);
 
 CAResult_t CAQueueingThreadDestroy(CAQueueingThread_t *thread);
 
+/**
+ * Queuing threads sharing a task. Data is queued by endpoint: the data of an endpoint
+ * always goes to the same thread and is handled in order, while the data of other
+ * endpoints is handled by the other threads in parallel.
+ */
+typedef struct
+{
+    /** Number of threads. **/
+    uint32_t count;
+    /** Threads, NULL if not initialized. **/
+    CAQueueingThread_t *threads;
+} CAQueueingThreadGroup_t;
+
+/**
+ * Initializes the queuing threads of a group.
+ * @param[in]   group        group of threads.
+ * @param[in]   count        number of threads.
+ * @param[in]   handle       thread pool handle created.
+ * @param[in]   task         function to be called for each data.
+ * @param[in]   destroy      function to data destroy.
+ * @return  CA_STATUS_OK or ERROR CODES (CAResult_t error codes in cacommon.h).
+ */
+CAResult_t CAQueueingThreadGroupInitialize(CAQueueingThreadGroup_t *group, uint32_t count,
+                                           ca_thread_pool_t handle, CAThreadTask task,
+                                           CADataDestroyFunction destroy);
+
+/**
+ * Set the batch task of every thread of a group, see CAQueueingThreadSetBatchTask().
+ * @param[in]   group        group of threads.
+ * @param[in]   task         function to be called with the queued data, NULL to disable.
+ * @param[in]   maxCount     maximum number of data per call.
+ * @return  CA_STATUS_OK or ERROR CODES (CAResult_t error codes in cacommon.h).
+ */
+CAResult_t CAQueueingThreadGroupSetBatchTask(CAQueueingThreadGroup_t *group,
+                                             CAThreadBatchTask task, uint32_t maxCount);
+
+/**
+ * Start the queuing threads of a group.
+ * @param[in]   group        group of threads.
+ * @return  CA_STATUS_OK or ERROR CODES (CAResult_t error codes in cacommon.h).
+ */
+CAResult_t CAQueueingThreadGroupStart(CAQueueingThreadGroup_t *group);
+
+/**
+ * Add data to the thread of its endpoint.
+ * @param[in]   group        group of threads.
+ * @param[in]   endpoint     endpoint the data is for, selects the thread.
+ * @param[in]   data         data that needs to be given to the thread.
+ * @param[in]   size         length of the data.
+ * @return  CA_STATUS_OK or ERROR CODES (CAResult_t error codes in cacommon.h).
+ */
+CAResult_t CAQueueingThreadGroupAddData(CAQueueingThreadGroup_t *group,
+                                        const CAEndpoint_t *endpoint,
+                                        void *data, uint32_t size);
+
+/**
+ * Stop the queuing threads of a group.
+ * @param[in]   group        group of threads.
+ * @return  CA_STATUS_OK or ERROR CODES (CAResult_t error codes in cacommon.h).
+ */
+CAResult_t CAQueueingThreadGroupStop(CAQueueingThreadGroup_t *group);
+
+/**
+ * Terminate the queuing threads of a group.
+ * @param[in]   group        group of threads.
+ * @return  CA_STATUS_OK or ERROR CODES (CAResult_t error codes in cacommon.h).
+ */
+CAResult_t CAQueueingThreadGroupDestroy(CAQueueingThreadGroup_t *group);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
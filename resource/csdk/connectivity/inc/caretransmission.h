@@ -30,7 +30,7 @@
 
 #include "cathreadpool.h"
 #include "octhread.h"
-#include "uarraylist.h"
+#include "uhashmap.h"
 #include "cacommon.h"
 
 /** IP, EDR, LE. **/
@@ -44,9 +44,6 @@
 /** default max retransmission trying count is 4(CoAP). **/
 #define DEFAULT_RETRANSMISSION_COUNT      4
 
-/** check period is 1 sec. **/
-#define RETRANSMISSION_CHECK_PERIOD_SEC     1
-
 /** retransmission data send method type. **/
 typedef CAResult_t (*CADataSendMethod_t)(const CAEndpoint_t *endpoint,
                                          const void *pdu,
@@ -68,6 +65,9 @@ typedef struct
 
 } CARetransmissionConfig_t;
 
+/** pending CON message, private to caretransmission.c. **/
+typedef struct CARetransmissionData CARetransmissionData_t;
+
 typedef struct
 {
     /** Thread pool of the thread started. **/
@@ -91,8 +91,17 @@ typedef struct
     /** Variable to inform the thread to stop. **/
     bool isStop;
 
-    /** array list on which the thread is operating. **/
-    u_arraylist_t *dataList;
+    /** pending messages, binary min-heap ordered by next retransmission time. **/
+    CARetransmissionData_t **dataHeap;
+
+    /** number of pending messages in dataHeap. **/
+    size_t dataCount;
+
+    /** allocated size of dataHeap. **/
+    size_t dataCapacity;
+
+    /** pending messages indexed by message id and transport adapter. **/
+    u_hashmap_t *dataIndex;
 
 } CARetransmission_t;
 
@@ -108,6 +108,14 @@ CAResult_t CAInitializeTCP(CARegisterConnectivityCallback registerCallback,
                            CAConnectionChangeCallback connCallback,
                            CAErrorHandleCallback errorCallback, ca_thread_pool_t handle);
 
+/**
+ * Set the number of threads sending TCP data, before the adapter is started.
+ * Data to an endpoint is always sent by the same thread.
+ * @param[in] threadCount           Number of threads, 1 by default.
+ * @return  ::CA_STATUS_OK or Appropriate error code.
+ */
+CAResult_t CATCPSetSendThreadCount(uint32_t threadCount);
+
 /**
  * Start TCP Interface adapter.
  * @return  ::CA_STATUS_OK or Appropriate error code.
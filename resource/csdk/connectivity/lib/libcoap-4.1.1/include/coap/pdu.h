@@ -415,6 +415,31 @@ coap_pdu_t *coap_new_pdu2(coap_transport_t transport, unsigned int size);
 
 void coap_delete_pdu(coap_pdu_t *);
 
+#if defined(WITH_POSIX) || defined(WITH_ARDUINO)
+/**
+ * Allocator for the storage of PDUs, called with the number of bytes to
+ * allocate. Returns @c NULL if out of memory.
+ */
+typedef void *(*coap_pdu_alloc_t)(size_t size);
+
+/**
+ * Releases storage obtained from the matching coap_pdu_alloc_t.
+ */
+typedef void (*coap_pdu_free_t)(void *storage);
+
+/**
+ * Sets the functions coap_pdu_init2() and coap_delete_pdu() use to allocate
+ * and release PDUs, e.g. to take them from a pool. PDUs that are alive when
+ * this is called are released with @p free_fn as well, which must therefore
+ * also release storage obtained with malloc(). Must be called before PDUs are
+ * created by other threads. Passing @c NULL restores malloc() and free().
+ *
+ * @param alloc_fn The allocator.
+ * @param free_fn  The matching release function.
+ */
+void coap_pdu_set_allocator(coap_pdu_alloc_t alloc_fn, coap_pdu_free_t free_fn);
+#endif
+
 /**
  * Parses @p data into the CoAP PDU structure given in @p result.
  * This function returns @c 0 on error or a number greater than zero on success.
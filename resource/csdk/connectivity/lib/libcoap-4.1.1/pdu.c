@@ -50,6 +50,29 @@ coap_pdu_resources_init()
 #include "include/coap/mem.h"
 #endif /* WITH_CONTIKI */
 
+#if defined(WITH_POSIX) || defined(WITH_ARDUINO)
+static void *
+pdu_malloc(size_t size)
+{
+    return coap_malloc(size);
+}
+
+static void
+pdu_free(void *storage)
+{
+    coap_free(storage);
+}
+
+static coap_pdu_alloc_t pdu_alloc_fn = pdu_malloc;
+static coap_pdu_free_t pdu_free_fn = pdu_free;
+
+void coap_pdu_set_allocator(coap_pdu_alloc_t alloc_fn, coap_pdu_free_t free_fn)
+{
+    pdu_alloc_fn = alloc_fn ? alloc_fn : pdu_malloc;
+    pdu_free_fn = free_fn ? free_fn : pdu_free;
+}
+#endif
+
 void coap_pdu_clear(coap_pdu_t *pdu, size_t size)
 {
     coap_pdu_clear2(pdu, size, COAP_UDP, 0);
@@ -154,7 +177,9 @@ coap_pdu_init2(unsigned char type, unsigned char code, unsigned short id,
 #endif
 
     /* size must be large enough for hdr */
-#if defined(WITH_POSIX) || defined(WITH_ARDUINO) || defined(_WIN32)
+#if defined(WITH_POSIX) || defined(WITH_ARDUINO)
+    pdu = (coap_pdu_t *) pdu_alloc_fn(sizeof(coap_pdu_t) + size);
+#elif defined(_WIN32)
     pdu = (coap_pdu_t *) coap_malloc(sizeof(coap_pdu_t) + size);
 #endif
 #ifdef WITH_CONTIKI
@@ -252,7 +277,8 @@ coap_new_pdu2(coap_transport_t transport, unsigned int size)
 void coap_delete_pdu(coap_pdu_t *pdu)
 {
 #if defined(WITH_POSIX) || defined(WITH_ARDUINO)
-    coap_free( pdu );
+    if (pdu != NULL)
+        pdu_free_fn( pdu );
 #endif
 #ifdef WITH_LWIP
     if (pdu != NULL) /* accepting double free as the other implementation accept that too */
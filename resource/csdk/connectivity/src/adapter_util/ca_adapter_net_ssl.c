@@ -34,10 +34,13 @@
 #include "caipinterface.h"
 #include "cacertprofile.h"
 #include "oic_malloc.h"
+#include "oic_string.h"
 #include "experimental/ocrandom.h"
 #include "experimental/byte_array.h"
 #include "octhread.h"
 #include "octimer.h"
+#include "ocatomic.h"
+#include "uhashmap.h"
 
 // headers required for mbed TLS
 #include "mbedtls/platform.h"
@@ -54,6 +57,12 @@
 #include "mbedtls/timing.h"
 #include "mbedtls/ssl_cookie.h"
 #endif
+#ifdef MBEDTLS_SSL_CACHE_C
+#include "mbedtls/ssl_cache.h"
+#endif
+#if defined(MBEDTLS_SSL_SESSION_TICKETS) && defined(MBEDTLS_SSL_TICKET_C)
+#include "mbedtls/ssl_ticket.h"
+#endif
 
 #if !defined(NDEBUG) || defined(TB_LOG)
 #include "mbedtls/debug.h"
@@ -137,6 +146,20 @@
  * @brief MAC key length for SHA384 cipher suites
  */
 #define SHA384_MAC_KEY_LENGTH (48)
+/**
+ * @def SSL_SESSION_CACHE_SIZE
+ * @brief Number of sessions kept by the client side to resume them
+ */
+#ifndef SSL_SESSION_CACHE_SIZE
+#define SSL_SESSION_CACHE_SIZE (16)
+#endif
+/**
+ * @def SSL_SESSION_LIFETIME_SEC
+ * @brief Lifetime of the sessions cached by the server side and of session tickets
+ */
+#ifndef SSL_SESSION_LIFETIME_SEC
+#define SSL_SESSION_LIFETIME_SEC (86400)
+#endif
 /**
  * @def SHA256_MAC_KEY_LENGTH
  * @brief MAC key length for SHA256 cipher suites
@@ -356,6 +379,19 @@ typedef struct TlsCallBacks
     CAErrorHandleCallback errorCallback;    /**< Callback used to pass error to upper layer. */
 } SslCallbacks_t;
 
+/**
+ * Data structure for holding a session the client side can resume.
+ */
+typedef struct SslSession
+{
+    bool used;
+    CATransportAdapter_t adapter;
+    char addr[MAX_ADDR_STR_SIZE_CA];
+    uint16_t port;
+    uint32_t lastUse;
+    mbedtls_ssl_session session;
+} SslSession_t;
+
 /**
  * Data structure for holding the mbedTLS interface related info.
  */
@@ -363,8 +399,12 @@ typedef struct SslContext
 {
     u_arraylist_t *peerList;         /**< peer list which holds the mapping between
                                               peer id, it's n/w address and mbedTLS context. */
+    u_hashmap_t *peerIndex;          /**< peerList indexed by adapter, address and port. */
+    uint32_t peersInUse;             /**< references taken with AcquireSslPeer(). */
+    oc_cond peersInUseCond;          /**< signaled when peersInUse drops to 0. */
     mbedtls_entropy_context entropy;
     mbedtls_ctr_drbg_context rnd;
+    oc_mutex rndMutex;               /**< serializes the use of rnd, see SslRandom(). */
     mbedtls_x509_crt ca;
     mbedtls_x509_crt crt;
     mbedtls_pk_context pkey;
@@ -380,6 +420,25 @@ typedef struct SslContext
     bool cipherFlag[2];
     int selectedCipher;
 
+    int32_t pkixGeneration;          /**< PKIX generation parsed into ca, crt, pkey and crl,
+                                              0 if none. */
+    int32_t dtlsPkixGeneration;      /**< PKIX generation set in the DTLS configs. */
+    int32_t tlsPkixGeneration;       /**< PKIX generation set in the TLS configs. */
+    bool pkixOwnCert;                /**< crt and pkey hold a usable own certificate. */
+    bool pkixCrl;                    /**< crl holds a usable CRL. */
+
+    SslSession_t sessions[SSL_SESSION_CACHE_SIZE]; /**< sessions to resume as a client. */
+    uint32_t sessionUseCount;        /**< LRU clock of the client sessions. */
+    int32_t sessionGeneration;       /**< PKIX generation the cached sessions belong to. */
+#ifdef MBEDTLS_SSL_CACHE_C
+    mbedtls_ssl_cache_context sessionCache;    /**< sessions to resume as a server. */
+#endif
+#if defined(MBEDTLS_SSL_SESSION_TICKETS) && defined(MBEDTLS_SSL_TICKET_C)
+    mbedtls_ssl_ticket_context ticketCtx;      /**< session ticket keys as a server. */
+#endif
+    uint32_t fullHandshakes;         /**< completed handshakes without resumption. */
+    uint32_t resumedHandshakes;      /**< completed handshakes resuming a session. */
+
 #ifdef __WITH_DTLS__
     mbedtls_ssl_cookie_ctx cookieCtx;
     int timerId;
@@ -410,6 +469,14 @@ static CAgetCredentialTypesHandler g_getCredentialTypesCallback = NULL;
  */
 static CAgetPkixInfoHandler g_getPkixInfoCallback = NULL;
 
+/**
+ * @var g_pkixGeneration
+ *
+ * @brief generation of the PKIX info, incremented each time it changes.
+ *        Parsed PKIX info is kept until the generation changes.
+ */
+static volatile int32_t g_pkixGeneration = 1;
+
 /**
  * @var g_dtlsContextMutex
  * @brief Mutex to synchronize access to g_caSslContext and g_sslCallback.
@@ -441,6 +508,12 @@ typedef struct SslRecBuf
 /**
  * Data structure for holding the data related to endpoint
  * and TLS session.
+ *
+ * Until the handshake is over, a session is only used with g_sslContextMutex held.
+ * Once established, encrypt and decrypt calls take a reference to the session with
+ * AcquireSslPeer() and use its ssl context and recBuf holding only its mutex, so that
+ * different peers are served in parallel. The session mutex is never waited for while
+ * holding g_sslContextMutex, as the adapter callbacks run with the session mutex held.
  */
 typedef struct SslEndPoint
 {
@@ -450,6 +523,11 @@ typedef struct SslEndPoint
     SslRecBuf_t recBuf;
     uint8_t master[MASTER_SECRET_LEN];
     uint8_t random[2*RANDOM_LEN];
+    bool resumed;
+    bool established;       /**< handshake over, the session is used under mutex. */
+    bool closeNotify;       /**< send close_notify when the session is deleted. */
+    uint32_t refCount;      /**< references of the peer list and AcquireSslPeer(). */
+    oc_mutex mutex;
 #ifdef __WITH_DTLS__
     mbedtls_timing_delay_context timer;
 #endif // __WITH_DTLS__
@@ -467,9 +545,21 @@ void CAsetPkixInfoCallback(CAgetPkixInfoHandler infoCallback)
 {
     OIC_LOG_V(DEBUG, NET_SSL_TAG, "In %s", __func__);
     g_getPkixInfoCallback = infoCallback;
+    CAsetPkixInfoChanged();
     OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s", __func__);
 }
 
+void CAsetPkixInfoChanged(void)
+{
+    int32_t generation = oc_atomic_increment(&g_pkixGeneration);
+    if (0 == generation)
+    {
+        // 0 means nothing loaded, skip it on wrap around.
+        generation = oc_atomic_increment(&g_pkixGeneration);
+    }
+    OIC_LOG_V(DEBUG, NET_SSL_TAG, "PKIX info generation %" PRId32, generation);
+}
+
 void CAsetCredentialTypesCallback(CAgetCredentialTypesHandler credTypesCallback)
 {
     OIC_LOG_V(DEBUG, NET_SSL_TAG, "In %s", __func__);
@@ -559,6 +649,27 @@ static int GetAdapterIndex(CATransportAdapter_t adapter)
     }
 }
 
+/**
+ * Random number generator of the TLS configurations.
+ *
+ * mbedTLS is built without MBEDTLS_THREADING_C, and the DRBG is shared by the
+ * sessions encrypting in parallel, e.g. for the explicit IVs of CBC records.
+ *
+ * @param[in]  ctx        SSL context
+ * @param[out] output     buffer to fill
+ * @param[in]  outputLen  length of the buffer
+ *
+ * @return  0 on success or mbedTLS error code
+ */
+static int SslRandom(void * ctx, unsigned char * output, size_t outputLen)
+{
+    SslContext_t * sslContext = (SslContext_t *) ctx;
+    oc_mutex_lock(sslContext->rndMutex);
+    int ret = mbedtls_ctr_drbg_random(&sslContext->rnd, output, outputLen);
+    oc_mutex_unlock(sslContext->rndMutex);
+    return ret;
+}
+
 static void SendCacheMessages(SslEndPoint_t * tep, CAResult_t errorCode);
 
 /**
@@ -711,8 +822,8 @@ static void DeInitPkixInfo(PkiInfo_t * inf)
     OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s", __func__);
 }
 
-//Loads PKIX related information from SRM
-static int InitPKIX(CATransportAdapter_t adapter)
+//Loads and parses PKIX related information from SRM
+static int ParsePKIX(int32_t generation)
 {
     OIC_LOG_V(DEBUG, NET_SSL_TAG, "In %s", __func__);
     VERIFY_NON_NULL_RET(g_getPkixInfoCallback, NET_SSL_TAG, "PKIX info callback is NULL", -1);
@@ -731,6 +842,13 @@ static int InitPKIX(CATransportAdapter_t adapter)
 
     VERIFY_NON_NULL_RET(g_caSslContext, NET_SSL_TAG, "SSL Context is NULL", -1);
 
+    // The configs of both transports refer to the parsed data, none is up to date anymore.
+    g_caSslContext->pkixGeneration = 0;
+    g_caSslContext->dtlsPkixGeneration = 0;
+    g_caSslContext->tlsPkixGeneration = 0;
+    g_caSslContext->pkixOwnCert = false;
+    g_caSslContext->pkixCrl = false;
+
     mbedtls_x509_crt_free(&g_caSslContext->ca);
     mbedtls_x509_crt_free(&g_caSslContext->crt);
     mbedtls_pk_free(&g_caSslContext->pkey);
@@ -741,12 +859,6 @@ static int InitPKIX(CATransportAdapter_t adapter)
     mbedtls_pk_init(&g_caSslContext->pkey);
     mbedtls_x509_crl_init(&g_caSslContext->crl);
 
-    mbedtls_ssl_config * serverConf = (adapter == CA_ADAPTER_IP ||
-                                   adapter == CA_ADAPTER_GATT_BTLE ?
-                                   &g_caSslContext->serverDtlsConf : &g_caSslContext->serverTlsConf);
-    mbedtls_ssl_config * clientConf = (adapter == CA_ADAPTER_IP ||
-                                   adapter == CA_ADAPTER_GATT_BTLE ?
-                                   &g_caSslContext->clientDtlsConf : &g_caSslContext->clientTlsConf);
     // optional
     int ret;
     int errNum;
@@ -781,6 +893,68 @@ static int InitPKIX(CATransportAdapter_t adapter)
         OIC_LOG(WARNING, NET_SSL_TAG, "Key parsing error");
         goto required;
     }
+    g_caSslContext->pkixOwnCert = true;
+
+    required:
+    count = ParseChain(&g_caSslContext->ca, pkiInfo.ca.data, pkiInfo.ca.len, &errNum);
+    if(0 >= count)
+    {
+        OIC_LOG(ERROR, NET_SSL_TAG, "CA chain parsing error");
+        OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s", __func__);
+        DeInitPkixInfo(&pkiInfo);
+        return -1;
+    }
+    if(0 != errNum)
+    {
+        OIC_LOG_V(WARNING, NET_SSL_TAG, "CA chain parsing warning: %d certs failed to parse", errNum);
+    }
+    else
+    {
+        ret = ValidateRootCACertListProfiles(&g_caSslContext->ca);
+        if (CP_INVALID_CERT_LIST == ret)
+        {
+            OIC_LOG(ERROR, NET_SSL_TAG, "Invalid own CA cert chain");
+            OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s", __func__);
+            DeInitPkixInfo(&pkiInfo);
+            return -1;
+        }
+        else if (0 < ret )
+        {
+            OIC_LOG_V(ERROR, NET_SSL_TAG, "%d certificate(s) in own CA cert chain violate OCF Root CA cert profile requirements", ret);
+            OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s", __func__);
+            DeInitPkixInfo(&pkiInfo);
+            return -1;
+        }
+    }
+
+    ret = mbedtls_x509_crl_parse_der(&g_caSslContext->crl, pkiInfo.crl.data, pkiInfo.crl.len);
+    if(0 != ret)
+    {
+        OIC_LOG(WARNING, NET_SSL_TAG, "CRL parsing error");
+    }
+    else
+    {
+        g_caSslContext->pkixCrl = true;
+    }
+
+    DeInitPkixInfo(&pkiInfo);
+
+    g_caSslContext->pkixGeneration = generation;
+
+    OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s", __func__);
+    return 0;
+}
+
+//Sets the parsed PKIX information in the configs of a transport
+static void ConfigurePKIX(mbedtls_ssl_config * serverConf, mbedtls_ssl_config * clientConf)
+{
+    OIC_LOG_V(DEBUG, NET_SSL_TAG, "In %s", __func__);
+
+    int ret;
+    if (!g_caSslContext->pkixOwnCert)
+    {
+        goto required;
+    }
 
     ret = mbedtls_ssl_conf_own_cert(serverConf, &g_caSslContext->crt, &g_caSslContext->pkey);
     if (0 != ret)
@@ -812,51 +986,54 @@ static int InitPKIX(CATransportAdapter_t adapter)
     }
 
     required:
-    count = ParseChain(&g_caSslContext->ca, pkiInfo.ca.data, pkiInfo.ca.len, &errNum);
-    if(0 >= count)
+    if (!g_caSslContext->pkixCrl)
     {
-        OIC_LOG(ERROR, NET_SSL_TAG, "CA chain parsing error");
-        OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s", __func__);
-        DeInitPkixInfo(&pkiInfo);
-        return -1;
+        CONF_SSL(clientConf, serverConf, mbedtls_ssl_conf_ca_chain, &g_caSslContext->ca, NULL);
     }
-    if(0 != errNum)
+    else
     {
-        OIC_LOG_V(WARNING, NET_SSL_TAG, "CA chain parsing warning: %d certs failed to parse", errNum);
+        CONF_SSL(clientConf, serverConf, mbedtls_ssl_conf_ca_chain,
+                 &g_caSslContext->ca, &g_caSslContext->crl);
     }
-    else
+
+    OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s", __func__);
+}
+
+//Loads PKIX related information from SRM unless the loaded one is up to date
+static int InitPKIX(CATransportAdapter_t adapter)
+{
+    OIC_LOG_V(DEBUG, NET_SSL_TAG, "In %s", __func__);
+    VERIFY_NON_NULL_RET(g_caSslContext, NET_SSL_TAG, "SSL Context is NULL", -1);
+
+    // Read the generation before the info, a change while parsing is seen next time.
+    int32_t generation = oc_atomic_add(&g_pkixGeneration, 0);
+
+    if (generation != g_caSslContext->pkixGeneration)
     {
-        ret = ValidateRootCACertListProfiles(&g_caSslContext->ca);
-        if (CP_INVALID_CERT_LIST == ret)
-        {
-            OIC_LOG(ERROR, NET_SSL_TAG, "Invalid own CA cert chain");
-            OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s", __func__);
-            DeInitPkixInfo(&pkiInfo);
-            return -1;
-        }
-        else if (0 < ret )
+        if (0 != ParsePKIX(generation))
         {
-            OIC_LOG_V(ERROR, NET_SSL_TAG, "%d certificate(s) in own CA cert chain violate OCF Root CA cert profile requirements", ret);
             OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s", __func__);
-            DeInitPkixInfo(&pkiInfo);
             return -1;
         }
     }
 
-    ret = mbedtls_x509_crl_parse_der(&g_caSslContext->crl, pkiInfo.crl.data, pkiInfo.crl.len);
-    if(0 != ret)
+    bool isDtls = (adapter == CA_ADAPTER_IP || adapter == CA_ADAPTER_GATT_BTLE);
+    int32_t * configured = isDtls ? &g_caSslContext->dtlsPkixGeneration
+                                  : &g_caSslContext->tlsPkixGeneration;
+    if (generation != *configured)
     {
-        OIC_LOG(WARNING, NET_SSL_TAG, "CRL parsing error");
-        CONF_SSL(clientConf, serverConf, mbedtls_ssl_conf_ca_chain, &g_caSslContext->ca, NULL);
+        mbedtls_ssl_config * serverConf = (isDtls ?
+                                       &g_caSslContext->serverDtlsConf : &g_caSslContext->serverTlsConf);
+        mbedtls_ssl_config * clientConf = (isDtls ?
+                                       &g_caSslContext->clientDtlsConf : &g_caSslContext->clientTlsConf);
+        ConfigurePKIX(serverConf, clientConf);
+        *configured = generation;
     }
     else
     {
-        CONF_SSL(clientConf, serverConf, mbedtls_ssl_conf_ca_chain,
-                 &g_caSslContext->ca, &g_caSslContext->crl);
+        OIC_LOG(DEBUG, NET_SSL_TAG, "PKIX info is up to date");
     }
 
-    DeInitPkixInfo(&pkiInfo);
-
     OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s", __func__);
     return 0;
 }
@@ -902,6 +1079,43 @@ static int GetPskCredentialsCallback(void * notUsed, mbedtls_ssl_context * ssl,
     OIC_LOG_V(WARNING, NET_SSL_TAG, "Out %s", __func__);
     return -1;
 }
+/**
+ * Hash function of the peer index, consistent with SslPeerMatch().
+ *
+ * @param[in]  key    remote address
+ *
+ * @return  hash of the adapter, address and port
+ */
+static uint32_t SslPeerHash(const void *key)
+{
+    const CAEndpoint_t *peer = (const CAEndpoint_t *) key;
+    uint32_t hash = u_hashmap_hash_bytes(&peer->adapter, sizeof(peer->adapter),
+                                         U_HASHMAP_HASH_SEED);
+    hash = u_hashmap_hash_bytes(peer->addr, strnlen(peer->addr, MAX_ADDR_STR_SIZE_CA), hash);
+    if (CA_ADAPTER_GATT_BTLE != peer->adapter)
+    {
+        hash = u_hashmap_hash_bytes(&peer->port, sizeof(peer->port), hash);
+    }
+    return hash;
+}
+
+/**
+ * Match function of the peer index. The port is ignored for BLE.
+ *
+ * @param[in]  key     remote address
+ * @param[in]  data    TLS session
+ *
+ * @return  true if the session is the one of the remote address
+ */
+static bool SslPeerMatch(const void *key, const void *data)
+{
+    const CAEndpoint_t *peer = (const CAEndpoint_t *) key;
+    const SslEndPoint_t *tep = (const SslEndPoint_t *) data;
+    return (peer->adapter == tep->sep.endpoint.adapter)
+            && (0 == strncmp(peer->addr, tep->sep.endpoint.addr, MAX_ADDR_STR_SIZE_CA))
+            && (peer->port == tep->sep.endpoint.port || CA_ADAPTER_GATT_BTLE == peer->adapter);
+}
+
 /**
  * Gets session corresponding for endpoint.
  *
@@ -911,40 +1125,12 @@ static int GetPskCredentialsCallback(void * notUsed, mbedtls_ssl_context * ssl,
  */
 static SslEndPoint_t *GetSslPeer(const CAEndpoint_t *peer)
 {
-    size_t listIndex = 0;
-    size_t listLength = 0;
-    OIC_LOG_V(DEBUG, NET_SSL_TAG, "In %s", __func__);
-
     oc_mutex_assert_owner(g_sslContextMutex, true);
 
     VERIFY_NON_NULL_RET(peer, NET_SSL_TAG, "TLS peer is NULL", NULL);
     VERIFY_NON_NULL_RET(g_caSslContext, NET_SSL_TAG, "SSL Context is NULL", NULL);
 
-    SslEndPoint_t *tep = NULL;
-    listLength = u_arraylist_length(g_caSslContext->peerList);
-    for (listIndex = 0; listIndex < listLength; listIndex++)
-    {
-        tep = (SslEndPoint_t *) u_arraylist_get(g_caSslContext->peerList, listIndex);
-        if (NULL == tep)
-        {
-            continue;
-        }
-
-        OIC_LOG_V(DEBUG, NET_SSL_TAG, "Compare [%s:%d] and [%s:%d] for %d adapter",
-                  peer->addr, peer->port, tep->sep.endpoint.addr, tep->sep.endpoint.port,
-                  peer->adapter);
-
-        if((peer->adapter == tep->sep.endpoint.adapter)
-                && (0 == strncmp(peer->addr, tep->sep.endpoint.addr, MAX_ADDR_STR_SIZE_CA))
-                && (peer->port == tep->sep.endpoint.port || CA_ADAPTER_GATT_BTLE == peer->adapter))
-        {
-            OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s", __func__);
-            return tep;
-        }
-    }
-    OIC_LOG(DEBUG, NET_SSL_TAG, "Return NULL");
-    OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s", __func__);
-    return NULL;
+    return (SslEndPoint_t *) u_hashmap_get(g_caSslContext->peerIndex, peer);
 }
 
 /**
@@ -1134,11 +1320,100 @@ static void DeleteSslEndPoint(SslEndPoint_t * tep)
     OIC_LOG_V(DEBUG, NET_SSL_TAG, "In %s", __func__);
     VERIFY_NON_NULL_VOID(tep, NET_SSL_TAG, "tep");
 
+    if (tep->closeNotify)
+    {
+        /* No error checking, the connection might be closed already */
+        int ret = 0;
+        SSL_CLOSE_NOTIFY(tep, ret);
+    }
     mbedtls_ssl_free(&tep->ssl);
     DeleteCacheList(tep->cacheList);
+    oc_mutex_free(tep->mutex);
     OICFree(tep);
     OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s", __func__);
 }
+/**
+ * Releases a reference to a session, deleting the session with the last one.
+ *
+ * @param[in]  tep    endpoint with session info
+ */
+static void UnrefSslPeer(SslEndPoint_t * tep)
+{
+    oc_mutex_assert_owner(g_sslContextMutex, true);
+
+    if (0 == --tep->refCount)
+    {
+        DeleteSslEndPoint(tep);
+    }
+}
+/**
+ * Takes a reference to an established session, to use it after releasing
+ * g_sslContextMutex. The reference is released with ReleaseSslPeer().
+ *
+ * @param[in]  tep    endpoint with session info
+ */
+static void AcquireSslPeer(SslEndPoint_t * tep)
+{
+    oc_mutex_assert_owner(g_sslContextMutex, true);
+
+    tep->refCount++;
+    g_caSslContext->peersInUse++;
+}
+/**
+ * Releases a reference taken with AcquireSslPeer().
+ *
+ * @param[in]  tep    endpoint with session info
+ */
+static void ReleaseSslPeer(SslEndPoint_t * tep)
+{
+    oc_mutex_assert_owner(g_sslContextMutex, true);
+
+    UnrefSslPeer(tep);
+    if (0 == --g_caSslContext->peersInUse)
+    {
+        oc_cond_signal(g_caSslContext->peersInUseCond);
+    }
+}
+/**
+ * Adds endpoint session to the list, which owns the reference of a new session.
+ *
+ * @param[in]  tep    endpoint with session info
+ *
+ * @return  true on success
+ */
+static bool AddPeerToList(SslEndPoint_t * tep)
+{
+    oc_mutex_assert_owner(g_sslContextMutex, true);
+
+    if (!u_hashmap_put(g_caSslContext->peerIndex, &tep->sep.endpoint, tep))
+    {
+        return false;
+    }
+    if (!u_arraylist_add(g_caSslContext->peerList, (void *) tep))
+    {
+        u_hashmap_remove_data(g_caSslContext->peerIndex, &tep->sep.endpoint, tep);
+        return false;
+    }
+    return true;
+}
+/**
+ * Removes endpoint session from list, if it was not removed already.
+ *
+ * @param[in]  tep    endpoint with session info
+ */
+static void RemoveSslPeer(SslEndPoint_t * tep)
+{
+    oc_mutex_assert_owner(g_sslContextMutex, true);
+
+    size_t listIndex = 0;
+    if (!u_arraylist_get_index(g_caSslContext->peerList, tep, &listIndex))
+    {
+        return;
+    }
+    u_arraylist_remove(g_caSslContext->peerList, listIndex);
+    u_hashmap_remove_data(g_caSslContext->peerIndex, &tep->sep.endpoint, tep);
+    UnrefSslPeer(tep);
+}
 /**
  * Removes endpoint session from list.
  *
@@ -1151,21 +1426,10 @@ static void RemovePeerFromList(CAEndpoint_t * endpoint)
     VERIFY_NON_NULL_VOID(g_caSslContext, NET_SSL_TAG, "SSL Context is NULL");
     VERIFY_NON_NULL_VOID(endpoint, NET_SSL_TAG, "endpoint");
 
-    size_t listLength = u_arraylist_length(g_caSslContext->peerList);
-    for (size_t listIndex = 0; listIndex < listLength; listIndex++)
+    SslEndPoint_t * tep = GetSslPeer(endpoint);
+    if (NULL != tep)
     {
-        SslEndPoint_t * tep = (SslEndPoint_t *)u_arraylist_get(g_caSslContext->peerList, listIndex);
-        if (NULL == tep)
-        {
-            continue;
-        }
-        if(0 == strncmp(endpoint->addr, tep->sep.endpoint.addr, MAX_ADDR_STR_SIZE_CA)
-                && (endpoint->port == tep->sep.endpoint.port))
-        {
-            u_arraylist_remove(g_caSslContext->peerList, listIndex);
-            DeleteSslEndPoint(tep);
-            return;
-        }
+        RemoveSslPeer(tep);
     }
 }
 
@@ -1271,18 +1535,12 @@ static void DeletePeerList(void)
         {
             continue;
         }
-        if (MBEDTLS_SSL_HANDSHAKE_OVER == tep->ssl.state)
-        {
-            int ret = 0;
-            do
-            {
-                ret = mbedtls_ssl_close_notify(&tep->ssl);
-            }
-            while (MBEDTLS_ERR_SSL_WANT_WRITE == ret);
-        }
-        DeleteSslEndPoint(tep);
+        // Sessions still in use are deleted when released.
+        tep->closeNotify = tep->established;
+        UnrefSslPeer(tep);
     }
     u_arraylist_free(&g_caSslContext->peerList);
+    u_hashmap_free(&g_caSslContext->peerIndex);
 }
 
 CAResult_t CAcloseSslConnection(const CAEndpoint_t *endpoint)
@@ -1304,15 +1562,9 @@ CAResult_t CAcloseSslConnection(const CAEndpoint_t *endpoint)
         oc_mutex_unlock(g_sslContextMutex);
         return CA_STATUS_FAILED;
     }
-    /* No error checking, the connection might be closed already */
-    int ret = 0;
-    do
-    {
-        ret = mbedtls_ssl_close_notify(&tep->ssl);
-    }
-    while (MBEDTLS_ERR_SSL_WANT_WRITE == ret);
-
-    RemovePeerFromList(&tep->sep.endpoint);
+    // close_notify is sent once no encrypt or decrypt call uses the session.
+    tep->closeNotify = true;
+    RemoveSslPeer(tep);
     oc_mutex_unlock(g_sslContextMutex);
 
     OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s", __func__);
@@ -1360,13 +1612,207 @@ void CAcloseSslConnectionAll(CATransportAdapter_t transportType)
 
         // delete from list
         u_arraylist_remove(g_caSslContext->peerList, i - 1);
-        DeleteSslEndPoint(tep);
+        u_hashmap_remove_data(g_caSslContext->peerIndex, &tep->sep.endpoint, tep);
+        UnrefSslPeer(tep);
     }
     oc_mutex_unlock(g_sslContextMutex);
 
     OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s", __func__);
     return;
 }
+/**
+ * Checks whether a session may be resumed. Sessions based on PSK or anonymous
+ * cipher suites are not, the peer identity is only known from a full handshake.
+ *
+ * @param[in]  ciphersuite    cipher suite of the session
+ *
+ * @return  true if the session may be cached
+ */
+static bool IsResumableCipherSuite(int ciphersuite)
+{
+    return (MBEDTLS_TLS_ECDHE_PSK_WITH_AES_128_CBC_SHA256 != ciphersuite &&
+            MBEDTLS_TLS_ECDH_ANON_WITH_AES_128_CBC_SHA256 != ciphersuite);
+}
+
+#ifdef MBEDTLS_SSL_CACHE_C
+static int SslSessionCacheSet(void * data, const mbedtls_ssl_session * session)
+{
+    if (!IsResumableCipherSuite(session->ciphersuite))
+    {
+        return 0;
+    }
+    return mbedtls_ssl_cache_set(data, session);
+}
+#endif
+
+#if defined(MBEDTLS_SSL_SESSION_TICKETS) && defined(MBEDTLS_SSL_TICKET_C)
+static int SslTicketWrite(void * ticketCtx, const mbedtls_ssl_session * session,
+                          unsigned char * start, const unsigned char * end,
+                          size_t * tlen, uint32_t * lifetime)
+{
+    // mbedTLS sends an empty ticket when writing fails
+    if (!IsResumableCipherSuite(session->ciphersuite))
+    {
+        return MBEDTLS_ERR_SSL_FEATURE_UNAVAILABLE;
+    }
+    return mbedtls_ssl_ticket_write(ticketCtx, session, start, end, tlen, lifetime);
+}
+#endif
+
+static SslSession_t * GetSslSession(const CAEndpoint_t * endpoint)
+{
+    for (size_t i = 0; i < SSL_SESSION_CACHE_SIZE; i++)
+    {
+        SslSession_t * entry = &g_caSslContext->sessions[i];
+        if (entry->used && entry->adapter == endpoint->adapter && entry->port == endpoint->port
+            && 0 == strncmp(entry->addr, endpoint->addr, sizeof(entry->addr)))
+        {
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+static void DeleteSslSession(SslSession_t * entry)
+{
+    mbedtls_ssl_session_free(&entry->session);
+    entry->used = false;
+}
+
+/**
+ * Drops the cached sessions and session ticket keys once the credentials
+ * they were established with changed.
+ */
+static void CheckSslSessionGeneration(void)
+{
+    int32_t generation = oc_atomic_add(&g_pkixGeneration, 0);
+    if (generation == g_caSslContext->sessionGeneration)
+    {
+        return;
+    }
+    OIC_LOG(DEBUG, NET_SSL_TAG, "Credentials changed, dropping cached sessions");
+
+    for (size_t i = 0; i < SSL_SESSION_CACHE_SIZE; i++)
+    {
+        if (g_caSslContext->sessions[i].used)
+        {
+            DeleteSslSession(&g_caSslContext->sessions[i]);
+        }
+    }
+#ifdef MBEDTLS_SSL_CACHE_C
+    mbedtls_ssl_cache_free(&g_caSslContext->sessionCache);
+    mbedtls_ssl_cache_init(&g_caSslContext->sessionCache);
+    mbedtls_ssl_cache_set_timeout(&g_caSslContext->sessionCache, SSL_SESSION_LIFETIME_SEC);
+#endif
+#if defined(MBEDTLS_SSL_SESSION_TICKETS) && defined(MBEDTLS_SSL_TICKET_C)
+    mbedtls_ssl_ticket_free(&g_caSslContext->ticketCtx);
+    mbedtls_ssl_ticket_init(&g_caSslContext->ticketCtx);
+    if (0 != mbedtls_ssl_ticket_setup(&g_caSslContext->ticketCtx, SslRandom,
+                                      g_caSslContext, MBEDTLS_CIPHER_AES_128_GCM,
+                                      SSL_SESSION_LIFETIME_SEC))
+    {
+        OIC_LOG(WARNING, NET_SSL_TAG, "Session ticket setup failed!");
+    }
+#endif
+    g_caSslContext->sessionGeneration = generation;
+}
+
+/**
+ * Keeps the session of a client endpoint whose handshake is over, so that the
+ * next connection to the same peer can resume it.
+ */
+static void SaveSslSession(SslEndPoint_t * tep)
+{
+    if (!IsResumableCipherSuite(tep->ssl.session->ciphersuite))
+    {
+        return;
+    }
+
+    const CAEndpoint_t * endpoint = &tep->sep.endpoint;
+    SslSession_t * entry = GetSslSession(endpoint);
+    if (NULL == entry)
+    {
+        // take a free entry, or the least recently used one
+        entry = &g_caSslContext->sessions[0];
+        for (size_t i = 0; i < SSL_SESSION_CACHE_SIZE && entry->used; i++)
+        {
+            SslSession_t * candidate = &g_caSslContext->sessions[i];
+            if (!candidate->used || candidate->lastUse < entry->lastUse)
+            {
+                entry = candidate;
+            }
+        }
+    }
+    if (entry->used)
+    {
+        DeleteSslSession(entry);
+    }
+
+    mbedtls_ssl_session_init(&entry->session);
+    if (0 != mbedtls_ssl_get_session(&tep->ssl, &entry->session))
+    {
+        OIC_LOG(WARNING, NET_SSL_TAG, "Failed to save session");
+        mbedtls_ssl_session_free(&entry->session);
+        return;
+    }
+    entry->adapter = endpoint->adapter;
+    OICStrcpy(entry->addr, sizeof(entry->addr), endpoint->addr);
+    entry->port = endpoint->port;
+    entry->lastUse = ++g_caSslContext->sessionUseCount;
+    entry->used = true;
+}
+
+/**
+ * Checks whether a cached session may be offered with the cipher suites that
+ * SetupCipher() selected: a PSK or anonymous handshake must not pick up a
+ * session established with a certificate, and the session cipher suite must
+ * still be configured.
+ *
+ * @param[in]  ciphersuite    cipher suite of the cached session
+ *
+ * @return  true if the session may be offered
+ */
+static bool IsSessionAllowed(int ciphersuite)
+{
+    if (SSL_ECDHE_PSK_WITH_AES_128_CBC_SHA256 == g_caSslContext->cipher ||
+        SSL_ECDH_ANON_WITH_AES_128_CBC_SHA256 == g_caSslContext->cipher)
+    {
+        return false;
+    }
+    for (size_t i = 0; i < SSL_CIPHER_MAX && 0 != g_cipherSuitesList[i]; i++)
+    {
+        if (ciphersuite == g_cipherSuitesList[i])
+        {
+            return IsResumableCipherSuite(ciphersuite);
+        }
+    }
+    return false;
+}
+
+/**
+ * Offers the session cached for a peer, if any, in a new client handshake.
+ */
+static void LoadSslSession(SslEndPoint_t * tep)
+{
+    SslSession_t * entry = GetSslSession(&tep->sep.endpoint);
+    if (NULL == entry)
+    {
+        return;
+    }
+    if (!IsSessionAllowed(entry->session.ciphersuite))
+    {
+        OIC_LOG(DEBUG, NET_SSL_TAG, "Cached session not allowed with the selected ciphers");
+        return;
+    }
+    if (0 != mbedtls_ssl_set_session(&tep->ssl, &entry->session))
+    {
+        OIC_LOG(WARNING, NET_SSL_TAG, "Failed to load session");
+        return;
+    }
+    entry->lastUse = ++g_caSslContext->sessionUseCount;
+    OIC_LOG(DEBUG, NET_SSL_TAG, "Trying to resume session");
+}
+
 /**
  * Creates session for endpoint.
  *
@@ -1392,10 +1838,20 @@ static SslEndPoint_t * NewSslEndPoint(const CAEndpoint_t * endpoint, mbedtls_ssl
 
     tep->sep.endpoint = *endpoint;
     tep->sep.endpoint.flags = (CATransportFlags_t)(tep->sep.endpoint.flags | CA_SECURE);
+    tep->refCount = 1;
+
+    tep->mutex = oc_mutex_new_recursive();
+    if (NULL == tep->mutex)
+    {
+        OIC_LOG(ERROR, NET_SSL_TAG, "Mutex creation failed!");
+        OICFree(tep);
+        return NULL;
+    }
 
     if(0 != mbedtls_ssl_setup(&tep->ssl, config))
     {
         OIC_LOG(ERROR, NET_SSL_TAG, "Setup failed");
+        oc_mutex_free(tep->mutex);
         OICFree(tep);
         OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s", __func__);
         return NULL;
@@ -1413,6 +1869,7 @@ static SslEndPoint_t * NewSslEndPoint(const CAEndpoint_t * endpoint, mbedtls_ssl
             {
                 OIC_LOG(ERROR, NET_SSL_TAG, "Transport id setup failed!");
                 mbedtls_ssl_free(&tep->ssl);
+                oc_mutex_free(tep->mutex);
                 OICFree(tep);
                 OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s", __func__);
                 return NULL;
@@ -1424,6 +1881,7 @@ static SslEndPoint_t * NewSslEndPoint(const CAEndpoint_t * endpoint, mbedtls_ssl
     {
         OIC_LOG(ERROR, NET_SSL_TAG, "cacheList initialization failed!");
         mbedtls_ssl_free(&tep->ssl);
+        oc_mutex_free(tep->mutex);
         OICFree(tep);
         OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s", __func__);
         return NULL;
@@ -1599,12 +2057,14 @@ static SslEndPoint_t * InitiateTlsHandshake(const CAEndpoint_t *endpoint)
         return NULL;
     }
 
+    CheckSslSessionGeneration();
+    LoadSslSession(tep);
+
     oc_mutex_lock(g_sslContextMutex);
-    ret = u_arraylist_add(g_caSslContext->peerList, (void *) tep);
-    if (!ret)
+    if (!AddPeerToList(tep))
     {
         oc_mutex_unlock(g_sslContextMutex);
-        OIC_LOG(ERROR, NET_SSL_TAG, "u_arraylist_add failed!");
+        OIC_LOG(ERROR, NET_SSL_TAG, "AddPeerToList failed!");
         DeleteSslEndPoint(tep);
         return NULL;
     }
@@ -1628,12 +2088,13 @@ static SslEndPoint_t * InitiateTlsHandshake(const CAEndpoint_t *endpoint)
                                "Handshake error",
                                MBEDTLS_SSL_ALERT_MSG_HANDSHAKE_FAILURE))
         {
+            // checkSslOperation() removed and deleted the session.
             oc_mutex_unlock(g_sslContextMutex);
             OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s", __func__);
-            DeleteSslEndPoint(tep);
             return NULL;
         }
     }
+    tep->established = (MBEDTLS_SSL_HANDSHAKE_OVER == tep->ssl.state);
 
     oc_mutex_unlock(g_sslContextMutex);
     OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s", __func__);
@@ -1665,6 +2126,27 @@ void CAdeinitSslAdapter(void)
     // Clear all lists
     DeletePeerList();
 
+    // Wait for the encrypt and decrypt calls using established sessions
+    while (0 < g_caSslContext->peersInUse)
+    {
+        oc_cond_wait(g_caSslContext->peersInUseCond, g_sslContextMutex);
+    }
+
+    // Drop resumable sessions
+    for (size_t i = 0; i < SSL_SESSION_CACHE_SIZE; i++)
+    {
+        if (g_caSslContext->sessions[i].used)
+        {
+            DeleteSslSession(&g_caSslContext->sessions[i]);
+        }
+    }
+#ifdef MBEDTLS_SSL_CACHE_C
+    mbedtls_ssl_cache_free(&g_caSslContext->sessionCache);
+#endif
+#if defined(MBEDTLS_SSL_SESSION_TICKETS) && defined(MBEDTLS_SSL_TICKET_C)
+    mbedtls_ssl_ticket_free(&g_caSslContext->ticketCtx);
+#endif
+
     // De-initialize mbedTLS
     mbedtls_x509_crt_free(&g_caSslContext->crt);
     mbedtls_pk_free(&g_caSslContext->pkey);
@@ -1679,6 +2161,8 @@ void CAdeinitSslAdapter(void)
 #endif // __WITH_DTLS__
     mbedtls_ctr_drbg_free(&g_caSslContext->rnd);
     mbedtls_entropy_free(&g_caSslContext->entropy);
+    oc_mutex_free(g_caSslContext->rndMutex);
+    oc_cond_free(g_caSslContext->peersInUseCond);
 #ifdef __WITH_DTLS__
     StopRetransmit();
 #endif
@@ -1711,7 +2195,7 @@ static int InitConfig(mbedtls_ssl_config * conf, int transport, int mode)
      * time, see extlibs/mbedtls/config-iotivity.h
      */
     mbedtls_ssl_conf_psk_cb(conf, GetPskCredentialsCallback, NULL);
-    mbedtls_ssl_conf_rng(conf, mbedtls_ctr_drbg_random, &g_caSslContext->rnd);
+    mbedtls_ssl_conf_rng(conf, SslRandom, g_caSslContext);
     mbedtls_ssl_conf_curves(conf, curve[ADAPTER_CURVE_SECP256R1]);
     mbedtls_ssl_conf_authmode(conf, MBEDTLS_SSL_VERIFY_REQUIRED);
 
@@ -1724,6 +2208,18 @@ static int InitConfig(mbedtls_ssl_config * conf, int transport, int mode)
     }
 #endif // __WITH_DTLS__
 
+    if (MBEDTLS_SSL_IS_SERVER == mode)
+    {
+#ifdef MBEDTLS_SSL_CACHE_C
+        mbedtls_ssl_conf_session_cache(conf, &g_caSslContext->sessionCache,
+                                       mbedtls_ssl_cache_get, SslSessionCacheSet);
+#endif
+#if defined(MBEDTLS_SSL_SESSION_TICKETS) && defined(MBEDTLS_SSL_TICKET_C)
+        mbedtls_ssl_conf_session_tickets_cb(conf, SslTicketWrite, mbedtls_ssl_ticket_parse,
+                                            &g_caSslContext->ticketCtx);
+#endif
+    }
+
     /* Set TLS 1.2 as the minimum allowed version. */
     mbedtls_ssl_conf_min_version(conf, MBEDTLS_SSL_MAJOR_VERSION_3, MBEDTLS_SSL_MINOR_VERSION_3);
 
@@ -1764,7 +2260,7 @@ static void StartRetransmit(void *ctx)
         for (listIndex = 0; listIndex < listLength; listIndex++)
         {
             tep = (SslEndPoint_t *) u_arraylist_get(g_caSslContext->peerList, listIndex);
-            if (NULL == tep
+            if (NULL == tep || tep->established
                 || (tep->ssl.conf && MBEDTLS_SSL_TRANSPORT_STREAM == tep->ssl.conf->transport)
                 || MBEDTLS_SSL_HANDSHAKE_OVER == tep->ssl.state)
             {
@@ -1825,10 +2321,18 @@ CAResult_t CAinitSslAdapter(void)
 
     // Create peer list
     g_caSslContext->peerList = u_arraylist_create();
+    g_caSslContext->peerIndex = u_hashmap_create(SslPeerHash, SslPeerMatch);
+    g_caSslContext->peersInUseCond = oc_cond_new();
+    g_caSslContext->rndMutex = oc_mutex_new();
 
-    if(NULL == g_caSslContext->peerList)
+    if(NULL == g_caSslContext->peerList || NULL == g_caSslContext->peerIndex ||
+       NULL == g_caSslContext->peersInUseCond || NULL == g_caSslContext->rndMutex)
     {
         OIC_LOG(ERROR, NET_SSL_TAG, "peerList initialization failed!");
+        u_arraylist_free(&g_caSslContext->peerList);
+        u_hashmap_free(&g_caSslContext->peerIndex);
+        oc_cond_free(g_caSslContext->peersInUseCond);
+        oc_mutex_free(g_caSslContext->rndMutex);
         OICFree(g_caSslContext);
         g_caSslContext = NULL;
         oc_mutex_unlock(g_sslContextMutex);
@@ -1865,6 +2369,23 @@ CAResult_t CAinitSslAdapter(void)
     }
     mbedtls_ctr_drbg_set_prediction_resistance(&g_caSslContext->rnd, MBEDTLS_CTR_DRBG_PR_ON);
 
+    /* Session resumption
+     */
+#ifdef MBEDTLS_SSL_CACHE_C
+    mbedtls_ssl_cache_init(&g_caSslContext->sessionCache);
+    mbedtls_ssl_cache_set_timeout(&g_caSslContext->sessionCache, SSL_SESSION_LIFETIME_SEC);
+#endif
+#if defined(MBEDTLS_SSL_SESSION_TICKETS) && defined(MBEDTLS_SSL_TICKET_C)
+    mbedtls_ssl_ticket_init(&g_caSslContext->ticketCtx);
+    if (0 != mbedtls_ssl_ticket_setup(&g_caSslContext->ticketCtx, SslRandom,
+                                      g_caSslContext, MBEDTLS_CIPHER_AES_128_GCM,
+                                      SSL_SESSION_LIFETIME_SEC))
+    {
+        OIC_LOG(WARNING, NET_SSL_TAG, "Session ticket setup failed!");
+    }
+#endif
+    g_caSslContext->sessionGeneration = oc_atomic_add(&g_pkixGeneration, 0);
+
 #ifdef __WITH_TLS__
     if (0 != InitConfig(&g_caSslContext->clientTlsConf,
                         MBEDTLS_SSL_TRANSPORT_STREAM, MBEDTLS_SSL_IS_CLIENT))
@@ -1888,8 +2409,8 @@ CAResult_t CAinitSslAdapter(void)
 #endif // __WITH_TLS__
 #ifdef __WITH_DTLS__
     mbedtls_ssl_cookie_init(&g_caSslContext->cookieCtx);
-    if (0 != mbedtls_ssl_cookie_setup(&g_caSslContext->cookieCtx, mbedtls_ctr_drbg_random,
-                                      &g_caSslContext->rnd))
+    if (0 != mbedtls_ssl_cookie_setup(&g_caSslContext->cookieCtx, SslRandom,
+                                      g_caSslContext))
     {
         OIC_LOG(ERROR, NET_SSL_TAG, "Cookie setup failed!");
         oc_mutex_unlock(g_sslContextMutex);
@@ -2014,33 +2535,7 @@ CAResult_t CAencryptSsl(const CAEndpoint_t *endpoint,
         return CA_STATUS_FAILED;
     }
 
-    if (MBEDTLS_SSL_HANDSHAKE_OVER == tep->ssl.state)
-    {
-        unsigned char *dataBuf = (unsigned char *)data;
-        size_t written = 0;
-
-        do
-        {
-            ret = mbedtls_ssl_write(&tep->ssl, dataBuf, dataLen - written);
-            if (ret < 0)
-            {
-                if (MBEDTLS_ERR_SSL_WANT_WRITE != ret)
-                {
-                    OIC_LOG_V(ERROR, NET_SSL_TAG, "mbedTLS write failed! returned 0x%x", -ret);
-                    RemovePeerFromList(&tep->sep.endpoint);
-                    oc_mutex_unlock(g_sslContextMutex);
-                    return CA_STATUS_FAILED;
-                }
-                continue;
-            }
-            OIC_LOG_V(DEBUG, NET_SSL_TAG, "mbedTLS write returned with sent bytes[%d]", ret);
-
-            dataBuf += ret;
-            written += ret;
-        } while (dataLen > written);
-
-    }
-    else
+    if (!tep->established)
     {
         SslCacheMessage_t * msg = NewCacheMessage((uint8_t*) data, dataLen);
         if (NULL == msg || !u_arraylist_add(tep->cacheList, (void *) msg))
@@ -2049,12 +2544,50 @@ CAResult_t CAencryptSsl(const CAEndpoint_t *endpoint,
             oc_mutex_unlock(g_sslContextMutex);
             return CA_STATUS_FAILED;
         }
+        oc_mutex_unlock(g_sslContextMutex);
+
+        OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s", __func__);
+        return CA_STATUS_OK;
     }
 
+    AcquireSslPeer(tep);
+    oc_mutex_unlock(g_sslContextMutex);
+
+    CAResult_t result = CA_STATUS_OK;
+    unsigned char *dataBuf = (unsigned char *)data;
+    size_t written = 0;
+
+    oc_mutex_lock(tep->mutex);
+    do
+    {
+        ret = mbedtls_ssl_write(&tep->ssl, dataBuf, dataLen - written);
+        if (ret < 0)
+        {
+            if (MBEDTLS_ERR_SSL_WANT_WRITE != ret)
+            {
+                OIC_LOG_V(ERROR, NET_SSL_TAG, "mbedTLS write failed! returned 0x%x", -ret);
+                result = CA_STATUS_FAILED;
+                break;
+            }
+            continue;
+        }
+        OIC_LOG_V(DEBUG, NET_SSL_TAG, "mbedTLS write returned with sent bytes[%d]", ret);
+
+        dataBuf += ret;
+        written += ret;
+    } while (dataLen > written);
+    oc_mutex_unlock(tep->mutex);
+
+    oc_mutex_lock(g_sslContextMutex);
+    if (CA_STATUS_OK != result)
+    {
+        RemoveSslPeer(tep);
+    }
+    ReleaseSslPeer(tep);
     oc_mutex_unlock(g_sslContextMutex);
 
     OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s", __func__);
-    return CA_STATUS_OK;
+    return result;
 }
 /**
  * Sends cached messages via TLS connection.
@@ -2150,6 +2683,85 @@ void CAsetSslHandshakeCallback(CAHandshakeErrorCallback tlsHandshakeCallback)
     OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s(%p)", __func__, tlsHandshakeCallback);
 }
 
+CAResult_t CAgetSslSessionStats(uint32_t *fullHandshakes, uint32_t *resumedHandshakes)
+{
+    VERIFY_NON_NULL_RET(fullHandshakes, NET_SSL_TAG, "fullHandshakes is NULL", CA_STATUS_INVALID_PARAM);
+    VERIFY_NON_NULL_RET(resumedHandshakes, NET_SSL_TAG, "resumedHandshakes is NULL", CA_STATUS_INVALID_PARAM);
+
+    oc_mutex_lock(g_sslContextMutex);
+    if (NULL == g_caSslContext)
+    {
+        OIC_LOG(ERROR, NET_SSL_TAG, "Context is NULL");
+        oc_mutex_unlock(g_sslContextMutex);
+        return CA_STATUS_NOT_INITIALIZED;
+    }
+    *fullHandshakes = g_caSslContext->fullHandshakes;
+    *resumedHandshakes = g_caSslContext->resumedHandshakes;
+    oc_mutex_unlock(g_sslContextMutex);
+
+    return CA_STATUS_OK;
+}
+
+/**
+ * Reads a record received from an established session, with a reference taken
+ * by AcquireSslPeer().
+ *
+ * @param[in]  peer       remote peer
+ * @param[in]  peerSep    copy of the secure endpoint of peer
+ * @param[in]  data       received record
+ * @param[in]  dataLen    record length
+ * @param[out] closed     set to true if the peer closed the connection
+ *
+ * @return  CA_STATUS_OK on success; other error code if the session failed
+ */
+static CAResult_t ReadSslPeer(SslEndPoint_t * peer, const CASecureEndpoint_t * peerSep,
+                              uint8_t * data, size_t dataLen, bool * closed)
+{
+    CAResult_t result = CA_STATUS_OK;
+    uint8_t decryptBuffer[TLS_MSG_BUF_LEN] = {0};
+    int ret = 0;
+
+    oc_mutex_lock(peer->mutex);
+    peer->recBuf.buff = data;
+    peer->recBuf.len = dataLen;
+    peer->recBuf.loaded = 0;
+
+    do
+    {
+        ret = mbedtls_ssl_read(&peer->ssl, decryptBuffer, TLS_MSG_BUF_LEN);
+    } while (MBEDTLS_ERR_SSL_WANT_READ == ret);
+
+    int adapterIndex = GetAdapterIndex(peer->sep.endpoint.adapter);
+    if (MBEDTLS_ERR_SSL_PEER_CLOSE_NOTIFY == ret ||
+        // TinyDTLS sends fatal close_notify alert
+        (MBEDTLS_ERR_SSL_FATAL_ALERT_MESSAGE == ret &&
+         MBEDTLS_SSL_ALERT_LEVEL_FATAL == peer->ssl.in_msg[0] &&
+         MBEDTLS_SSL_ALERT_MSG_CLOSE_NOTIFY == peer->ssl.in_msg[1]))
+    {
+        OIC_LOG(INFO, NET_SSL_TAG, "Connection was closed gracefully");
+        *closed = true;
+    }
+    else if (adapterIndex < 0)
+    {
+        OIC_LOG(ERROR, NET_SSL_TAG, "Unsuported adapter");
+        result = CA_STATUS_FAILED;
+    }
+    else if (0 > ret)
+    {
+        OIC_LOG_V(ERROR, NET_SSL_TAG, "mbedtls_ssl_read returned -0x%x", -ret);
+        g_caSslContext->adapterCallbacks[adapterIndex].errorCallback(&peerSep->endpoint,
+                peer->recBuf.buff, peer->recBuf.len, CA_STATUS_FAILED);
+        result = CA_STATUS_FAILED;
+    }
+    else if (0 < ret)
+    {
+        g_caSslContext->adapterCallbacks[adapterIndex].recvCallback(peerSep, decryptBuffer, ret);
+    }
+    oc_mutex_unlock(peer->mutex);
+
+    return result;
+}
+
 /* Read data from TLS connection
  */
 CAResult_t CAdecryptSsl(const CASecureEndpoint_t *sep, uint8_t *data, size_t dataLen)
@@ -2168,6 +2780,26 @@ CAResult_t CAdecryptSsl(const CASecureEndpoint_t *sep, uint8_t *data, size_t dat
     }
 
     SslEndPoint_t * peer = GetSslPeer(&sep->endpoint);
+    if (NULL != peer && peer->established)
+    {
+        AcquireSslPeer(peer);
+        CASecureEndpoint_t peerSep = peer->sep;
+        oc_mutex_unlock(g_sslContextMutex);
+
+        bool closed = false;
+        CAResult_t result = ReadSslPeer(peer, &peerSep, data, dataLen, &closed);
+
+        oc_mutex_lock(g_sslContextMutex);
+        if (closed || CA_STATUS_OK != result)
+        {
+            RemoveSslPeer(peer);
+        }
+        ReleaseSslPeer(peer);
+        oc_mutex_unlock(g_sslContextMutex);
+
+        OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s", __func__);
+        return result;
+    }
     if (NULL == peer)
     {
         mbedtls_ssl_config * config = (sep->endpoint.adapter == CA_ADAPTER_IP ||
@@ -2188,11 +2820,11 @@ CAResult_t CAdecryptSsl(const CASecureEndpoint_t *sep, uint8_t *data, size_t dat
             oc_mutex_unlock(g_sslContextMutex);
             return CA_STATUS_FAILED;
         }
+        CheckSslSessionGeneration();
 
-        ret = u_arraylist_add(g_caSslContext->peerList, (void *) peer);
-        if (!ret)
+        if (!AddPeerToList(peer))
         {
-            OIC_LOG(ERROR, NET_SSL_TAG, "u_arraylist_add failed!");
+            OIC_LOG(ERROR, NET_SSL_TAG, "AddPeerToList failed!");
             DeleteSslEndPoint(peer);
             oc_mutex_unlock(g_sslContextMutex);
             return CA_STATUS_FAILED;
@@ -2299,9 +2931,43 @@ CAResult_t CAdecryptSsl(const CASecureEndpoint_t *sep, uint8_t *data, size_t dat
         {
             memcpy(peer->random, peer->ssl.handshake->randbytes, sizeof(peer->random));
         }
+        if (MBEDTLS_SSL_HANDSHAKE_WRAPUP == peer->ssl.state && NULL != peer->ssl.handshake
+            && peer->ssl.handshake->resume)
+        {
+            // An abbreviated handshake skips the key exchange and the peer certificate
+            // verification, the certificate comes from the resumed session.
+            peer->resumed = true;
+            memcpy(peer->random, peer->ssl.handshake->randbytes, sizeof(peer->random));
+            mbedtls_x509_crt *peerCert = peer->ssl.session_negotiate->peer_cert;
+            if (NULL != peerCert && CA_STATUS_OK != PeerCertExtractCN(peerCert))
+            {
+                oc_mutex_unlock(g_sslContextMutex);
+                OIC_LOG(ERROR, NET_SSL_TAG, "ProcessPeerCert failed for resumed session");
+                OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s", __func__);
+                return CA_STATUS_FAILED;
+            }
+        }
 
         if (MBEDTLS_SSL_HANDSHAKE_OVER == peer->ssl.state)
         {
+            peer->established = true;
+            if (peer->resumed)
+            {
+                g_caSslContext->resumedHandshakes++;
+            }
+            else
+            {
+                g_caSslContext->fullHandshakes++;
+            }
+            OIC_LOG_V(DEBUG, NET_SSL_TAG, "(D)TLS handshake %s, %" PRIu32 " of %" PRIu32 " resumed",
+                      peer->resumed ? "resumed" : "full", g_caSslContext->resumedHandshakes,
+                      g_caSslContext->resumedHandshakes + g_caSslContext->fullHandshakes);
+
+            if (MBEDTLS_SSL_IS_CLIENT == peer->ssl.conf->endpoint)
+            {
+                SaveSslSession(peer);
+            }
+
             CAResult_t result = notifySubscriber(peer, CA_STATUS_OK);
 
             if (MBEDTLS_SSL_IS_CLIENT == peer->ssl.conf->endpoint)
@@ -2440,51 +3106,6 @@ CAResult_t CAdecryptSsl(const CASecureEndpoint_t *sep, uint8_t *data, size_t dat
         }
     }
 
-    if (MBEDTLS_SSL_HANDSHAKE_OVER == peer->ssl.state)
-    {
-        uint8_t decryptBuffer[TLS_MSG_BUF_LEN] = {0};
-        do
-        {
-            ret = mbedtls_ssl_read(&peer->ssl, decryptBuffer, TLS_MSG_BUF_LEN);
-        } while (MBEDTLS_ERR_SSL_WANT_READ == ret);
-
-        if (MBEDTLS_ERR_SSL_PEER_CLOSE_NOTIFY == ret ||
-            // TinyDTLS sends fatal close_notify alert
-            (MBEDTLS_ERR_SSL_FATAL_ALERT_MESSAGE == ret &&
-             MBEDTLS_SSL_ALERT_LEVEL_FATAL == peer->ssl.in_msg[0] &&
-             MBEDTLS_SSL_ALERT_MSG_CLOSE_NOTIFY == peer->ssl.in_msg[1]))
-        {
-            OIC_LOG(INFO, NET_SSL_TAG, "Connection was closed gracefully");
-            RemovePeerFromList(&peer->sep.endpoint);
-            oc_mutex_unlock(g_sslContextMutex);
-            return CA_STATUS_OK;
-        }
-
-        int adapterIndex = GetAdapterIndex(peer->sep.endpoint.adapter);
-        if (adapterIndex >= 0)
-        {
-            if (0 > ret)
-            {
-                OIC_LOG_V(ERROR, NET_SSL_TAG, "mbedtls_ssl_read returned -0x%x", -ret);
-                g_caSslContext->adapterCallbacks[adapterIndex].errorCallback(&peer->sep.endpoint, peer->recBuf.buff, peer->recBuf.len, CA_STATUS_FAILED);
-                RemovePeerFromList(&peer->sep.endpoint);
-                oc_mutex_unlock(g_sslContextMutex);
-                return CA_STATUS_FAILED;
-            }
-            else if (0 < ret)
-            {
-                g_caSslContext->adapterCallbacks[adapterIndex].recvCallback(&peer->sep, decryptBuffer, ret);
-            }
-        }
-        else
-        {
-            OIC_LOG(ERROR, NET_SSL_TAG, "Unsuported adapter");
-            RemovePeerFromList(&peer->sep.endpoint);
-            oc_mutex_unlock(g_sslContextMutex);
-            return CA_STATUS_FAILED;
-        }
-    }
-
     oc_mutex_unlock(g_sslContextMutex);
     OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s", __func__);
     return CA_STATUS_OK;
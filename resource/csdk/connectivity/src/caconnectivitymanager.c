@@ -28,6 +28,7 @@
 #include "caremotehandler.h"
 #include "camessagehandler.h"
 #include "caprotocolmessage.h"
+#include "capdupool.h"
 #include "canetworkconfigurator.h"
 #include "cainterfacecontroller.h"
 #include "experimental/logger.h"
@@ -36,6 +37,10 @@
 #include "ca_adapter_net_ssl.h"
 #endif // __WITH_DTLS__ or __WITH_TLS__
 
+#ifdef IP_ADAPTER
+#include "caipadapter.h"
+#endif
+
 #ifdef TCP_ADAPTER
 #include "catcpadapter.h"
 #endif
@@ -52,6 +57,8 @@ static bool g_isInitialized = false;
 extern void CAsetPkixInfoCallback(CAgetPkixInfoHandler infCallback);
 extern void CAsetPskCredentialsCallback(CAgetPskCredentialsHandler credCallback);
 extern void CAsetCredentialTypesCallback(CAgetCredentialTypesHandler credCallback);
+extern void CAsetPkixInfoChanged(void);
+extern CAResult_t CAgetSslSessionStats(uint32_t *fullHandshakes, uint32_t *resumedHandshakes);
 #endif // __WITH_DTLS__ or __WITH_TLS__
 
 
@@ -61,6 +68,10 @@ CAResult_t CAInitialize(CATransportAdapter_t transportType)
 
     if (!g_isInitialized)
     {
+#if !defined(WITH_UPSTREAM_LIBCOAP) && defined(WITH_POSIX)
+        // PDUs are released by the pool as well, including those allocated before.
+        coap_pdu_set_allocator(CAPDUPoolAlloc, CAPDUPoolFree);
+#endif
         CAResult_t res = CAInitializeMessageHandler(transportType);
         if (res != CA_STATUS_OK)
         {
@@ -228,6 +239,20 @@ CAResult_t CAregisterPkixInfoHandler(CAgetPkixInfoHandler getPkixInfoHandler)
     return CA_STATUS_OK;
 }
 
+void CAnotifyPkixInfoChanged(void)
+{
+    CAsetPkixInfoChanged();
+}
+
+CAResult_t CAgetSecureSessionStats(uint32_t *fullHandshakes, uint32_t *resumedHandshakes)
+{
+    if (!g_isInitialized)
+    {
+        return CA_STATUS_NOT_INITIALIZED;
+    }
+    return CAgetSslSessionStats(fullHandshakes, resumedHandshakes);
+}
+
 CAResult_t CAregisterGetCredentialTypesHandler(CAgetCredentialTypesHandler getCredTypesHandler)
 {
     OIC_LOG_V(DEBUG, TAG, "In %s", __func__);
@@ -489,6 +514,36 @@ CAResult_t CAUnSelectNetwork(CATransportAdapter_t nonInterestedNetwork)
     return res;
 }
 
+CAResult_t CASetSendQueueThreads(CATransportAdapter_t adapter, uint32_t threadCount)
+{
+    if (g_isInitialized)
+    {
+        OIC_LOG(ERROR, TAG, "already initialized");
+        return CA_STATUS_FAILED;
+    }
+
+    CAResult_t res = CASetSendThreadCount(adapter, threadCount);
+    if (CA_STATUS_OK != res)
+    {
+        return res;
+    }
+
+    // The adapters encrypting and writing in their own send threads get as many.
+#ifdef IP_ADAPTER
+    if (CA_ADAPTER_IP == adapter)
+    {
+        res = CAIPSetSendThreadCount(threadCount);
+    }
+#endif
+#ifdef TCP_ADAPTER
+    if (CA_ADAPTER_TCP == adapter)
+    {
+        res = CATCPSetSendThreadCount(threadCount);
+    }
+#endif
+    return res;
+}
+
 CAResult_t CAHandleRequestResponse(void)
 {
     if (!g_isInitialized)
@@ -502,6 +557,48 @@ CAResult_t CAHandleRequestResponse(void)
     return CA_STATUS_OK;
 }
 
+CAResult_t CAHandleRequestResponseBatch(uint32_t maxMessages, uint32_t timeoutMs,
+                                        uint32_t *handledCount)
+{
+    if (!g_isInitialized)
+    {
+        OIC_LOG(ERROR, TAG, "not initialized");
+        return CA_STATUS_NOT_INITIALIZED;
+    }
+
+    uint32_t handled = CAHandleRequestResponseCallbacksBatch(maxMessages, timeoutMs);
+    if (handledCount)
+    {
+        *handledCount = handled;
+    }
+
+    return CA_STATUS_OK;
+}
+
+CAResult_t CAWaitForRequestResponse(uint32_t timeoutMs)
+{
+    if (!g_isInitialized)
+    {
+        OIC_LOG(ERROR, TAG, "not initialized");
+        return CA_STATUS_NOT_INITIALIZED;
+    }
+
+    return CAWaitForReceivedData(timeoutMs);
+}
+
+CAResult_t CAWakeUpRequestResponseWait(void)
+{
+    if (!g_isInitialized)
+    {
+        OIC_LOG(ERROR, TAG, "not initialized");
+        return CA_STATUS_NOT_INITIALIZED;
+    }
+
+    CAWakeUpReceivedDataWait();
+
+    return CA_STATUS_OK;
+}
+
 CAResult_t CASelectCipherSuite(const uint16_t cipher, CATransportAdapter_t adapter)
 {
     (void)(adapter); // prevent unused-parameter warning when building release variant
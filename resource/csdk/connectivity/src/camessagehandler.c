@@ -39,6 +39,7 @@
 #include "cainterfacecontroller.h"
 #include "caretransmission.h"
 #include "oic_string.h"
+#include "oic_time.h"
 #include "caping.h"
 
 #ifdef WITH_BWT
@@ -62,8 +63,48 @@
 // thread pool handle
 static ca_thread_pool_t g_threadPoolHandle = NULL;
 
+/**
+ * Send queue of an adapter. Messages to an endpoint are always queued to the same
+ * worker, so they are sent in order, while other endpoints are served in parallel.
+ */
+typedef struct
+{
+    /** Adapter of the queue, ::CA_DEFAULT_ADAPTER for the shared queue. **/
+    CATransportAdapter_t adapter;
+    /** Number of workers, set with CASetSendThreadCount(). **/
+    uint32_t workerCount;
+    /** Workers, each with its own queue and thread, not initialized when not started. **/
+    CAQueueingThreadGroup_t workers;
+} CASendQueue_t;
+
+// Send queues by adapter. The last one takes the messages of the adapters
+// without a queue, e.g. multicast over several adapters.
+static CASendQueue_t g_sendQueues[] =
+{
+#ifdef IP_ADAPTER
+    { CA_ADAPTER_IP, 1, { 0, NULL } },
+#endif
+#ifdef LE_ADAPTER
+    { CA_ADAPTER_GATT_BTLE, 1, { 0, NULL } },
+#endif
+#ifdef EDR_ADAPTER
+    { CA_ADAPTER_RFCOMM_BTEDR, 1, { 0, NULL } },
+#endif
+#ifdef RA_ADAPTER
+    { CA_ADAPTER_REMOTE_ACCESS, 1, { 0, NULL } },
+#endif
+#ifdef TCP_ADAPTER
+    { CA_ADAPTER_TCP, 1, { 0, NULL } },
+#endif
+#ifdef NFC_ADAPTER
+    { CA_ADAPTER_NFC, 1, { 0, NULL } },
+#endif
+    { CA_DEFAULT_ADAPTER, 1, { 0, NULL } }
+};
+
+#define CA_SEND_QUEUE_COUNT (sizeof(g_sendQueues) / sizeof(g_sendQueues[0]))
+
 // message handler main thread
-static CAQueueingThread_t g_sendThread;
 static CAQueueingThread_t g_receiveThread;
 
 
@@ -71,6 +112,12 @@ static CAQueueingThread_t g_receiveThread;
 
 static CARetransmission_t g_retransmissionContext;
 
+#ifdef SINGLE_HANDLE
+// set by CAWakeUpReceivedDataWait() to end CAWaitForReceivedData() early.
+// protected by the receive queue mutex.
+static bool g_receiveWaitWakeUp = false;
+#endif
+
 // handler field
 static CARequestCallback g_requestHandler = NULL;
 static CAResponseCallback g_responseHandler = NULL;
@@ -100,13 +147,43 @@ static bool CADropSecondMessage(CAHistory_t *history, const CAEndpoint_t *endpoi
  */
 static void CALogPDUInfo(const CAData_t *data, const coap_pdu_t *pdu);
 
+static CASendQueue_t *CAGetSendQueue(CATransportAdapter_t adapter)
+{
+    for (size_t i = 0; i < CA_SEND_QUEUE_COUNT - 1; i++)
+    {
+        if (adapter == g_sendQueues[i].adapter && g_sendQueues[i].workers.threads)
+        {
+            return &g_sendQueues[i];
+        }
+    }
+    return &g_sendQueues[CA_SEND_QUEUE_COUNT - 1];
+}
+
+/**
+ * Queue data to the send worker of its endpoint.
+ * @param[in] data    send data, owned by the queue.
+ */
+static void CAAddDataToSendQueue(CAData_t *data)
+{
+    const CAEndpoint_t *endpoint = data->remoteEndpoint;
+    CASendQueue_t *queue = CAGetSendQueue(endpoint->adapter);
+    if (NULL == queue->workers.threads)
+    {
+        OIC_LOG(ERROR, TAG, "send queue is not started");
+        CADestroyData(data, sizeof(CAData_t));
+        return;
+    }
+
+    CAQueueingThreadGroupAddData(&queue->workers, endpoint, data, sizeof(CAData_t));
+}
+
 #if defined(WITH_BWT) || defined(TCP_ADAPTER)
 void CAAddDataToSendThread(CAData_t *data)
 {
     VERIFY_NON_NULL_VOID(data, TAG, "data");
 
     // add thread
-    CAQueueingThreadAddData(&g_sendThread, data, sizeof(CAData_t));
+    CAAddDataToSendQueue(data);
 }
 
 void CAAddDataToReceiveThread(CAData_t *data)
@@ -903,27 +980,27 @@ exit:
     OIC_TRACE_END();
 }
 
-void CAHandleRequestResponseCallbacks(void)
-{
 #ifdef SINGLE_HANDLE
-    // parse the data and call the callbacks.
-    // #1 parse the data
-    // #2 get endpoint
-
-    oc_mutex_lock(g_receiveThread.threadMutex);
-
-    u_queue_message_t *item = u_queue_get_element(g_receiveThread.dataQueue);
-
-    oc_mutex_unlock(g_receiveThread.threadMutex);
-
-    if (NULL == item || NULL == item->msg)
+/**
+ * Wait until received data is queued, a wake up is requested or the timeout elapses.
+ * The receive queue thread is not running in this mode, so its condition is only
+ * signalled by CAQueueingThreadAddData and CAWakeUpReceivedDataWait.
+ * Must be called with the receive queue mutex held.
+ * @param[in] timeoutMs     time in milliseconds to wait, 0 to return immediately.
+ */
+static void CAWaitForReceivedDataLocked(uint32_t timeoutMs)
+{
+    if (0 < timeoutMs && !g_receiveWaitWakeUp
+        && 0 == u_queue_get_size(g_receiveThread.dataQueue))
     {
-        return;
+        oc_cond_wait_for(g_receiveThread.threadCond, g_receiveThread.threadMutex,
+                         (uint64_t) timeoutMs * US_PER_MS);
     }
+    g_receiveWaitWakeUp = false;
+}
 
-    // get endpoint
-    CAData_t *td = (CAData_t *) item->msg;
-
+static void CADispatchReceivedData(CAData_t *td)
+{
     if (td->requestInfo && g_requestHandler)
     {
         OIC_LOG_V(DEBUG, TAG, "request callback : %d", td->requestInfo->info.numOptions);
@@ -939,10 +1016,89 @@ void CAHandleRequestResponseCallbacks(void)
         OIC_LOG_V(DEBUG, TAG, "error callback error: %d", td->errorInfo->result);
         g_errorHandler(td->remoteEndpoint, td->errorInfo);
     }
+}
+#endif // SINGLE_HANDLE
+
+void CAHandleRequestResponseCallbacks(void)
+{
+    CAHandleRequestResponseCallbacksBatch(1, 0);
+}
+
+uint32_t CAHandleRequestResponseCallbacksBatch(uint32_t maxMessages, uint32_t timeoutMs)
+{
+#ifdef SINGLE_HANDLE
+    // parse the data and call the callbacks.
+    // #1 detach a batch of received data from the receive queue
+    // #2 call the callbacks without holding the queue lock
+
+    if (NULL == g_receiveThread.threadMutex)
+    {
+        return 0;
+    }
+
+    u_queue_t batch = { NULL, NULL, 0 };
+
+    oc_mutex_lock(g_receiveThread.threadMutex);
+
+    CAWaitForReceivedDataLocked(timeoutMs);
+
+    u_queue_move_elements(&batch, g_receiveThread.dataQueue, maxMessages);
+
+    oc_mutex_unlock(g_receiveThread.threadMutex);
+
+    uint32_t handled = 0;
+    u_queue_message_t *item = NULL;
+    while (NULL != (item = u_queue_get_element(&batch)))
+    {
+        if (NULL != item->msg)
+        {
+            CADispatchReceivedData((CAData_t *) item->msg);
+            CADestroyData(item->msg, sizeof(CAData_t));
+            handled++;
+        }
+        OICFree(item);
+    }
+
+    return handled;
+#else
+    OC_UNUSED(maxMessages);
+    OC_UNUSED(timeoutMs);
+    return 0;
+#endif // SINGLE_HANDLE
+}
+
+CAResult_t CAWaitForReceivedData(uint32_t timeoutMs)
+{
+#ifdef SINGLE_HANDLE
+    if (NULL == g_receiveThread.threadMutex)
+    {
+        return CA_STATUS_NOT_INITIALIZED;
+    }
 
-    CADestroyData(item->msg, sizeof(CAData_t));
-    OICFree(item);
+    oc_mutex_lock(g_receiveThread.threadMutex);
+    CAWaitForReceivedDataLocked(timeoutMs);
+    oc_mutex_unlock(g_receiveThread.threadMutex);
+
+    return CA_STATUS_OK;
+#else
+    // the receive thread calls the callbacks, there is nothing to wait for.
+    OC_UNUSED(timeoutMs);
+    return CA_NOT_SUPPORTED;
+#endif // SINGLE_HANDLE
+}
+
+void CAWakeUpReceivedDataWait(void)
+{
+#ifdef SINGLE_HANDLE
+    if (NULL == g_receiveThread.threadMutex)
+    {
+        return;
+    }
 
+    oc_mutex_lock(g_receiveThread.threadMutex);
+    g_receiveWaitWakeUp = true;
+    oc_cond_broadcast(g_receiveThread.threadCond);
+    oc_mutex_unlock(g_receiveThread.threadMutex);
 #endif // SINGLE_HANDLE
 }
 
@@ -1060,7 +1216,7 @@ CAResult_t CADetachSendMessage(const CAEndpoint_t *endpoint, const void *sendMsg
             OICFree(csmOpts);
 
             // #3. Add pdu to send queue.
-            CAQueueingThreadAddData(&g_sendThread, data, sizeof(CAData_t));
+            CAAddDataToSendQueue(data);
         }
     }
 #endif
@@ -1097,7 +1253,7 @@ CAResult_t CADetachSendMessage(const CAEndpoint_t *endpoint, const void *sendMsg
         if (CA_NOT_SUPPORTED == res)
         {
             OIC_LOG(DEBUG, TAG, "normal msg will be sent");
-            CAQueueingThreadAddData(&g_sendThread, data, sizeof(CAData_t));
+            CAAddDataToSendQueue(data);
             return CA_STATUS_OK;
         }
         else
@@ -1109,7 +1265,7 @@ CAResult_t CADetachSendMessage(const CAEndpoint_t *endpoint, const void *sendMsg
     else
 #endif // WITH_BWT
     {
-        CAQueueingThreadAddData(&g_sendThread, data, sizeof(CAData_t));
+        CAAddDataToSendQueue(data);
     }
 
     return CA_STATUS_OK;
@@ -1128,36 +1284,96 @@ void CASetNetworkMonitorCallback(CANetworkMonitorCallback nwMonitorHandler)
     g_nwMonitorHandler = nwMonitorHandler;
 }
 
-CAResult_t CAInitializeMessageHandler(CATransportAdapter_t transportType)
+CAResult_t CASetSendThreadCount(CATransportAdapter_t adapter, uint32_t threadCount)
 {
-    CASetPacketReceivedCallback(CAReceivedPacketCallback);
-    CASetErrorHandleCallback(CAErrorHandler);
+    if (0 == threadCount || CA_MAX_SEND_THREADS < threadCount)
+    {
+        OIC_LOG_V(ERROR, TAG, "invalid send thread count: %u", threadCount);
+        return CA_STATUS_INVALID_PARAM;
+    }
 
-    // create thread pool
-    CAResult_t res = ca_thread_pool_init(MAX_THREAD_POOL_SIZE, &g_threadPoolHandle);
-    if (CA_STATUS_OK != res)
+    for (size_t i = 0; i < CA_SEND_QUEUE_COUNT; i++)
     {
-        OIC_LOG(ERROR, TAG, "thread pool initialize error.");
-        return res;
+        if (adapter == g_sendQueues[i].adapter)
+        {
+            g_sendQueues[i].workerCount = threadCount;
+            return CA_STATUS_OK;
+        }
     }
 
-    // send thread initialize
-    res = CAQueueingThreadInitialize(&g_sendThread, g_threadPoolHandle,
-                                     CASendThreadProcess, CADestroyData);
+    OIC_LOG_V(ERROR, TAG, "no send queue for adapter %d", adapter);
+    return CA_NOT_SUPPORTED;
+}
+
+static CAResult_t CAStartSendQueue(CASendQueue_t *queue)
+{
+    CAResult_t res = CAQueueingThreadGroupInitialize(&queue->workers, queue->workerCount,
+                                                     g_threadPoolHandle, CASendThreadProcess,
+                                                     CADestroyData);
     if (CA_STATUS_OK != res)
     {
         OIC_LOG(ERROR, TAG, "Failed to Initialize send queue thread");
         return res;
     }
 
-    // start send thread
-    res = CAQueueingThreadStart(&g_sendThread);
+    res = CAQueueingThreadGroupStart(&queue->workers);
     if (CA_STATUS_OK != res)
     {
         OIC_LOG(ERROR, TAG, "thread start error(send thread).");
         return res;
     }
 
+    OIC_LOG_V(DEBUG, TAG, "send queue of adapter %d started with %u threads",
+              queue->adapter, queue->workerCount);
+    return CA_STATUS_OK;
+}
+
+static void CAStopSendQueues(void)
+{
+    for (size_t i = 0; i < CA_SEND_QUEUE_COUNT; i++)
+    {
+        CAQueueingThreadGroupStop(&g_sendQueues[i].workers);
+    }
+}
+
+static void CADestroySendQueues(void)
+{
+    for (size_t i = 0; i < CA_SEND_QUEUE_COUNT; i++)
+    {
+        CAQueueingThreadGroupDestroy(&g_sendQueues[i].workers);
+    }
+}
+
+CAResult_t CAInitializeMessageHandler(CATransportAdapter_t transportType)
+{
+    CASetPacketReceivedCallback(CAReceivedPacketCallback);
+    CASetErrorHandleCallback(CAErrorHandler);
+
+    // create thread pool
+    CAResult_t res = ca_thread_pool_init(MAX_THREAD_POOL_SIZE, &g_threadPoolHandle);
+    if (CA_STATUS_OK != res)
+    {
+        OIC_LOG(ERROR, TAG, "thread pool initialize error.");
+        return res;
+    }
+
+    // start the send queues of the initialized adapters and the shared one
+    for (size_t i = 0; i < CA_SEND_QUEUE_COUNT; i++)
+    {
+        CATransportAdapter_t adapter = g_sendQueues[i].adapter;
+        if (CA_DEFAULT_ADAPTER != adapter && CA_DEFAULT_ADAPTER != transportType
+            && !(adapter & transportType))
+        {
+            continue;
+        }
+
+        res = CAStartSendQueue(&g_sendQueues[i]);
+        if (CA_STATUS_OK != res)
+        {
+            return res;
+        }
+    }
+
     // receive thread initialize
     res = CAQueueingThreadInitialize(&g_receiveThread, g_threadPoolHandle,
                                      CAReceiveThreadProcess, CADestroyData);
@@ -1226,12 +1442,8 @@ void CATerminateMessageHandler(void)
         CARetransmissionStop(&g_retransmissionContext);
     }
 
-    // stop thread
-    // delete thread data
-    if (NULL != g_sendThread.threadMutex)
-    {
-        CAQueueingThreadStop(&g_sendThread);
-    }
+    // stop send threads
+    CAStopSendQueues();
 
     // stop thread
     // delete thread data
@@ -1253,7 +1465,7 @@ void CATerminateMessageHandler(void)
     CATerminateBlockWiseTransfer();
 #endif
     CARetransmissionDestroy(&g_retransmissionContext);
-    CAQueueingThreadDestroy(&g_sendThread);
+    CADestroySendQueues();
     CAQueueingThreadDestroy(&g_receiveThread);
 
     // terminate interface adapters by controller
@@ -0,0 +1,213 @@
+/* ****************************************************************
+ *
+ * Copyright 2017 Open Connectivity Foundation All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+#include "iotivity_config.h"
+#include <stdint.h>
+
+#include "capdupool.h"
+#include "cainterface.h"
+#include "cacommonutil.h"
+#include "oic_malloc.h"
+#include "experimental/logger.h"
+
+#define TAG "OIC_CA_PDU_POOL"
+
+#if CA_PDU_POOL_COUNT > 0
+
+#include "ocatomic.h"
+
+/*
+ * The free list head packs the index + 1 of the top buffer in its low bits and
+ * a version in its high bits, which changes on every update so that a stale
+ * head never compares equal (ABA).
+ */
+#define CA_PDU_POOL_INDEX_MASK 0xffff
+#define CA_PDU_POOL_VERSION_STEP 0x10000u
+
+#if CA_PDU_POOL_COUNT > CA_PDU_POOL_INDEX_MASK
+#error "CA_PDU_POOL_COUNT is too large"
+#endif
+
+typedef union
+{
+    void *p;
+    double d;
+    int64_t i;
+    uint8_t data[CA_PDU_POOL_BUFFER_SIZE];
+} CAPDUPoolBuffer_t;
+
+static CAPDUPoolBuffer_t g_buffers[CA_PDU_POOL_COUNT];
+
+/** Index + 1 of the buffer below each free buffer, 0 at the bottom. */
+static volatile int32_t g_next[CA_PDU_POOL_COUNT];
+
+/** Top of the free list. */
+static volatile int32_t g_head = 0;
+
+/** Number of buffers handed out at least once, unused ones are not in the free list. */
+static volatile int32_t g_used = 0;
+
+static volatile int32_t g_hits = 0;
+static volatile int32_t g_misses = 0;
+
+static int32_t CAPDUPoolNextHead(int32_t head, int32_t index)
+{
+    return (int32_t) ((((uint32_t) head & ~(uint32_t) CA_PDU_POOL_INDEX_MASK)
+                       + CA_PDU_POOL_VERSION_STEP) | (uint32_t) index);
+}
+
+static CAPDUPoolBuffer_t *CAPDUPoolPop(void)
+{
+    for (;;)
+    {
+        int32_t head = oc_atomic_add(&g_head, 0);
+        int32_t index = head & CA_PDU_POOL_INDEX_MASK;
+        if (0 == index)
+        {
+            break;
+        }
+        int32_t next = g_next[index - 1];
+        if (oc_atomic_cmpxchg(&g_head, head, CAPDUPoolNextHead(head, next)))
+        {
+            return &g_buffers[index - 1];
+        }
+    }
+
+    // Check first so that g_used only overshoots by the number of racing threads.
+    if (oc_atomic_add(&g_used, 0) < CA_PDU_POOL_COUNT)
+    {
+        int32_t used = oc_atomic_increment(&g_used);
+        if (used <= CA_PDU_POOL_COUNT)
+        {
+            return &g_buffers[used - 1];
+        }
+    }
+    return NULL;
+}
+
+static void CAPDUPoolPush(CAPDUPoolBuffer_t *buffer)
+{
+    int32_t index = (int32_t) (buffer - g_buffers) + 1;
+    for (;;)
+    {
+        int32_t head = oc_atomic_add(&g_head, 0);
+        g_next[index - 1] = head & CA_PDU_POOL_INDEX_MASK;
+        if (oc_atomic_cmpxchg(&g_head, head, CAPDUPoolNextHead(head, index)))
+        {
+            return;
+        }
+    }
+}
+
+void *CAPDUPoolAlloc(size_t size)
+{
+    if (size <= CA_PDU_POOL_BUFFER_SIZE)
+    {
+        CAPDUPoolBuffer_t *buffer = CAPDUPoolPop();
+        if (buffer)
+        {
+            oc_atomic_increment(&g_hits);
+            return buffer->data;
+        }
+    }
+    oc_atomic_increment(&g_misses);
+    return OICMalloc(size);
+}
+
+void CAPDUPoolFree(void *buffer)
+{
+    uintptr_t address = (uintptr_t) buffer;
+    if (address >= (uintptr_t) g_buffers &&
+        address < (uintptr_t) (g_buffers + CA_PDU_POOL_COUNT))
+    {
+        CAPDUPoolPush((CAPDUPoolBuffer_t *) buffer);
+    }
+    else
+    {
+        OICFree(buffer);
+    }
+}
+
+void CAPDUPoolGetStats(CAPDUPoolStats_t *stats)
+{
+    if (stats)
+    {
+        stats->hits = (uint32_t) oc_atomic_add(&g_hits, 0);
+        stats->misses = (uint32_t) oc_atomic_add(&g_misses, 0);
+    }
+}
+
+static void CAPDUPoolResetCounter(volatile int32_t *counter)
+{
+    int32_t value;
+    do
+    {
+        value = oc_atomic_add(counter, 0);
+    } while (!oc_atomic_cmpxchg(counter, value, 0));
+}
+
+void CAPDUPoolResetStats(void)
+{
+    CAPDUPoolResetCounter(&g_hits);
+    CAPDUPoolResetCounter(&g_misses);
+}
+
+#else // CA_PDU_POOL_COUNT > 0
+
+static uint32_t g_misses = 0;
+
+void *CAPDUPoolAlloc(size_t size)
+{
+    g_misses++;
+    return OICMalloc(size);
+}
+
+void CAPDUPoolFree(void *buffer)
+{
+    OICFree(buffer);
+}
+
+void CAPDUPoolGetStats(CAPDUPoolStats_t *stats)
+{
+    if (stats)
+    {
+        stats->hits = 0;
+        stats->misses = g_misses;
+    }
+}
+
+void CAPDUPoolResetStats(void)
+{
+    g_misses = 0;
+}
+
+#endif // CA_PDU_POOL_COUNT > 0
+
+CAResult_t CAGetPDUPoolStats(uint32_t *hits, uint32_t *misses)
+{
+    VERIFY_NON_NULL(hits, TAG, "hits");
+    VERIFY_NON_NULL(misses, TAG, "misses");
+
+    CAPDUPoolStats_t stats;
+    CAPDUPoolGetStats(&stats);
+    *hits = stats.hits;
+    *misses = stats.misses;
+    return CA_STATUS_OK;
+}
@@ -38,6 +38,7 @@
 #endif
 
 #include "caprotocolmessage.h"
+#include "capdupool.h"
 #include "experimental/logger.h"
 #include "oic_malloc.h"
 #include "oic_string.h"
@@ -826,11 +827,20 @@ CAResult_t CAGetInfoFromPDU(const coap_pdu_t *pdu, const CAEndpoint_t *endpoint,
     }
 
     coap_opt_t *option = NULL;
-    char *optionResult = (char *)OICCalloc(1, CA_MAX_URI_LENGTH * sizeof(char));
+    // Scratch buffers come from the PDU pool, they are released before returning.
+    char *buf = NULL;
+    char *optionResult = (char *)CAPDUPoolAlloc(CA_MAX_URI_LENGTH * sizeof(char));
     if (NULL == optionResult)
     {
         goto exit;
     }
+    optionResult[0] = '\0';
+
+    buf = (char *)CAPDUPoolAlloc(COAP_MAX_PDU_SIZE * sizeof(char));
+    if (NULL == buf)
+    {
+        goto exit;
+    }
 
     uint32_t idx = 0;
     uint32_t optionLength = 0;
@@ -840,12 +850,6 @@ CAResult_t CAGetInfoFromPDU(const coap_pdu_t *pdu, const CAEndpoint_t *endpoint,
 
     while ((option = coap_option_next(&opt_iter)))
     {
-        char *buf = (char *)OICCalloc(1, COAP_MAX_PDU_SIZE * sizeof(char));
-        if (NULL == buf)
-        {
-            goto exit;
-        }
-
         uint32_t bufLength =
             CAGetOptionData(opt_iter.type, (uint8_t *)(COAP_OPT_VALUE(option)),
                     COAP_OPT_LENGTH(option), (uint8_t *)buf, COAP_MAX_PDU_SIZE);
@@ -867,7 +871,6 @@ CAResult_t CAGetInfoFromPDU(const coap_pdu_t *pdu, const CAEndpoint_t *endpoint,
                     }
                     else
                     {
-                        OICFree(buf);
                         goto exit;
                     }
                 }
@@ -883,7 +886,6 @@ CAResult_t CAGetInfoFromPDU(const coap_pdu_t *pdu, const CAEndpoint_t *endpoint,
                         }
                         else
                         {
-                            OICFree(buf);
                             goto exit;
                         }
                     }
@@ -900,7 +902,6 @@ CAResult_t CAGetInfoFromPDU(const coap_pdu_t *pdu, const CAEndpoint_t *endpoint,
                             }
                             else
                             {
-                                OICFree(buf);
                                 goto exit;
                             }
                         }
@@ -914,7 +915,6 @@ CAResult_t CAGetInfoFromPDU(const coap_pdu_t *pdu, const CAEndpoint_t *endpoint,
                             }
                             else
                             {
-                                OICFree(buf);
                                 goto exit;
                             }
                         }
@@ -927,7 +927,6 @@ CAResult_t CAGetInfoFromPDU(const coap_pdu_t *pdu, const CAEndpoint_t *endpoint,
                     }
                     else
                     {
-                        OICFree(buf);
                         goto exit;
                     }
                 }
@@ -1035,8 +1034,9 @@ CAResult_t CAGetInfoFromPDU(const coap_pdu_t *pdu, const CAEndpoint_t *endpoint,
                 }
             }
         }
-        OICFree(buf);
     } // while
+    CAPDUPoolFree(buf);
+    buf = NULL;
 
     unsigned char* token = NULL;
     unsigned int token_length = 0;
@@ -1051,7 +1051,7 @@ CAResult_t CAGetInfoFromPDU(const coap_pdu_t *pdu, const CAEndpoint_t *endpoint,
         {
             OIC_LOG(ERROR, TAG, "Out of memory");
             OICFree(outInfo->options);
-            OICFree(optionResult);
+            CAPDUPoolFree(optionResult);
             return CA_MEMORY_ALLOC_FAILED;
         }
         memcpy(outInfo->token, token, token_length);
@@ -1072,7 +1072,7 @@ CAResult_t CAGetInfoFromPDU(const coap_pdu_t *pdu, const CAEndpoint_t *endpoint,
             OIC_LOG(ERROR, TAG, "Out of memory");
             OICFree(outInfo->options);
             OICFree(outInfo->token);
-            OICFree(optionResult);
+            CAPDUPoolFree(optionResult);
             return CA_MEMORY_ALLOC_FAILED;
         }
         memcpy(outInfo->payload, pdu->data, dataSize);
@@ -1089,7 +1089,7 @@ CAResult_t CAGetInfoFromPDU(const coap_pdu_t *pdu, const CAEndpoint_t *endpoint,
             OIC_LOG(ERROR, TAG, "Out of memory");
             OICFree(outInfo->options);
             OICFree(outInfo->token);
-            OICFree(optionResult);
+            CAPDUPoolFree(optionResult);
             return CA_MEMORY_ALLOC_FAILED;
         }
     }
@@ -1106,18 +1106,19 @@ CAResult_t CAGetInfoFromPDU(const coap_pdu_t *pdu, const CAEndpoint_t *endpoint,
             OIC_LOG(ERROR, TAG, "Out of memory");
             OICFree(outInfo->options);
             OICFree(outInfo->token);
-            OICFree(optionResult);
+            CAPDUPoolFree(optionResult);
             return CA_MEMORY_ALLOC_FAILED;
         }
     }
-    OICFree(optionResult);
+    CAPDUPoolFree(optionResult);
     OIC_LOG(INFO, TAG, "OUT - CAGetInfoFromPDU");
     return CA_STATUS_OK;
 
 exit:
     OIC_LOG(ERROR, TAG, "buffer too small");
     OICFree(outInfo->options);
-    OICFree(optionResult);
+    CAPDUPoolFree(buf);
+    CAPDUPoolFree(optionResult);
     return CA_STATUS_FAILED;
 }
 
@@ -30,11 +30,67 @@
 #endif
 
 #include "caqueueingthread.h"
+#include "uhashmap.h"
 #include "oic_malloc.h"
 #include "experimental/logger.h"
 
 #define TAG PCF("OIC_CA_QING")
 
+static void CAQueueingThreadDestroyMessage(CAQueueingThread_t *thread,
+                                           u_queue_message_t *message)
+{
+    if (NULL != thread->destroy)
+    {
+        thread->destroy(message->msg, message->size);
+    }
+    else
+    {
+        OICFree(message->msg);
+    }
+
+    OICFree(message);
+}
+
+/**
+ * Take up to batchSize data from the queue and pass them to the batch task at once.
+ * thread->threadMutex must be held, it is released before the task is invoked.
+ */
+static void CAQueueingThreadProcessBatch(CAQueueingThread_t *thread)
+{
+    u_queue_message_t *messages[CA_QUEUEING_THREAD_MAX_BATCH];
+    void *data[CA_QUEUEING_THREAD_MAX_BATCH];
+    uint32_t count = 0;
+
+    while (count < thread->batchSize)
+    {
+        u_queue_message_t *message = u_queue_get_element(thread->dataQueue);
+        if (NULL == message)
+        {
+            break;
+        }
+        messages[count] = message;
+        data[count] = message->msg;
+        count++;
+    }
+
+    // mutex unlock
+    oc_mutex_unlock(thread->threadMutex);
+
+    if (0 == count)
+    {
+        return;
+    }
+
+    // process data
+    thread->batchTask(data, count);
+
+    // free
+    for (uint32_t i = 0; i < count; i++)
+    {
+        CAQueueingThreadDestroyMessage(thread, messages[i]);
+    }
+}
+
 static void CAQueueingThreadBaseRoutine(void *threadValue)
 {
     OIC_LOG(DEBUG, TAG, "message handler main thread start..");
@@ -71,6 +127,12 @@ static void CAQueueingThreadBaseRoutine(void *threadValue)
             continue;
         }
 
+        if (NULL != thread->batchTask)
+        {
+            CAQueueingThreadProcessBatch(thread);
+            continue;
+        }
+
         // get data
         u_queue_message_t *message = u_queue_get_element(thread->dataQueue);
         // mutex unlock
@@ -84,16 +146,7 @@ static void CAQueueingThreadBaseRoutine(void *threadValue)
         thread->threadTask(message->msg);
 
         // free
-        if (NULL != thread->destroy)
-        {
-            thread->destroy(message->msg, message->size);
-        }
-        else
-        {
-            OICFree(message->msg);
-        }
-
-        OICFree(message);
+        CAQueueingThreadDestroyMessage(thread, message);
     }
 
     oc_mutex_lock(thread->threadMutex);
@@ -128,6 +181,8 @@ CAResult_t CAQueueingThreadInitialize(CAQueueingThread_t *thread, ca_thread_pool
     thread->isStop = true;
     thread->threadTask = task;
     thread->destroy = destroy;
+    thread->batchTask = NULL;
+    thread->batchSize = 0;
     if (NULL == thread->dataQueue || NULL == thread->threadMutex || NULL == thread->threadCond)
     {
         goto ERROR_MEM_FAILURE;
@@ -154,6 +209,31 @@ ERROR_MEM_FAILURE:
     return CA_MEMORY_ALLOC_FAILED;
 }
 
+CAResult_t CAQueueingThreadSetBatchTask(CAQueueingThread_t *thread, CAThreadBatchTask task,
+                                        uint32_t maxCount)
+{
+    if (NULL == thread)
+    {
+        OIC_LOG(ERROR, TAG, "thread instance is empty..");
+        return CA_STATUS_INVALID_PARAM;
+    }
+
+    if (NULL != task && (0 == maxCount || CA_QUEUEING_THREAD_MAX_BATCH < maxCount))
+    {
+        OIC_LOG_V(ERROR, TAG, "invalid batch size %u", maxCount);
+        return CA_STATUS_INVALID_PARAM;
+    }
+
+    // mutex lock
+    oc_mutex_lock(thread->threadMutex);
+    thread->batchTask = task;
+    thread->batchSize = task ? maxCount : 0;
+    // mutex unlock
+    oc_mutex_unlock(thread->threadMutex);
+
+    return CA_STATUS_OK;
+}
+
 CAResult_t CAQueueingThreadStart(CAQueueingThread_t *thread)
 {
     if (NULL == thread)
@@ -258,16 +338,7 @@ CAResult_t CAQueueingThreadDestroy(CAQueueingThread_t *thread)
         // free
         if (NULL != message)
         {
-            if (NULL != thread->destroy)
-            {
-                thread->destroy(message->msg, message->size);
-            }
-            else
-            {
-                OICFree(message->msg);
-            }
-
-            OICFree(message);
+            CAQueueingThreadDestroyMessage(thread, message);
         }
     }
 
@@ -313,3 +384,140 @@ CAResult_t CAQueueingThreadStop(CAQueueingThread_t *thread)
 
     return CA_STATUS_OK;
 }
+
+CAResult_t CAQueueingThreadGroupInitialize(CAQueueingThreadGroup_t *group, uint32_t count,
+                                           ca_thread_pool_t handle, CAThreadTask task,
+                                           CADataDestroyFunction destroy)
+{
+    if (NULL == group || 0 == count)
+    {
+        OIC_LOG(ERROR, TAG, "invalid thread group..");
+        return CA_STATUS_INVALID_PARAM;
+    }
+
+    group->threads = (CAQueueingThread_t *) OICCalloc(count, sizeof(CAQueueingThread_t));
+    if (NULL == group->threads)
+    {
+        OIC_LOG(ERROR, TAG, "memory error!!");
+        return CA_MEMORY_ALLOC_FAILED;
+    }
+    group->count = count;
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        CAResult_t res = CAQueueingThreadInitialize(&group->threads[i], handle, task, destroy);
+        if (CA_STATUS_OK != res)
+        {
+            CAQueueingThreadGroupDestroy(group);
+            return res;
+        }
+    }
+
+    return CA_STATUS_OK;
+}
+
+CAResult_t CAQueueingThreadGroupSetBatchTask(CAQueueingThreadGroup_t *group,
+                                             CAThreadBatchTask task, uint32_t maxCount)
+{
+    if (NULL == group || NULL == group->threads)
+    {
+        OIC_LOG(ERROR, TAG, "thread group is not initialized..");
+        return CA_STATUS_INVALID_PARAM;
+    }
+
+    for (uint32_t i = 0; i < group->count; i++)
+    {
+        CAResult_t res = CAQueueingThreadSetBatchTask(&group->threads[i], task, maxCount);
+        if (CA_STATUS_OK != res)
+        {
+            return res;
+        }
+    }
+
+    return CA_STATUS_OK;
+}
+
+CAResult_t CAQueueingThreadGroupStart(CAQueueingThreadGroup_t *group)
+{
+    if (NULL == group || NULL == group->threads)
+    {
+        OIC_LOG(ERROR, TAG, "thread group is not initialized..");
+        return CA_STATUS_INVALID_PARAM;
+    }
+
+    for (uint32_t i = 0; i < group->count; i++)
+    {
+        // The threads already started are stopped by CAQueueingThreadGroupStop().
+        CAResult_t res = CAQueueingThreadStart(&group->threads[i]);
+        if (CA_STATUS_OK != res)
+        {
+            return res;
+        }
+    }
+
+    return CA_STATUS_OK;
+}
+
+CAResult_t CAQueueingThreadGroupAddData(CAQueueingThreadGroup_t *group,
+                                        const CAEndpoint_t *endpoint,
+                                        void *data, uint32_t size)
+{
+    if (NULL == group || NULL == group->threads || NULL == endpoint)
+    {
+        OIC_LOG(ERROR, TAG, "thread group is not initialized..");
+        return CA_STATUS_INVALID_PARAM;
+    }
+
+    uint32_t index = 0;
+    if (group->count > 1)
+    {
+        uint32_t hash = u_hashmap_hash_bytes(endpoint->addr,
+                                             strnlen(endpoint->addr, sizeof(endpoint->addr)),
+                                             U_HASHMAP_HASH_SEED);
+        hash = u_hashmap_hash_bytes(&endpoint->port, sizeof(endpoint->port), hash);
+        index = hash % group->count;
+    }
+
+    return CAQueueingThreadAddData(&group->threads[index], data, size);
+}
+
+CAResult_t CAQueueingThreadGroupStop(CAQueueingThreadGroup_t *group)
+{
+    if (NULL == group)
+    {
+        OIC_LOG(ERROR, TAG, "thread group is empty..");
+        return CA_STATUS_INVALID_PARAM;
+    }
+
+    for (uint32_t i = 0; group->threads && i < group->count; i++)
+    {
+        if (NULL != group->threads[i].threadMutex)
+        {
+            CAQueueingThreadStop(&group->threads[i]);
+        }
+    }
+
+    return CA_STATUS_OK;
+}
+
+CAResult_t CAQueueingThreadGroupDestroy(CAQueueingThreadGroup_t *group)
+{
+    if (NULL == group)
+    {
+        OIC_LOG(ERROR, TAG, "thread group is empty..");
+        return CA_STATUS_INVALID_PARAM;
+    }
+
+    for (uint32_t i = 0; group->threads && i < group->count; i++)
+    {
+        if (NULL != group->threads[i].threadMutex)
+        {
+            CAQueueingThreadDestroy(&group->threads[i]);
+        }
+    }
+    OICFree(group->threads);
+    group->threads = NULL;
+    group->count = 0;
+
+    return CA_STATUS_OK;
+}
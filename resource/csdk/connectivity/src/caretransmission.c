@@ -73,19 +73,27 @@
 
 #define TAG "OIC_CA_RETRANS"
 
-typedef struct
+struct CARetransmissionData
 {
     uint64_t timeStamp;                 /**< last sent time. microseconds */
     uint64_t timeout;                   /**< timeout value. microseconds */
+    uint64_t fireTime;                  /**< next retransmission time. microseconds */
+    size_t heapIndex;                   /**< position in the retransmission heap */
     uint8_t triedCount;                 /**< retransmission count */
     uint16_t messageId;                 /**< coap PDU message id */
     CADataType_t dataType;              /**< data Type (Request/Response) */
     CAEndpoint_t *endpoint;             /**< remote endpoint */
     void *pdu;                          /**< coap PDU */
     uint32_t size;                      /**< coap PDU size */
-} CARetransmissionData_t;
+};
+
+/** key of the retransmission index. */
+typedef struct
+{
+    uint16_t messageId;                 /**< coap PDU message id */
+    CATransportAdapter_t adapter;       /**< transport adapter of the remote endpoint */
+} CARetransmissionKey_t;
 
-static const uint64_t USECS_PER_SEC = 1000000;
 static const uint64_t USECS_PER_MSEC = 1000;
 static const uint64_t MSECS_PER_SEC = 1000;
 
@@ -134,25 +142,142 @@ CAResult_t CARetransmissionStart(CARetransmission_t *context)
     return res;
 }
 
+
 /**
- * @brief   check timeout routine
- * @param[in] currentTime  microseconds
+ * @brief   next retransmission time of a message
  * @param[in] retData      retransmission data
- * @return  true if the timeout period has elapsed, false otherwise
+ * @return  microseconds
  */
-static bool CACheckTimeout(uint64_t currentTime, CARetransmissionData_t *retData)
+static uint64_t CAGetNextFireTime(const CARetransmissionData_t *retData)
 {
-    // #1. calculate timeout
     uint64_t milliTimeoutValue = retData->timeout / USECS_PER_MSEC;
-    uint64_t timeout = (milliTimeoutValue << retData->triedCount) * USECS_PER_MSEC;
+    return retData->timeStamp + (milliTimeoutValue << retData->triedCount) * USECS_PER_MSEC;
+}
+
+static uint32_t CARetransmissionKeyHash(const void *key)
+{
+    const CARetransmissionKey_t *retKey = (const CARetransmissionKey_t *) key;
+    uint32_t hash = u_hashmap_hash_bytes(&retKey->messageId, sizeof(retKey->messageId),
+                                         U_HASHMAP_HASH_SEED);
+    return u_hashmap_hash_bytes(&retKey->adapter, sizeof(retKey->adapter), hash);
+}
+
+static bool CARetransmissionKeyMatch(const void *key, const void *data)
+{
+    const CARetransmissionKey_t *retKey = (const CARetransmissionKey_t *) key;
+    const CARetransmissionData_t *retData = (const CARetransmissionData_t *) data;
+    return retData->messageId == retKey->messageId
+           && retData->endpoint->adapter == retKey->adapter;
+}
+
+static void CAHeapSet(CARetransmission_t *context, size_t index, CARetransmissionData_t *retData)
+{
+    context->dataHeap[index] = retData;
+    retData->heapIndex = index;
+}
 
-    if (currentTime >= retData->timeStamp + timeout)
+static void CAHeapSiftUp(CARetransmission_t *context, size_t index)
+{
+    CARetransmissionData_t *retData = context->dataHeap[index];
+    while (index > 0)
     {
-        OIC_LOG_V(DEBUG, TAG, "%" PRIu64 " microseconds time out!!, tried count(%d)",
-                  timeout, retData->triedCount);
-        return true;
+        size_t parent = (index - 1) / 2;
+        if (context->dataHeap[parent]->fireTime <= retData->fireTime)
+        {
+            break;
+        }
+        CAHeapSet(context, index, context->dataHeap[parent]);
+        index = parent;
     }
-    return false;
+    CAHeapSet(context, index, retData);
+}
+
+static void CAHeapSiftDown(CARetransmission_t *context, size_t index)
+{
+    CARetransmissionData_t *retData = context->dataHeap[index];
+    for (;;)
+    {
+        size_t child = index * 2 + 1;
+        if (child >= context->dataCount)
+        {
+            break;
+        }
+        if (child + 1 < context->dataCount
+            && context->dataHeap[child + 1]->fireTime < context->dataHeap[child]->fireTime)
+        {
+            child++;
+        }
+        if (retData->fireTime <= context->dataHeap[child]->fireTime)
+        {
+            break;
+        }
+        CAHeapSet(context, index, context->dataHeap[child]);
+        index = child;
+    }
+    CAHeapSet(context, index, retData);
+}
+
+/**
+ * @brief   add retransmission data to the heap and the index. threadMutex must be held.
+ * @param[in] context      context for retransmission
+ * @param[in] retData      retransmission data
+ * @return  ::CA_STATUS_OK or ::CA_MEMORY_ALLOC_FAILED
+ */
+static CAResult_t CAAddRetransmissionData(CARetransmission_t *context,
+                                          CARetransmissionData_t *retData)
+{
+    if (context->dataCount == context->dataCapacity)
+    {
+        size_t capacity = context->dataCapacity ? context->dataCapacity * 2 : 8;
+        CARetransmissionData_t **heap = (CARetransmissionData_t **) OICRealloc(
+                context->dataHeap, capacity * sizeof(CARetransmissionData_t *));
+        if (NULL == heap)
+        {
+            return CA_MEMORY_ALLOC_FAILED;
+        }
+        context->dataHeap = heap;
+        context->dataCapacity = capacity;
+    }
+
+    CARetransmissionKey_t key = { .messageId = retData->messageId,
+                                  .adapter = retData->endpoint->adapter };
+    if (!u_hashmap_put(context->dataIndex, &key, retData))
+    {
+        return CA_MEMORY_ALLOC_FAILED;
+    }
+
+    context->dataHeap[context->dataCount] = retData;
+    CAHeapSiftUp(context, context->dataCount++);
+    return CA_STATUS_OK;
+}
+
+/**
+ * @brief   remove retransmission data from the heap and the index. threadMutex must be held.
+ * @param[in] context      context for retransmission
+ * @param[in] retData      retransmission data
+ */
+static void CARemoveRetransmissionData(CARetransmission_t *context,
+                                       CARetransmissionData_t *retData)
+{
+    CARetransmissionKey_t key = { .messageId = retData->messageId,
+                                  .adapter = retData->endpoint->adapter };
+    u_hashmap_remove_data(context->dataIndex, &key, retData);
+
+    size_t index = retData->heapIndex;
+    CARetransmissionData_t *last = context->dataHeap[--context->dataCount];
+    if (last != retData)
+    {
+        CAHeapSet(context, index, last);
+        CAHeapSiftDown(context, index);
+        CAHeapSiftUp(context, last->heapIndex);
+    }
+}
+
+static void CADestroyRetransmissionData(CARetransmissionData_t *retData)
+{
+    CAFreeEndpoint(retData->endpoint);
+    OICFree(retData->pdu);
+    OICFree(retData);
 }
 
 static void CACheckRetransmissionList(CARetransmission_t *context)
@@ -166,65 +291,50 @@ static void CACheckRetransmissionList(CARetransmission_t *context)
     // mutex lock
     oc_mutex_lock(context->threadMutex);
 
-    size_t len = u_arraylist_length(context->dataList);
+    uint64_t currentTime = OICGetCurrentTime(TIME_IN_US);
 
-    for (size_t i = 0; i < len; i++)
+    // only the messages at the top of the heap can be due.
+    while (0 < context->dataCount && context->dataHeap[0]->fireTime <= currentTime)
     {
-        CARetransmissionData_t *retData = u_arraylist_get(context->dataList, i);
+        CARetransmissionData_t *retData = context->dataHeap[0];
 
-        if (NULL == retData)
-        {
-            continue;
-        }
-
-        uint64_t currentTime = OICGetCurrentTime(TIME_IN_US);
+        OIC_LOG_V(DEBUG, TAG, "%" PRIu64 " microseconds time out!!, tried count(%d)",
+                  retData->fireTime - retData->timeStamp, retData->triedCount);
 
-        if (CACheckTimeout(currentTime, retData))
+        // #1. time's up, send the data.
+        if (NULL != context->dataSendMethod)
         {
-            // #2. if time's up, send the data.
-            if (NULL != context->dataSendMethod)
-            {
-                OIC_LOG_V(DEBUG, TAG, "retransmission CON data!!, msgid=%d",
-                          retData->messageId);
-                context->dataSendMethod(retData->endpoint, retData->pdu,
-                                        retData->size, retData->dataType);
-            }
-
-            // #3. increase the retransmission count and update timestamp.
-            retData->timeStamp = currentTime;
-            retData->triedCount++;
+            OIC_LOG_V(DEBUG, TAG, "retransmission CON data!!, msgid=%d",
+                      retData->messageId);
+            context->dataSendMethod(retData->endpoint, retData->pdu,
+                                    retData->size, retData->dataType);
         }
 
-        // #4. if tried count is max, remove the retransmission data from list.
+        // #2. increase the retransmission count and update timestamp.
+        retData->timeStamp = currentTime;
+        retData->triedCount++;
+
+        // #3. if tried count is max, remove the retransmission data.
         if (retData->triedCount >= context->config.tryingCount)
         {
-            CARetransmissionData_t *removedData = u_arraylist_remove(context->dataList, i);
-            if (NULL == removedData)
-            {
-                OIC_LOG(ERROR, TAG, "Removed data is NULL");
-                // mutex unlock
-                oc_mutex_unlock(context->threadMutex);
-                return;
-            }
+            CARemoveRetransmissionData(context, retData);
             OIC_LOG_V(DEBUG, TAG, "max trying count, remove RTCON data,"
-                      "msgid=%d", removedData->messageId);
+                      "msgid=%d", retData->messageId);
 
             // callback for retransmit timeout
             if (NULL != context->timeoutCallback)
             {
-                context->timeoutCallback(removedData->endpoint, removedData->pdu,
-                                         removedData->size);
+                context->timeoutCallback(retData->endpoint, retData->pdu,
+                                         retData->size);
             }
 
-            CAFreeEndpoint(removedData->endpoint);
-            OICFree(removedData->pdu);
-
-            OICFree(removedData);
-
-            // modify loop value.
-            len = u_arraylist_length(context->dataList);
-            --i;
+            CADestroyRetransmissionData(retData);
+            continue;
         }
+
+        // #4. otherwise reschedule it with the doubled timeout.
+        retData->fireTime = CAGetNextFireTime(retData);
+        CAHeapSiftDown(context, 0);
     }
 
     // mutex unlock
@@ -250,7 +360,7 @@ void CARetransmissionBaseRoutine(void *threadValue)
         // mutex lock
         oc_mutex_lock(context->threadMutex);
 
-        if (!context->isStop && u_arraylist_length(context->dataList) <= 0)
+        if (!context->isStop && 0 == context->dataCount)
         {
             // if list is empty, thread will wait
             OIC_LOG(DEBUG, TAG, "wait..there is no retransmission data.");
@@ -262,13 +372,18 @@ void CARetransmissionBaseRoutine(void *threadValue)
         }
         else if (!context->isStop)
         {
-            // check each RETRANSMISSION_CHECK_PERIOD_SEC time.
-            OIC_LOG_V(DEBUG, TAG, "wait..(%" PRIu64 ")microseconds",
-                      RETRANSMISSION_CHECK_PERIOD_SEC * (uint64_t) USECS_PER_SEC);
+            // sleep until the earliest retransmission is due, or a new message is added.
+            uint64_t currentTime = OICGetCurrentTime(TIME_IN_US);
+            uint64_t fireTime = context->dataHeap[0]->fireTime;
+            if (fireTime > currentTime)
+            {
+                OIC_LOG_V(DEBUG, TAG, "wait..(%" PRIu64 ")microseconds",
+                          fireTime - currentTime);
 
-            // wait
-            uint64_t absTime = RETRANSMISSION_CHECK_PERIOD_SEC * (uint64_t) USECS_PER_SEC;
-            oc_cond_wait_for(context->threadCond, context->threadMutex, absTime );
+                // wait
+                oc_cond_wait_for(context->threadCond, context->threadMutex,
+                                 fireTime - currentTime);
+            }
         }
         else
         {
@@ -323,6 +438,13 @@ CAResult_t CARetransmissionInitialize(CARetransmission_t *context,
         cfg = *config;
     }
 
+    context->dataIndex = u_hashmap_create(CARetransmissionKeyHash, CARetransmissionKeyMatch);
+    if (NULL == context->dataIndex)
+    {
+        OIC_LOG(ERROR, TAG, "memory error");
+        return CA_MEMORY_ALLOC_FAILED;
+    }
+
     // set send thread data
     context->threadPool = handle;
     context->threadMutex = oc_mutex_new();
@@ -331,7 +453,6 @@ CAResult_t CARetransmissionInitialize(CARetransmission_t *context,
     context->timeoutCallback = timeoutCallback;
     context->config = cfg;
     context->isStop = false;
-    context->dataList = u_arraylist_create();
 
     return CA_STATUS_OK;
 }
@@ -405,41 +526,41 @@ CAResult_t CARetransmissionSentData(CARetransmission_t *context,
     retData->pdu = pduData;
     retData->size = size;
     retData->dataType = dataType;
+    retData->fireTime = CAGetNextFireTime(retData);
     // mutex lock
     oc_mutex_lock(context->threadMutex);
 
-    size_t len = u_arraylist_length(context->dataList);
-
-    // #3. add data into list
-    for (size_t i = 0; i < len; i++)
+    // #3. check duplicate message id
+    CARetransmissionKey_t key = { .messageId = messageId, .adapter = endpoint->adapter };
+    if (NULL != u_hashmap_get(context->dataIndex, &key))
     {
-        CARetransmissionData_t *currData = u_arraylist_get(context->dataList, i);
+        OIC_LOG(ERROR, TAG, "Duplicate message ID");
 
-        if (NULL == currData)
-        {
-            continue;
-        }
+        // mutex unlock
+        oc_mutex_unlock(context->threadMutex);
 
-        // found index
-        if (NULL != currData->endpoint && currData->messageId == messageId
-            && (currData->endpoint->adapter == endpoint->adapter))
-        {
-            OIC_LOG(ERROR, TAG, "Duplicate message ID");
+        CADestroyRetransmissionData(retData);
+        return CA_STATUS_FAILED;
+    }
 
-            // mutex unlock
-            oc_mutex_unlock(context->threadMutex);
+    // #4. add data into heap and index
+    CAResult_t res = CAAddRetransmissionData(context, retData);
+    if (CA_STATUS_OK != res)
+    {
+        OIC_LOG(ERROR, TAG, "memory error");
 
-            OICFree(retData);
-            OICFree(pduData);
-            OICFree(remoteEndpoint);
-            return CA_STATUS_FAILED;
-        }
-    }
+        // mutex unlock
+        oc_mutex_unlock(context->threadMutex);
 
-    u_arraylist_add(context->dataList, (void *) retData);
+        CADestroyRetransmissionData(retData);
+        return res;
+    }
 
-    // notify the thread
-    oc_cond_signal(context->threadCond);
+    // notify the thread only if the earliest deadline changed
+    if (context->dataHeap[0] == retData)
+    {
+        oc_cond_signal(context->threadCond);
+    }
 
     // mutex unlock
     oc_mutex_unlock(context->threadMutex);
@@ -482,73 +603,49 @@ CAResult_t CARetransmissionReceivedData(CARetransmission_t *context,
 
     // mutex lock
     oc_mutex_lock(context->threadMutex);
-    size_t len = u_arraylist_length(context->dataList);
 
-    for (size_t i = 0; i < len; i++)
-    {
-        CARetransmissionData_t *retData = (CARetransmissionData_t *) u_arraylist_get(
-                context->dataList, i);
+    CARetransmissionKey_t key = { .messageId = messageId, .adapter = endpoint->adapter };
+    CARetransmissionData_t *retData =
+        (CARetransmissionData_t *) u_hashmap_get(context->dataIndex, &key);
 
-        if (NULL == retData)
+    if (NULL != retData)
+    {
+        // get pdu data for getting token when CA_EMPTY(RST/ACK) is received from remote device
+        // if retransmission was finish..token will be unavailable.
+        if (CA_EMPTY == code)
         {
-            continue;
-        }
+            OIC_LOG(DEBUG, TAG, "code is CA_EMPTY");
 
-        // found index
-        if (NULL != retData->endpoint && retData->messageId == messageId
-            && (retData->endpoint->adapter == endpoint->adapter))
-        {
-            // get pdu data for getting token when CA_EMPTY(RST/ACK) is received from remote device
-            // if retransmission was finish..token will be unavailable.
-            if (CA_EMPTY == CAGetCodeFromPduBinaryData(pdu, size))
+            if (NULL == retData->pdu)
             {
-                OIC_LOG(DEBUG, TAG, "code is CA_EMPTY");
-
-                if (NULL == retData->pdu)
-                {
-                    OIC_LOG(ERROR, TAG, "retData->pdu is null");
-                    OICFree(retData);
-                    // mutex unlock
-                    oc_mutex_unlock(context->threadMutex);
-
-                    return CA_STATUS_FAILED;
-                }
-
-                // copy PDU data
-                (*retransmissionPdu) = (void *) OICCalloc(1, retData->size);
-                if ((*retransmissionPdu) == NULL)
-                {
-                    OICFree(retData);
-                    OIC_LOG(ERROR, TAG, "memory error");
-
-                    // mutex unlock
-                    oc_mutex_unlock(context->threadMutex);
-
-                    return CA_MEMORY_ALLOC_FAILED;
-                }
-                memcpy((*retransmissionPdu), retData->pdu, retData->size);
+                OIC_LOG(ERROR, TAG, "retData->pdu is null");
+
+                // mutex unlock
+                oc_mutex_unlock(context->threadMutex);
+
+                return CA_STATUS_FAILED;
             }
 
-            // #2. remove data from list
-            CARetransmissionData_t *removedData = u_arraylist_remove(context->dataList, i);
-            if (NULL == removedData)
+            // copy PDU data
+            (*retransmissionPdu) = (void *) OICCalloc(1, retData->size);
+            if ((*retransmissionPdu) == NULL)
             {
-                OIC_LOG(ERROR, TAG, "Removed data is NULL");
+                OIC_LOG(ERROR, TAG, "memory error");
 
                 // mutex unlock
                 oc_mutex_unlock(context->threadMutex);
 
-                return CA_STATUS_FAILED;
+                return CA_MEMORY_ALLOC_FAILED;
             }
+            memcpy((*retransmissionPdu), retData->pdu, retData->size);
+        }
 
-            OIC_LOG_V(DEBUG, TAG, "remove RTCON data!!, msgid=%d", messageId);
+        // #2. remove data from heap and index
+        CARemoveRetransmissionData(context, retData);
 
-            CAFreeEndpoint(removedData->endpoint);
-            OICFree(removedData->pdu);
-            OICFree(removedData);
+        OIC_LOG_V(DEBUG, TAG, "remove RTCON data!!, msgid=%d", messageId);
 
-            break;
-        }
+        CADestroyRetransmissionData(retData);
     }
 
     // mutex unlock
@@ -596,24 +693,20 @@ CAResult_t CARetransmissionDestroy(CARetransmission_t *context)
     OIC_LOG(DEBUG, TAG, "retransmission context destroy..");
 
     oc_mutex_lock(context->threadMutex);
-    size_t len = u_arraylist_length(context->dataList);
-    for (size_t i = 0; i < len; i++)
+    for (size_t i = 0; i < context->dataCount; i++)
     {
-        CARetransmissionData_t *data = u_arraylist_get(context->dataList, i);
-        if (NULL == data)
-        {
-            continue;
-        }
-        CAFreeEndpoint(data->endpoint);
-        OICFree(data->pdu);
-        OICFree(data);
+        CADestroyRetransmissionData(context->dataHeap[i]);
     }
+    OICFree(context->dataHeap);
+    context->dataHeap = NULL;
+    context->dataCount = 0;
+    context->dataCapacity = 0;
+    u_hashmap_free(&context->dataIndex);
     oc_mutex_unlock(context->threadMutex);
 
     oc_mutex_free(context->threadMutex);
     context->threadMutex = NULL;
     oc_cond_free(context->threadCond);
-    u_arraylist_free(&context->dataList);
 
     return CA_STATUS_OK;
 }
@@ -56,9 +56,15 @@ typedef struct
 } CAIPData_t;
 
 /**
- * Queue handle for Send Data.
+ * Queue for Send Data. Each thread sends to its own endpoints, so the DTLS
+ * encryption and the socket writes for different peers run in parallel.
  */
-static CAQueueingThread_t *g_sendQueueHandle = NULL;
+static CAQueueingThreadGroup_t g_sendQueue = { 0, NULL };
+
+/**
+ * Number of threads of the send queue, set with CAIPSetSendThreadCount().
+ */
+static uint32_t g_sendThreadCount = 1;
 
 /**
  * List of the endpoint that has a stack-owned IP address.
@@ -96,6 +102,8 @@ static void CAIPDeinitializeQueueHandles(void);
 
 static void CAIPSendDataThread(void *threadData);
 
+static void CAIPSendDataBatchThread(void **threadData, uint32_t count);
+
 static CAIPData_t *CACreateIPData(const CAEndpoint_t *remoteEndpoint,
                                   const void *data, uint32_t dataLength,
                                   bool isMulticast);
@@ -107,7 +115,7 @@ static void CADataDestroyer(void *data, uint32_t size);
 CAResult_t CAIPInitializeQueueHandles(void)
 {
     // Check if the message queue is already initialized
-    if (g_sendQueueHandle)
+    if (g_sendQueue.threads)
     {
         OIC_LOG(DEBUG, TAG, "send queue handle is already initialized!");
         return CA_STATUS_OK;
@@ -121,35 +129,30 @@ CAResult_t CAIPInitializeQueueHandles(void)
     }
 
     // Create send message queue
-    g_sendQueueHandle = OICMalloc(sizeof(CAQueueingThread_t));
-    if (!g_sendQueueHandle)
-    {
-        OIC_LOG(ERROR, TAG, "Memory allocation failed! (g_sendQueueHandle)");
-        u_arraylist_free(&g_ownIpEndpointList);
-        g_ownIpEndpointList = NULL;
-        return CA_MEMORY_ALLOC_FAILED;
-    }
-
-    if (CA_STATUS_OK != CAQueueingThreadInitialize(g_sendQueueHandle,
+    if (CA_STATUS_OK != CAQueueingThreadGroupInitialize(&g_sendQueue, g_sendThreadCount,
                                 (const ca_thread_pool_t)caglobals.ip.threadpool,
                                 CAIPSendDataThread, CADataDestroyer))
     {
         OIC_LOG(ERROR, TAG, "Failed to Initialize send queue thread");
-        OICFree(g_sendQueueHandle);
-        g_sendQueueHandle = NULL;
         u_arraylist_free(&g_ownIpEndpointList);
         g_ownIpEndpointList = NULL;
         return CA_STATUS_FAILED;
     }
 
+    // Drain queued datagrams together so that CAIPSendDataBatch() can hand them
+    // to the socket layer with as few calls as possible.
+    if (CA_STATUS_OK != CAQueueingThreadGroupSetBatchTask(&g_sendQueue, CAIPSendDataBatchThread,
+                                                          CA_QUEUEING_THREAD_MAX_BATCH))
+    {
+        OIC_LOG(DEBUG, TAG, "Batch send not enabled, sending one datagram at a time");
+    }
+
     return CA_STATUS_OK;
 }
 
 void CAIPDeinitializeQueueHandles(void)
 {
-    CAQueueingThreadDestroy(g_sendQueueHandle);
-    OICFree(g_sendQueueHandle);
-    g_sendQueueHandle = NULL;
+    CAQueueingThreadGroupDestroy(&g_sendQueue);
 
     // Since the items in g_ownIpEndpointList are allocated once in a big chunk, we only need to
     // free the first item. Another location this is done is in the CA_INTERFACE_DOWN handler
@@ -380,6 +383,23 @@ CAResult_t CAInitializeIP(CARegisterConnectivityCallback registerCallback,
     return CA_STATUS_OK;
 }
 
+CAResult_t CAIPSetSendThreadCount(uint32_t threadCount)
+{
+    if (0 == threadCount)
+    {
+        OIC_LOG(ERROR, TAG, "Invalid send thread count");
+        return CA_STATUS_INVALID_PARAM;
+    }
+    if (g_sendQueue.threads)
+    {
+        OIC_LOG(ERROR, TAG, "send queue is already initialized");
+        return CA_STATUS_FAILED;
+    }
+
+    g_sendThreadCount = threadCount;
+    return CA_STATUS_OK;
+}
+
 CAResult_t CAStartIP(void)
 {
     //Initializing the Globals
@@ -399,8 +419,8 @@ CAResult_t CAStartIP(void)
         return CA_STATUS_FAILED;
     }
 
-    // Start send queue thread
-    if (CA_STATUS_OK != CAQueueingThreadStart(g_sendQueueHandle))
+    // Start send queue threads
+    if (CA_STATUS_OK != CAQueueingThreadGroupStart(&g_sendQueue))
     {
         OIC_LOG(ERROR, TAG, "Failed to Start Send Data Thread");
         return CA_STATUS_FAILED;
@@ -458,7 +478,7 @@ static int32_t CAQueueIPData(bool isMulticast, const CAEndpoint_t *endpoint,
     }
 
 
-    VERIFY_NON_NULL_RET(g_sendQueueHandle, TAG, "sendQueueHandle", -1);
+    VERIFY_NON_NULL_RET(g_sendQueue.threads, TAG, "sendQueue", -1);
     // Create IPData to add to queue
     CAIPData_t *ipData = CACreateIPData(endpoint, data, dataLength, isMulticast);
     if (!ipData)
@@ -466,8 +486,8 @@ static int32_t CAQueueIPData(bool isMulticast, const CAEndpoint_t *endpoint,
         OIC_LOG(ERROR, TAG, "Failed to create ipData!");
         return -1;
     }
-    // Add message to send queue
-    CAQueueingThreadAddData(g_sendQueueHandle, ipData, sizeof(CAIPData_t));
+    // Add message to the send queue of the endpoint
+    CAQueueingThreadGroupAddData(&g_sendQueue, endpoint, ipData, sizeof(CAIPData_t));
 
 
     return dataLength;
@@ -500,10 +520,7 @@ CAResult_t CAStopIP(void)
     CAdeinitSslAdapter();
 #endif
 
-    if (g_sendQueueHandle && g_sendQueueHandle->threadMutex)
-    {
-        CAQueueingThreadStop(g_sendQueueHandle);
-    }
+    CAQueueingThreadGroupStop(&g_sendQueue);
 
     CAIPStopNetworkMonitor(CA_ADAPTER_IP);
     CAIPStopServer();
@@ -568,6 +585,49 @@ void CAIPSendDataThread(void *threadData)
     }
 }
 
+void CAIPSendDataBatchThread(void **threadData, uint32_t count)
+{
+    CAIPSendItem_t items[CA_QUEUEING_THREAD_MAX_BATCH];
+    size_t itemCount = 0;
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        CAIPData_t *ipData = (CAIPData_t *) threadData[i];
+        if (!ipData)
+        {
+            OIC_LOG(DEBUG, TAG, "Invalid ip data!");
+            continue;
+        }
+
+#ifdef __WITH_DTLS__
+        if (!ipData->isMulticast && ipData->remoteEndpoint
+            && (ipData->remoteEndpoint->flags & CA_SECURE))
+        {
+            // Keep the queue order: send what was collected before encrypting.
+            CAIPSendDataBatch(items, itemCount);
+            itemCount = 0;
+            CAIPSendDataThread(ipData);
+            continue;
+        }
+#endif
+
+        if (CA_QUEUEING_THREAD_MAX_BATCH == itemCount)
+        {
+            CAIPSendDataBatch(items, itemCount);
+            itemCount = 0;
+        }
+        items[itemCount].endpoint = ipData->remoteEndpoint;
+        items[itemCount].data = ipData->data;
+        items[itemCount].dataLength = ipData->dataLen;
+        items[itemCount].isMulticast = ipData->isMulticast;
+        itemCount++;
+    }
+
+    if (itemCount)
+    {
+        CAIPSendDataBatch(items, itemCount);
+    }
+}
 
 CAIPData_t *CACreateIPData(const CAEndpoint_t *remoteEndpoint, const void *data,
                            uint32_t dataLength, bool isMulticast)
@@ -46,6 +46,9 @@
 #ifdef HAVE_SYS_SELECT_H
 #include <sys/select.h>
 #endif
+#ifdef HAVE_SYS_EPOLL_H
+#include <sys/epoll.h>
+#endif
 #ifdef HAVE_ARPA_INET_H
 #include <arpa/inet.h>
 #endif
@@ -90,6 +93,16 @@
 
 #define SELECT_TIMEOUT 1     // select() seconds (and termination latency)
 
+#ifdef HAVE_SYS_EPOLL_H
+#define EPOLL_MAX_EVENTS 16  // events handled per epoll_wait()
+
+/*
+ * epoll instance watching the sockets, the shutdown pipe and the netlink socket.
+ * select() is used instead while it is -1.
+ */
+static int g_epollFd = -1;
+#endif
+
 #define IPv4_MULTICAST     "224.0.1.187"
 static struct in_addr IPv4MulticastAddress = { 0 };
 
@@ -114,6 +127,56 @@ static struct in6_addr IPv6MulticastAddressGlb;
  */
 #define RECV_MSG_BUF_LEN 16384
 
+#if (defined(HAVE_RECVMMSG) || defined(HAVE_SENDMMSG)) && !defined(_WIN32)
+/*
+ * Ancillary data buffer large enough for one IP_PKTINFO or IPV6_PKTINFO message.
+ */
+typedef union
+{
+    struct cmsghdr cmsg;
+    unsigned char data[CMSG_SPACE(sizeof (struct in6_pktinfo))];
+} CAPktInfoControl_t;
+#endif
+
+#if defined(HAVE_RECVMMSG) && !defined(WSA_CMSG_DATA)
+/*
+ * Number of datagrams read by one recvmmsg() call. The vectors are preallocated
+ * and only used by the receive thread.
+ */
+#ifndef RECV_MSG_BATCH_LEN
+#define RECV_MSG_BATCH_LEN 8
+#endif
+
+static char g_recvBuffers[RECV_MSG_BATCH_LEN][RECV_MSG_BUF_LEN];
+static struct sockaddr_storage g_recvAddrs[RECV_MSG_BATCH_LEN];
+static CAPktInfoControl_t g_recvControls[RECV_MSG_BATCH_LEN];
+static struct iovec g_recvIovs[RECV_MSG_BATCH_LEN];
+static struct mmsghdr g_recvMsgs[RECV_MSG_BATCH_LEN];
+#endif
+
+#if defined(HAVE_SENDMMSG) && !defined(_WIN32)
+/*
+ * Maximum number of datagrams sent by one sendmmsg() call.
+ */
+#ifndef SEND_MSG_BATCH_LEN
+#define SEND_MSG_BATCH_LEN 32
+#endif
+
+/*
+ * Datagrams collected by CAIPSendDataBatch() for one socket.
+ */
+typedef struct
+{
+    CASocketFd_t fd;
+    unsigned int count;
+    struct mmsghdr msgs[SEND_MSG_BATCH_LEN];
+    struct iovec iovs[SEND_MSG_BATCH_LEN];
+    struct sockaddr_storage addrs[SEND_MSG_BATCH_LEN];
+    CAPktInfoControl_t controls[SEND_MSG_BATCH_LEN];
+    const CAEndpoint_t *endpoints[SEND_MSG_BATCH_LEN];
+} CAIPSendBatch_t;
+#endif
+
 static char *ipv6mcnames[IPv6_DOMAINS] = {
     NULL,
     IPv6_MULTICAST_INT,
@@ -156,14 +219,30 @@ static CAIPPacketReceivedCallback g_packetReceivedCallback = NULL;
 static void CAFindReadyMessage(void);
 #if !defined(WSA_WAIT_EVENT_0)
 static void CASelectReturned(fd_set *readFds, int ret);
+static void CAHandleNetlinkEvent(void);
+#ifdef HAVE_SYS_EPOLL_H
+static void CAEpollReturned(const struct epoll_event *events, int count);
+#endif
 #else
 static void CAEventReturned(CASocketFd_t socket);
 #endif
 
 static CAResult_t CAReceiveMessage(CASocketFd_t fd, CATransportFlags_t flags);
+#if defined(HAVE_RECVMMSG) && !defined(WSA_CMSG_DATA)
+static CAResult_t CAReceiveMessages(CASocketFd_t fd, CATransportFlags_t flags);
+#else
+#define CAReceiveMessages CAReceiveMessage
+#endif
 
 static void CACloseFDs(void)
 {
+#ifdef HAVE_SYS_EPOLL_H
+    if (-1 != g_epollFd)
+    {
+        close(g_epollFd);
+        g_epollFd = -1;
+    }
+#endif
 #if !defined(WSA_WAIT_EVENT_0)
     if (caglobals.ip.shutdownFds[0] != -1)
     {
@@ -210,6 +289,31 @@ static void CAReceiveHandler(void *data)
 
 static void CAFindReadyMessage(void)
 {
+#ifdef HAVE_SYS_EPOLL_H
+    if (-1 != g_epollFd)
+    {
+        struct epoll_event events[EPOLL_MAX_EVENTS];
+        int ms = caglobals.ip.selectTimeout == -1 ? -1 : caglobals.ip.selectTimeout * 1000;
+        int count = epoll_wait(g_epollFd, events, EPOLL_MAX_EVENTS, ms);
+
+        if (caglobals.ip.terminate)
+        {
+            OIC_LOG_V(DEBUG, TAG, "Packet receiver Stop request received.");
+            return;
+        }
+
+        if (0 < count)
+        {
+            CAEpollReturned(events, count);
+        }
+        else if (0 > count && EINTR != errno)
+        {
+            OIC_LOG_V(FATAL, TAG, "epoll_wait error %s", CAIPS_GET_ERROR);
+        }
+        return;
+    }
+#endif
+
     fd_set readFds;
     struct timeval timeout;
 
@@ -277,23 +381,7 @@ static void CASelectReturned(fd_set *readFds, int ret)
         else ISSET(m4s, readFds, CA_MULTICAST | CA_IPV4 | CA_SECURE)
         else if ((caglobals.ip.netlinkFd != OC_INVALID_SOCKET) && FD_ISSET(caglobals.ip.netlinkFd, readFds))
         {
-#if NETWORK_INTERFACE_CHANGED_LOGGING
-            OIC_LOG_V(DEBUG, TAG, "Netlink event detected");
-#endif
-            u_arraylist_t *iflist = CAFindInterfaceChange();
-            if (iflist)
-            {
-                size_t listLength = u_arraylist_length(iflist);
-                for (size_t i = 0; i < listLength; i++)
-                {
-                    CAInterface_t *ifitem = (CAInterface_t *)u_arraylist_get(iflist, i);
-                    if (ifitem)
-                    {
-                        CAProcessNewInterface(ifitem);
-                    }
-                }
-                u_arraylist_destroy(iflist);
-            }
+            CAHandleNetlinkEvent();
             break;
         }
         else if (FD_ISSET(caglobals.ip.shutdownFds[0], readFds))
@@ -310,11 +398,123 @@ static void CASelectReturned(fd_set *readFds, int ret)
         {
             break;
         }
-        (void)CAReceiveMessage(fd, flags);
+        (void)CAReceiveMessages(fd, flags);
         FD_CLR(fd, readFds);
     }
 }
 
+static void CAHandleNetlinkEvent(void)
+{
+#if NETWORK_INTERFACE_CHANGED_LOGGING
+    OIC_LOG_V(DEBUG, TAG, "Netlink event detected");
+#endif
+    u_arraylist_t *iflist = CAFindInterfaceChange();
+    if (iflist)
+    {
+        size_t listLength = u_arraylist_length(iflist);
+        for (size_t i = 0; i < listLength; i++)
+        {
+            CAInterface_t *ifitem = (CAInterface_t *)u_arraylist_get(iflist, i);
+            if (ifitem)
+            {
+                CAProcessNewInterface(ifitem);
+            }
+        }
+        u_arraylist_destroy(iflist);
+    }
+}
+
+#ifdef HAVE_SYS_EPOLL_H
+
+#define EPOLLISSET(TYPE, FD, FLAGS) \
+    if (caglobals.ip.TYPE.fd != OC_INVALID_SOCKET && caglobals.ip.TYPE.fd == FD) \
+    { \
+        flags = FLAGS; \
+    }
+
+static void CAEpollReturned(const struct epoll_event *events, int count)
+{
+    for (int i = 0; i < count && !caglobals.ip.terminate; i++)
+    {
+        CASocketFd_t fd = events[i].data.fd;
+        CATransportFlags_t flags = CA_DEFAULT_FLAGS;
+
+        if (caglobals.ip.netlinkFd != OC_INVALID_SOCKET && caglobals.ip.netlinkFd == fd)
+        {
+            CAHandleNetlinkEvent();
+            continue;
+        }
+        if (caglobals.ip.shutdownFds[0] == fd)
+        {
+            char buf[10] = {0};
+            if (-1 == read(caglobals.ip.shutdownFds[0], buf, sizeof (buf)))
+            {
+                OIC_LOG_V(DEBUG, TAG, "read failed: %s", strerror(errno));
+            }
+            continue;
+        }
+
+        EPOLLISSET(u6,  fd, CA_IPV6)
+        else EPOLLISSET(u6s, fd, CA_IPV6 | CA_SECURE)
+        else EPOLLISSET(u4,  fd, CA_IPV4)
+        else EPOLLISSET(u4s, fd, CA_IPV4 | CA_SECURE)
+        else EPOLLISSET(m6,  fd, CA_MULTICAST | CA_IPV6)
+        else EPOLLISSET(m6s, fd, CA_MULTICAST | CA_IPV6 | CA_SECURE)
+        else EPOLLISSET(m4,  fd, CA_MULTICAST | CA_IPV4)
+        else EPOLLISSET(m4s, fd, CA_MULTICAST | CA_IPV4 | CA_SECURE)
+        else
+        {
+            continue;
+        }
+        (void)CAReceiveMessages(fd, flags);
+    }
+}
+
+static void CAEpollAdd(int fd)
+{
+    if (-1 == g_epollFd || -1 == fd)
+    {
+        return;
+    }
+
+    struct epoll_event event = { .events = EPOLLIN, .data.fd = fd };
+    if (-1 == epoll_ctl(g_epollFd, EPOLL_CTL_ADD, fd, &event))
+    {
+        OIC_LOG_V(ERROR, TAG, "epoll_ctl failed: %s, falling back to select",
+                  strerror(errno));
+        close(g_epollFd);
+        g_epollFd = -1;
+    }
+}
+
+/*
+ * The sockets of the IP adapter do not change while it runs, so they are
+ * registered once. Events are level-triggered: CAReceiveMessage() reads a
+ * single datagram from a blocking socket per call.
+ */
+static void CAInitializeEpoll(void)
+{
+    g_epollFd = epoll_create1(EPOLL_CLOEXEC);
+    if (-1 == g_epollFd)
+    {
+        OIC_LOG_V(ERROR, TAG, "epoll_create1 failed: %s, using select", strerror(errno));
+        return;
+    }
+
+    CAEpollAdd(caglobals.ip.u6.fd);
+    CAEpollAdd(caglobals.ip.u6s.fd);
+    CAEpollAdd(caglobals.ip.u4.fd);
+    CAEpollAdd(caglobals.ip.u4s.fd);
+    CAEpollAdd(caglobals.ip.m6.fd);
+    CAEpollAdd(caglobals.ip.m6s.fd);
+    CAEpollAdd(caglobals.ip.m4.fd);
+    CAEpollAdd(caglobals.ip.m4s.fd);
+    CAEpollAdd(caglobals.ip.shutdownFds[0]);
+    CAEpollAdd(caglobals.ip.netlinkFd);
+}
+
+#endif // HAVE_SYS_EPOLL_H
+
 #else // if defined(WSA_WAIT_EVENT_0)
 
 #define PUSH_HANDLE(HANDLE, ARRAY, INDEX) \
@@ -559,6 +759,77 @@ void CADeInitializeIPGlobals(void)
     CAUnregisterForAddressChanges();
 }
 
+/**
+ * Pass a received datagram to the upper layer, or to DTLS if it was received
+ * on a secure socket.
+ */
+static CAResult_t CAHandleReceivedDatagram(CATransportFlags_t flags, unsigned char *pktinfo,
+                                           struct sockaddr_storage *srcAddr, int namelen,
+                                           char *recvBuffer, size_t recvLen)
+{
+    if (!pktinfo)
+    {
+        OIC_LOG(ERROR, TAG, "pktinfo is null");
+        return CA_STATUS_FAILED;
+    }
+
+    CASecureEndpoint_t sep = {.endpoint = {.adapter = CA_ADAPTER_IP, .flags = flags}};
+
+    if (flags & CA_IPV6)
+    {
+        sep.endpoint.ifindex = ((struct in6_pktinfo *)pktinfo)->ipi6_ifindex;
+
+        if (flags & CA_MULTICAST)
+        {
+            struct in6_addr *addr = &(((struct in6_pktinfo *)pktinfo)->ipi6_addr);
+            unsigned char topbits = ((unsigned char *)addr)[0];
+            if (topbits != 0xff)
+            {
+                sep.endpoint.flags &= ~CA_MULTICAST;
+            }
+        }
+    }
+    else
+    {
+        sep.endpoint.ifindex = ((struct in_pktinfo *)pktinfo)->ipi_ifindex;
+
+        if (flags & CA_MULTICAST)
+        {
+            struct in_addr *addr = &((struct in_pktinfo *)pktinfo)->ipi_addr;
+            uint32_t host = ntohl(addr->s_addr);
+            unsigned char topbits = ((unsigned char *)&host)[3];
+            if (topbits < 224 || topbits > 239)
+            {
+                sep.endpoint.flags &= ~CA_MULTICAST;
+            }
+        }
+    }
+
+    CAConvertAddrToName(srcAddr, namelen, sep.endpoint.addr, &sep.endpoint.port);
+
+    if (flags & CA_SECURE)
+    {
+#ifdef __WITH_DTLS__
+#ifdef TB_LOG
+        int decryptResult =
+#endif
+        CAdecryptSsl(&sep, (uint8_t *)recvBuffer, recvLen);
+        OIC_LOG_V(DEBUG, TAG, "CAdecryptSsl returns [%d]", decryptResult);
+#else
+        OIC_LOG(ERROR, TAG, "Encrypted message but no DTLS");
+#endif // __WITH_DTLS__
+    }
+    else
+    {
+        if (g_packetReceivedCallback)
+        {
+            g_packetReceivedCallback(&sep, recvBuffer, recvLen);
+        }
+    }
+
+    return CA_STATUS_OK;
+}
+
 static CAResult_t CAReceiveMessage(CASocketFd_t fd, CATransportFlags_t flags)
 {
     char recvBuffer[RECV_MSG_BUF_LEN] = {0};
@@ -661,68 +932,69 @@ static CAResult_t CAReceiveMessage(CASocketFd_t fd, CATransportFlags_t flags)
         }
     }
 #endif // !defined(WSA_CMSG_DATA)
-    if (!pktinfo)
-    {
-        OIC_LOG(ERROR, TAG, "pktinfo is null");
-        return CA_STATUS_FAILED;
-    }
 
-    CASecureEndpoint_t sep = {.endpoint = {.adapter = CA_ADAPTER_IP, .flags = flags}};
+    return CAHandleReceivedDatagram(flags, pktinfo, &srcAddr, namelen, recvBuffer, recvLen);
+}
+
+#if defined(HAVE_RECVMMSG) && !defined(WSA_CMSG_DATA)
+/**
+ * Read all datagrams queued on a socket, up to RECV_MSG_BATCH_LEN, with one call.
+ */
+static CAResult_t CAReceiveMessages(CASocketFd_t fd, CATransportFlags_t flags)
+{
+    int namelen = sizeof (struct sockaddr_in);
+    int level = IPPROTO_IP;
+    int type = IP_PKTINFO;
 
     if (flags & CA_IPV6)
     {
-        sep.endpoint.ifindex = ((struct in6_pktinfo *)pktinfo)->ipi6_ifindex;
-
-        if (flags & CA_MULTICAST)
-        {
-            struct in6_addr *addr = &(((struct in6_pktinfo *)pktinfo)->ipi6_addr);
-            unsigned char topbits = ((unsigned char *)addr)[0];
-            if (topbits != 0xff)
-            {
-                sep.endpoint.flags &= ~CA_MULTICAST;
-            }
-        }
+        namelen = sizeof (struct sockaddr_in6);
+        level = IPPROTO_IPV6;
+        type = IPV6_PKTINFO;
     }
-    else
+
+    for (size_t i = 0; i < RECV_MSG_BATCH_LEN; i++)
     {
-        sep.endpoint.ifindex = ((struct in_pktinfo *)pktinfo)->ipi_ifindex;
+        g_recvIovs[i].iov_base = g_recvBuffers[i];
+        g_recvIovs[i].iov_len = sizeof (g_recvBuffers[i]);
 
-        if (flags & CA_MULTICAST)
-        {
-            struct in_addr *addr = &((struct in_pktinfo *)pktinfo)->ipi_addr;
-            uint32_t host = ntohl(addr->s_addr);
-            unsigned char topbits = ((unsigned char *)&host)[3];
-            if (topbits < 224 || topbits > 239)
-            {
-                sep.endpoint.flags &= ~CA_MULTICAST;
-            }
-        }
+        struct msghdr *msg = &g_recvMsgs[i].msg_hdr;
+        msg->msg_name = &g_recvAddrs[i];
+        msg->msg_namelen = namelen;
+        msg->msg_iov = &g_recvIovs[i];
+        msg->msg_iovlen = 1;
+        msg->msg_control = &g_recvControls[i];
+        msg->msg_controllen = CMSG_SPACE(sizeof (struct in6_pktinfo));
+        msg->msg_flags = 0;
     }
 
-    CAConvertAddrToName(&srcAddr, namelen, sep.endpoint.addr, &sep.endpoint.port);
-
-    if (flags & CA_SECURE)
+    // the socket is readable, do not wait for the rest of the batch.
+    int count = recvmmsg(fd, g_recvMsgs, RECV_MSG_BATCH_LEN, MSG_DONTWAIT, NULL);
+    if (OC_SOCKET_ERROR == count)
     {
-#ifdef __WITH_DTLS__
-#ifdef TB_LOG
-        int decryptResult =
-#endif
-        CAdecryptSsl(&sep, (uint8_t *)recvBuffer, recvLen);
-        OIC_LOG_V(DEBUG, TAG, "CAdecryptSsl returns [%d]", decryptResult);
-#else
-        OIC_LOG(ERROR, TAG, "Encrypted message but no DTLS");
-#endif // __WITH_DTLS__
+        OIC_LOG_V(ERROR, TAG, "recvmmsg failed %s", strerror(errno));
+        return CA_STATUS_FAILED;
     }
-    else
+
+    for (int i = 0; i < count; i++)
     {
-        if (g_packetReceivedCallback)
+        struct msghdr *msg = &g_recvMsgs[i].msg_hdr;
+        unsigned char *pktinfo = NULL;
+        for (struct cmsghdr *cmp = CMSG_FIRSTHDR(msg); cmp != NULL; cmp = CMSG_NXTHDR(msg, cmp))
         {
-            g_packetReceivedCallback(&sep, recvBuffer, recvLen);
+            if (cmp->cmsg_level == level && cmp->cmsg_type == type)
+            {
+                pktinfo = CMSG_DATA(cmp);
+            }
         }
+
+        (void)CAHandleReceivedDatagram(flags, pktinfo, &g_recvAddrs[i], namelen,
+                                       g_recvBuffers[i], g_recvMsgs[i].msg_len);
     }
 
     return CA_STATUS_OK;
 }
+#endif
 
 void CAIPPullData(void)
 {
@@ -1007,6 +1279,10 @@ CAResult_t CAIPStartServer(const ca_thread_pool_t threadPool)
     // create source of network address change notifications
     CARegisterForAddressChanges();
 
+#ifdef HAVE_SYS_EPOLL_H
+    CAInitializeEpoll();
+#endif
+
     caglobals.ip.selectTimeout = CAGetPollingInterval(caglobals.ip.selectTimeout);
 
     res = CAIPStartListenServer();
@@ -1554,6 +1830,238 @@ void CAIPSendData(CAEndpoint_t *endpoint, const void *data, size_t datalen,
     }
 }
 
+#if defined(HAVE_SENDMMSG) && !defined(_WIN32)
+static void CAIPSendBatchFlush(CAIPSendBatch_t *batch)
+{
+    unsigned int sent = 0;
+    while (sent < batch->count)
+    {
+        int ret = sendmmsg(batch->fd, &batch->msgs[sent], batch->count - sent, 0);
+        if (OC_SOCKET_ERROR == ret)
+        {
+            // sendmmsg() stops at the first datagram it cannot send,
+            // report that one and go on with the rest of the batch.
+            const char *error = strerror(errno);
+            const CAEndpoint_t *endpoint = batch->endpoints[sent];
+            if (g_ipErrorHandler)
+            {
+                g_ipErrorHandler(endpoint, batch->iovs[sent].iov_base,
+                                 batch->iovs[sent].iov_len, CA_SEND_FAILED);
+            }
+            OIC_LOG_V(ERROR, TAG, "sendmmsg failed: %s", error);
+            CALogSendStateInfo(endpoint->adapter, endpoint->addr, endpoint->port,
+                               -1, false, error);
+            sent++;
+            continue;
+        }
+
+        for (int i = 0; i < ret; i++)
+        {
+            const CAEndpoint_t *endpoint = batch->endpoints[sent + i];
+            OIC_LOG_V(INFO, TAG, "sendmmsg is successful: %u bytes", batch->msgs[sent + i].msg_len);
+            CALogSendStateInfo(endpoint->adapter, endpoint->addr, endpoint->port,
+                               batch->msgs[sent + i].msg_len, true, NULL);
+        }
+        sent += ret;
+    }
+    batch->count = 0;
+}
+
+/**
+ * Queue one datagram on the batch, flushing it first if it is full or collects
+ * datagrams for another socket. A non zero ifindex selects the outgoing
+ * interface with a pktinfo message instead of IP_MULTICAST_IF.
+ */
+static void CAIPSendBatchAdd(CAIPSendBatch_t *batch, CASocketFd_t fd,
+                             const CAEndpoint_t *endpoint,
+                             const void *data, size_t dlen, uint32_t ifindex)
+{
+    if (batch->count && (batch->fd != fd || SEND_MSG_BATCH_LEN == batch->count))
+    {
+        CAIPSendBatchFlush(batch);
+    }
+    batch->fd = fd;
+
+    unsigned int i = batch->count;
+    struct sockaddr_storage *sock = &batch->addrs[i];
+    memset(sock, 0, sizeof (*sock));
+    CAConvertNameToAddr(endpoint->addr, endpoint->port, sock);
+
+    batch->iovs[i].iov_base = (void *)data;
+    batch->iovs[i].iov_len = dlen;
+
+    struct msghdr *msg = &batch->msgs[i].msg_hdr;
+    memset(msg, 0, sizeof (*msg));
+    msg->msg_name = sock;
+    msg->msg_namelen = (AF_INET6 == sock->ss_family) ? sizeof (struct sockaddr_in6)
+                                                      : sizeof (struct sockaddr_in);
+    msg->msg_iov = &batch->iovs[i];
+    msg->msg_iovlen = 1;
+
+    if (ifindex)
+    {
+        memset(&batch->controls[i], 0, sizeof (batch->controls[i]));
+        msg->msg_control = &batch->controls[i];
+        msg->msg_controllen = sizeof (batch->controls[i]);
+
+        struct cmsghdr *cmsg = CMSG_FIRSTHDR(msg);
+        if (AF_INET6 == sock->ss_family)
+        {
+            cmsg->cmsg_level = IPPROTO_IPV6;
+            cmsg->cmsg_type = IPV6_PKTINFO;
+            cmsg->cmsg_len = CMSG_LEN(sizeof (struct in6_pktinfo));
+            ((struct in6_pktinfo *)CMSG_DATA(cmsg))->ipi6_ifindex = ifindex;
+            msg->msg_controllen = CMSG_SPACE(sizeof (struct in6_pktinfo));
+        }
+        else
+        {
+            cmsg->cmsg_level = IPPROTO_IP;
+            cmsg->cmsg_type = IP_PKTINFO;
+            cmsg->cmsg_len = CMSG_LEN(sizeof (struct in_pktinfo));
+            ((struct in_pktinfo *)CMSG_DATA(cmsg))->ipi_ifindex = ifindex;
+            msg->msg_controllen = CMSG_SPACE(sizeof (struct in_pktinfo));
+        }
+    }
+
+    batch->endpoints[i] = endpoint;
+    batch->count++;
+}
+
+static void CAIPSendBatchMulticast(CAIPSendBatch_t *batch, const u_arraylist_t *iflist,
+                                   CAEndpoint_t *endpoint, const void *data, size_t datalen,
+                                   int family)
+{
+    CASocketFd_t fd;
+    const char *mcname;
+    if (AF_INET6 == family)
+    {
+        int scope = endpoint->flags & CA_SCOPE_MASK;
+        mcname = ipv6mcnames[scope];
+        if (!mcname)
+        {
+            OIC_LOG_V(INFO, TAG, "IPv6 multicast scope invalid: %d", scope);
+            return;
+        }
+        fd = caglobals.ip.u6.fd;
+    }
+    else
+    {
+        mcname = IPv4_MULTICAST;
+        fd = caglobals.ip.u4.fd;
+    }
+
+    // pending datagrams may still refer to the endpoint address for logging.
+    if (batch->count && batch->fd != fd)
+    {
+        CAIPSendBatchFlush(batch);
+    }
+    OICStrcpy(endpoint->addr, sizeof(endpoint->addr), mcname);
+
+    size_t len = u_arraylist_length(iflist);
+    for (size_t i = 0; i < len; i++)
+    {
+        CAInterface_t *ifitem = (CAInterface_t *)u_arraylist_get(iflist, i);
+        if (!ifitem)
+        {
+            continue;
+        }
+        if ((ifitem->flags & IFF_UP_RUNNING_FLAGS) != IFF_UP_RUNNING_FLAGS)
+        {
+            continue;
+        }
+        if (ifitem->family != family)
+        {
+            continue;
+        }
+        CAIPSendBatchAdd(batch, fd, endpoint, data, datalen, ifitem->index);
+    }
+}
+#endif // HAVE_SENDMMSG
+
+void CAIPSendDataBatch(CAIPSendItem_t *items, size_t count)
+{
+    VERIFY_NON_NULL_VOID(items, TAG, "items is NULL");
+
+#if defined(HAVE_SENDMMSG) && !defined(_WIN32)
+    CAIPSendBatch_t batch;
+    batch.fd = OC_INVALID_SOCKET;
+    batch.count = 0;
+    u_arraylist_t *iflist = NULL;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        CAEndpoint_t *endpoint = items[i].endpoint;
+        const void *data = items[i].data;
+        size_t datalen = items[i].dataLength;
+        if (!endpoint || !data)
+        {
+            OIC_LOG(ERROR, TAG, "endpoint or data is NULL");
+            continue;
+        }
+
+        bool isSecure = (endpoint->flags & CA_SECURE) != 0;
+
+        if (items[i].isMulticast)
+        {
+            endpoint->port = isSecure ? CA_SECURE_COAP : CA_COAP;
+
+            if (!iflist)
+            {
+                iflist = CAIPGetInterfaceInformation(0);
+                if (!iflist)
+                {
+                    OIC_LOG_V(ERROR, TAG, "get interface info failed: %s", strerror(errno));
+                    continue;
+                }
+            }
+
+            if ((endpoint->flags & CA_IPV6) && caglobals.ip.ipv6enabled)
+            {
+                CAIPSendBatchMulticast(&batch, iflist, endpoint, data, datalen, AF_INET6);
+            }
+            if ((endpoint->flags & CA_IPV4) && caglobals.ip.ipv4enabled)
+            {
+                CAIPSendBatchMulticast(&batch, iflist, endpoint, data, datalen, AF_INET);
+            }
+        }
+        else
+        {
+            if (!endpoint->port)    // unicast discovery
+            {
+                endpoint->port = isSecure ? CA_SECURE_COAP : CA_COAP;
+            }
+
+            CASocketFd_t fd;
+            if (caglobals.ip.ipv6enabled && (endpoint->flags & CA_IPV6))
+            {
+                fd = isSecure ? caglobals.ip.u6s.fd : caglobals.ip.u6.fd;
+#ifndef __WITH_DTLS__
+                fd = caglobals.ip.u6.fd;
+#endif
+                CAIPSendBatchAdd(&batch, fd, endpoint, data, datalen, 0);
+            }
+            if (caglobals.ip.ipv4enabled && (endpoint->flags & CA_IPV4))
+            {
+                fd = isSecure ? caglobals.ip.u4s.fd : caglobals.ip.u4.fd;
+#ifndef __WITH_DTLS__
+                fd = caglobals.ip.u4.fd;
+#endif
+                CAIPSendBatchAdd(&batch, fd, endpoint, data, datalen, 0);
+            }
+        }
+    }
+
+    CAIPSendBatchFlush(&batch);
+    u_arraylist_destroy(iflist);
+#else
+    for (size_t i = 0; i < count; i++)
+    {
+        CAIPSendData(items[i].endpoint, items[i].data, items[i].dataLength,
+                     items[i].isMulticast);
+    }
+#endif
+}
+
 CAResult_t CAGetIPInterfaceInformation(CAEndpoint_t **info, size_t *size)
 {
     VERIFY_NON_NULL(info, TAG, "info is NULL");
@@ -67,9 +67,15 @@ typedef struct
 #define CA_TCP_SELECT_TIMEOUT 10
 
 /**
- * Queue handle for Send Data.
+ * Queue for Send Data. Each thread sends to its own endpoints, so the TLS
+ * encryption and the socket writes for different peers run in parallel.
  */
-static CAQueueingThread_t *g_sendQueueHandle = NULL;
+static CAQueueingThreadGroup_t g_sendQueue = { 0, NULL };
+
+/**
+ * Number of threads of the send queue, set with CATCPSetSendThreadCount().
+ */
+static uint32_t g_sendThreadCount = 1;
 
 /**
  * Network Packet Received Callback to CA.
@@ -121,27 +127,18 @@ static int32_t CAQueueTCPData(bool isMulticast, const CAEndpoint_t *endpoint,
 CAResult_t CATCPInitializeQueueHandles(void)
 {
     // Check if the message queue is already initialized
-    if (g_sendQueueHandle)
+    if (g_sendQueue.threads)
     {
         OIC_LOG(DEBUG, TAG, "send queue handle is already initialized!");
         return CA_STATUS_OK;
     }
 
     // Create send message queue
-    g_sendQueueHandle = OICMalloc(sizeof(CAQueueingThread_t));
-    if (!g_sendQueueHandle)
-    {
-        OIC_LOG(ERROR, TAG, "Memory allocation failed!");
-        return CA_MEMORY_ALLOC_FAILED;
-    }
-
-    if (CA_STATUS_OK != CAQueueingThreadInitialize(g_sendQueueHandle,
+    if (CA_STATUS_OK != CAQueueingThreadGroupInitialize(&g_sendQueue, g_sendThreadCount,
                                 (const ca_thread_pool_t)caglobals.tcp.threadpool,
                                 CATCPSendDataThread, CADataDestroyer))
     {
         OIC_LOG(ERROR, TAG, "Failed to Initialize send queue thread");
-        OICFree(g_sendQueueHandle);
-        g_sendQueueHandle = NULL;
         return CA_STATUS_FAILED;
     }
 
@@ -150,9 +147,7 @@ CAResult_t CATCPInitializeQueueHandles(void)
 
 void CATCPDeinitializeQueueHandles(void)
 {
-    CAQueueingThreadDestroy(g_sendQueueHandle);
-    OICFree(g_sendQueueHandle);
-    g_sendQueueHandle = NULL;
+    CAQueueingThreadGroupDestroy(&g_sendQueue);
 }
 
 void CATCPConnectionStateCB(const char *ipAddress, CANetworkStatus_t status)
@@ -383,6 +378,23 @@ CAResult_t CAInitializeTCP(CARegisterConnectivityCallback registerCallback,
     return CA_STATUS_OK;
 }
 
+CAResult_t CATCPSetSendThreadCount(uint32_t threadCount)
+{
+    if (0 == threadCount)
+    {
+        OIC_LOG(ERROR, TAG, "Invalid send thread count");
+        return CA_STATUS_INVALID_PARAM;
+    }
+    if (g_sendQueue.threads)
+    {
+        OIC_LOG(ERROR, TAG, "send queue is already initialized");
+        return CA_STATUS_FAILED;
+    }
+
+    g_sendThreadCount = threadCount;
+    return CA_STATUS_OK;
+}
+
 CAResult_t CAStartTCP()
 {
     OIC_LOG(DEBUG, TAG, "IN");
@@ -397,8 +409,8 @@ CAResult_t CAStartTCP()
         return CA_STATUS_FAILED;
     }
 
-    // Start send queue thread
-    if (CA_STATUS_OK != CAQueueingThreadStart(g_sendQueueHandle))
+    // Start send queue threads
+    if (CA_STATUS_OK != CAQueueingThreadGroupStart(&g_sendQueue))
     {
         OIC_LOG(ERROR, TAG, "Failed to Start Send Data Thread");
         return CA_STATUS_FAILED;
@@ -475,7 +487,7 @@ static int32_t CAQueueTCPData(bool isMulticast, const CAEndpoint_t *endpoint,
                     TAG,
                     "Invalid Data Length",
                     -1);
-    VERIFY_NON_NULL_RET(g_sendQueueHandle, TAG, "sendQueueHandle", -1);
+    VERIFY_NON_NULL_RET(g_sendQueue.threads, TAG, "sendQueue", -1);
 
     // Create TCPData to add to queue
     CATCPData *tcpData = CACreateTCPData(endpoint, data, dataLength, isMulticast, encryptedData);
@@ -484,8 +496,8 @@ static int32_t CAQueueTCPData(bool isMulticast, const CAEndpoint_t *endpoint,
         OIC_LOG(ERROR, TAG, "Failed to create ipData!");
         return -1;
     }
-    // Add message to send queue
-    CAQueueingThreadAddData(g_sendQueueHandle, tcpData, sizeof(CATCPData));
+    // Add message to the send queue of the endpoint
+    CAQueueingThreadGroupAddData(&g_sendQueue, endpoint, tcpData, sizeof(CATCPData));
 
     return (int32_t)dataLength;
 }
@@ -523,10 +535,7 @@ CAResult_t CAStopTCP()
 {
     CAIPStopNetworkMonitor(CA_ADAPTER_TCP);
 
-    if (g_sendQueueHandle && g_sendQueueHandle->threadMutex)
-    {
-        CAQueueingThreadStop(g_sendQueueHandle);
-    }
+    CAQueueingThreadGroupStop(&g_sendQueue);
     CATCPDeinitializeQueueHandles();
 
     CATCPStopServer();
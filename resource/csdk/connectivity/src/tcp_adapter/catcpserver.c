@@ -36,6 +36,9 @@
 #ifdef HAVE_SYS_POLL_H
 #include <sys/poll.h>
 #endif
+#ifdef HAVE_SYS_EPOLL_H
+#include <sys/epoll.h>
+#endif
 #include <stdio.h>
 #ifdef HAVE_UNISTD_H
 #include <unistd.h>
@@ -63,6 +66,7 @@
 #include "octhread.h"
 #include "oic_malloc.h"
 #include "oic_string.h"
+#include "uhashmap.h"
 
 #include <coap/pdu.h>
 #include <coap/utlist.h>
@@ -118,10 +122,35 @@ static CATCPConnectionHandleCallback g_connectionCallback = NULL;
  */
 static CATCPSessionInfo_t *g_sessionList = NULL;
 
+/**
+ * Sessions of g_sessionList, indexed by remote endpoint.
+ */
+static u_hashmap_t *g_sessionEndpointIndex = NULL;
+
+/**
+ * Connected sessions of g_sessionList, indexed by socket.
+ */
+static u_hashmap_t *g_sessionFdIndex = NULL;
+
+#ifdef HAVE_SYS_EPOLL_H
+/**
+ * Maximum number of events handled per epoll_wait().
+ */
+#define EPOLL_MAX_EVENTS 64
+
+/**
+ * epoll instance watching the accept sockets, the pipes and the connected sessions.
+ * select() is used instead while it is -1.
+ */
+static int g_epollFd = -1;
+#endif
+
 static CAResult_t CATCPCreateMutex(void);
 static void CATCPDestroyMutex(void);
 static CAResult_t CATCPCreateCond(void);
 static void CATCPDestroyCond(void);
+static CAResult_t CATCPCreateSessionIndex(void);
+static void CATCPDestroySessionIndex(void);
 static CASocketFd_t CACreateAcceptSocket(int family, CASocket_t *sock);
 static void CAAcceptConnection(CATransportFlags_t flag, CASocket_t *sock);
 static void CAFindReadyMessage(void);
@@ -133,6 +162,11 @@ static void CASocketEventReturned(CASocketFd_t socket, long networkEvents);
 static CAResult_t CAReceiveMessage(CATCPSessionInfo_t *svritem);
 static void CAReceiveHandler(void *data);
 static CAResult_t CATCPCreateSocket(int family, CATCPSessionInfo_t *svritem);
+static bool CATCPAddSession(CATCPSessionInfo_t *session);
+static void CATCPRemoveSession(CATCPSessionInfo_t *session);
+static void CATCPWatchSession(CATCPSessionInfo_t *session);
+static void CATCPUnwatchSession(CATCPSessionInfo_t *session);
+static void CATCPReadSession(CASocketFd_t fd);
 
 #if defined(WSA_WAIT_EVENT_0)
 #define CHECKFD(FD)
@@ -213,6 +247,65 @@ static CAResult_t CATCPCreateCond(void)
     return CA_STATUS_OK;
 }
 
+/*
+ * Sessions are looked up the way the session list used to be searched: same address
+ * and port, and at least one transport flag in common. The flags are therefore left
+ * out of the hash.
+ */
+static uint32_t CATCPSessionEndpointHash(const void *key)
+{
+    const CAEndpoint_t *endpoint = (const CAEndpoint_t *) key;
+    uint32_t hash = u_hashmap_hash_bytes(endpoint->addr,
+                                         strnlen(endpoint->addr, sizeof(endpoint->addr)),
+                                         U_HASHMAP_HASH_SEED);
+    return u_hashmap_hash_bytes(&endpoint->port, sizeof(endpoint->port), hash);
+}
+
+static bool CATCPSessionEndpointMatch(const void *key, const void *data)
+{
+    const CAEndpoint_t *endpoint = (const CAEndpoint_t *) key;
+    const CAEndpoint_t *sessionEndpoint = &((const CATCPSessionInfo_t *) data)->sep.endpoint;
+    return !strncmp(sessionEndpoint->addr, endpoint->addr, sizeof(sessionEndpoint->addr))
+            && (sessionEndpoint->port == endpoint->port)
+            && (sessionEndpoint->flags & endpoint->flags);
+}
+
+static uint32_t CATCPSessionFdHash(const void *key)
+{
+    return u_hashmap_hash_bytes(key, sizeof(CASocketFd_t), U_HASHMAP_HASH_SEED);
+}
+
+static bool CATCPSessionFdMatch(const void *key, const void *data)
+{
+    return ((const CATCPSessionInfo_t *) data)->fd == *(const CASocketFd_t *) key;
+}
+
+static void CATCPDestroySessionIndex(void)
+{
+    u_hashmap_free(&g_sessionEndpointIndex);
+    u_hashmap_free(&g_sessionFdIndex);
+}
+
+static CAResult_t CATCPCreateSessionIndex(void)
+{
+    if (!g_sessionEndpointIndex)
+    {
+        g_sessionEndpointIndex = u_hashmap_create(CATCPSessionEndpointHash,
+                                                  CATCPSessionEndpointMatch);
+    }
+    if (!g_sessionFdIndex)
+    {
+        g_sessionFdIndex = u_hashmap_create(CATCPSessionFdHash, CATCPSessionFdMatch);
+    }
+    if (!g_sessionEndpointIndex || !g_sessionFdIndex)
+    {
+        OIC_LOG(ERROR, TAG, "Failed to create session index!");
+        CATCPDestroySessionIndex();
+        return CA_STATUS_FAILED;
+    }
+    return CA_STATUS_OK;
+}
+
 static void CAReceiveHandler(void *data)
 {
     (void)data;
@@ -230,10 +323,268 @@ static void CAReceiveHandler(void *data)
     OIC_LOG(DEBUG, TAG, "OUT - CAReceiveHandler");
 }
 
+#ifdef HAVE_SYS_EPOLL_H
+
+static bool CATCPEpollAdd(int fd)
+{
+    struct epoll_event event = { .events = EPOLLIN, .data.fd = fd };
+    if (-1 == epoll_ctl(g_epollFd, EPOLL_CTL_ADD, fd, &event))
+    {
+        OIC_LOG_V(ERROR, TAG, "epoll_ctl failed: %s", strerror(errno));
+        return false;
+    }
+    return true;
+}
+
+static bool CATCPEpollAddSession(void *data, void *ctx)
+{
+    (void)ctx;
+    CATCPEpollAdd(((CATCPSessionInfo_t *) data)->fd);
+    return true;
+}
+
+/**
+ * Create the epoll instance and register the accept sockets, the pipes and the
+ * sessions connected so far. Events are level-triggered: sockets are blocking and
+ * CAReceiveMessage() reads one buffer or TLS record fragment per call.
+ */
+static void CATCPInitializeEpoll(void)
+{
+    oc_mutex_lock(g_mutexObjectList);
+
+    g_epollFd = epoll_create1(EPOLL_CLOEXEC);
+
+    bool ok = (-1 != g_epollFd);
+    int fds[] = { caglobals.tcp.ipv4.fd, caglobals.tcp.ipv4s.fd,
+                  caglobals.tcp.ipv6.fd, caglobals.tcp.ipv6s.fd,
+                  caglobals.tcp.shutdownFds[0], caglobals.tcp.connectionFds[0] };
+    for (size_t i = 0; ok && i < sizeof(fds) / sizeof(fds[0]); i++)
+    {
+        if (OC_INVALID_SOCKET != fds[i])
+        {
+            ok = CATCPEpollAdd(fds[i]);
+        }
+    }
+
+    if (!ok)
+    {
+        OIC_LOG(ERROR, TAG, "epoll setup failed, using select");
+        if (-1 != g_epollFd)
+        {
+            close(g_epollFd);
+            g_epollFd = -1;
+        }
+    }
+    else
+    {
+        u_hashmap_foreach(g_sessionFdIndex, CATCPEpollAddSession, NULL);
+    }
+
+    oc_mutex_unlock(g_mutexObjectList);
+}
+
+static void CATCPTerminateEpoll(void)
+{
+    oc_mutex_lock(g_mutexObjectList);
+    if (-1 != g_epollFd)
+    {
+        close(g_epollFd);
+        g_epollFd = -1;
+    }
+    oc_mutex_unlock(g_mutexObjectList);
+}
+
+static void CAEpollReturned(const struct epoll_event *events, int count)
+{
+    for (int i = 0; i < count && !caglobals.tcp.terminate; i++)
+    {
+        CASocketFd_t fd = events[i].data.fd;
+
+        if (caglobals.tcp.ipv4.fd == fd)
+        {
+            CAAcceptConnection(CA_IPV4, &caglobals.tcp.ipv4);
+        }
+        else if (caglobals.tcp.ipv4s.fd == fd)
+        {
+            CAAcceptConnection(CA_IPV4 | CA_SECURE, &caglobals.tcp.ipv4s);
+        }
+        else if (caglobals.tcp.ipv6.fd == fd)
+        {
+            CAAcceptConnection(CA_IPV6, &caglobals.tcp.ipv6);
+        }
+        else if (caglobals.tcp.ipv6s.fd == fd)
+        {
+            CAAcceptConnection(CA_IPV6 | CA_SECURE, &caglobals.tcp.ipv6s);
+        }
+        else if (caglobals.tcp.connectionFds[0] == fd)
+        {
+            // client sessions register themselves, just drain the pipe.
+            char buf[MAX_ADDR_STR_SIZE_CA] = {0};
+            ssize_t len = read(caglobals.tcp.connectionFds[0], buf, sizeof (buf));
+            if (-1 != len)
+            {
+                OIC_LOG_V(DEBUG, TAG, "Received new connection event with [%s]", buf);
+            }
+        }
+        else if (caglobals.tcp.shutdownFds[0] == fd)
+        {
+            // terminate flag is checked by the loop.
+        }
+        else
+        {
+            CATCPReadSession(fd);
+        }
+    }
+}
+
+#endif // HAVE_SYS_EPOLL_H
+
+/**
+ * Add a session to the session list. g_mutexObjectList must be held.
+ *
+ * A session to an endpoint that already has one is not added: u_hashmap_put() would
+ * replace the existing session in the endpoint index, leaving it in the list where
+ * it could no longer be found.
+ *
+ * @param[in] session   new session.
+ *
+ * @return  true if the session was added, false if the endpoint has a session already
+ *          or memory allocation failed.
+ */
+static bool CATCPAddSession(CATCPSessionInfo_t *session)
+{
+    if (u_hashmap_get(g_sessionEndpointIndex, &session->sep.endpoint))
+    {
+        OIC_LOG_V(ERROR, TAG, "Session with [%s:%d] exists already",
+                  session->sep.endpoint.addr, session->sep.endpoint.port);
+        return false;
+    }
+    if (!u_hashmap_put(g_sessionEndpointIndex, &session->sep.endpoint, session))
+    {
+        OIC_LOG(ERROR, TAG, "Out of memory");
+        return false;
+    }
+    LL_APPEND(g_sessionList, session);
+    return true;
+}
+
+/**
+ * Remove a session from the session list, before it is disconnected.
+ * g_mutexObjectList must be held.
+ *
+ * @param[in] session   session to remove.
+ */
+static void CATCPRemoveSession(CATCPSessionInfo_t *session)
+{
+    LL_DELETE(g_sessionList, session);
+    u_hashmap_remove_data(g_sessionEndpointIndex, &session->sep.endpoint, session);
+}
+
+/**
+ * Register a connected session for reception. g_mutexObjectList must be held.
+ *
+ * @param[in] session   connected session.
+ */
+static void CATCPWatchSession(CATCPSessionInfo_t *session)
+{
+    if (OC_INVALID_SOCKET == session->fd)
+    {
+        return;
+    }
+    if (!u_hashmap_put(g_sessionFdIndex, &session->fd, session))
+    {
+        OIC_LOG(ERROR, TAG, "Out of memory");
+        return;
+    }
+#ifdef HAVE_SYS_EPOLL_H
+    if (-1 != g_epollFd)
+    {
+        CATCPEpollAdd(session->fd);
+    }
+#endif
+}
+
+/**
+ * Unregister a session before its socket is closed. g_mutexObjectList must be held.
+ *
+ * @param[in] session   session to unregister.
+ */
+static void CATCPUnwatchSession(CATCPSessionInfo_t *session)
+{
+    if (OC_INVALID_SOCKET == session->fd)
+    {
+        return;
+    }
+    if (u_hashmap_remove_data(g_sessionFdIndex, &session->fd, session))
+    {
+#ifdef HAVE_SYS_EPOLL_H
+        if (-1 != g_epollFd)
+        {
+            epoll_ctl(g_epollFd, EPOLL_CTL_DEL, session->fd, NULL);
+        }
+#endif
+    }
+}
+
+/**
+ * Receive from the session connected on a socket ready to be read, and disconnect
+ * it if an error occurs.
+ *
+ * @param[in] fd        socket ready to be read.
+ */
+static void CATCPReadSession(CASocketFd_t fd)
+{
+    oc_mutex_lock(g_mutexObjectList);
+    // the session may have been removed since the socket was polled.
+    CATCPSessionInfo_t *session = u_hashmap_get(g_sessionFdIndex, &fd);
+    if (session)
+    {
+        CAResult_t res = CAReceiveMessage(session);
+        //disconnect session and clean-up data if any error occurs
+        if (res != CA_STATUS_OK && session == u_hashmap_get(g_sessionFdIndex, &fd))
+        {
+#ifdef __WITH_TLS__
+            if (CA_STATUS_OK != CAcloseSslConnection(&session->sep.endpoint))
+            {
+                OIC_LOG(ERROR, TAG, "Failed to close TLS session");
+            }
+#endif
+            CATCPRemoveSession(session);
+            CADisconnectTCPSession(session);
+        }
+    }
+    oc_mutex_unlock(g_mutexObjectList);
+}
+
 #if !defined(WSA_WAIT_EVENT_0)
 
 static void CAFindReadyMessage(void)
 {
+#ifdef HAVE_SYS_EPOLL_H
+    if (-1 != g_epollFd)
+    {
+        struct epoll_event events[EPOLL_MAX_EVENTS];
+        int count = epoll_wait(g_epollFd, events, EPOLL_MAX_EVENTS,
+                               caglobals.tcp.selectTimeout * 1000);
+
+        if (caglobals.tcp.terminate)
+        {
+            OIC_LOG_V(DEBUG, TAG, "Packet receiver Stop request received.");
+            return;
+        }
+
+        if (0 < count)
+        {
+            CAEpollReturned(events, count);
+        }
+        else if (0 > count && EINTR != errno)
+        {
+            OIC_LOG_V(FATAL, TAG, "epoll_wait error %s", strerror(errno));
+        }
+        return;
+    }
+#endif
+
     fd_set readFds;
     struct timeval timeout = { .tv_sec = caglobals.tcp.selectTimeout };
 
@@ -324,34 +675,13 @@ static void CASelectReturned(fd_set *readFds)
     }
     else
     {
-        oc_mutex_lock(g_mutexObjectList);
-        CATCPSessionInfo_t *session = NULL;
-        CATCPSessionInfo_t *tmp = NULL;
-        LL_FOREACH_SAFE(g_sessionList, session, tmp)
+        for (CASocketFd_t fd = 0; fd <= caglobals.tcp.maxfd; fd++)
         {
-            if (session && session->fd != OC_INVALID_SOCKET)
+            if (FD_ISSET(fd, readFds))
             {
-                if (FD_ISSET(session->fd, readFds))
-                {
-                    CAResult_t res = CAReceiveMessage(session);
-                    //disconnect session and clean-up data if any error occurs
-                    if (res != CA_STATUS_OK)
-                    {
-#ifdef __WITH_TLS__
-                        if (CA_STATUS_OK != CAcloseSslConnection(&session->sep.endpoint))
-                        {
-                            OIC_LOG(ERROR, TAG, "Failed to close TLS session");
-                        }
-#endif
-                        LL_DELETE(g_sessionList, session);
-                        CADisconnectTCPSession(session);
-                        oc_mutex_unlock(g_mutexObjectList);
-                        return;
-                    }
-                }
+                CATCPReadSession(fd);
             }
         }
-        oc_mutex_unlock(g_mutexObjectList);
     }
 }
 
@@ -540,31 +870,7 @@ static void CASocketEventReturned(CASocketFd_t s, long networkEvents)
 
     if (FD_READ & networkEvents)
     {
-        oc_mutex_lock(g_mutexObjectList);
-        CATCPSessionInfo_t *session = NULL;
-        CATCPSessionInfo_t *tmp = NULL;
-        LL_FOREACH_SAFE(g_sessionList, session, tmp)
-        {
-            if (session && (session->fd == s))
-            {
-                CAResult_t res = CAReceiveMessage(session);
-                //disconnect session and clean-up data if any error occurs
-                if (res != CA_STATUS_OK)
-                {
-#ifdef __WITH_TLS__
-                    if (CA_STATUS_OK != CAcloseSslConnection(&session->sep.endpoint))
-                    {
-                        OIC_LOG(ERROR, TAG, "Failed to close TLS session");
-                    }
-#endif
-                    LL_DELETE(g_sessionList, session);
-                    CADisconnectTCPSession(session);
-                    oc_mutex_unlock(g_mutexObjectList);
-                    return;
-                }
-            }
-        }
-        oc_mutex_unlock(g_mutexObjectList);
+        CATCPReadSession(s);
     }
 }
 
@@ -602,7 +908,31 @@ static void CAAcceptConnection(CATransportFlags_t flag, CASocket_t *sock)
                             svritem->sep.endpoint.addr, &svritem->sep.endpoint.port);
 
         oc_mutex_lock(g_mutexObjectList);
-        LL_APPEND(g_sessionList, svritem);
+        // the peer does not reuse the address and port of a connection it still uses,
+        // so a session with the same endpoint is stale and replaced by the new one.
+        CATCPSessionInfo_t *stale = u_hashmap_get(g_sessionEndpointIndex,
+                                                  &svritem->sep.endpoint);
+        if (stale)
+        {
+            OIC_LOG_V(INFO, TAG, "Replace stale session with [%s:%d]",
+                      stale->sep.endpoint.addr, stale->sep.endpoint.port);
+#ifdef __WITH_TLS__
+            if (CA_STATUS_OK != CAcloseSslConnection(&stale->sep.endpoint))
+            {
+                OIC_LOG(ERROR, TAG, "Failed to close TLS session");
+            }
+#endif
+            CATCPRemoveSession(stale);
+            CADisconnectTCPSession(stale);
+        }
+        if (!CATCPAddSession(svritem))
+        {
+            oc_mutex_unlock(g_mutexObjectList);
+            OC_CLOSE_SOCKET(sockfd);
+            OICFree(svritem);
+            return;
+        }
+        CATCPWatchSession(svritem);
         oc_mutex_unlock(g_mutexObjectList);
 
         CHECKFD(sockfd);
@@ -924,7 +1254,10 @@ static CAResult_t CATCPCreateSocket(int family, CATCPSessionInfo_t *svritem)
     }
 
     OIC_LOG(DEBUG, TAG, "connect socket success");
+    oc_mutex_lock(g_mutexObjectList);
     svritem->state = CONNECTED;
+    CATCPWatchSession(svritem);
+    oc_mutex_unlock(g_mutexObjectList);
     CHECKFD(svritem->fd);
 #if !defined(WSA_WAIT_EVENT_0)
     ssize_t len = CAWakeUpForReadFdsUpdate(svritem->sep.endpoint.addr);
@@ -1082,9 +1415,13 @@ CAResult_t CATCPStartServer(const ca_thread_pool_t threadPool)
     {
         res = CATCPCreateCond();
     }
+    if (CA_STATUS_OK == res)
+    {
+        res = CATCPCreateSessionIndex();
+    }
     if (CA_STATUS_OK != res)
     {
-        OIC_LOG(ERROR, TAG, "failed to create mutex/cond");
+        OIC_LOG(ERROR, TAG, "failed to create mutex/cond/index");
         return res;
     }
 
@@ -1128,6 +1465,10 @@ CAResult_t CATCPStartServer(const ca_thread_pool_t threadPool)
     CHECKFD(caglobals.tcp.connectionFds[1]);
 #endif
 
+#ifdef HAVE_SYS_EPOLL_H
+    CATCPInitializeEpoll();
+#endif
+
     caglobals.tcp.terminate = false;
     res = ca_thread_pool_add_task(threadPool, CAReceiveHandler, NULL);
     if (CA_STATUS_OK != res)
@@ -1196,10 +1537,15 @@ void CATCPStopServer(void)
     caglobals.tcp.shutdownFds[0] = OC_INVALID_SOCKET;
 #endif
 
+#ifdef HAVE_SYS_EPOLL_H
+    CATCPTerminateEpoll();
+#endif
+
     // mutex unlock
     oc_mutex_unlock(g_mutexObjectList);
 
     CATCPDisconnectAll();
+    CATCPDestroySessionIndex();
     CATCPDestroyMutex();
     CATCPDestroyCond();
 
@@ -1250,7 +1596,7 @@ size_t CACheckPayloadLengthFromHeader(const void *data, size_t dlen)
         payloadLen = (unsigned char *) pdu->hdr + pdu->length - pdu->data;
     }
 
-    OICFree(pdu);
+    coap_delete_pdu(pdu);
 
     return payloadLen;
 }
@@ -1451,13 +1797,28 @@ CASocketFd_t CAConnectTCPSession(const CAEndpoint_t *endpoint)
 
     // #2. add TCP connection info to list
     oc_mutex_lock(g_mutexObjectList);
-    LL_APPEND(g_sessionList, svritem);
+    if (!CATCPAddSession(svritem))
+    {
+        // another thread connected to the endpoint since it was looked up,
+        // use its session once it is connected.
+        CATCPSessionInfo_t *session = u_hashmap_get(g_sessionEndpointIndex, endpoint);
+        CASocketFd_t fd = (session && CONNECTED == session->state) ?
+                                session->fd : OC_INVALID_SOCKET;
+        oc_mutex_unlock(g_mutexObjectList);
+        OICFree(svritem);
+        return fd;
+    }
     oc_mutex_unlock(g_mutexObjectList);
 
     // #3. create the socket and connect to TCP server
     int family = (svritem->sep.endpoint.flags & CA_IPV6) ? AF_INET6 : AF_INET;
     if (CA_STATUS_OK != CATCPCreateSocket(family, svritem))
     {
+        // remove the session, so that the next send connects again.
+        oc_mutex_lock(g_mutexObjectList);
+        CATCPRemoveSession(svritem);
+        CADisconnectTCPSession(svritem);
+        oc_mutex_unlock(g_mutexObjectList);
         return OC_INVALID_SOCKET;
     }
 
@@ -1479,6 +1840,10 @@ CAResult_t CADisconnectTCPSession(CATCPSessionInfo_t *removedData)
     // close the socket and remove session info in list.
     if (removedData->fd != OC_INVALID_SOCKET)
     {
+        oc_mutex_lock(g_mutexObjectList);
+        CATCPUnwatchSession(removedData);
+        oc_mutex_unlock(g_mutexObjectList);
+
         shutdown(removedData->fd, SHUT_RDWR);
         OC_CLOSE_SOCKET(removedData->fd);
         removedData->fd = OC_INVALID_SOCKET;
@@ -1510,7 +1875,7 @@ void CATCPDisconnectAll(void)
     {
         if (session)
         {
-            LL_DELETE(g_sessionList, session);
+            CATCPRemoveSession(session);
             // disconnect session from remote device.
             CADisconnectTCPSession(session);
         }
@@ -1532,21 +1897,12 @@ CATCPSessionInfo_t *CAGetTCPSessionInfoFromEndpoint(const CAEndpoint_t *endpoint
     OIC_LOG_V(DEBUG, TAG, "Looking for [%s:%d]", endpoint->addr, endpoint->port);
 
     // get connection info from list
-    CATCPSessionInfo_t *session = NULL;
-    LL_FOREACH(g_sessionList, session)
-    {
-        if (!strncmp(session->sep.endpoint.addr, endpoint->addr,
-                     sizeof(session->sep.endpoint.addr))
-                && (session->sep.endpoint.port == endpoint->port)
-                && (session->sep.endpoint.flags & endpoint->flags))
-        {
-            OIC_LOG(DEBUG, TAG, "Found in session list");
-            return session;
-        }
-    }
+    oc_mutex_lock(g_mutexObjectList);
+    CATCPSessionInfo_t *session = u_hashmap_get(g_sessionEndpointIndex, endpoint);
+    oc_mutex_unlock(g_mutexObjectList);
 
-    OIC_LOG(DEBUG, TAG, "Session not found");
-    return NULL;
+    OIC_LOG(DEBUG, TAG, session ? "Found in session list" : "Session not found");
+    return session;
 }
 
 CASocketFd_t CAGetSocketFDFromEndpoint(const CAEndpoint_t *endpoint)
@@ -1557,23 +1913,12 @@ CASocketFd_t CAGetSocketFDFromEndpoint(const CAEndpoint_t *endpoint)
 
     // get connection info from list.
     oc_mutex_lock(g_mutexObjectList);
-    CATCPSessionInfo_t *session = NULL;
-    LL_FOREACH(g_sessionList, session)
-    {
-        if (!strncmp(session->sep.endpoint.addr, endpoint->addr,
-                     sizeof(session->sep.endpoint.addr))
-                && (session->sep.endpoint.port == endpoint->port)
-                && (session->sep.endpoint.flags & endpoint->flags))
-        {
-            oc_mutex_unlock(g_mutexObjectList);
-            OIC_LOG(DEBUG, TAG, "Found in session list");
-            return session->fd;
-        }
-    }
-
+    CATCPSessionInfo_t *session = u_hashmap_get(g_sessionEndpointIndex, endpoint);
+    CASocketFd_t fd = session ? session->fd : OC_INVALID_SOCKET;
     oc_mutex_unlock(g_mutexObjectList);
-    OIC_LOG(DEBUG, TAG, "Session not found");
-    return OC_INVALID_SOCKET;
+
+    OIC_LOG(DEBUG, TAG, session ? "Found in session list" : "Session not found");
+    return fd;
 }
 
 CAResult_t CASearchAndDeleteTCPSession(const CAEndpoint_t *endpoint)
@@ -1583,27 +1928,20 @@ CAResult_t CASearchAndDeleteTCPSession(const CAEndpoint_t *endpoint)
     OIC_LOG_V(DEBUG, TAG, "Looking for [%s:%d]", endpoint->addr, endpoint->port);
 
     // get connection info from list
-    CATCPSessionInfo_t *session = NULL;
-    CATCPSessionInfo_t *tmp = NULL;
-
     oc_mutex_lock(g_mutexObjectList);
-    LL_FOREACH_SAFE(g_sessionList, session, tmp)
+    CATCPSessionInfo_t *session = u_hashmap_get(g_sessionEndpointIndex, endpoint);
+    if (session)
     {
-        if (!strncmp(session->sep.endpoint.addr, endpoint->addr,
-                     sizeof(session->sep.endpoint.addr))
-                && (session->sep.endpoint.port == endpoint->port)
-                && (session->sep.endpoint.flags & endpoint->flags))
-        {
-            OIC_LOG(DEBUG, TAG, "Found in session list");
-            LL_DELETE(g_sessionList, session);
-            CADisconnectTCPSession(session);
-            oc_mutex_unlock(g_mutexObjectList);
-            return CA_STATUS_OK;
-        }
+        OIC_LOG(DEBUG, TAG, "Found in session list");
+        CATCPRemoveSession(session);
+        CADisconnectTCPSession(session);
+    }
+    else
+    {
+        OIC_LOG(DEBUG, TAG, "Session not found");
     }
     oc_mutex_unlock(g_mutexObjectList);
 
-    OIC_LOG(DEBUG, TAG, "Session not found");
     return CA_STATUS_OK;
 }
 
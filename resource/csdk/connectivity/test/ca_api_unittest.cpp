@@ -240,6 +240,20 @@ TEST(InitializeTest, CAInitializeTest)
     CATerminate();
 }
 
+TEST(InitializeTest, CASetSendQueueThreadsTest)
+{
+    EXPECT_EQ(CA_STATUS_INVALID_PARAM, CASetSendQueueThreads(CA_DEFAULT_ADAPTER, 0));
+    EXPECT_EQ(CA_STATUS_INVALID_PARAM,
+              CASetSendQueueThreads(CA_DEFAULT_ADAPTER, CA_MAX_SEND_THREADS + 1));
+    EXPECT_EQ(CA_STATUS_OK, CASetSendQueueThreads(CA_DEFAULT_ADAPTER, 4));
+
+    EXPECT_EQ(CA_STATUS_OK, CAInitialize(CA_DEFAULT_ADAPTER));
+    EXPECT_EQ(CA_STATUS_FAILED, CASetSendQueueThreads(CA_DEFAULT_ADAPTER, 1));
+    CATerminate();
+
+    EXPECT_EQ(CA_STATUS_OK, CASetSendQueueThreads(CA_DEFAULT_ADAPTER, 1));
+}
+
 //CATerminate TC
 TEST_F(CATests, TerminateTest)
 {
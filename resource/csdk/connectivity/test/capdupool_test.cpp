@@ -0,0 +1,114 @@
+//******************************************************************
+//
+// Copyright 2017 Open Connectivity Foundation All Rights Reserved.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+
+#include <gtest/gtest.h>
+
+#include <string.h>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "capdupool.h"
+#include "cainterface.h"
+
+class CAPDUPoolF : public testing::Test
+{
+protected:
+    virtual void SetUp()
+    {
+        CAPDUPoolResetStats();
+    }
+};
+
+TEST_F(CAPDUPoolF, ReusesBuffers)
+{
+    void *first = CAPDUPoolAlloc(COAP_MAX_PDU_SIZE);
+    ASSERT_TRUE(first != NULL);
+    memset(first, 0xa5, CA_PDU_POOL_BUFFER_SIZE);
+    CAPDUPoolFree(first);
+
+    void *second = CAPDUPoolAlloc(CA_PDU_POOL_BUFFER_SIZE);
+    EXPECT_EQ(first, second);
+    CAPDUPoolFree(second);
+
+    CAPDUPoolStats_t stats;
+    CAPDUPoolGetStats(&stats);
+    EXPECT_EQ(2u, stats.hits);
+    EXPECT_EQ(0u, stats.misses);
+}
+
+TEST_F(CAPDUPoolF, FallsBackToHeap)
+{
+    void *large = CAPDUPoolAlloc(CA_PDU_POOL_BUFFER_SIZE + 1);
+    ASSERT_TRUE(large != NULL);
+    CAPDUPoolFree(large);
+
+    std::vector<void *> buffers;
+    for (size_t i = 0; i <= CA_PDU_POOL_COUNT; i++)
+    {
+        void *buffer = CAPDUPoolAlloc(COAP_MAX_PDU_SIZE);
+        ASSERT_TRUE(buffer != NULL);
+        buffers.push_back(buffer);
+    }
+    EXPECT_EQ(buffers.size(), std::set<void *>(buffers.begin(), buffers.end()).size());
+    for (size_t i = 0; i < buffers.size(); i++)
+    {
+        CAPDUPoolFree(buffers[i]);
+    }
+
+    uint32_t hits = 0;
+    uint32_t misses = 0;
+    EXPECT_EQ(CA_STATUS_OK, CAGetPDUPoolStats(&hits, &misses));
+    // Buffers still held elsewhere in the process count as misses here.
+    EXPECT_EQ((uint32_t) CA_PDU_POOL_COUNT + 2, hits + misses);
+    EXPECT_LE(2u, misses);
+    EXPECT_EQ(CA_STATUS_INVALID_PARAM, CAGetPDUPoolStats(NULL, &misses));
+}
+
+TEST_F(CAPDUPoolF, ConcurrentUse)
+{
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++)
+    {
+        threads.push_back(std::thread([t]()
+        {
+            for (int i = 0; i < 10000; i++)
+            {
+                unsigned char *buffer = (unsigned char *) CAPDUPoolAlloc(COAP_MAX_PDU_SIZE);
+                ASSERT_TRUE(buffer != NULL);
+                memset(buffer, t, COAP_MAX_PDU_SIZE);
+                // Nobody else may use the buffer while we own it.
+                for (size_t j = 0; j < COAP_MAX_PDU_SIZE; j += 64)
+                {
+                    ASSERT_EQ(t, buffer[j]);
+                }
+                CAPDUPoolFree(buffer);
+            }
+        }));
+    }
+    for (size_t t = 0; t < threads.size(); t++)
+    {
+        threads[t].join();
+    }
+
+    CAPDUPoolStats_t stats;
+    CAPDUPoolGetStats(&stats);
+    EXPECT_EQ(40000u, stats.hits + stats.misses);
+}
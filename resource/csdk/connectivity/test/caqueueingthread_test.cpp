@@ -0,0 +1,308 @@
+//******************************************************************
+//
+// Copyright 2017 Open Connectivity Foundation All Rights Reserved.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+
+#include "iotivity_config.h"
+#include <gtest/gtest.h>
+
+#include "caqueueingthread.h"
+#include "cathreadpool.h"
+
+#include "oic_malloc.h"
+#include "oic_string.h"
+
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#define ENDPOINT_COUNT 5
+#define MESSAGE_COUNT 50
+
+// Data queued in the tests, freed by the queueing thread.
+typedef struct
+{
+    int endpoint;
+    int sequence;
+} TestData_t;
+
+static std::mutex s_mutex;
+static std::vector<int> s_sequences[ENDPOINT_COUNT];
+static std::map<int, std::thread::id> s_threads[ENDPOINT_COUNT];
+static size_t s_handled = 0;
+
+static void RecordData(void *threadData)
+{
+    TestData_t *data = (TestData_t *) threadData;
+    std::lock_guard<std::mutex> lock(s_mutex);
+    s_sequences[data->endpoint].push_back(data->sequence);
+    s_threads[data->endpoint][data->sequence] = std::this_thread::get_id();
+    s_handled++;
+}
+
+static bool WaitForHandled(size_t count)
+{
+    for (int i = 0; i < 500; i++)
+    {
+        {
+            std::lock_guard<std::mutex> lock(s_mutex);
+            if (s_handled >= count)
+            {
+                return true;
+            }
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return false;
+}
+
+class CAQueueingThreadGroupF : public testing::Test {
+public:
+    CAQueueingThreadGroupF() :
+      testing::Test(),
+      pool(NULL)
+  {
+  }
+
+protected:
+    virtual void SetUp()
+    {
+        ASSERT_EQ(CA_STATUS_OK, ca_thread_pool_init(4, &pool));
+        memset(&group, 0, sizeof(group));
+        for (int i = 0; i < ENDPOINT_COUNT; i++)
+        {
+            s_sequences[i].clear();
+            s_threads[i].clear();
+        }
+        s_handled = 0;
+    }
+
+    virtual void TearDown()
+    {
+        EXPECT_EQ(CA_STATUS_OK, CAQueueingThreadGroupStop(&group));
+        EXPECT_EQ(CA_STATUS_OK, CAQueueingThreadGroupDestroy(&group));
+        ca_thread_pool_free(pool);
+    }
+
+    static void SetEndpoint(CAEndpoint_t *endpoint, int index)
+    {
+        memset(endpoint, 0, sizeof(*endpoint));
+        endpoint->adapter = CA_ADAPTER_IP;
+        endpoint->flags = CA_IPV4;
+        OICStrcpy(endpoint->addr, sizeof(endpoint->addr), "192.168.0.1");
+        endpoint->port = (uint16_t) (5683 + index);
+    }
+
+    ca_thread_pool_t pool;
+    CAQueueingThreadGroup_t group;
+};
+
+TEST_F(CAQueueingThreadGroupF, InvalidParams)
+{
+    EXPECT_EQ(CA_STATUS_INVALID_PARAM,
+              CAQueueingThreadGroupInitialize(NULL, 1, pool, RecordData, NULL));
+    EXPECT_EQ(CA_STATUS_INVALID_PARAM,
+              CAQueueingThreadGroupInitialize(&group, 0, pool, RecordData, NULL));
+    EXPECT_EQ(CA_STATUS_INVALID_PARAM, CAQueueingThreadGroupStart(&group));
+
+    CAEndpoint_t endpoint;
+    SetEndpoint(&endpoint, 0);
+    TestData_t data = { 0, 0 };
+    EXPECT_EQ(CA_STATUS_INVALID_PARAM,
+              CAQueueingThreadGroupAddData(&group, &endpoint, &data, sizeof(data)));
+}
+
+TEST_F(CAQueueingThreadGroupF, KeepsOrderPerEndpoint)
+{
+    ASSERT_EQ(CA_STATUS_OK, CAQueueingThreadGroupInitialize(&group, 4, pool, RecordData, NULL));
+    ASSERT_EQ(CA_STATUS_OK, CAQueueingThreadGroupStart(&group));
+
+    // Interleave the messages of the endpoints.
+    for (int sequence = 0; sequence < MESSAGE_COUNT; sequence++)
+    {
+        for (int i = 0; i < ENDPOINT_COUNT; i++)
+        {
+            CAEndpoint_t endpoint;
+            SetEndpoint(&endpoint, i);
+            TestData_t *data = (TestData_t *) OICMalloc(sizeof(TestData_t));
+            ASSERT_TRUE(NULL != data);
+            data->endpoint = i;
+            data->sequence = sequence;
+            EXPECT_EQ(CA_STATUS_OK,
+                      CAQueueingThreadGroupAddData(&group, &endpoint, data, sizeof(*data)));
+        }
+    }
+
+    ASSERT_TRUE(WaitForHandled(ENDPOINT_COUNT * MESSAGE_COUNT));
+
+    std::lock_guard<std::mutex> lock(s_mutex);
+    for (int i = 0; i < ENDPOINT_COUNT; i++)
+    {
+        ASSERT_EQ((size_t) MESSAGE_COUNT, s_sequences[i].size());
+        for (int sequence = 0; sequence < MESSAGE_COUNT; sequence++)
+        {
+            EXPECT_EQ(sequence, s_sequences[i][sequence]);
+
+            // An endpoint is always served by the same thread.
+            EXPECT_EQ(s_threads[i][0], s_threads[i][sequence]);
+        }
+    }
+}
+
+TEST_F(CAQueueingThreadGroupF, DestroyFreesQueuedData)
+{
+    ASSERT_EQ(CA_STATUS_OK, CAQueueingThreadGroupInitialize(&group, 2, pool, RecordData, NULL));
+
+    // Never started, the data is released by CAQueueingThreadGroupDestroy().
+    for (int i = 0; i < ENDPOINT_COUNT; i++)
+    {
+        CAEndpoint_t endpoint;
+        SetEndpoint(&endpoint, i);
+        TestData_t *data = (TestData_t *) OICMalloc(sizeof(TestData_t));
+        ASSERT_TRUE(NULL != data);
+        data->endpoint = i;
+        data->sequence = 0;
+        EXPECT_EQ(CA_STATUS_OK,
+                  CAQueueingThreadGroupAddData(&group, &endpoint, data, sizeof(*data)));
+    }
+
+    EXPECT_EQ(CA_STATUS_OK, CAQueueingThreadGroupStop(&group));
+    EXPECT_EQ(CA_STATUS_OK, CAQueueingThreadGroupDestroy(&group));
+    EXPECT_TRUE(NULL == group.threads);
+    EXPECT_EQ(0u, s_handled);
+}
+
+#define BATCH_SIZE 8
+#define BATCH_MESSAGE_COUNT 20
+
+static std::vector<uint32_t> s_batches;
+static std::vector<int> s_freed;
+static size_t s_freedBeforeHandled = 0;
+
+static void UnexpectedData(void *)
+{
+    ADD_FAILURE() << "data passed to the task instead of the batch task";
+}
+
+static void RecordBatch(void **threadData, uint32_t count)
+{
+    {
+        std::lock_guard<std::mutex> lock(s_mutex);
+        s_batches.push_back(count);
+    }
+    for (uint32_t i = 0; i < count; i++)
+    {
+        RecordData(threadData[i]);
+    }
+}
+
+// Data stays owned by the queueing thread until the whole batch was handled.
+static void FreeData(void *threadData, uint32_t size)
+{
+    TestData_t *data = (TestData_t *) threadData;
+    EXPECT_EQ(sizeof(TestData_t), size);
+    {
+        std::lock_guard<std::mutex> lock(s_mutex);
+        std::vector<int> &handled = s_sequences[data->endpoint];
+        if (std::find(handled.begin(), handled.end(), data->sequence) == handled.end())
+        {
+            s_freedBeforeHandled++;
+        }
+        s_freed.push_back(data->sequence);
+    }
+    OICFree(data);
+}
+
+class CAQueueingThreadBatchF : public testing::Test {
+public:
+    CAQueueingThreadBatchF() :
+      testing::Test(),
+      pool(NULL)
+  {
+  }
+
+protected:
+    virtual void SetUp()
+    {
+        ASSERT_EQ(CA_STATUS_OK, ca_thread_pool_init(1, &pool));
+        ASSERT_EQ(CA_STATUS_OK,
+                  CAQueueingThreadInitialize(&thread, pool, UnexpectedData, FreeData));
+        s_sequences[0].clear();
+        s_handled = 0;
+        s_batches.clear();
+        s_freed.clear();
+        s_freedBeforeHandled = 0;
+    }
+
+    virtual void TearDown()
+    {
+        EXPECT_EQ(CA_STATUS_OK, CAQueueingThreadStop(&thread));
+        EXPECT_EQ(CA_STATUS_OK, CAQueueingThreadDestroy(&thread));
+        ca_thread_pool_free(pool);
+    }
+
+    ca_thread_pool_t pool;
+    CAQueueingThread_t thread;
+};
+
+TEST_F(CAQueueingThreadBatchF, InvalidParams)
+{
+    EXPECT_EQ(CA_STATUS_INVALID_PARAM, CAQueueingThreadSetBatchTask(NULL, RecordBatch, 1));
+    EXPECT_EQ(CA_STATUS_INVALID_PARAM, CAQueueingThreadSetBatchTask(&thread, RecordBatch, 0));
+    EXPECT_EQ(CA_STATUS_INVALID_PARAM,
+              CAQueueingThreadSetBatchTask(&thread, RecordBatch, CA_QUEUEING_THREAD_MAX_BATCH + 1));
+    EXPECT_EQ(CA_STATUS_OK,
+              CAQueueingThreadSetBatchTask(&thread, RecordBatch, CA_QUEUEING_THREAD_MAX_BATCH));
+    EXPECT_EQ(CA_STATUS_OK, CAQueueingThreadSetBatchTask(&thread, NULL, 0));
+}
+
+TEST_F(CAQueueingThreadBatchF, HandlesQueuedDataInOrderedBatches)
+{
+    ASSERT_EQ(CA_STATUS_OK, CAQueueingThreadSetBatchTask(&thread, RecordBatch, BATCH_SIZE));
+
+    // Queued before the thread starts, so the first batches are full.
+    for (int sequence = 0; sequence < BATCH_MESSAGE_COUNT; sequence++)
+    {
+        TestData_t *data = (TestData_t *) OICMalloc(sizeof(TestData_t));
+        ASSERT_TRUE(NULL != data);
+        data->endpoint = 0;
+        data->sequence = sequence;
+        EXPECT_EQ(CA_STATUS_OK, CAQueueingThreadAddData(&thread, data, sizeof(*data)));
+    }
+
+    ASSERT_EQ(CA_STATUS_OK, CAQueueingThreadStart(&thread));
+    ASSERT_TRUE(WaitForHandled(BATCH_MESSAGE_COUNT));
+    EXPECT_EQ(CA_STATUS_OK, CAQueueingThreadStop(&thread));
+
+    std::lock_guard<std::mutex> lock(s_mutex);
+    std::vector<uint32_t> batches = { BATCH_SIZE, BATCH_SIZE,
+                                      BATCH_MESSAGE_COUNT - 2 * BATCH_SIZE };
+    EXPECT_EQ(batches, s_batches);
+
+    ASSERT_EQ((size_t) BATCH_MESSAGE_COUNT, s_sequences[0].size());
+    ASSERT_EQ((size_t) BATCH_MESSAGE_COUNT, s_freed.size());
+    for (int sequence = 0; sequence < BATCH_MESSAGE_COUNT; sequence++)
+    {
+        EXPECT_EQ(sequence, s_sequences[0][sequence]);
+        EXPECT_EQ(sequence, s_freed[sequence]);
+    }
+    EXPECT_EQ(0u, s_freedBeforeHandled);
+}
@@ -0,0 +1,191 @@
+//******************************************************************
+//
+// Copyright 2017 Open Connectivity Foundation All Rights Reserved.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+
+#include "iotivity_config.h"
+#include <gtest/gtest.h>
+
+#include "caretransmission.h"
+#include "cathreadpool.h"
+
+#include "oic_malloc.h"
+
+#include <chrono>
+#include <thread>
+
+// CoAP header: version 1, type, token length 0, code, message id (network order).
+static void MakePdu(uint8_t *pdu, uint8_t type, uint8_t code, uint16_t messageId)
+{
+    pdu[0] = (uint8_t) (0x40 | (type << 4));
+    pdu[1] = code;
+    pdu[2] = (uint8_t) (messageId >> 8);
+    pdu[3] = (uint8_t) (messageId & 0xFF);
+}
+
+// The retransmission thread updates the count under the context mutex.
+static size_t DataCount(CARetransmission_t *context)
+{
+    oc_mutex_lock(context->threadMutex);
+    size_t count = context->dataCount;
+    oc_mutex_unlock(context->threadMutex);
+    return count;
+}
+
+static CAResult_t DummySend(const CAEndpoint_t *, const void *, uint32_t, CADataType_t)
+{
+    return CA_STATUS_OK;
+}
+
+class CARetransmissionF : public testing::Test {
+public:
+    CARetransmissionF() :
+      testing::Test(),
+      pool(NULL)
+  {
+  }
+
+protected:
+    virtual void SetUp()
+    {
+        ASSERT_EQ(CA_STATUS_OK, ca_thread_pool_init(1, &pool));
+        ASSERT_EQ(CA_STATUS_OK, CARetransmissionInitialize(&context, pool, DummySend,
+                                                           NULL, NULL));
+        memset(&endpoint, 0, sizeof(endpoint));
+        endpoint.adapter = CA_ADAPTER_IP;
+    }
+
+    virtual void TearDown()
+    {
+        EXPECT_EQ(CA_STATUS_OK, CARetransmissionDestroy(&context));
+        ca_thread_pool_free(pool);
+    }
+
+    CAResult_t Sent(uint16_t messageId)
+    {
+        uint8_t pdu[4];
+        MakePdu(pdu, CA_MSG_CONFIRM, 0x01, messageId);
+        return CARetransmissionSentData(&context, &endpoint, CA_REQUEST_DATA, pdu, sizeof(pdu));
+    }
+
+    void *Acked(uint16_t messageId)
+    {
+        uint8_t pdu[4];
+        void *retransmissionPdu = NULL;
+        MakePdu(pdu, CA_MSG_ACKNOWLEDGE, 0x00, messageId);
+        EXPECT_EQ(CA_STATUS_OK, CARetransmissionReceivedData(&context, &endpoint, pdu,
+                                                             sizeof(pdu), &retransmissionPdu));
+        return retransmissionPdu;
+    }
+
+    ca_thread_pool_t pool;
+    CARetransmission_t context;
+    CAEndpoint_t endpoint;
+};
+
+TEST_F(CARetransmissionF, DuplicateMessageId)
+{
+    EXPECT_EQ(CA_STATUS_OK, Sent(1));
+    EXPECT_EQ(CA_STATUS_FAILED, Sent(1));
+    EXPECT_EQ(1u, DataCount(&context));
+
+    // same message id on another adapter is a different message
+    endpoint.adapter = CA_ADAPTER_GATT_BTLE;
+    EXPECT_EQ(CA_STATUS_OK, Sent(1));
+    EXPECT_EQ(2u, DataCount(&context));
+}
+
+TEST_F(CARetransmissionF, NonConfirmableIsNotKept)
+{
+    uint8_t pdu[4];
+    MakePdu(pdu, CA_MSG_NONCONFIRM, 0x01, 1);
+    EXPECT_EQ(CA_NOT_SUPPORTED,
+              CARetransmissionSentData(&context, &endpoint, CA_REQUEST_DATA, pdu, sizeof(pdu)));
+    EXPECT_EQ(0u, DataCount(&context));
+}
+
+TEST_F(CARetransmissionF, AckRemovesMessage)
+{
+    for (uint16_t id = 1; id <= 100; id++)
+    {
+        ASSERT_EQ(CA_STATUS_OK, Sent(id));
+    }
+    EXPECT_EQ(100u, DataCount(&context));
+
+    // empty ACK gives back the acknowledged request
+    for (uint16_t id = 1; id <= 100; id += 2)
+    {
+        uint8_t *pdu = (uint8_t *) Acked(id);
+        ASSERT_TRUE(pdu != NULL);
+        EXPECT_EQ(id, (uint16_t) ((pdu[2] << 8) | pdu[3]));
+        OICFree(pdu);
+    }
+    EXPECT_EQ(50u, DataCount(&context));
+
+    // unknown message id is ignored
+    EXPECT_EQ(NULL, Acked(1));
+    EXPECT_EQ(50u, DataCount(&context));
+
+    // message id can be reused once acknowledged
+    EXPECT_EQ(CA_STATUS_OK, Sent(1));
+    EXPECT_EQ(51u, DataCount(&context));
+}
+
+static int g_timeoutCount = 0;
+
+static void CountTimeout(const CAEndpoint_t *, const void *, uint32_t)
+{
+    g_timeoutCount++;
+}
+
+TEST(CARetransmission, TimeoutWithoutPolling)
+{
+    ca_thread_pool_t pool = NULL;
+    ASSERT_EQ(CA_STATUS_OK, ca_thread_pool_init(1, &pool));
+
+    // a single try times out after the first ACK timeout (2 to 3 seconds)
+    CARetransmissionConfig_t config = { CA_ADAPTER_IP, 1 };
+    CARetransmission_t context;
+    ASSERT_EQ(CA_STATUS_OK, CARetransmissionInitialize(&context, pool, DummySend,
+                                                       CountTimeout, &config));
+    ASSERT_EQ(CA_STATUS_OK, CARetransmissionStart(&context));
+
+    CAEndpoint_t endpoint;
+    memset(&endpoint, 0, sizeof(endpoint));
+    endpoint.adapter = CA_ADAPTER_IP;
+
+    g_timeoutCount = 0;
+    for (uint16_t id = 1; id <= 3; id++)
+    {
+        uint8_t pdu[4];
+        MakePdu(pdu, CA_MSG_CONFIRM, 0x01, id);
+        ASSERT_EQ(CA_STATUS_OK, CARetransmissionSentData(&context, &endpoint, CA_REQUEST_DATA,
+                                                         pdu, sizeof(pdu)));
+    }
+
+    for (int i = 0; i < 50 && 0 != DataCount(&context); i++)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+    EXPECT_EQ(0u, DataCount(&context));
+
+    EXPECT_EQ(CA_STATUS_OK, CARetransmissionStop(&context));
+    EXPECT_EQ(3, g_timeoutCount);
+    EXPECT_EQ(CA_STATUS_OK, CARetransmissionDestroy(&context));
+    ca_thread_pool_free(pool);
+}
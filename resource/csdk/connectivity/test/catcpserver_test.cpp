@@ -0,0 +1,183 @@
+//******************************************************************
+//
+// Copyright 2017 Open Connectivity Foundation All Rights Reserved.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+
+#include "iotivity_config.h"
+#include <gtest/gtest.h>
+
+#include "cacommon.h"
+#include "catcpinterface.h"
+#include "cathreadpool.h"
+
+#include "oic_string.h"
+
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+static std::mutex s_mutex;
+static std::vector<CAEndpoint_t> s_accepted;
+static std::vector<CAEndpoint_t> s_disconnected;
+static std::vector<CAEndpoint_t> s_received;
+
+// Records the server side of the connections.
+static void ConnectionChanged(const CAEndpoint_t *endpoint, bool isConnected, bool isClient)
+{
+    if (!isClient)
+    {
+        std::lock_guard<std::mutex> lock(s_mutex);
+        (isConnected ? s_accepted : s_disconnected).push_back(*endpoint);
+    }
+}
+
+static void PacketReceived(const CASecureEndpoint_t *sep, const void *, size_t)
+{
+    std::lock_guard<std::mutex> lock(s_mutex);
+    s_received.push_back(sep->endpoint);
+}
+
+static bool WaitForEndpoints(const std::vector<CAEndpoint_t> &endpoints, size_t count)
+{
+    for (int i = 0; i < 500; i++)
+    {
+        {
+            std::lock_guard<std::mutex> lock(s_mutex);
+            if (endpoints.size() >= count)
+            {
+                return true;
+            }
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return false;
+}
+
+class CATCPServerF : public testing::Test {
+public:
+    CATCPServerF() :
+      testing::Test(),
+      pool(NULL)
+  {
+  }
+
+protected:
+    virtual void SetUp()
+    {
+        s_accepted.clear();
+        s_disconnected.clear();
+        s_received.clear();
+
+        ASSERT_EQ(CA_STATUS_OK, ca_thread_pool_init(2, &pool));
+        CATCPSetConnectionChangedCallback(ConnectionChanged);
+        CATCPSetPacketReceiveCallback(PacketReceived);
+
+        // as set by the TCP adapter, listening on ports assigned by the system.
+        SetAcceptSocket(&caglobals.tcp.ipv4);
+        SetAcceptSocket(&caglobals.tcp.ipv4s);
+        SetAcceptSocket(&caglobals.tcp.ipv6);
+        SetAcceptSocket(&caglobals.tcp.ipv6s);
+        caglobals.tcp.selectTimeout = 10;
+        caglobals.tcp.listenBacklog = 3;
+        ASSERT_EQ(CA_STATUS_OK, CATCPStartServer(pool));
+
+        SetEndpoint(&server, caglobals.tcp.ipv4.port);
+    }
+
+    virtual void TearDown()
+    {
+        CATCPStopServer();
+        CATCPSetConnectionChangedCallback(NULL);
+        CATCPSetPacketReceiveCallback(NULL);
+        ca_thread_pool_free(pool);
+    }
+
+    static void SetAcceptSocket(CASocket_t *sock)
+    {
+        sock->fd = OC_INVALID_SOCKET;
+        sock->port = 0;
+    }
+
+    static void SetEndpoint(CAEndpoint_t *endpoint, uint16_t port)
+    {
+        memset(endpoint, 0, sizeof(*endpoint));
+        endpoint->adapter = CA_ADAPTER_TCP;
+        endpoint->flags = CA_IPV4;
+        OICStrcpy(endpoint->addr, sizeof(endpoint->addr), "127.0.0.1");
+        endpoint->port = port;
+    }
+
+    ca_thread_pool_t pool;
+    CAEndpoint_t server;
+};
+
+TEST_F(CATCPServerF, SessionIndexedByEndpoint)
+{
+    CASocketFd_t fd = CAConnectTCPSession(&server);
+    ASSERT_NE(OC_INVALID_SOCKET, fd);
+    EXPECT_EQ(fd, CAGetSocketFDFromEndpoint(&server));
+    CATCPSessionInfo_t *session = CAGetTCPSessionInfoFromEndpoint(&server);
+    ASSERT_TRUE(NULL != session);
+    EXPECT_TRUE(session->isClient);
+
+    // A second connection to the endpoint uses the existing session
+    EXPECT_EQ(fd, CAConnectTCPSession(&server));
+    EXPECT_EQ(session, CAGetTCPSessionInfoFromEndpoint(&server));
+
+    // The accepted session is found by the address of the client
+    ASSERT_TRUE(WaitForEndpoints(s_accepted, 1));
+    CAEndpoint_t client = s_accepted[0];
+    session = CAGetTCPSessionInfoFromEndpoint(&client);
+    ASSERT_TRUE(NULL != session);
+    EXPECT_FALSE(session->isClient);
+
+    EXPECT_EQ(CA_STATUS_OK, CASearchAndDeleteTCPSession(&server));
+    EXPECT_TRUE(NULL == CAGetTCPSessionInfoFromEndpoint(&server));
+    EXPECT_EQ(OC_INVALID_SOCKET, CAGetSocketFDFromEndpoint(&server));
+}
+
+TEST_F(CATCPServerF, SessionIndexedBySocket)
+{
+    const char data[] = "data";
+    ASSERT_EQ((ssize_t) sizeof(data), CATCPSendData(&server, data, sizeof(data)));
+
+    // The data is read from the accepted session, looked up by its socket
+    ASSERT_TRUE(WaitForEndpoints(s_accepted, 1));
+    ASSERT_TRUE(WaitForEndpoints(s_received, 1));
+    CAEndpoint_t client = s_accepted[0];
+    EXPECT_STREQ(client.addr, s_received[0].addr);
+    EXPECT_EQ(client.port, s_received[0].port);
+
+    // The accepted session is removed when the client disconnects
+    EXPECT_EQ(CA_STATUS_OK, CASearchAndDeleteTCPSession(&server));
+    ASSERT_TRUE(WaitForEndpoints(s_disconnected, 1));
+    EXPECT_EQ(client.port, s_disconnected[0].port);
+    EXPECT_TRUE(NULL == CAGetTCPSessionInfoFromEndpoint(&client));
+}
+
+TEST_F(CATCPServerF, FailedConnectionIsRemoved)
+{
+    // The IPv6 accept socket is IPv6 only, nothing listens on its port for IPv4
+    CAEndpoint_t endpoint;
+    SetEndpoint(&endpoint, caglobals.tcp.ipv6.port);
+
+    EXPECT_EQ(OC_INVALID_SOCKET, CAConnectTCPSession(&endpoint));
+    EXPECT_TRUE(NULL == CAGetTCPSessionInfoFromEndpoint(&endpoint));
+    EXPECT_EQ(OC_INVALID_SOCKET, CAGetSocketFDFromEndpoint(&endpoint));
+}
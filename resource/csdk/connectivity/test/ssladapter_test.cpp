@@ -1900,6 +1900,8 @@ static void * test0CAinitiateSslHandshake(void * arg)
     oc_mutex_lock(g_sslContextMutex);
     g_caSslContext = (SslContext_t *)OICCalloc(1, sizeof(SslContext_t));
     g_caSslContext->peerList = u_arraylist_create();
+    g_caSslContext->peerIndex = u_hashmap_create(SslPeerHash, SslPeerMatch);
+    g_caSslContext->rndMutex = oc_mutex_new();
     mbedtls_entropy_init(&g_caSslContext->entropy);
     mbedtls_ctr_drbg_init(&g_caSslContext->rnd);
     mbedtls_ctr_drbg_seed(&g_caSslContext->rnd, mbedtls_entropy_func_clutch,
@@ -1956,10 +1958,10 @@ static void * test0CAinitiateSslHandshake(void * arg)
     predictedClientHello[13] = (unixTime << 16) >> 24;
     predictedClientHello[14] = (unixTime << 24) >> 24;
 
-    // CAcloseTlsConnection
+    // CAcloseTlsConnection, close_notify is sent once when the session is deleted
     oc_mutex_lock(g_sslContextMutex);
     SslEndPoint_t * tep = GetSslPeer(&serverAddr);
-    mbedtls_ssl_close_notify(&tep->ssl);
+    tep->closeNotify = true;
     RemovePeerFromList(&tep->sep.endpoint);
     oc_mutex_unlock(g_sslContextMutex);
 
@@ -1972,6 +1974,7 @@ static void * test0CAinitiateSslHandshake(void * arg)
     mbedtls_ssl_config_free(&g_caSslContext->serverTlsConf);
     mbedtls_ctr_drbg_free(&g_caSslContext->rnd);
     mbedtls_entropy_free(&g_caSslContext->entropy);
+    oc_mutex_free(g_caSslContext->rndMutex);
     OICFree(g_caSslContext);
     g_caSslContext = NULL;
     oc_mutex_unlock(g_sslContextMutex);
@@ -2966,6 +2969,8 @@ TEST(TLSAdapter, Test_11)
     oc_mutex_lock(g_sslContextMutex);
     g_caSslContext = (SslContext_t *)OICCalloc(1, sizeof(SslContext_t));
     g_caSslContext->peerList = u_arraylist_create();
+    g_caSslContext->peerIndex = u_hashmap_create(SslPeerHash, SslPeerMatch);
+    g_caSslContext->rndMutex = oc_mutex_new();
     mbedtls_entropy_init(&g_caSslContext->entropy);
     mbedtls_ctr_drbg_init(&g_caSslContext->rnd);
     mbedtls_ctr_drbg_seed(&g_caSslContext->rnd, mbedtls_entropy_func_clutch,
@@ -3041,6 +3046,419 @@ TEST(TLSAdapter, Test_ParseChain)
     EXPECT_EQ(0, errNum);
 }
 
+static int pkixInfoCallbackCount = 0;
+
+static void infoCallback_that_counts(PkiInfo_t * inf)
+{
+    pkixInfoCallbackCount++;
+    infoCallback_that_loads_x509(inf);
+}
+
+TEST(TLSAdapter, Test_PKIXCache)
+{
+    g_caSslContext = (SslContext_t *)OICCalloc(1, sizeof(SslContext_t));
+    ASSERT_TRUE(NULL != g_caSslContext);
+    InitConfig(&g_caSslContext->clientTlsConf,
+                        MBEDTLS_SSL_TRANSPORT_STREAM, MBEDTLS_SSL_IS_CLIENT);
+    InitConfig(&g_caSslContext->serverTlsConf,
+                        MBEDTLS_SSL_TRANSPORT_STREAM, MBEDTLS_SSL_IS_SERVER);
+    InitConfig(&g_caSslContext->clientDtlsConf,
+                        MBEDTLS_SSL_TRANSPORT_DATAGRAM, MBEDTLS_SSL_IS_CLIENT);
+    InitConfig(&g_caSslContext->serverDtlsConf,
+                        MBEDTLS_SSL_TRANSPORT_DATAGRAM, MBEDTLS_SSL_IS_SERVER);
+    mbedtls_x509_crt_init(&g_caSslContext->ca);
+    mbedtls_x509_crt_init(&g_caSslContext->crt);
+    mbedtls_pk_init(&g_caSslContext->pkey);
+    mbedtls_x509_crl_init(&g_caSslContext->crl);
+
+    pkixInfoCallbackCount = 0;
+    CAsetPkixInfoCallback(infoCallback_that_counts);
+
+    // Parsed once, then reused by the following handshakes of both transports
+    EXPECT_EQ(0, InitPKIX(CA_ADAPTER_TCP));
+    EXPECT_EQ(0, InitPKIX(CA_ADAPTER_TCP));
+    EXPECT_EQ(0, InitPKIX(CA_ADAPTER_IP));
+    EXPECT_EQ(1, pkixInfoCallbackCount);
+    EXPECT_EQ(g_caSslContext->pkixGeneration, g_caSslContext->tlsPkixGeneration);
+    EXPECT_EQ(g_caSslContext->pkixGeneration, g_caSslContext->dtlsPkixGeneration);
+
+    // A change of the credentials is picked up by the next handshake
+    CAsetPkixInfoChanged();
+    EXPECT_EQ(0, InitPKIX(CA_ADAPTER_IP));
+    EXPECT_EQ(2, pkixInfoCallbackCount);
+    EXPECT_EQ(0, g_caSslContext->tlsPkixGeneration);
+
+    g_getPkixInfoCallback = NULL;
+    mbedtls_ssl_config_free(&g_caSslContext->clientTlsConf);
+    mbedtls_ssl_config_free(&g_caSslContext->serverTlsConf);
+    mbedtls_ssl_config_free(&g_caSslContext->clientDtlsConf);
+    mbedtls_ssl_config_free(&g_caSslContext->serverDtlsConf);
+    mbedtls_x509_crt_free(&g_caSslContext->ca);
+    mbedtls_x509_crt_free(&g_caSslContext->crt);
+    mbedtls_pk_free(&g_caSslContext->pkey);
+    mbedtls_x509_crl_free(&g_caSslContext->crl);
+    OICFree(g_caSslContext);
+    g_caSslContext = NULL;
+}
+
+static void setTestSessionAddr(CAEndpoint_t * endpoint, uint16_t port)
+{
+    memset(endpoint, 0, sizeof(*endpoint));
+    endpoint->adapter = CA_ADAPTER_TCP;
+    endpoint->flags = CA_SECURE;
+    endpoint->port = port;
+    OICStrcpy(endpoint->addr, sizeof(endpoint->addr), "127.0.0.1");
+}
+
+static void addTestSslSession(const CAEndpoint_t * endpoint, int ciphersuite)
+{
+    SslSession_t * entry = &g_caSslContext->sessions[0];
+    mbedtls_ssl_session_init(&entry->session);
+    entry->session.ciphersuite = ciphersuite;
+    entry->adapter = endpoint->adapter;
+    OICStrcpy(entry->addr, sizeof(entry->addr), endpoint->addr);
+    entry->port = endpoint->port;
+    entry->lastUse = ++g_caSslContext->sessionUseCount;
+    entry->used = true;
+}
+
+static void setTestCipherSuites(SslCipher_t cipher, int first, int second)
+{
+    g_caSslContext->cipher = cipher;
+    memset(g_cipherSuitesList, 0, sizeof(g_cipherSuitesList));
+    g_cipherSuitesList[0] = first;
+    g_cipherSuitesList[1] = second;
+}
+
+// Returns whether a new client endpoint offers the cached session
+static bool isTestSessionOffered(const CAEndpoint_t * endpoint)
+{
+    SslEndPoint_t * tep = NewSslEndPoint(endpoint, &g_caSslContext->clientTlsConf);
+    if (NULL == tep)
+    {
+        return false;
+    }
+    LoadSslSession(tep);
+    bool offered = (1 == tep->ssl.handshake->resume);
+    DeleteSslEndPoint(tep);
+    return offered;
+}
+
+TEST(TLSAdapter, Test_SessionResumption)
+{
+    ASSERT_EQ(CA_STATUS_OK, CAinitSslAdapter());
+    CAEndpoint_t serverAddr;
+    setTestSessionAddr(&serverAddr, 4433);
+
+    setTestCipherSuites(SSL_ECDHE_ECDSA_WITH_AES_128_CCM,
+                        MBEDTLS_TLS_ECDHE_ECDSA_WITH_AES_128_CCM, 0);
+    addTestSslSession(&serverAddr, MBEDTLS_TLS_ECDHE_ECDSA_WITH_AES_128_CCM);
+    uint32_t lastUse = g_caSslContext->sessions[0].lastUse;
+
+    // The next connection to the same peer offers the cached session
+    EXPECT_TRUE(isTestSessionOffered(&serverAddr));
+    EXPECT_LT(lastUse, g_caSslContext->sessions[0].lastUse);
+
+    // Other peers do a full handshake
+    CAEndpoint_t otherAddr;
+    setTestSessionAddr(&otherAddr, 4434);
+    EXPECT_FALSE(isTestSessionOffered(&otherAddr));
+
+    // A session whose cipher suite is no longer configured is not offered
+    setTestCipherSuites(SSL_ECDHE_ECDSA_WITH_AES_128_CCM_8,
+                        MBEDTLS_TLS_ECDHE_ECDSA_WITH_AES_128_CCM_8, 0);
+    EXPECT_FALSE(isTestSessionOffered(&serverAddr));
+
+    // Changed credentials drop the cached sessions
+    CAsetPkixInfoChanged();
+    CheckSslSessionGeneration();
+    EXPECT_FALSE(g_caSslContext->sessions[0].used);
+
+    CAdeinitSslAdapter();
+}
+
+TEST(TLSAdapter, Test_SessionNotResumedWithPskOrAnon)
+{
+    ASSERT_EQ(CA_STATUS_OK, CAinitSslAdapter());
+    CAEndpoint_t serverAddr;
+    setTestSessionAddr(&serverAddr, 4433);
+    addTestSslSession(&serverAddr, MBEDTLS_TLS_ECDHE_ECDSA_WITH_AES_128_CCM);
+
+    // A PSK or anonymous handshake must not pick up the certificate session,
+    // even if the certificate cipher suite is configured as well
+    setTestCipherSuites(SSL_ECDHE_PSK_WITH_AES_128_CBC_SHA256,
+                        MBEDTLS_TLS_ECDHE_PSK_WITH_AES_128_CBC_SHA256,
+                        MBEDTLS_TLS_ECDHE_ECDSA_WITH_AES_128_CCM);
+    EXPECT_FALSE(isTestSessionOffered(&serverAddr));
+
+    setTestCipherSuites(SSL_ECDH_ANON_WITH_AES_128_CBC_SHA256,
+                        MBEDTLS_TLS_ECDH_ANON_WITH_AES_128_CBC_SHA256,
+                        MBEDTLS_TLS_ECDHE_ECDSA_WITH_AES_128_CCM);
+    EXPECT_FALSE(isTestSessionOffered(&serverAddr));
+
+    // Only PSK credentials are available for the peer
+    setTestCipherSuites(SSL_CIPHER_MAX, MBEDTLS_TLS_ECDHE_PSK_WITH_AES_128_CBC_SHA256, 0);
+    EXPECT_FALSE(isTestSessionOffered(&serverAddr));
+
+    // PSK and certificate credentials, no preferred cipher suite
+    setTestCipherSuites(SSL_CIPHER_MAX, MBEDTLS_TLS_ECDHE_PSK_WITH_AES_128_CBC_SHA256,
+                        MBEDTLS_TLS_ECDHE_ECDSA_WITH_AES_128_CCM);
+    EXPECT_TRUE(isTestSessionOffered(&serverAddr));
+
+    // PSK and anonymous sessions are never offered
+    addTestSslSession(&serverAddr, MBEDTLS_TLS_ECDHE_PSK_WITH_AES_128_CBC_SHA256);
+    EXPECT_FALSE(isTestSessionOffered(&serverAddr));
+
+    CAdeinitSslAdapter();
+}
+
+TEST(TLSAdapter, Test_SessionStats)
+{
+    uint32_t fullHandshakes = 0xFF;
+    uint32_t resumedHandshakes = 0xFF;
+
+    EXPECT_EQ(CA_STATUS_INVALID_PARAM, CAgetSslSessionStats(NULL, &resumedHandshakes));
+    EXPECT_EQ(CA_STATUS_INVALID_PARAM, CAgetSslSessionStats(&fullHandshakes, NULL));
+
+    ASSERT_EQ(CA_STATUS_OK, CAinitSslAdapter());
+    EXPECT_EQ(CA_STATUS_OK, CAgetSslSessionStats(&fullHandshakes, &resumedHandshakes));
+    EXPECT_EQ(0u, fullHandshakes);
+    EXPECT_EQ(0u, resumedHandshakes);
+
+    g_caSslContext->fullHandshakes = 3;
+    g_caSslContext->resumedHandshakes = 2;
+    EXPECT_EQ(CA_STATUS_OK, CAgetSslSessionStats(&fullHandshakes, &resumedHandshakes));
+    EXPECT_EQ(3u, fullHandshakes);
+    EXPECT_EQ(2u, resumedHandshakes);
+    CAdeinitSslAdapter();
+
+    // The counters start over with the next context
+    ASSERT_EQ(CA_STATUS_OK, CAinitSslAdapter());
+    EXPECT_EQ(CA_STATUS_OK, CAgetSslSessionStats(&fullHandshakes, &resumedHandshakes));
+    EXPECT_EQ(0u, fullHandshakes);
+    EXPECT_EQ(0u, resumedHandshakes);
+    CAdeinitSslAdapter();
+}
+
+#define TEST_PEER_PORT 4433
+#define TEST_PEER_COUNT 2
+#define TEST_PEER_RECORDS 200
+
+// Last record sent to and data received from each test peer
+static uint8_t g_peerRecord[TEST_PEER_COUNT][TLS_MSG_BUF_LEN];
+static size_t g_peerRecordLen[TEST_PEER_COUNT];
+static uint8_t g_peerData[TEST_PEER_COUNT][TLS_MSG_BUF_LEN];
+static size_t g_peerDataLen[TEST_PEER_COUNT];
+static int g_peerRoundTrips[TEST_PEER_COUNT];
+static int g_closeNotifyCount = 0;
+static volatile bool g_deinitDone = false;
+
+static ssize_t TestPeerSendCB(CAEndpoint_t *endpoint, const void *buf, size_t buflen)
+{
+    const uint8_t *record = (const uint8_t *)buf;
+    if (MBEDTLS_SSL_MSG_ALERT == record[0])
+    {
+        if (MBEDTLS_SSL_ALERT_MSG_CLOSE_NOTIFY == record[6])
+        {
+            g_closeNotifyCount++;
+        }
+        return (ssize_t)buflen;
+    }
+    int peer = endpoint->port - TEST_PEER_PORT;
+    memcpy(g_peerRecord[peer], buf, buflen);
+    g_peerRecordLen[peer] = buflen;
+    return (ssize_t)buflen;
+}
+
+static void TestPeerReceivedCB(const CASecureEndpoint_t *sep, const void *data, size_t dataLength)
+{
+    int peer = sep->endpoint.port - TEST_PEER_PORT;
+    memcpy(g_peerData[peer], data, dataLength);
+    g_peerDataLen[peer] = dataLength;
+}
+
+// Adds a session established without a handshake. Having no transform,
+// its records are sent and read in plain text.
+static SslEndPoint_t * addTestSslPeer(const CAEndpoint_t * endpoint)
+{
+    SslEndPoint_t * tep = NewSslEndPoint(endpoint, &g_caSslContext->clientTlsConf);
+    if (NULL == tep)
+    {
+        return NULL;
+    }
+    tep->ssl.state = MBEDTLS_SSL_HANDSHAKE_OVER;
+    tep->ssl.major_ver = MBEDTLS_SSL_MAJOR_VERSION_3;
+    tep->ssl.minor_ver = MBEDTLS_SSL_MINOR_VERSION_3;
+    tep->established = true;
+    if (!AddPeerToList(tep))
+    {
+        DeleteSslEndPoint(tep);
+        return NULL;
+    }
+    return tep;
+}
+
+static void initTestSslPeers()
+{
+    memset(g_peerRecordLen, 0, sizeof(g_peerRecordLen));
+    memset(g_peerDataLen, 0, sizeof(g_peerDataLen));
+    memset(g_peerRoundTrips, 0, sizeof(g_peerRoundTrips));
+    g_closeNotifyCount = 0;
+    CAsetSslAdapterCallbacks(TestPeerReceivedCB, TestPeerSendCB, CATCPPacketErrorCB, CA_ADAPTER_TCP);
+}
+
+// Sends records to a test peer and reads them back, counting the round trips
+static void * useTestSslPeer(void * arg)
+{
+    int peer = *((int*)arg);
+    CASecureEndpoint_t sep;
+    memset(&sep, 0, sizeof(sep));
+    setTestSessionAddr(&sep.endpoint, (uint16_t)(TEST_PEER_PORT + peer));
+
+    for (int i = 0; i < TEST_PEER_RECORDS; i++)
+    {
+        char data[32];
+        size_t dataLen = (size_t)snprintf(data, sizeof(data), "peer %d record %d", peer, i);
+        if (CA_STATUS_OK != CAencryptSsl(&sep.endpoint, data, dataLen) ||
+            CA_STATUS_OK != CAdecryptSsl(&sep, g_peerRecord[peer], g_peerRecordLen[peer]) ||
+            dataLen != g_peerDataLen[peer] ||
+            0 != memcmp(data, g_peerData[peer], dataLen))
+        {
+            break;
+        }
+        g_peerRoundTrips[peer]++;
+    }
+    return NULL;
+}
+
+static void * deinitTestSslAdapter(void *)
+{
+    CAdeinitSslAdapter();
+    g_deinitDone = true;
+    return NULL;
+}
+
+TEST(TLSAdapter, Test_PeerDeletedWithLastReference)
+{
+    ASSERT_EQ(CA_STATUS_OK, CAinitSslAdapter());
+    initTestSslPeers();
+    CAEndpoint_t serverAddr;
+    setTestSessionAddr(&serverAddr, TEST_PEER_PORT);
+
+    oc_mutex_lock(g_sslContextMutex);
+    SslEndPoint_t * tep = addTestSslPeer(&serverAddr);
+    ASSERT_TRUE(NULL != tep);
+    EXPECT_EQ(1u, tep->refCount);
+
+    // An encrypt or decrypt call takes a reference
+    AcquireSslPeer(tep);
+    EXPECT_EQ(2u, tep->refCount);
+    EXPECT_EQ(1u, g_caSslContext->peersInUse);
+    oc_mutex_unlock(g_sslContextMutex);
+
+    // Closing removes the session, which is kept until the reference is released
+    EXPECT_EQ(CA_STATUS_OK, CAcloseSslConnection(&serverAddr));
+    oc_mutex_lock(g_sslContextMutex);
+    EXPECT_TRUE(NULL == GetSslPeer(&serverAddr));
+    EXPECT_EQ(1u, tep->refCount);
+    EXPECT_TRUE(tep->closeNotify);
+    EXPECT_EQ(0, g_closeNotifyCount);
+
+    // The last reference deletes the session and sends close_notify once
+    ReleaseSslPeer(tep);
+    EXPECT_EQ(1, g_closeNotifyCount);
+    EXPECT_EQ(0u, g_caSslContext->peersInUse);
+
+    // A session not in use is deleted when it is closed
+    ASSERT_TRUE(NULL != addTestSslPeer(&serverAddr));
+    oc_mutex_unlock(g_sslContextMutex);
+    EXPECT_EQ(CA_STATUS_OK, CAcloseSslConnection(&serverAddr));
+    EXPECT_EQ(2, g_closeNotifyCount);
+
+    CAdeinitSslAdapter();
+    EXPECT_EQ(2, g_closeNotifyCount);
+}
+
+TEST(TLSAdapter, Test_DeinitWaitsForPeersInUse)
+{
+    ASSERT_EQ(CA_STATUS_OK, CAinitSslAdapter());
+    initTestSslPeers();
+    g_deinitDone = false;
+    CAEndpoint_t serverAddr;
+    setTestSessionAddr(&serverAddr, TEST_PEER_PORT);
+
+    oc_mutex_lock(g_sslContextMutex);
+    SslEndPoint_t * tep = addTestSslPeer(&serverAddr);
+    ASSERT_TRUE(NULL != tep);
+    AcquireSslPeer(tep);
+    oc_mutex_unlock(g_sslContextMutex);
+
+    pthread_t thread;
+    ASSERT_EQ(0, pthread_create(&thread, NULL, deinitTestSslAdapter, NULL));
+    sleep(1);
+
+    // The peer list is cleared, the session in use is kept until it is released
+    oc_mutex_lock(g_sslContextMutex);
+    EXPECT_FALSE(g_deinitDone);
+    ASSERT_TRUE(NULL != g_caSslContext);
+    EXPECT_EQ(0u, u_arraylist_length(g_caSslContext->peerList));
+    EXPECT_TRUE(tep->closeNotify);
+    EXPECT_EQ(0, g_closeNotifyCount);
+
+    ReleaseSslPeer(tep);
+    EXPECT_EQ(1, g_closeNotifyCount);
+    oc_mutex_unlock(g_sslContextMutex);
+
+    pthread_join(thread, NULL);
+    EXPECT_TRUE(g_deinitDone);
+    EXPECT_TRUE(NULL == g_caSslContext);
+}
+
+TEST(TLSAdapter, Test_EncryptDecryptOnTwoPeers)
+{
+    ASSERT_EQ(CA_STATUS_OK, CAinitSslAdapter());
+    initTestSslPeers();
+
+    CAEndpoint_t peerAddr[TEST_PEER_COUNT];
+    oc_mutex_lock(g_sslContextMutex);
+    for (int i = 0; i < TEST_PEER_COUNT; i++)
+    {
+        setTestSessionAddr(&peerAddr[i], (uint16_t)(TEST_PEER_PORT + i));
+        ASSERT_TRUE(NULL != addTestSslPeer(&peerAddr[i]));
+    }
+    oc_mutex_unlock(g_sslContextMutex);
+
+    // Each thread sends and reads the records of its own peer
+    pthread_t threads[TEST_PEER_COUNT];
+    int peers[TEST_PEER_COUNT];
+    for (int i = 0; i < TEST_PEER_COUNT; i++)
+    {
+        peers[i] = i;
+        ASSERT_EQ(0, pthread_create(&threads[i], NULL, useTestSslPeer, &peers[i]));
+    }
+    for (int i = 0; i < TEST_PEER_COUNT; i++)
+    {
+        pthread_join(threads[i], NULL);
+        EXPECT_EQ(TEST_PEER_RECORDS, g_peerRoundTrips[i]);
+    }
+
+    // All the references taken by the calls are released
+    oc_mutex_lock(g_sslContextMutex);
+    EXPECT_EQ(0u, g_caSslContext->peersInUse);
+    for (int i = 0; i < TEST_PEER_COUNT; i++)
+    {
+        SslEndPoint_t * tep = GetSslPeer(&peerAddr[i]);
+        ASSERT_TRUE(NULL != tep);
+        EXPECT_EQ(1u, tep->refCount);
+    }
+    oc_mutex_unlock(g_sslContextMutex);
+    EXPECT_EQ(0, g_closeNotifyCount);
+
+    // Deinit closes the established sessions
+    CAdeinitSslAdapter();
+    EXPECT_EQ(TEST_PEER_COUNT, g_closeNotifyCount);
+}
+
 TEST(TLSAdapter, TestCertsValid)
 {
     mbedtls_x509_crt cert;
@@ -0,0 +1,193 @@
+//******************************************************************
+//
+// Copyright 2017 Open Connectivity Foundation All Rights Reserved.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+
+#include <gtest/gtest.h>
+
+#include <string.h>
+#include <stdio.h>
+
+#include "uhashmap.h"
+
+typedef struct
+{
+    char name[16];
+    int value;
+} Item;
+
+static bool MatchItemName(const void *key, const void *data)
+{
+    return 0 == strcmp((const char *) key, ((const Item *) data)->name);
+}
+
+static bool CountItems(void *data, void *ctx)
+{
+    (void) data;
+    (*(size_t *) ctx)++;
+    return true;
+}
+
+class UHashMapF : public testing::Test {
+public:
+    UHashMapF() :
+      testing::Test(),
+      map(NULL)
+  {
+  }
+
+protected:
+    virtual void SetUp()
+    {
+        map = u_hashmap_create(u_hashmap_hash_string, MatchItemName);
+        ASSERT_TRUE(map != NULL);
+    }
+
+    virtual void TearDown()
+    {
+        u_hashmap_free(&map);
+        ASSERT_EQ(NULL, map);
+    }
+
+    u_hashmap_t *map;
+};
+
+TEST(UHashMap, Base)
+{
+    u_hashmap_t *map = u_hashmap_create(u_hashmap_hash_pointer, u_hashmap_match_pointer);
+    ASSERT_TRUE(map != NULL);
+    EXPECT_EQ(0u, u_hashmap_length(map));
+
+    u_hashmap_free(&map);
+    ASSERT_EQ(NULL, map);
+}
+
+TEST(UHashMap, CreateInvalid)
+{
+    EXPECT_TRUE(NULL == u_hashmap_create(NULL, u_hashmap_match_pointer));
+    EXPECT_TRUE(NULL == u_hashmap_create(u_hashmap_hash_pointer, NULL));
+}
+
+TEST(UHashMap, FreeNull)
+{
+    u_hashmap_free(NULL);
+    u_hashmap_t *map = NULL;
+    u_hashmap_free(&map);
+}
+
+TEST_F(UHashMapF, PutGet)
+{
+    Item items[1000];
+    for (int i = 0; i < 1000; ++i)
+    {
+        snprintf(items[i].name, sizeof(items[i].name), "/item/%d", i);
+        items[i].value = i;
+        ASSERT_TRUE(u_hashmap_put(map, items[i].name, &items[i]));
+    }
+    EXPECT_EQ(1000u, u_hashmap_length(map));
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        char name[16];
+        snprintf(name, sizeof(name), "/item/%d", i);
+        Item *item = (Item *) u_hashmap_get(map, name);
+        ASSERT_TRUE(item != NULL);
+        EXPECT_EQ(i, item->value);
+    }
+
+    EXPECT_TRUE(NULL == u_hashmap_get(map, "/item/1000"));
+}
+
+TEST_F(UHashMapF, PutReplaces)
+{
+    Item first = { "/a", 1 };
+    Item second = { "/a", 2 };
+    ASSERT_TRUE(u_hashmap_put(map, first.name, &first));
+    ASSERT_TRUE(u_hashmap_put(map, second.name, &second));
+    EXPECT_EQ(1u, u_hashmap_length(map));
+    EXPECT_EQ(&second, u_hashmap_get(map, "/a"));
+}
+
+TEST_F(UHashMapF, Remove)
+{
+    Item items[100];
+    for (int i = 0; i < 100; ++i)
+    {
+        snprintf(items[i].name, sizeof(items[i].name), "/item/%d", i);
+        items[i].value = i;
+        ASSERT_TRUE(u_hashmap_put(map, items[i].name, &items[i]));
+    }
+
+    for (int i = 0; i < 100; i += 2)
+    {
+        EXPECT_EQ(&items[i], u_hashmap_remove(map, items[i].name));
+    }
+    EXPECT_EQ(50u, u_hashmap_length(map));
+
+    for (int i = 0; i < 100; ++i)
+    {
+        EXPECT_EQ((i % 2) ? &items[i] : NULL, u_hashmap_get(map, items[i].name));
+    }
+
+    EXPECT_TRUE(NULL == u_hashmap_remove(map, "/item/0"));
+}
+
+TEST_F(UHashMapF, RemoveData)
+{
+    Item item = { "/a", 1 };
+    Item other = { "/a", 2 };
+    ASSERT_TRUE(u_hashmap_put(map, item.name, &item));
+
+    // only the exact data is removed
+    EXPECT_FALSE(u_hashmap_remove_data(map, other.name, &other));
+    EXPECT_EQ(1u, u_hashmap_length(map));
+    EXPECT_TRUE(u_hashmap_remove_data(map, item.name, &item));
+    EXPECT_EQ(0u, u_hashmap_length(map));
+}
+
+TEST_F(UHashMapF, ClearForeach)
+{
+    Item items[64];
+    for (int i = 0; i < 64; ++i)
+    {
+        snprintf(items[i].name, sizeof(items[i].name), "/item/%d", i);
+        ASSERT_TRUE(u_hashmap_put(map, items[i].name, &items[i]));
+    }
+
+    size_t count = 0;
+    u_hashmap_foreach(map, CountItems, &count);
+    EXPECT_EQ(64u, count);
+
+    u_hashmap_clear(map);
+    EXPECT_EQ(0u, u_hashmap_length(map));
+    EXPECT_TRUE(NULL == u_hashmap_get(map, "/item/1"));
+
+    // map is reusable after clear
+    ASSERT_TRUE(u_hashmap_put(map, items[1].name, &items[1]));
+    EXPECT_EQ(&items[1], u_hashmap_get(map, "/item/1"));
+}
+
+TEST(UHashMap, HashBytes)
+{
+    const char data[] = "abc";
+    uint32_t whole = u_hashmap_hash_bytes(data, 3, U_HASHMAP_HASH_SEED);
+    uint32_t split = u_hashmap_hash_bytes(data + 1, 2,
+                                          u_hashmap_hash_bytes(data, 1, U_HASHMAP_HASH_SEED));
+    EXPECT_EQ(whole, split);
+    EXPECT_EQ(whole, u_hashmap_hash_string(data));
+}
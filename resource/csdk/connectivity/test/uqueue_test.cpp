@@ -193,3 +193,66 @@ TEST_F(UQueueF, Reset)
 
     ASSERT_EQ(static_cast<uint32_t>(0), u_queue_get_size(queue));
 }
+
+TEST_F(UQueueF, MovePartial)
+{
+    u_queue_t *dest = u_queue_create();
+    ASSERT_TRUE(dest != NULL);
+
+    size_t values[10];
+    for (size_t i = 0; i < 10; ++i)
+    {
+        values[i] = i;
+        u_queue_message_t *message = CreateQueueMessage(&values[i], sizeof(values[i]));
+        EXPECT_EQ(CA_STATUS_OK, u_queue_add_element(queue, message));
+    }
+
+    EXPECT_EQ(static_cast<uint32_t>(4), u_queue_move_elements(dest, queue, 4));
+    EXPECT_EQ(static_cast<uint32_t>(4), u_queue_get_size(dest));
+    EXPECT_EQ(static_cast<uint32_t>(6), u_queue_get_size(queue));
+
+    // order is preserved in both queues
+    for (size_t i = 0; i < 4; ++i)
+    {
+        u_queue_message_t *value = u_queue_get_element(dest);
+        ASSERT_TRUE(value != NULL);
+        EXPECT_EQ(&values[i], value->msg);
+        OICFree(value);
+    }
+    EXPECT_EQ(&values[4], u_queue_get_head(queue)->msg);
+
+    // the source tail must still be usable after the split
+    u_queue_message_t *message = CreateQueueMessage(&values[0], sizeof(values[0]));
+    EXPECT_EQ(CA_STATUS_OK, u_queue_add_element(queue, message));
+    EXPECT_EQ(static_cast<uint32_t>(7), u_queue_get_size(queue));
+
+    EXPECT_EQ(CA_STATUS_OK, u_queue_delete(dest));
+}
+
+TEST_F(UQueueF, MoveAll)
+{
+    u_queue_t *dest = u_queue_create();
+    ASSERT_TRUE(dest != NULL);
+
+    for (size_t i = 0; i < 1000; ++i)
+    {
+        u_queue_message_t *message = CreateQueueMessage(&i, sizeof(i));
+        EXPECT_EQ(CA_STATUS_OK, u_queue_add_element(queue, message));
+    }
+
+    EXPECT_EQ(static_cast<uint32_t>(1000), u_queue_move_elements(dest, queue, 0));
+    EXPECT_EQ(static_cast<uint32_t>(0), u_queue_get_size(queue));
+    EXPECT_TRUE(u_queue_get_head(queue) == NULL);
+    EXPECT_EQ(static_cast<uint32_t>(1000), u_queue_get_size(dest));
+
+    // moving from an empty queue is a no-op
+    EXPECT_EQ(static_cast<uint32_t>(0), u_queue_move_elements(dest, queue, 0));
+
+    // source queue is reusable once emptied
+    int dummy = 0;
+    u_queue_message_t *message = CreateQueueMessage(&dummy, sizeof(dummy));
+    EXPECT_EQ(CA_STATUS_OK, u_queue_add_element(queue, message));
+    EXPECT_EQ(static_cast<uint32_t>(1), u_queue_get_size(queue));
+
+    EXPECT_EQ(CA_STATUS_OK, u_queue_delete(dest));
+}
@@ -1190,6 +1190,26 @@ typedef enum
 } OCObserveAction;
 
 
+/**
+ * How the stack lays out its databases (e.g. the SVR database) in persistent storage,
+ * see OCSetPersistentStorageLayout().
+ */
+typedef enum
+{
+    /** All resources of a database in one file, every update reads and rewrites the file. */
+    OC_PS_LAYOUT_SINGLE_FILE = 0,
+
+    /** As ::OC_PS_LAYOUT_SINGLE_FILE, but the resources are kept in memory after the first
+     *  read, so reads no longer touch the file and updates only write it. */
+    OC_PS_LAYOUT_CACHED_FILE,
+
+    /** One file per resource, named "<database>.<resource>", kept in memory after the first
+     *  read. An update only writes the file of the changed resource. A database still in a
+     *  single file is split on first use, the single file is removed once every resource
+     *  file is written. The open handler must honour the path it is given. */
+    OC_PS_LAYOUT_FILE_PER_RESOURCE
+} OCPersistentStorageLayout;
+
 /**
  * Persistent storage handlers. An APP must provide OCPersistentStorage handler pointers
  * when it calls OCRegisterPersistentStorageHandler.
@@ -1616,6 +1636,21 @@ typedef struct
     OCByteString cborPayload;
 } OCIntrospectionPayload;
 
+/**
+ * Read only view of a CBOR encoded representation, as received in the PDU.
+ * Properties are looked up in place with the OCCborView* functions of ocpayload.h
+ * without building an OCRepPayload. The view does not own the bytes. The view of a
+ * request, see OCGetRequestPayloadView(), is valid until the request is answered.
+ */
+typedef struct
+{
+    /** pointer to the first CBOR byte, NULL if there is no CBOR payload.*/
+    const uint8_t* data;
+
+    /** number of CBOR bytes.*/
+    size_t size;
+} OCCborView;
+
 /**
  * Incoming requests handled by the server. Requests are passed in as a parameter to the
  * OCEntityHandler callback API.
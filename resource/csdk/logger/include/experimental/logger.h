@@ -102,6 +102,12 @@ typedef enum {
 #define IF_OC_PRINT_LOG_LEVEL(level) \
     if (((int)OC_MINIMUM_LOG_LEVEL) <= ((int)(level & (~OC_LOG_PRIVATE_DATA))))
 
+// Messages below OC_MINIMUM_LOG_LEVEL are removed at compile time, the others are
+// checked against the level set by OCSetLogLevel() before their arguments are
+// evaluated and formatted.
+#define IF_OC_LOG_ENABLED(level) \
+    IF_OC_PRINT_LOG_LEVEL(level) if (OCLogIsEnabled(level))
+
 /**
  * Set log level and privacy log to print.
  *
@@ -110,6 +116,15 @@ typedef enum {
  */
 void OCSetLogLevel(LogLevel level, bool hidePrivateLogEntries);
 
+/**
+ * Check whether a message with the specified priority level would be logged.
+ *
+ * @param level  - DEBUG, INFO, WARNING, ERROR, FATAL plus possibly the OC_LOG_PRIVATE_DATA bit
+ *
+ * @return true if the message would be logged.
+ */
+bool OCLogIsEnabled(int level);
+
 #ifdef __TIZEN__
 /**
  * Output the contents of the specified buffer (in hex) with the specified priority level.
@@ -210,13 +225,13 @@ void OCLogBuffer(int level, const char* tag, const uint8_t* buffer, size_t buffe
 
 #define OIC_LOG_BUFFER(level, tag, buffer, bufferSize) \
     do { \
-        IF_OC_PRINT_LOG_LEVEL((level)) \
+        IF_OC_LOG_ENABLED((level)) \
             OCLogBuffer((level), (tag), (buffer), (bufferSize)); \
     } while(0)
 
 #define OIC_LOG_CA_BUFFER(level, tag, buffer, bufferSize, isHeader) \
     do { \
-        IF_OC_PRINT_LOG_LEVEL((level)) \
+        IF_OC_LOG_ENABLED((level)) \
             OCPrintCALogBuffer((level), (tag), (buffer), (bufferSize), (isHeader)); \
     } while(0)
 
@@ -224,14 +239,14 @@ void OCLogBuffer(int level, const char* tag, const uint8_t* buffer, size_t buffe
 #define OIC_LOG_SHUTDOWN()     OCLogShutdown()
 #define OIC_LOG(level, tag, logStr) \
     do { \
-        IF_OC_PRINT_LOG_LEVEL((level)) \
+        IF_OC_LOG_ENABLED((level)) \
             OCLog((level), (tag), (logStr)); \
     } while(0)
 
 // Define variable argument log function for Linux, Android, and Win32
 #define OIC_LOG_V(level, tag, ...) \
     do { \
-        IF_OC_PRINT_LOG_LEVEL((level)) \
+        IF_OC_LOG_ENABLED((level)) \
             OCLogv((level), (tag), __VA_ARGS__); \
     } while(0)
 
@@ -149,6 +149,11 @@ static bool AdjustAndVerifyLogLevel(int* level)
     return true;
 }
 
+bool OCLogIsEnabled(int level)
+{
+    return AdjustAndVerifyLogLevel(&level);
+}
+
 #ifndef ARDUINO
 
 /**
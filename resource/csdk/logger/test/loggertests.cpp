@@ -364,3 +364,17 @@ TEST(LoggerTest, LogBuffer) {
         EXPECT_STREQ(stdFileMD5, testFileMD5);
     }
 }
+
+TEST(LoggerTest, LogIsEnabled) {
+    OCSetLogLevel(WARNING, true);
+    EXPECT_FALSE(OCLogIsEnabled(INFO));
+    EXPECT_TRUE(OCLogIsEnabled(WARNING));
+    EXPECT_TRUE(OCLogIsEnabled(ERROR));
+    EXPECT_FALSE(OCLogIsEnabled(ERROR_PRIVATE));
+
+    OCSetLogLevel(DEBUG, false);
+    EXPECT_TRUE(OCLogIsEnabled(DEBUG));
+    EXPECT_TRUE(OCLogIsEnabled(DEBUG_PRIVATE));
+
+    OCSetLogLevel(DEBUG, true);
+}
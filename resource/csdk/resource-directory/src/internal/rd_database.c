@@ -119,59 +119,141 @@ static bool stringArgumentsWithinBounds(const char** arguments, size_t count)
     return true;
 }
 
-static int storeResourceTypes(const char **resourceTypes, size_t size, sqlite3_int64 rowid)
+/*
+ * Statements used to store a publish. They are prepared on first use and kept until the
+ * database is closed.
+ */
+typedef enum
 {
-    int res = SQLITE_ERROR;
-    sqlite3_stmt *stmt = NULL;
-    if (!stringArgumentsWithinBounds(resourceTypes, size))
+    RD_INSERT_DEVICE,
+    RD_UPDATE_DEVICE,
+    RD_SELECT_DEVICE,
+    RD_INSERT_LINK,
+    RD_UPDATE_LINK,
+    RD_SELECT_LINK,
+    RD_DELETE_RT,
+    RD_INSERT_RT,
+    RD_DELETE_IF,
+    RD_INSERT_IF,
+    RD_DELETE_EP,
+    RD_INSERT_EP,
+    RD_STATEMENT_COUNT
+} RDStatement;
+
+static const char *gRDStatementSql[RD_STATEMENT_COUNT] =
+{
+    /* INSERT OR IGNORE then UPDATE to update or insert the row without triggering the cascading deletes */
+    "INSERT OR IGNORE INTO RD_DEVICE_LIST (ID, di, ttl, external_host) "
+        "VALUES ((SELECT ID FROM RD_DEVICE_LIST WHERE di=@deviceId), @deviceId, @ttl, @external_host)",
+    "UPDATE RD_DEVICE_LIST SET ttl=@ttl WHERE di=@deviceId",
+    "SELECT ID FROM RD_DEVICE_LIST WHERE di=@deviceId",
+    "INSERT OR IGNORE INTO RD_DEVICE_LINK_LIST (ins, href, DEVICE_ID) "
+        "VALUES((SELECT ins FROM RD_DEVICE_LINK_LIST WHERE DEVICE_ID=@id AND href=@uri),@uri,@id)",
+    "UPDATE RD_DEVICE_LINK_LIST SET anchor=@anchor,bm=@bm WHERE DEVICE_ID=@id AND href=@uri",
+    "SELECT ins FROM RD_DEVICE_LINK_LIST WHERE DEVICE_ID=@id AND href=@uri",
+    "DELETE FROM RD_LINK_RT WHERE LINK_ID=@id",
+    "INSERT INTO RD_LINK_RT VALUES(@resourceType, @id)",
+    "DELETE FROM RD_LINK_IF WHERE LINK_ID=@id",
+    "INSERT INTO RD_LINK_IF VALUES(@interfaceType, @id)",
+    "DELETE FROM RD_LINK_EP WHERE LINK_ID=@id",
+    "INSERT INTO RD_LINK_EP VALUES(@ep, @pri, @id)"
+};
+
+static sqlite3_stmt *gRDStatements[RD_STATEMENT_COUNT];
+
+/*
+ * Get a statement, preparing it on first use. The statement belongs to the cache and must be
+ * given back with releaseStatement() rather than finalized.
+ */
+static int getStatement(RDStatement id, sqlite3_stmt **stmt)
+{
+    if (!gRDStatements[id])
     {
-        return res;
+        int res = sqlite3_prepare_v2(gRDDB, gRDStatementSql[id], -1, &gRDStatements[id], NULL);
+        if (SQLITE_OK != res)
+        {
+            return res;
+        }
     }
+    *stmt = gRDStatements[id];
+    return SQLITE_OK;
+}
 
-    VERIFY_SQLITE(sqlite3_exec(gRDDB, "SAVEPOINT storeResourceTypes", NULL, NULL, NULL));
+static void releaseStatement(sqlite3_stmt *stmt)
+{
+    if (stmt)
+    {
+        sqlite3_reset(stmt);
+        sqlite3_clear_bindings(stmt);
+    }
+}
+
+static void finalizeStatements(void)
+{
+    for (size_t i = 0; i < RD_STATEMENT_COUNT; i++)
+    {
+        sqlite3_finalize(gRDStatements[i]);
+        gRDStatements[i] = NULL;
+    }
+}
 
-    static const char deleteRT[] = "DELETE FROM RD_LINK_RT WHERE LINK_ID=@id";
-    static const char insertRT[] = "INSERT INTO RD_LINK_RT VALUES(@resourceType, @id)";
-    int deleteRTSize = (int)sizeof(deleteRT);
-    int insertRTSize = (int)sizeof(insertRT);
+/* Step a statement expected to complete in one step, and release it. */
+static int stepStatement(sqlite3_stmt *stmt)
+{
+    int res = sqlite3_step(stmt);
+    releaseStatement(stmt);
+    return (SQLITE_DONE == res) ? SQLITE_OK : res;
+}
 
-    VERIFY_SQLITE(sqlite3_prepare_v2(gRDDB, deleteRT, deleteRTSize, &stmt, NULL));
+static int deleteLinkRows(RDStatement id, sqlite3_int64 rowid)
+{
+    int res;
+    sqlite3_stmt *stmt = NULL;
+    VERIFY_SQLITE(getStatement(id, &stmt));
     VERIFY_SQLITE(sqlite3_bind_int64(stmt, sqlite3_bind_parameter_index(stmt, "@id"), rowid));
-    res = sqlite3_step(stmt);
-    if (SQLITE_DONE != res)
+    res = stepStatement(stmt);
+    stmt = NULL;
+
+exit:
+    releaseStatement(stmt);
+    return res;
+}
+
+/*
+ * The store functions below run inside the transaction of storeResources(), which rolls
+ * the whole publish back on error.
+ */
+static int storeResourceTypes(const char **resourceTypes, size_t size, sqlite3_int64 rowid)
+{
+    int res = SQLITE_ERROR;
+    sqlite3_stmt *stmt = NULL;
+    if (!stringArgumentsWithinBounds(resourceTypes, size))
     {
-        goto exit;
+        return res;
     }
-    VERIFY_SQLITE(sqlite3_finalize(stmt));
-    stmt = NULL;
+
+    VERIFY_SQLITE(deleteLinkRows(RD_DELETE_RT, rowid));
 
     for (size_t i = 0; i < size; i++)
     {
-        VERIFY_SQLITE(sqlite3_prepare_v2(gRDDB, insertRT, insertRTSize, &stmt, NULL));
+        VERIFY_SQLITE(getStatement(RD_INSERT_RT, &stmt));
         if (resourceTypes[i])
         {
             VERIFY_SQLITE(sqlite3_bind_text(stmt, sqlite3_bind_parameter_index(stmt, "@resourceType"),
                             resourceTypes[i], (int)strlen(resourceTypes[i]), SQLITE_STATIC));
             VERIFY_SQLITE(sqlite3_bind_int64(stmt, sqlite3_bind_parameter_index(stmt, "@id"), rowid));
         }
-        res = sqlite3_step(stmt);
-        if (SQLITE_DONE != res)
+        res = stepStatement(stmt);
+        stmt = NULL;
+        if (SQLITE_OK != res)
         {
             goto exit;
         }
-        VERIFY_SQLITE(sqlite3_finalize(stmt));
-        stmt = NULL;
     }
-
-    VERIFY_SQLITE(sqlite3_exec(gRDDB, "RELEASE storeResourceTypes", NULL, NULL, NULL));
     res = SQLITE_OK;
 
 exit:
-    sqlite3_finalize(stmt);
-    if (SQLITE_OK != res)
-    {
-        sqlite3_exec(gRDDB, "ROLLBACK TO storeResourceTypes", NULL, NULL, NULL);
-    }
+    releaseStatement(stmt);
     return res;
 }
 
@@ -184,50 +266,28 @@ static int storeInterfaces(const char **interfaces, size_t size, sqlite3_int64 r
         return res;
     }
 
-    VERIFY_SQLITE(sqlite3_exec(gRDDB, "SAVEPOINT storeInterfaces", NULL, NULL, NULL));
-
-    static const char deleteIF[] = "DELETE FROM RD_LINK_IF WHERE LINK_ID=@id";
-    static const char insertIF[] = "INSERT INTO RD_LINK_IF VALUES(@interfaceType, @id)";
-    int deleteIFLength = (int)sizeof(deleteIF);
-    int insertIFLength = (int)sizeof(insertIF);
-
-    VERIFY_SQLITE(sqlite3_prepare_v2(gRDDB, deleteIF, deleteIFLength, &stmt, NULL));
-    VERIFY_SQLITE(sqlite3_bind_int64(stmt, sqlite3_bind_parameter_index(stmt, "@id"), rowid));
-    res = sqlite3_step(stmt);
-    if (SQLITE_DONE != res)
-    {
-        goto exit;
-    }
-    VERIFY_SQLITE(sqlite3_finalize(stmt));
-    stmt = NULL;
+    VERIFY_SQLITE(deleteLinkRows(RD_DELETE_IF, rowid));
 
     for (size_t i = 0; i < size; i++)
     {
-        VERIFY_SQLITE(sqlite3_prepare_v2(gRDDB, insertIF, insertIFLength, &stmt, NULL));
+        VERIFY_SQLITE(getStatement(RD_INSERT_IF, &stmt));
         if (interfaces[i])
         {
             VERIFY_SQLITE(sqlite3_bind_text(stmt, sqlite3_bind_parameter_index(stmt, "@interfaceType"),
                             interfaces[i], (int)strlen(interfaces[i]), SQLITE_STATIC));
             VERIFY_SQLITE(sqlite3_bind_int64(stmt, sqlite3_bind_parameter_index(stmt, "@id"), rowid));
         }
-        res = sqlite3_step(stmt);
-        if (SQLITE_DONE != res)
+        res = stepStatement(stmt);
+        stmt = NULL;
+        if (SQLITE_OK != res)
         {
             goto exit;
         }
-        VERIFY_SQLITE(sqlite3_finalize(stmt));
-        stmt = NULL;
     }
-
-    VERIFY_SQLITE(sqlite3_exec(gRDDB, "RELEASE storeInterfaces", NULL, NULL, NULL));
     res = SQLITE_OK;
 
 exit:
-    sqlite3_finalize(stmt);
-    if (SQLITE_OK != res)
-    {
-        sqlite3_exec(gRDDB, "ROLLBACK TO storeInterfaces", NULL, NULL, NULL);
-    }
+    releaseStatement(stmt);
     return res;
 }
 
@@ -237,29 +297,16 @@ static int storeEndpoints(OCRepPayload **eps, size_t size, sqlite3_int64 rowid)
     char *ep = NULL;
     sqlite3_stmt *stmt = NULL;
 
-    VERIFY_SQLITE(sqlite3_exec(gRDDB, "SAVEPOINT storeEndpoints", NULL, NULL, NULL));
-    static const char deleteEp[] = "DELETE FROM RD_LINK_EP WHERE LINK_ID=@id";
-    static const char insertEp[] = "INSERT INTO RD_LINK_EP VALUES(@ep, @pri, @id)";
-    int deleteEpLength = (int)sizeof(deleteEp);
-    int insertEpLength = (int)sizeof(insertEp);
-
-    VERIFY_SQLITE(sqlite3_prepare_v2(gRDDB, deleteEp, deleteEpLength, &stmt, NULL));
-    VERIFY_SQLITE(sqlite3_bind_int64(stmt, sqlite3_bind_parameter_index(stmt, "@id"), rowid));
-    res = sqlite3_step(stmt);
-    if (SQLITE_DONE != res)
-    {
-        goto exit;
-    }
-    VERIFY_SQLITE(sqlite3_finalize(stmt));
-    stmt = NULL;
+    VERIFY_SQLITE(deleteLinkRows(RD_DELETE_EP, rowid));
 
     for (size_t i = 0; i < size; i++)
     {
-        VERIFY_SQLITE(sqlite3_prepare_v2(gRDDB, insertEp, insertEpLength, &stmt, NULL));
+        VERIFY_SQLITE(getStatement(RD_INSERT_EP, &stmt));
         if (OCRepPayloadGetPropString(eps[i], OC_RSRVD_ENDPOINT, &ep))
         {
             if (!stringArgumentWithinBounds(ep))
             {
+                res = SQLITE_ERROR;
                 goto exit;
             }
             VERIFY_SQLITE(sqlite3_bind_text(stmt, sqlite3_bind_parameter_index(stmt, "@ep"),
@@ -269,27 +316,20 @@ static int storeEndpoints(OCRepPayload **eps, size_t size, sqlite3_int64 rowid)
         OCRepPayloadGetPropInt(eps[i], OC_RSRVD_PRIORITY, (int64_t *) &pri);
         VERIFY_SQLITE(sqlite3_bind_int64(stmt, sqlite3_bind_parameter_index(stmt, "@pri"), pri));
         VERIFY_SQLITE(sqlite3_bind_int64(stmt, sqlite3_bind_parameter_index(stmt, "@id"), rowid));
-        res = sqlite3_step(stmt);
-        if (SQLITE_DONE != res)
+        res = stepStatement(stmt);
+        stmt = NULL;
+        if (SQLITE_OK != res)
         {
             goto exit;
         }
-        VERIFY_SQLITE(sqlite3_finalize(stmt));
-        stmt = NULL;
         OICFree(ep);
         ep = NULL;
     }
-
-    VERIFY_SQLITE(sqlite3_exec(gRDDB, "RELEASE storeEndpoints", NULL, NULL, NULL));
     res = SQLITE_OK;
 
 exit:
     OICFree(ep);
-    sqlite3_finalize(stmt);
-    if (SQLITE_OK != res)
-    {
-        sqlite3_exec(gRDDB, "ROLLBACK TO storeInterfaces", NULL, NULL, NULL);
-    }
+    releaseStatement(stmt);
     return res;
 }
 
@@ -332,20 +372,10 @@ static int storeLinkPayload(OCRepPayloadValue *links, sqlite3_int64 rowid)
     OCRepPayload** eps = NULL;
     size_t epsDim[MAX_REP_ARRAY_DEPTH] = {0};
 
-    static const char insertDeviceLLList[] = "INSERT OR IGNORE INTO RD_DEVICE_LINK_LIST (ins, href, DEVICE_ID) "
-        "VALUES((SELECT ins FROM RD_DEVICE_LINK_LIST WHERE DEVICE_ID=@id AND href=@uri),@uri,@id)";
-    static const char updateDeviceLLList[] = "UPDATE RD_DEVICE_LINK_LIST SET anchor=@anchor,bm=@bm "
-        "WHERE DEVICE_ID=@id AND href=@uri";
-    int insertDeviceLLListSize = (int)sizeof(insertDeviceLLList);
-    int updateDeviceLLListSize = (int)sizeof(updateDeviceLLList);
-
     assert(links);
     for (size_t i = 0; (SQLITE_OK == res) && (i < links->arr.dimensions[0]); i++)
     {
-        VERIFY_SQLITE(sqlite3_exec(gRDDB, "SAVEPOINT storeLinkPayload", NULL, NULL, NULL));
-
-        VERIFY_SQLITE(sqlite3_prepare_v2(gRDDB, insertDeviceLLList,
-                        insertDeviceLLListSize, &stmt, NULL));
+        VERIFY_SQLITE(getStatement(RD_INSERT_LINK, &stmt));
 
         OCRepPayload *link = links->arr.objArray[i];
         VERIFY_SQLITE(sqlite3_bind_int64(stmt, sqlite3_bind_parameter_index(stmt, "@id"), rowid));
@@ -353,21 +383,20 @@ static int storeLinkPayload(OCRepPayloadValue *links, sqlite3_int64 rowid)
         {
             if (!stringArgumentWithinBounds(uri))
             {
-                return SQLITE_ERROR;
+                res = SQLITE_ERROR;
+                goto exit;
             }
             VERIFY_SQLITE(sqlite3_bind_text(stmt, sqlite3_bind_parameter_index(stmt, "@uri"),
                             uri, (int)strlen(uri), SQLITE_STATIC));
         }
-        res = sqlite3_step(stmt);
-        if (SQLITE_DONE != res)
+        res = stepStatement(stmt);
+        stmt = NULL;
+        if (SQLITE_OK != res)
         {
             goto exit;
         }
-        VERIFY_SQLITE(sqlite3_finalize(stmt));
-        stmt = NULL;
 
-        VERIFY_SQLITE(sqlite3_prepare_v2(gRDDB, updateDeviceLLList,
-                        updateDeviceLLListSize, &stmt, NULL));
+        VERIFY_SQLITE(getStatement(RD_UPDATE_LINK, &stmt));
         VERIFY_SQLITE(sqlite3_bind_int64(stmt, sqlite3_bind_parameter_index(stmt, "@id"), rowid));
         if (uri)
         {
@@ -378,6 +407,7 @@ static int storeLinkPayload(OCRepPayloadValue *links, sqlite3_int64 rowid)
         {
             if (!stringArgumentWithinBounds(anchor))
             {
+                res = SQLITE_ERROR;
                 goto exit;
             }
             VERIFY_SQLITE(sqlite3_bind_text(stmt, sqlite3_bind_parameter_index(stmt, "@anchor"),
@@ -391,18 +421,14 @@ static int storeLinkPayload(OCRepPayloadValue *links, sqlite3_int64 rowid)
                 VERIFY_SQLITE(sqlite3_bind_int64(stmt, sqlite3_bind_parameter_index(stmt, "@bm"), bm));
             }
         }
-        res = sqlite3_step(stmt);
-        if (SQLITE_DONE != res)
+        res = stepStatement(stmt);
+        stmt = NULL;
+        if (SQLITE_OK != res)
         {
             goto exit;
         }
-        VERIFY_SQLITE(sqlite3_finalize(stmt));
-        stmt = NULL;
 
-        static const char input[] = "SELECT ins FROM RD_DEVICE_LINK_LIST WHERE DEVICE_ID=@id AND href=@uri";
-        int inputSize = (int)sizeof(input);
-
-        VERIFY_SQLITE(sqlite3_prepare_v2(gRDDB, input, inputSize, &stmt, NULL));
+        VERIFY_SQLITE(getStatement(RD_SELECT_LINK, &stmt));
         VERIFY_SQLITE(sqlite3_bind_int64(stmt, sqlite3_bind_parameter_index(stmt, "@id"), rowid));
         if (uri)
         {
@@ -413,12 +439,13 @@ static int storeLinkPayload(OCRepPayloadValue *links, sqlite3_int64 rowid)
         if (res == SQLITE_ROW || res == SQLITE_DONE)
         {
             sqlite3_int64 ins = sqlite3_column_int64(stmt, 0);
-            VERIFY_SQLITE(sqlite3_finalize(stmt));
+            releaseStatement(stmt);
             stmt = NULL;
             if (!OCRepPayloadSetPropInt(link, OC_RSRVD_INS, ins))
             {
                 OIC_LOG_V(ERROR, TAG, "Error setting 'ins' value");
-                return SQLITE_ERROR;
+                res = SQLITE_ERROR;
+                goto exit;
             }
             OCRepPayloadGetStringArray(link, OC_RSRVD_RESOURCE_TYPE, &rt, rtDim);
             OCRepPayloadGetStringArray(link, OC_RSRVD_INTERFACE, &itf, itfDim);
@@ -427,13 +454,6 @@ static int storeLinkPayload(OCRepPayloadValue *links, sqlite3_int64 rowid)
             VERIFY_SQLITE(storeInterfaces((const char **) itf, itfDim[0], ins));
             VERIFY_SQLITE(storeEndpoints(eps, epsDim[0], ins));
         }
-        else
-        {
-            VERIFY_SQLITE(sqlite3_finalize(stmt));
-            stmt = NULL;
-        }
-
-        VERIFY_SQLITE(sqlite3_exec(gRDDB, "RELEASE storeLinkPayload", NULL, NULL, NULL));
         res = SQLITE_OK;
 
     exit:
@@ -470,12 +490,8 @@ static int storeLinkPayload(OCRepPayloadValue *links, sqlite3_int64 rowid)
         anchor = NULL;
         OICFree(uri);
         uri = NULL;
-        sqlite3_finalize(stmt);
+        releaseStatement(stmt);
         stmt = NULL;
-        if (SQLITE_OK != res)
-        {
-            sqlite3_exec(gRDDB, "ROLLBACK TO storeLinkPayload", NULL, NULL, NULL);
-        }
     }
 
     return res;
@@ -490,6 +506,7 @@ static int storeResources(const OCRepPayload *payload, bool externalHost)
     OCRepPayloadGetPropString(payload, OC_RSRVD_DEVICE_ID, &deviceId);
     if (!stringArgumentNonNullAndWithinBounds(deviceId))
     {
+        OICFree(deviceId);
         return SQLITE_ERROR;
     }
 
@@ -497,6 +514,7 @@ static int storeResources(const OCRepPayload *payload, bool externalHost)
     int64_t tmp = 0;
     if (!OCRepPayloadGetPropInt(payload, OC_RSRVD_DEVICE_TTL, &tmp))
     {
+        OICFree(deviceId);
         return SQLITE_ERROR;
     }
     /* Add current time in front of the seconds received from the Publishing Device */
@@ -506,87 +524,62 @@ static int storeResources(const OCRepPayload *payload, bool externalHost)
     OCRepPayloadValue *links = getLinks(payload);
     if (!links)
     {
+        OICFree(deviceId);
         return SQLITE_ERROR;
     }
 
+    /* The whole publish is stored in one transaction, the links are not committed one by one */
     int res;
     VERIFY_SQLITE(sqlite3_exec(gRDDB, "BEGIN TRANSACTION", NULL, NULL, NULL));
 
-    /* INSERT OR IGNORE then UPDATE to update or insert the row without triggering the cascading deletes */
-    static const char insertDeviceList[] = "INSERT OR IGNORE INTO RD_DEVICE_LIST (ID, di, ttl, external_host) "
-        "VALUES ((SELECT ID FROM RD_DEVICE_LIST WHERE di=@deviceId), @deviceId, @ttl, @external_host)";
-    int insertDeviceListSize = (int)sizeof(insertDeviceList);
-    VERIFY_SQLITE(sqlite3_prepare_v2(gRDDB, insertDeviceList, insertDeviceListSize,
-                    &stmt, NULL));
-    if (deviceId)
-    {
-        VERIFY_SQLITE(sqlite3_bind_text(stmt, sqlite3_bind_parameter_index(stmt, "@deviceId"),
-                        deviceId, (int)strlen(deviceId), SQLITE_STATIC));
-    }
+    VERIFY_SQLITE(getStatement(RD_INSERT_DEVICE, &stmt));
+    VERIFY_SQLITE(sqlite3_bind_text(stmt, sqlite3_bind_parameter_index(stmt, "@deviceId"),
+                    deviceId, (int)strlen(deviceId), SQLITE_STATIC));
     if (ttl)
     {
         VERIFY_SQLITE(sqlite3_bind_int64(stmt, sqlite3_bind_parameter_index(stmt, "@ttl"), ttl));
     }
     VERIFY_SQLITE(sqlite3_bind_int64(stmt, sqlite3_bind_parameter_index(stmt, "@external_host"),
             externalHost));
-    res = sqlite3_step(stmt);
-    if (SQLITE_DONE != res)
+    res = stepStatement(stmt);
+    stmt = NULL;
+    if (SQLITE_OK != res)
     {
         goto exit;
     }
-    VERIFY_SQLITE(sqlite3_finalize(stmt));
-    stmt = NULL;
 
-    static const char updateDeviceList[] = "UPDATE RD_DEVICE_LIST SET ttl=@ttl WHERE di=@deviceId";
-    int updateDeviceListSize = (int)sizeof(updateDeviceList);
-    VERIFY_SQLITE(sqlite3_prepare_v2(gRDDB, updateDeviceList, updateDeviceListSize,
-                    &stmt, NULL));
-    if (deviceId)
-    {
-        VERIFY_SQLITE(sqlite3_bind_text(stmt, sqlite3_bind_parameter_index(stmt, "@deviceId"),
-                        deviceId, (int)strlen(deviceId), SQLITE_STATIC));
-    }
+    VERIFY_SQLITE(getStatement(RD_UPDATE_DEVICE, &stmt));
+    VERIFY_SQLITE(sqlite3_bind_text(stmt, sqlite3_bind_parameter_index(stmt, "@deviceId"),
+                    deviceId, (int)strlen(deviceId), SQLITE_STATIC));
     if (ttl)
     {
         VERIFY_SQLITE(sqlite3_bind_int64(stmt, sqlite3_bind_parameter_index(stmt, "@ttl"), ttl));
     }
-    res = sqlite3_step(stmt);
-    if (SQLITE_DONE != res)
+    res = stepStatement(stmt);
+    stmt = NULL;
+    if (SQLITE_OK != res)
     {
         goto exit;
     }
-    VERIFY_SQLITE(sqlite3_finalize(stmt));
-    stmt = NULL;
 
     /* Store the rest of the payload */
-    static const char input[] = "SELECT ID FROM RD_DEVICE_LIST WHERE di=@deviceId";
-    int inputSize = (int)sizeof(input);
-
-    VERIFY_SQLITE(sqlite3_prepare_v2(gRDDB, input, inputSize, &stmt, NULL));
-    if (deviceId)
-    {
-        VERIFY_SQLITE(sqlite3_bind_text(stmt, sqlite3_bind_parameter_index(stmt, "@deviceId"),
-                        deviceId, (int)strlen(deviceId), SQLITE_STATIC));
-    }
+    VERIFY_SQLITE(getStatement(RD_SELECT_DEVICE, &stmt));
+    VERIFY_SQLITE(sqlite3_bind_text(stmt, sqlite3_bind_parameter_index(stmt, "@deviceId"),
+                    deviceId, (int)strlen(deviceId), SQLITE_STATIC));
     res = sqlite3_step(stmt);
     if (res == SQLITE_ROW || res == SQLITE_DONE)
     {
         sqlite3_int64 rowid = sqlite3_column_int64(stmt, 0);
-        VERIFY_SQLITE(sqlite3_finalize(stmt));
+        releaseStatement(stmt);
         stmt = NULL;
         VERIFY_SQLITE(storeLinkPayload(links, rowid));
     }
-    else
-    {
-        VERIFY_SQLITE(sqlite3_finalize(stmt));
-        stmt = NULL;
-    }
 
     VERIFY_SQLITE(sqlite3_exec(gRDDB, "COMMIT", NULL, NULL, NULL));
     res = SQLITE_OK;
 
 exit:
-    sqlite3_finalize(stmt);
+    releaseStatement(stmt);
     OICFree(deviceId);
     if (SQLITE_OK != res)
     {
@@ -724,6 +717,7 @@ exit:
     }
     else
     {
+        finalizeStatements();
         sqlite3_close(gRDDB);
         gRDDB = NULL;
         return OC_STACK_ERROR;
@@ -734,6 +728,7 @@ OCStackResult OC_CALL OCRDDatabaseClose()
 {
     CHECK_DATABASE_INIT;
     int res;
+    finalizeStatements();
     VERIFY_SQLITE(sqlite3_close(gRDDB));
     gRDDB = NULL;
 
@@ -44,6 +44,21 @@ OCStackResult InitACLResource(void);
  */
 OCStackResult DeInitACLResource(void);
 
+/**
+ * This method is used by PolicyEngine to index the ACEs of the ACL.
+ *
+ * @return first ACE of the ACL, NULL if empty. The list stays valid as long as
+ *         @ref GetACLResourceVersion does not change.
+ */
+const OicSecAce_t* GetACLResourceAces(void);
+
+/**
+ * Get the version of the ACL, which changes whenever an ACE is added, removed or modified.
+ *
+ * @return version of the ACL.
+ */
+uint32_t GetACLResourceVersion(void);
+
 /**
  * This method is used by PolicyEngine to retrieve ACL for a Subject.
  *
@@ -40,6 +40,11 @@
  */
 void CheckPermission( SRMRequestContext_t *context );
 
+/**
+ * Release the index of the ACL and the cached access decisions.
+ */
+void DeInitPolicyEngine(void);
+
 /**
  * Get CRUDN permission for a method.
  *
@@ -49,6 +49,27 @@ OCStackResult ReadDatabaseFromPS(const char *databaseName, const char *resourceN
  */
 OCStackResult UpdateResourceInPS(const char *databaseName, const char *resourceName, const uint8_t *payload, size_t size);
 
+/**
+ * Prepares the cache of the ::OC_PS_LAYOUT_CACHED_FILE and ::OC_PS_LAYOUT_FILE_PER_RESOURCE
+ * layouts, called when a persistent storage handler is registered. Any database already
+ * cached is released.
+ *
+ * @return ::OC_STACK_OK for Success, otherwise some error value
+ */
+OCStackResult InitPersistentStorageInterface(void);
+
+/**
+ * Releases the cache prepared by InitPersistentStorageInterface(), called when the
+ * persistent storage handler is unregistered.
+ */
+void DeinitPersistentStorageInterface(void);
+
+/**
+ * Releases the databases kept in memory with the ::OC_PS_LAYOUT_CACHED_FILE and
+ * ::OC_PS_LAYOUT_FILE_PER_RESOURCE layouts, they are read again on next use.
+ */
+void ClearPersistentStorageCache(void);
+
 /**
  * Reads the Secure Virtual Database from PS into dynamically allocated
  * memory buffer.
@@ -89,6 +89,10 @@ static uint16_t gAceFreeId = ACE_ID_FIRST_FREE;
 
 static oc_mutex g_AceIdCounterMutex = NULL;
 
+//incremented whenever gAcl or any of its aces changes, the policy engine then drops the
+//index and the decisions it keeps for gAcl. Like gAcl, only used on the OCProcess() thread.
+static uint32_t gAclVersion = 0;
+
 typedef struct AceIdList AceIdList_t;
 
 struct AceIdList
@@ -2251,6 +2255,8 @@ OCStackResult RemoveACE(const OicUuid_t *subject, const char *resource)
 
     if (deleteFlag)
     {
+        gAclVersion++;
+
         // In case of unit test do not update persistant storage.
         if (memcmp(subject->id, &WILDCARD_SUBJECT_B64_ID, sizeof(subject->id)) == 0)
         {
@@ -2313,6 +2319,8 @@ static OCStackResult RemoveAceByAceIds(AceIdList_t *aceIdList)
 
     if (deleteFlag)
     {
+        gAclVersion++;
+
         uint8_t *payload = NULL;
         size_t size = 0;
         if (OC_STACK_OK == AclToCBORPayload(gAcl, OIC_SEC_ACL_V2, &payload, &size))
@@ -2744,6 +2752,7 @@ static OCStackResult RemoveAllAce(const char *resource)
                 FreeACE(aceItem);
             }
         }
+        gAclVersion++;
 
         //Generate empty ACL payload
         ret = AclToCBORPayload(gAcl, OIC_SEC_ACL_V2, &payload, &size);
@@ -2770,6 +2779,7 @@ static OCStackResult RemoveAllAce(const char *resource)
                 {
                     DeleteACLList(gAcl);
                     gAcl = originAcl;
+                    gAclVersion++;
                 }
                 else
                 {
@@ -2969,6 +2979,7 @@ static OCEntityHandlerResult HandleACLPostRequest(const OCEntityHandlerRequest *
                         OIC_LOG(DEBUG, TAG, "Prepending new ACE:");
                         OIC_LOG_ACE(DEBUG, insertAce);
                         LL_PREPEND(gAcl->aces, insertAce);
+                        gAclVersion++;
                     }
                     else
                     {
@@ -3076,6 +3087,7 @@ static OCEntityHandlerResult HandleACL2PostRequest(const OCEntityHandlerRequest
                             //remove old ace with the same aceid
                             LL_DELETE(gAcl->aces, existAce);
                             FreeACE(existAce);
+                            gAclVersion++;
                             break;
                         }
                     }
@@ -3090,6 +3102,7 @@ static OCEntityHandlerResult HandleACL2PostRequest(const OCEntityHandlerRequest
                     OIC_LOG(DEBUG, TAG, "Prepending new ACE:");
                     OIC_LOG_ACE(DEBUG, insertAce);
                     LL_PREPEND(gAcl->aces, insertAce);
+                    gAclVersion++;
                 }
                 else
                 {
@@ -3294,6 +3307,7 @@ static OCStackResult CreateACLResource(void)
 OCStackResult SetDefaultACL(OicSecAcl_t *acl)
 {
     gAcl = acl;
+    gAclVersion++;
     return OC_STACK_OK;
 }
 
@@ -3514,6 +3528,7 @@ OCStackResult InitACLResource(void)
         // TODO Needs to update persistent storage
     }
     VERIFY_NOT_NULL(TAG, gAcl, FATAL);
+    gAclVersion++;
 
     // Instantiate 'oic.sec.acl'
     ret = CreateACLResource();
@@ -3537,6 +3552,7 @@ OCStackResult DeInitACLResource(void)
     {
         DeleteACLList(gAcl);
         gAcl = NULL;
+        gAclVersion++;
     }
 
     oc_mutex_free(g_AceIdCounterMutex);
@@ -3545,6 +3561,16 @@ OCStackResult DeInitACLResource(void)
     return (OC_STACK_OK != ret) ? ret : ret2;
 }
 
+const OicSecAce_t* GetACLResourceAces(void)
+{
+    return gAcl ? gAcl->aces : NULL;
+}
+
+uint32_t GetACLResourceVersion(void)
+{
+    return gAclVersion;
+}
+
 const OicSecAce_t* GetACLResourceData(const OicUuid_t* subjectId, OicSecAce_t **savePtr)
 {
     OicSecAce_t *ace = NULL;
@@ -3740,6 +3766,7 @@ OCStackResult AppendACLObject(const OicSecAcl_t* acl)
     {
         gAcl->aces = acl->aces;
     }
+    gAclVersion++;
 
     OIC_LOG_ACL(INFO, gAcl);
 
@@ -3985,6 +4012,7 @@ OCStackResult UpdateDefaultSecProvACE(void)
                     LL_DELETE(gAcl->aces, ace);
                     FreeACE(ace);
                     isRemoved = true;
+                    gAclVersion++;
                 }
             }
         }
@@ -4001,6 +4029,7 @@ OCStackResult UpdateDefaultSecProvACE(void)
             if (secDefaultAce)
             {
                 LL_APPEND(gAcl->aces, secDefaultAce);
+                gAclVersion++;
 
                 size_t size = 0;
                 uint8_t *payload = NULL;
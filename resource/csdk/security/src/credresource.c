@@ -1478,6 +1478,11 @@ static bool UpdatePersistentStorage(const OicSecCred_t *cred)
     bool ret = false;
     OIC_LOG(DEBUG, TAG, "IN Cred UpdatePersistentStorage");
 
+#if defined(__WITH_DTLS__) || defined(__WITH_TLS__)
+    // Every change of gCred ends here, have the TLS adapter reload certificates.
+    CAnotifyPkixInfoChanged();
+#endif
+
     // Convert Cred data into JSON for update to persistent storage
     if (cred)
     {
@@ -2694,6 +2699,9 @@ OCStackResult InitCredResource(void)
             OIC_LOG(FATAL, TAG, "UpdatePersistentStorage failed!");
         }
     }
+#if defined(__WITH_DTLS__) || defined(__WITH_TLS__)
+    CAnotifyPkixInfoChanged();
+#endif
     //Instantiate 'oic.sec.cred'
     ret = CreateCredResource();
 
@@ -2710,6 +2718,9 @@ OCStackResult DeInitCredResource(void)
     OCStackResult result = OCDeleteResource(gCredHandle);
     DeleteCredList(gCred);
     gCred = NULL;
+#if defined(__WITH_DTLS__) || defined(__WITH_TLS__)
+    CAnotifyPkixInfoChanged();
+#endif
     return result;
 }
 
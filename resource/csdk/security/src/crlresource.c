@@ -32,6 +32,7 @@
 #include "oic_string.h"
 #include "crlresource.h"
 #include "ocpayloadcbor.h"
+#include "casecurityinterface.h"
 #include "mbedtls/base64.h"
 #include <time.h>
 
@@ -445,6 +446,7 @@ OCStackResult UpdateCRLResource(OicSecCrl_t *crl)
         OIC_LOG(ERROR, TAG, "Can't update global crl");
         return OC_STACK_ERROR;
     }
+    CAnotifyPkixInfoChanged();
 
     char currentTime[32] = {0};
     getCurrentUTCTime(currentTime, sizeof(currentTime));
@@ -696,6 +698,7 @@ OCStackResult InitCRLResource(void)
     {
         gCrl = GetCrlDefault();
     }
+    CAnotifyPkixInfoChanged();
 
     ret = CreateCRLResource();
     OICFree(data);
@@ -711,6 +714,7 @@ OCStackResult DeInitCRLResource(void)
     gCrlHandle = NULL;
     DeleteCrl(gCrl);
     gCrl = NULL;
+    CAnotifyPkixInfoChanged();
     return result;
 }
 
@@ -22,6 +22,8 @@
 
 #include "utlist.h"
 #include "oic_malloc.h"
+#include "oic_string.h"
+#include "uhashmap.h"
 #include "experimental/ocrandom.h"
 #include "policyengine.h"
 #include "resourcemanager.h"
@@ -667,80 +669,531 @@ static void ProcessMatchingACE(SRMRequestContext_t *context, const OicSecAce_t *
 }
 
 /**
- * Search for an ACE that matches the Resource URI, by conntype, subjectuuid, or roles.
- * For each matching ACE, check whether it grants permission.
- * If any ACE grants permission, set responseVal to ACCESS_GRANTED.
+ * Number of entries of the decision cache.
  */
-static void ProcessAccessRequest(SRMRequestContext_t *context)
+#define PE_DECISION_CACHE_SIZE 32
+
+/**
+ * ACE of the index with its position in the ACL.
+ */
+typedef struct PEIndexedAce
 {
-    if (NULL == context)
+    const OicSecAce_t *ace;
+    size_t position;
+} PEIndexedAce_t;
+
+/**
+ * Permission granted on an href by the ACEs of a subject.
+ */
+typedef struct PEHrefPermission
+{
+    const char *href;
+    uint16_t permission;
+} PEHrefPermission_t;
+
+/**
+ * ACEs of one subject (UUID, role or conntype) in ACL order.
+ */
+typedef struct PESubjectAces
+{
+    OicSecAceSubjectType subjectType;
+    OicUuid_t subjectUuid;
+    OicSecRole_t subjectRole;
+    OicSecConntype_t subjectConn;
+    PEIndexedAce_t *aces;
+    size_t aceCount;
+    size_t aceCapacity;
+    /**
+     * Permissions by href, and for the "*" href, granted by ACEs without validity period.
+     * A single permission found there is granted without walking the ACEs.
+     */
+    u_hashmap_t *hrefPermissions;
+    uint16_t wildcardPermission;
+} PESubjectAces_t;
+
+/**
+ * Access decision taken by the ACL.
+ */
+typedef struct PEDecision
+{
+    char *resourceUri;
+    OicUuid_t subjectUuid;
+    uint16_t requestedPermission;
+    bool secureChannel;
+    bool resourceIsOcSecure;
+    bool resourceIsOcNonsecure;
+    OicSecDiscoverable_t discoverable;
+    SRMAccessResponse_t responseVal;
+} PEDecision_t;
+
+/*
+ * The index points to the ACEs of gAcl and is rebuilt when GetACLResourceVersion() changes.
+ * Like gAcl, the index and the decisions are only used on the thread calling OCProcess():
+ * CheckPermission() runs from the SRM request handler, and the ACL is changed by its entity
+ * handler and by the provisioning calls the application makes on that thread.
+ */
+
+/** ACEs by subject, built from the ACL of g_aclIndexVersion. */
+static u_hashmap_t *g_aclIndex = NULL;
+static bool g_aclIndexValid = false;
+static uint32_t g_aclIndexVersion = 0;
+
+/** Decisions of the ACL of g_aclIndexVersion that do not depend on time or roles. */
+static PEDecision_t g_decisions[PE_DECISION_CACHE_SIZE];
+
+static uint32_t HashSubject(const void *key)
+{
+    const PESubjectAces_t *subject = (const PESubjectAces_t *)key;
+    uint32_t hash = u_hashmap_hash_bytes(&subject->subjectType, sizeof(subject->subjectType),
+                                         U_HASHMAP_HASH_SEED);
+    switch (subject->subjectType)
     {
-        OIC_LOG(ERROR, TAG, "ProcessAccessRequest(): context is NULL, returning.");
-        return;
+        case OicSecAceUuidSubject:
+            hash = u_hashmap_hash_bytes(subject->subjectUuid.id, sizeof(subject->subjectUuid.id), hash);
+            break;
+        case OicSecAceRoleSubject:
+            hash = u_hashmap_hash_bytes(subject->subjectRole.id,
+                                        strlen(subject->subjectRole.id), hash);
+            hash = u_hashmap_hash_bytes(subject->subjectRole.authority,
+                                        strlen(subject->subjectRole.authority), hash);
+            break;
+        case OicSecAceConntypeSubject:
+            hash = u_hashmap_hash_bytes(&subject->subjectConn, sizeof(subject->subjectConn), hash);
+            break;
+        default:
+            break;
     }
+    return hash;
+}
 
-    OIC_LOG_V(DEBUG, TAG, "Entering %s(%s)", __func__, context->resourceUri);
+static bool MatchSubject(const void *key, const void *data)
+{
+    const PESubjectAces_t *subject = (const PESubjectAces_t *)key;
+    const PESubjectAces_t *entry = (const PESubjectAces_t *)data;
+    if (subject->subjectType != entry->subjectType)
+    {
+        return false;
+    }
+    switch (subject->subjectType)
+    {
+        case OicSecAceUuidSubject:
+            return UuidCmp(&subject->subjectUuid, &entry->subjectUuid);
+        case OicSecAceRoleSubject:
+            return (0 == strcmp(subject->subjectRole.id, entry->subjectRole.id)) &&
+                   (0 == strcmp(subject->subjectRole.authority, entry->subjectRole.authority));
+        case OicSecAceConntypeSubject:
+            return subject->subjectConn == entry->subjectConn;
+        default:
+            return false;
+    }
+}
+
+static bool MatchHrefPermission(const void *key, const void *data)
+{
+    return 0 == strcmp((const char *)key, ((const PEHrefPermission_t *)data)->href);
+}
 
-    const OicSecAce_t *currentAce = NULL;
-    OicSecAce_t *aceSavePtr = NULL;
+static bool FreeHrefPermission(void *data, void *ctx)
+{
+    OC_UNUSED(ctx);
+    OICFree(data);
+    return true;
+}
 
-    // Start out assuming subject not found.
-    context->responseVal = ACCESS_DENIED_SUBJECT_NOT_FOUND;
+static bool FreeSubjectAces(void *data, void *ctx)
+{
+    OC_UNUSED(ctx);
+    PESubjectAces_t *subject = (PESubjectAces_t *)data;
+    if (subject->hrefPermissions)
+    {
+        u_hashmap_foreach(subject->hrefPermissions, FreeHrefPermission, NULL);
+        u_hashmap_free(&subject->hrefPermissions);
+    }
+    OICFree(subject->aces);
+    OICFree(subject);
+    return true;
+}
 
-    // First, check for a conntype ACE that matches.
-    OicSecConntype_t conntype;
-    if (context->secureChannel)
+static void ClearDecisions(void)
+{
+    for (size_t i = 0; i < PE_DECISION_CACHE_SIZE; i++)
     {
-        conntype = AUTH_CRYPT;
+        OICFree(g_decisions[i].resourceUri);
     }
-    else
+    memset(g_decisions, 0, sizeof(g_decisions));
+}
+
+static void ClearAclIndex(void)
+{
+    if (g_aclIndex)
     {
-        conntype = ANON_CLEAR;
+        u_hashmap_foreach(g_aclIndex, FreeSubjectAces, NULL);
+        u_hashmap_clear(g_aclIndex);
     }
-    do
+    g_aclIndexValid = false;
+    ClearDecisions();
+}
+
+static bool AddHrefPermission(PESubjectAces_t *subject, const char *href, uint16_t permission)
+{
+    if (0 == strcmp(WILDCARD_RESOURCE_URI, href))
     {
-        currentAce = GetACLResourceDataByConntype(conntype, &aceSavePtr);
+        subject->wildcardPermission |= permission;
+        return true;
+    }
 
-        if (NULL != currentAce)
+    if (!subject->hrefPermissions)
+    {
+        subject->hrefPermissions = u_hashmap_create(u_hashmap_hash_string, MatchHrefPermission);
+        VERIFY_NOT_NULL_RETURN(TAG, subject->hrefPermissions, ERROR, false);
+    }
+    PEHrefPermission_t *hrefPermission =
+        (PEHrefPermission_t *)u_hashmap_get(subject->hrefPermissions, href);
+    if (!hrefPermission)
+    {
+        hrefPermission = (PEHrefPermission_t *)OICCalloc(1, sizeof(PEHrefPermission_t));
+        VERIFY_NOT_NULL_RETURN(TAG, hrefPermission, ERROR, false);
+        hrefPermission->href = href;
+        if (!u_hashmap_put(subject->hrefPermissions, href, hrefPermission))
         {
-            OIC_LOG_V(DEBUG, TAG, "%s: found conntype %s match; processing for access.",
-                __func__, (AUTH_CRYPT == conntype?"auth-crypt":"anon-clear"));
-            ProcessMatchingACE(context, currentAce);
+            OICFree(hrefPermission);
+            return false;
         }
-        else
+    }
+    hrefPermission->permission |= permission;
+    return true;
+}
+
+static bool IndexAce(const OicSecAce_t *ace, size_t position)
+{
+    PESubjectAces_t key;
+    memset(&key, 0, sizeof(key));
+    key.subjectType = ace->subjectType;
+    switch (ace->subjectType)
+    {
+        case OicSecAceUuidSubject:
+            key.subjectUuid = ace->subjectuuid;
+            break;
+        case OicSecAceRoleSubject:
+            key.subjectRole = ace->subjectRole;
+            break;
+        case OicSecAceConntypeSubject:
+            key.subjectConn = ace->subjectConn;
+            break;
+        default:
+            // Never matched by a request.
+            return true;
+    }
+
+    PESubjectAces_t *subject = (PESubjectAces_t *)u_hashmap_get(g_aclIndex, &key);
+    if (!subject)
+    {
+        subject = (PESubjectAces_t *)OICMalloc(sizeof(PESubjectAces_t));
+        VERIFY_NOT_NULL_RETURN(TAG, subject, ERROR, false);
+        *subject = key;
+        if (!u_hashmap_put(g_aclIndex, subject, subject))
         {
-            OIC_LOG_V(INFO, TAG, "%s:no ACL found matching conntype %s for resource %s",
-                __func__, (AUTH_CRYPT == conntype?"auth-crypt":"anon-clear"), context->resourceUri);
+            OICFree(subject);
+            return false;
         }
-    } while ((NULL != currentAce) && !IsAccessGranted(context->responseVal));
+    }
 
-    // If not granted via conntype, try Subject-based match.
-    if (!IsAccessGranted(context->responseVal))
+    if (subject->aceCount == subject->aceCapacity)
     {
-        currentAce = NULL;
-        aceSavePtr = NULL;
-        do
+        size_t capacity = subject->aceCapacity ? (2 * subject->aceCapacity) : 4;
+        PEIndexedAce_t *aces =
+            (PEIndexedAce_t *)OICRealloc(subject->aces, capacity * sizeof(PEIndexedAce_t));
+        VERIFY_NOT_NULL_RETURN(TAG, aces, ERROR, false);
+        subject->aces = aces;
+        subject->aceCapacity = capacity;
+    }
+    subject->aces[subject->aceCount].ace = ace;
+    subject->aces[subject->aceCount].position = position;
+    subject->aceCount++;
+
+    // Whether an ACE with a validity period applies depends on the time of the request.
+    if (NULL == ace->validities)
+    {
+        const OicSecRsrc_t *rsrc = NULL;
+        LL_FOREACH(ace->resources, rsrc)
+        {
+            if ((NULL != rsrc->href) && !AddHrefPermission(subject, rsrc->href, ace->permission))
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * Build the index of the ACL again if the ACL changed since it was built.
+ *
+ * @return true if the index is up to date.
+ */
+static bool UpdateAclIndex(void)
+{
+    uint32_t version = GetACLResourceVersion();
+    if (g_aclIndexValid && (version == g_aclIndexVersion))
+    {
+        return true;
+    }
+
+    OIC_LOG_V(DEBUG, TAG, "%s: ACL changed, building index", __func__);
+    ClearAclIndex();
+    if (!g_aclIndex)
+    {
+        g_aclIndex = u_hashmap_create(HashSubject, MatchSubject);
+        VERIFY_NOT_NULL_RETURN(TAG, g_aclIndex, ERROR, false);
+    }
+
+    size_t position = 0;
+    for (const OicSecAce_t *ace = GetACLResourceAces(); NULL != ace; ace = ace->next)
+    {
+        if (!IndexAce(ace, position++))
         {
-            currentAce = GetACLResourceData(&context->subjectUuid, &aceSavePtr);
+            OIC_LOG(ERROR, TAG, "Failed to index the ACL");
+            ClearAclIndex();
+            return false;
+        }
+    }
+    g_aclIndexVersion = version;
+    g_aclIndexValid = true;
+    return true;
+}
 
-            if (NULL != currentAce)
+static const PESubjectAces_t *FindSubjectAces(const PESubjectAces_t *key)
+{
+    return (const PESubjectAces_t *)u_hashmap_get(g_aclIndex, key);
+}
+
+/**
+ * Check whether the ACEs of a subject without validity period grant the requested
+ * permission on the resource.
+ */
+static bool IsGrantedBySubjectPermissions(const SRMRequestContext_t *context,
+                                          const PESubjectAces_t *subject)
+{
+    uint16_t requested = context->requestedPermission;
+    if (0 != (requested & (requested - 1)))
+    {
+        // Several permissions must be granted by the same ACE.
+        return false;
+    }
+
+    uint16_t permission = subject->wildcardPermission;
+    if (subject->hrefPermissions)
+    {
+        const PEHrefPermission_t *hrefPermission = (const PEHrefPermission_t *)
+            u_hashmap_get(subject->hrefPermissions, context->resourceUri);
+        if (hrefPermission)
+        {
+            permission |= hrefPermission->permission;
+        }
+    }
+    return IsPermissionAllowingRequest(permission, requested);
+}
+
+/**
+ * Check the ACEs of a subject in ACL order until one grants access.
+ *
+ * @param[in,out] context   Context of the request, responseVal is updated.
+ * @param[in]     subject   ACEs of the subject, may be NULL.
+ * @param[out]    timed     Set if an ACE with a validity period was checked.
+ */
+static void ProcessSubjectAces(SRMRequestContext_t *context, const PESubjectAces_t *subject,
+                               bool *timed)
+{
+    if (NULL == subject)
+    {
+        return;
+    }
+    if (IsGrantedBySubjectPermissions(context, subject))
+    {
+        OIC_LOG_V(INFO, TAG, "%s: access granted by indexed permissions", __func__);
+        context->responseVal = ACCESS_GRANTED;
+        return;
+    }
+    for (size_t i = 0; (i < subject->aceCount) && !IsAccessGranted(context->responseVal); i++)
+    {
+        const OicSecAce_t *ace = subject->aces[i].ace;
+        if (NULL != ace->validities)
+        {
+            *timed = true;
+        }
+        ProcessMatchingACE(context, ace);
+    }
+}
+
+#if defined(__WITH_DTLS__) || defined(__WITH_TLS__)
+/**
+ * Check the ACEs of the asserted roles in ACL order until one grants access.
+ */
+static void ProcessRoleAces(SRMRequestContext_t *context, const OicSecRole_t *roles,
+                            size_t roleCount)
+{
+    const PESubjectAces_t **subjects =
+        (const PESubjectAces_t **)OICCalloc(roleCount, sizeof(PESubjectAces_t *));
+    size_t *next = (size_t *)OICCalloc(roleCount, sizeof(size_t));
+    VERIFY_NOT_NULL(TAG, subjects, ERROR);
+    VERIFY_NOT_NULL(TAG, next, ERROR);
+
+    PESubjectAces_t key;
+    memset(&key, 0, sizeof(key));
+    key.subjectType = OicSecAceRoleSubject;
+    for (size_t i = 0; i < roleCount; i++)
+    {
+        key.subjectRole = roles[i];
+        subjects[i] = FindSubjectAces(&key);
+        for (size_t j = 0; (j < i) && (NULL != subjects[i]); j++)
+        {
+            if (subjects[j] == subjects[i])
             {
-                ProcessMatchingACE(context, currentAce);
+                // Role asserted twice.
+                subjects[i] = NULL;
             }
-            else
+        }
+        if ((NULL != subjects[i]) && IsGrantedBySubjectPermissions(context, subjects[i]))
+        {
+            OIC_LOG_V(INFO, TAG, "%s: access granted by indexed permissions", __func__);
+            context->responseVal = ACCESS_GRANTED;
+            goto exit;
+        }
+    }
+
+    // Merge the ACEs of the roles back into ACL order.
+    while (!IsAccessGranted(context->responseVal))
+    {
+        size_t best = roleCount;
+        for (size_t i = 0; i < roleCount; i++)
+        {
+            if ((NULL != subjects[i]) && (next[i] < subjects[i]->aceCount) &&
+                ((roleCount == best) ||
+                 (subjects[i]->aces[next[i]].position < subjects[best]->aces[next[best]].position)))
             {
-                OIC_LOG_V(INFO, TAG, "%s:no ACL found matching subject for resource %s",
-                    __func__, context->resourceUri);
+                best = i;
             }
-        } while ((NULL != currentAce) && !IsAccessGranted(context->responseVal));
+        }
+        if (roleCount == best)
+        {
+            break;
+        }
+        ProcessMatchingACE(context, subjects[best]->aces[next[best]].ace);
+        next[best]++;
     }
 
+exit:
+    OICFree(subjects);
+    OICFree(next);
+}
+#endif /* defined(__WITH_DTLS__) || defined(__WITH_TLS__) */
+
+static PEDecision_t *GetDecisionSlot(const SRMRequestContext_t *context)
+{
+    uint32_t hash = u_hashmap_hash_bytes(context->subjectUuid.id, sizeof(context->subjectUuid.id),
+                                         U_HASHMAP_HASH_SEED);
+    hash = u_hashmap_hash_bytes(context->resourceUri, strlen(context->resourceUri), hash);
+    hash = u_hashmap_hash_bytes(&context->requestedPermission,
+                                sizeof(context->requestedPermission), hash);
+    return &g_decisions[hash % PE_DECISION_CACHE_SIZE];
+}
+
+static bool GetCachedDecision(SRMRequestContext_t *context)
+{
+    const PEDecision_t *decision = GetDecisionSlot(context);
+    if ((NULL != decision->resourceUri) &&
+        (decision->requestedPermission == context->requestedPermission) &&
+        (decision->secureChannel == context->secureChannel) &&
+        (decision->resourceIsOcSecure == context->resourceIsOcSecure) &&
+        (decision->resourceIsOcNonsecure == context->resourceIsOcNonsecure) &&
+        (decision->discoverable == context->discoverable) &&
+        UuidCmp(&decision->subjectUuid, &context->subjectUuid) &&
+        (0 == strcmp(decision->resourceUri, context->resourceUri)))
+    {
+        context->responseVal = decision->responseVal;
+        return true;
+    }
+    return false;
+}
+
+static void CacheDecision(const SRMRequestContext_t *context)
+{
+    PEDecision_t *decision = GetDecisionSlot(context);
+    OICFree(decision->resourceUri);
+    memset(decision, 0, sizeof(*decision));
+
+    decision->resourceUri = OICStrdup(context->resourceUri);
+    if (NULL == decision->resourceUri)
+    {
+        return;
+    }
+    decision->subjectUuid = context->subjectUuid;
+    decision->requestedPermission = context->requestedPermission;
+    decision->secureChannel = context->secureChannel;
+    decision->resourceIsOcSecure = context->resourceIsOcSecure;
+    decision->resourceIsOcNonsecure = context->resourceIsOcNonsecure;
+    decision->discoverable = context->discoverable;
+    decision->responseVal = context->responseVal;
+}
+
+void DeInitPolicyEngine(void)
+{
+    ClearAclIndex();
+    u_hashmap_free(&g_aclIndex);
+}
+
+/**
+ * Search for an ACE that matches the Resource URI, by conntype, subjectuuid, or roles.
+ * For each matching ACE, check whether it grants permission.
+ * If any ACE grants permission, set responseVal to ACCESS_GRANTED.
+ */
+static void ProcessAccessRequest(SRMRequestContext_t *context)
+{
+    if (NULL == context)
+    {
+        OIC_LOG(ERROR, TAG, "ProcessAccessRequest(): context is NULL, returning.");
+        return;
+    }
+
+    OIC_LOG_V(DEBUG, TAG, "Entering %s(%s)", __func__, context->resourceUri);
+
+    if (!UpdateAclIndex())
+    {
+        context->responseVal = ACCESS_DENIED_POLICY_ENGINE_ERROR;
+        return;
+    }
+    if (GetCachedDecision(context))
+    {
+        OIC_LOG_V(INFO, TAG, "%s: returning cached responseVal = %s", __func__,
+            IsAccessGranted(context->responseVal) ? "ACCESS_GRANTED" : "ACCESS_DENIED");
+        return;
+    }
+
+    // Start out assuming subject not found.
+    context->responseVal = ACCESS_DENIED_SUBJECT_NOT_FOUND;
+    bool timed = false;
+
+    PESubjectAces_t key;
+    memset(&key, 0, sizeof(key));
+
+    // First, check for a conntype ACE that matches.
+    key.subjectType = OicSecAceConntypeSubject;
+    key.subjectConn = context->secureChannel ? AUTH_CRYPT : ANON_CLEAR;
+    ProcessSubjectAces(context, FindSubjectAces(&key), &timed);
+
+    // If not granted via conntype, try Subject-based match.
+    if (!IsAccessGranted(context->responseVal))
+    {
+        key.subjectType = OicSecAceUuidSubject;
+        key.subjectUuid = context->subjectUuid;
+        ProcessSubjectAces(context, FindSubjectAces(&key), &timed);
+    }
+
+    bool cacheable = !timed;
 #if defined(__WITH_DTLS__) || defined(__WITH_TLS__)
     // If no subject ACE granted access, try role ACEs.
     if (!IsAccessGranted(context->responseVal))
     {
-        currentAce = NULL;
-        aceSavePtr = NULL;
         OicSecRole_t *roles = NULL;
         size_t roleCount = 0;
         OCStackResult res = GetEndpointRoles(context->endPoint, &roles, &roleCount);
@@ -751,25 +1204,23 @@ static void ProcessAccessRequest(SRMRequestContext_t *context)
         else
         {
             OIC_LOG_V(DEBUG, TAG, "Found %u asserted roles for endpoint", (unsigned int) roleCount);
-            do
+            if (0 < roleCount)
             {
-                currentAce = GetACLResourceDataByRoles(roles, roleCount, &aceSavePtr);
-                if (NULL != currentAce)
-                {
-                    ProcessMatchingACE(context, currentAce);
-                }
-                else
-                {
-                    OIC_LOG_V(INFO, TAG, "%s:no ACL found matching roles for resource %s",
-                        __func__, context->resourceUri);
-                }
-            } while ((NULL != currentAce) && !IsAccessGranted(context->responseVal));
-
+                ProcessRoleAces(context, roles, roleCount);
+            }
             OICFree(roles);
         }
+
+        // The roles asserted by the endpoint change over time.
+        cacheable = false;
     }
 #endif /* defined(__WITH_DTLS__) || defined(__WITH_TLS__) */
 
+    if (cacheable)
+    {
+        CacheDecision(context);
+    }
+
     OIC_LOG_V(INFO, TAG, "%s: returning with responseVal = %s", __func__,
         IsAccessGranted(context->responseVal) ? "ACCESS_GRANTED" : "ACCESS_DENIED");
     return;
@@ -28,6 +28,9 @@
 #include "ocpayloadcbor.h"
 #include "ocstack.h"
 #include "oic_malloc.h"
+#include "oic_string.h"
+#include "octhread.h"
+#include "utlist.h"
 #include "experimental/payload_logging.h"
 #include "resourcemanager.h"
 #include "secureresourcemanager.h"
@@ -139,22 +142,12 @@ static size_t GetDatabaseSize(const OCPersistentStorage *ps, const char *databas
 }
 
 /**
- * Reads the database from PS
- * 
- * @note Caller of this method MUST use OICFree() method to release memory
- *       referenced by the data argument.
- *
- * @param databaseName is the name of the database to access through persistent storage.
- * @param resourceName is the name of the field for which file content are read.
- *                     if the value is NULL it will send the content of the whole file.
- * @param data         is the pointer to the file contents read from the database.
- * @param size         is the size of the file contents read.
- *
- * @return ::OC_STACK_OK for Success, otherwise some error value
+ * Reads the database from its file in PS, see ReadDatabaseFromPS().
  */
-OCStackResult ReadDatabaseFromPS(const char *databaseName, const char *resourceName, uint8_t **data, size_t *size)
+static OCStackResult ReadDatabaseFromFile(const char *databaseName, const char *resourceName,
+                                          uint8_t **data, size_t *size)
 {
-    OIC_LOG(DEBUG, TAG, "ReadDatabaseFromPS IN");
+    OIC_LOG(DEBUG, TAG, "ReadDatabaseFromFile IN");
 
     if (!databaseName || !data || *data || !size)
     {
@@ -206,7 +199,7 @@ OCStackResult ReadDatabaseFromPS(const char *databaseName, const char *resourceN
             }
         }
     }
-    OIC_LOG(DEBUG, TAG, "ReadDatabaseFromPS OUT");
+    OIC_LOG(DEBUG, TAG, "ReadDatabaseFromFile OUT");
 
 exit:
     if (fp)
@@ -218,18 +211,12 @@ exit:
 }
 
 /**
- * This method updates the database in PS
- *
- * @param databaseName  is the name of the database to access through persistent storage.
- * @param resourceName  is the name of the resource that will be updated.
- * @param payload       is the pointer to memory where the CBOR payload is located.
- * @param size          is the size of the CBOR payload.
- *
- * @return ::OC_STACK_OK for Success, otherwise some error value
+ * Updates the resource in the database file in PS, see UpdateResourceInPS().
  */
-OCStackResult UpdateResourceInPS(const char *databaseName, const char *resourceName, const uint8_t *payload, size_t size)
+static OCStackResult UpdateResourceInFile(const char *databaseName, const char *resourceName,
+                                          const uint8_t *payload, size_t size)
 {
-    OIC_LOG(DEBUG, TAG, "UpdateResourceInPS IN");
+    OIC_LOG(DEBUG, TAG, "UpdateResourceInFile IN");
     if (!databaseName || !resourceName)
     {
         return OC_STACK_INVALID_PARAM;
@@ -250,7 +237,7 @@ OCStackResult UpdateResourceInPS(const char *databaseName, const char *resourceN
     uint8_t *dpCbor = NULL;
 
     int64_t cborEncoderResult = CborNoError;
-    OCStackResult ret = ReadDatabaseFromPS(databaseName, NULL, &dbData, &dbSize);
+    OCStackResult ret = ReadDatabaseFromFile(databaseName, NULL, &dbData, &dbSize);
     if (dbData && dbSize)
     {
         PSDatabase database = PS_DATABASE_SECURITY;
@@ -476,7 +463,7 @@ OCStackResult UpdateResourceInPS(const char *databaseName, const char *resourceN
     ret = WritePayloadToPS(databaseName, outPayload, outSize);
     VERIFY_SUCCESS(TAG, (OC_STACK_OK == ret), ERROR);
 
-    OIC_LOG(DEBUG, TAG, "UpdateResourceInPS OUT");
+    OIC_LOG(DEBUG, TAG, "UpdateResourceInFile OUT");
 
 exit:
     OICFree(dbData);
@@ -492,6 +479,653 @@ exit:
     return ret;
 }
 
+/**
+ * Maximum number of resources kept in a database.
+ */
+#define PS_MAX_DATABASE_RESOURCES 7
+
+/**
+ * Resource of a database kept in memory.
+ */
+typedef struct PSCachedResource
+{
+    char *name;
+    uint8_t *data;
+    size_t size;
+    struct PSCachedResource *next;
+} PSCachedResource;
+
+/**
+ * Database kept in memory with the OC_PS_LAYOUT_CACHED_FILE and
+ * OC_PS_LAYOUT_FILE_PER_RESOURCE layouts.
+ */
+typedef struct PSCachedDatabase
+{
+    char *name;
+    PSCachedResource *resources;
+    struct PSCachedDatabase *next;
+} PSCachedDatabase;
+
+static PSCachedDatabase *g_cachedDatabases = NULL;
+
+/**
+ * Handler and layout the cached databases were read with.
+ */
+static const OCPersistentStorage *g_cacheHandler = NULL;
+static OCPersistentStorageLayout g_cacheLayout = OC_PS_LAYOUT_SINGLE_FILE;
+
+/**
+ * Guards the cached databases, handler and layout above, PS is accessed from the stack
+ * and from the provisioning threads. Exists while a handler is registered, the cached
+ * layouts are only used then.
+ */
+static oc_mutex g_cacheMutex = NULL;
+
+/**
+ * Gets the resources kept in a database, any other entry is dropped when the database
+ * is rewritten.
+ *
+ * @param databaseName is the name of the database.
+ * @param resources    is filled with the names of the resources.
+ *
+ * @return number of resources.
+ */
+static size_t GetDatabaseResources(const char *databaseName,
+                                   const char *resources[PS_MAX_DATABASE_RESOURCES])
+{
+    if (0 == strcmp(OC_DEVICE_PROPS_FILE_NAME, databaseName))
+    {
+        resources[0] = OC_JSON_DEVICE_PROPS_NAME;
+        return 1;
+    }
+
+    resources[0] = OIC_JSON_ACL_NAME;
+    resources[1] = OIC_JSON_PSTAT_NAME;
+    resources[2] = OIC_JSON_DOXM_NAME;
+    resources[3] = OIC_JSON_AMACL_NAME;
+    resources[4] = OIC_JSON_CRED_NAME;
+    resources[5] = OIC_JSON_RESET_PF_NAME;
+    resources[6] = OIC_JSON_CRL_NAME;
+    return 7;
+}
+
+static void FreeCachedResource(PSCachedResource *resource)
+{
+    if (resource)
+    {
+        OICFree(resource->name);
+        OICFree(resource->data);
+        OICFree(resource);
+    }
+}
+
+static void FreeCachedResources(PSCachedDatabase *database)
+{
+    PSCachedResource *resource = NULL;
+    PSCachedResource *tmp = NULL;
+    LL_FOREACH_SAFE(database->resources, resource, tmp)
+    {
+        LL_DELETE(database->resources, resource);
+        FreeCachedResource(resource);
+    }
+}
+
+static void FreeCachedDatabase(PSCachedDatabase *database)
+{
+    if (database)
+    {
+        FreeCachedResources(database);
+        OICFree(database->name);
+        OICFree(database);
+    }
+}
+
+static void FreeCachedDatabases(void)
+{
+    PSCachedDatabase *database = NULL;
+    PSCachedDatabase *tmp = NULL;
+    LL_FOREACH_SAFE(g_cachedDatabases, database, tmp)
+    {
+        LL_DELETE(g_cachedDatabases, database);
+        FreeCachedDatabase(database);
+    }
+    g_cacheHandler = NULL;
+    g_cacheLayout = OC_PS_LAYOUT_SINGLE_FILE;
+}
+
+void ClearPersistentStorageCache(void)
+{
+    // Nothing is cached without a registered handler.
+    if (NULL == g_cacheMutex)
+    {
+        return;
+    }
+
+    oc_mutex_lock(g_cacheMutex);
+    FreeCachedDatabases();
+    oc_mutex_unlock(g_cacheMutex);
+}
+
+OCStackResult InitPersistentStorageInterface(void)
+{
+    if (NULL == g_cacheMutex)
+    {
+        g_cacheMutex = oc_mutex_new();
+        if (NULL == g_cacheMutex)
+        {
+            OIC_LOG(ERROR, TAG, "Failed to create the cache mutex");
+            return OC_STACK_NO_MEMORY;
+        }
+    }
+
+    ClearPersistentStorageCache();
+    return OC_STACK_OK;
+}
+
+void DeinitPersistentStorageInterface(void)
+{
+    if (NULL != g_cacheMutex)
+    {
+        FreeCachedDatabases();
+        oc_mutex_free(g_cacheMutex);
+        g_cacheMutex = NULL;
+    }
+}
+
+static PSCachedResource *FindCachedResource(const PSCachedDatabase *database,
+                                            const char *resourceName)
+{
+    PSCachedResource *resource = NULL;
+    LL_FOREACH(database->resources, resource)
+    {
+        if (0 == strcmp(resource->name, resourceName))
+        {
+            break;
+        }
+    }
+    return resource;
+}
+
+/**
+ * Sets a resource of the cached database.
+ *
+ * @param database     is the cached database.
+ * @param resourceName is the name of the resource.
+ * @param data         is the CBOR payload of the resource, owned by the cache from now on.
+ *                     If NULL the resource is removed.
+ * @param size         is the size of the CBOR payload.
+ *
+ * @return ::OC_STACK_OK for Success, otherwise some error value
+ */
+static OCStackResult SetCachedResource(PSCachedDatabase *database, const char *resourceName,
+                                       uint8_t *data, size_t size)
+{
+    PSCachedResource *resource = FindCachedResource(database, resourceName);
+    if (!data || !size)
+    {
+        OICFree(data);
+        if (resource)
+        {
+            LL_DELETE(database->resources, resource);
+            FreeCachedResource(resource);
+        }
+        return OC_STACK_OK;
+    }
+
+    if (!resource)
+    {
+        resource = (PSCachedResource *) OICCalloc(1, sizeof(PSCachedResource));
+        if (resource)
+        {
+            resource->name = OICStrdup(resourceName);
+        }
+        if (!resource || !resource->name)
+        {
+            OIC_LOG(ERROR, TAG, "Failed to allocate cached resource");
+            OICFree(resource);
+            OICFree(data);
+            return OC_STACK_NO_MEMORY;
+        }
+        LL_APPEND(database->resources, resource);
+    }
+    OICFree(resource->data);
+    resource->data = data;
+    resource->size = size;
+    return OC_STACK_OK;
+}
+
+static uint8_t *DuplicatePayload(const uint8_t *payload, size_t size)
+{
+    uint8_t *copy = (uint8_t *) OICMalloc(size);
+    if (copy)
+    {
+        memcpy(copy, payload, size);
+    }
+    return copy;
+}
+
+/**
+ * Adds the resources of a database read as a single CBOR map to the cached database.
+ */
+static OCStackResult LoadCachedResources(PSCachedDatabase *database, const uint8_t *dbData,
+                                         size_t dbSize)
+{
+    const char *resources[PS_MAX_DATABASE_RESOURCES];
+    size_t count = GetDatabaseResources(database->name, resources);
+
+    CborParser parser;  // will be initialized in |cbor_parser_init|
+    CborValue cbor;     // will be initialized in |cbor_parser_init|
+    CborError cborFindResult = cbor_parser_init(dbData, dbSize, 0, &parser, &cbor);
+    if ((CborNoError != cborFindResult) || !cbor_value_is_map(&cbor))
+    {
+        // Treated as empty, as a corrupt file would be overwritten by the next update.
+        OIC_LOG_V(ERROR, TAG, "%s is not a CBOR map", database->name);
+        return OC_STACK_OK;
+    }
+
+    for (size_t i = 0; i < count; i++)
+    {
+        CborValue curVal = {0};
+        cborFindResult = cbor_value_map_find_value(&cbor, resources[i], &curVal);
+        if ((CborNoError == cborFindResult) && cbor_value_is_byte_string(&curVal))
+        {
+            uint8_t *data = NULL;
+            size_t size = 0;
+            cborFindResult = cbor_value_dup_byte_string(&curVal, &data, &size, NULL);
+            if (CborNoError != cborFindResult)
+            {
+                OIC_LOG_V(ERROR, TAG, "Failed Finding %s Value.", resources[i]);
+                OICFree(data);
+                return OC_STACK_ERROR;
+            }
+            OCStackResult ret = SetCachedResource(database, resources[i], data, size);
+            VERIFY_SUCCESS_RETURN(TAG, (OC_STACK_OK == ret), ERROR, ret);
+        }
+    }
+    return OC_STACK_OK;
+}
+
+/**
+ * Encodes the cached database as a single CBOR map.
+ *
+ * @note Caller of this method MUST use OICFree() method to release memory
+ *       referenced by the data argument.
+ */
+static OCStackResult EncodeCachedDatabase(const PSCachedDatabase *database, uint8_t **data,
+                                          size_t *size)
+{
+    size_t allocSize = CBOR_ENCODING_SIZE_ADDITION;
+    const PSCachedResource *resource = NULL;
+    LL_FOREACH(database->resources, resource)
+    {
+        allocSize += strlen(resource->name) + resource->size + CBOR_ENCODING_SIZE_ADDITION;
+    }
+
+    int64_t cborEncoderResult = CborNoError;
+    uint8_t *outPayload = (uint8_t *) OICCalloc(1, allocSize);
+    VERIFY_NOT_NULL_RETURN(TAG, outPayload, ERROR, OC_STACK_NO_MEMORY);
+    CborEncoder encoder;  // will be initialized in |cbor_parser_init|
+    cbor_encoder_init(&encoder, outPayload, allocSize, 0);
+    CborEncoder map;  // will be initialized in |cbor_encoder_create_map|
+    cborEncoderResult |= cbor_encoder_create_map(&encoder, &map, CborIndefiniteLength);
+    VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, cborEncoderResult, "Failed Adding PS Map.");
+
+    LL_FOREACH(database->resources, resource)
+    {
+        cborEncoderResult |= cbor_encode_text_string(&map, resource->name, strlen(resource->name));
+        VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, cborEncoderResult, "Failed Adding Value Tag");
+        cborEncoderResult |= cbor_encode_byte_string(&map, resource->data, resource->size);
+        VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, cborEncoderResult, "Failed Adding Value.");
+    }
+
+    cborEncoderResult |= cbor_encoder_close_container(&encoder, &map);
+    VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, cborEncoderResult, "Failed Closing Map.");
+    VERIFY_SUCCESS(TAG, (CborNoError == cborEncoderResult), ERROR);
+
+    *data = outPayload;
+    *size = cbor_encoder_get_buffer_size(&encoder, outPayload);
+    return OC_STACK_OK;
+
+exit:
+    OICFree(outPayload);
+    return OC_STACK_ERROR;
+}
+
+static char *GetResourceFileName(const char *databaseName, const char *resourceName)
+{
+    size_t length = strlen(databaseName) + strlen(resourceName) + 2;
+    char *fileName = (char *) OICMalloc(length);
+    if (fileName)
+    {
+        snprintf(fileName, length, "%s.%s", databaseName, resourceName);
+    }
+    return fileName;
+}
+
+/**
+ * Writes a cached resource to its own file, or removes the file if the resource is not
+ * in the cached database.
+ */
+static OCStackResult StoreResourceFile(const OCPersistentStorage *ps,
+                                       const PSCachedDatabase *database, const char *resourceName)
+{
+    char *fileName = GetResourceFileName(database->name, resourceName);
+    VERIFY_NOT_NULL_RETURN(TAG, fileName, ERROR, OC_STACK_NO_MEMORY);
+
+    OCStackResult ret = OC_STACK_OK;
+    const PSCachedResource *resource = FindCachedResource(database, resourceName);
+    if (resource)
+    {
+        ret = WritePayloadToPS(fileName, resource->data, resource->size);
+    }
+    else
+    {
+        // Fails if the resource never had a file, which is fine.
+        ps->unlink(fileName);
+    }
+    OICFree(fileName);
+    return ret;
+}
+
+/**
+ * Writes the cached database to PS.
+ *
+ * @param ps           is the persistent storage handler.
+ * @param layout       is the layout of the database.
+ * @param database     is the cached database.
+ * @param resourceName is the name of the resource that changed, NULL if any may have.
+ *                     With one file per resource only its file is written.
+ *
+ * @return ::OC_STACK_OK for Success, otherwise some error value
+ */
+static OCStackResult StoreCachedDatabase(const OCPersistentStorage *ps,
+                                         OCPersistentStorageLayout layout,
+                                         const PSCachedDatabase *database,
+                                         const char *resourceName)
+{
+    OCStackResult ret = OC_STACK_OK;
+
+    if (OC_PS_LAYOUT_FILE_PER_RESOURCE != layout)
+    {
+        uint8_t *dbData = NULL;
+        size_t dbSize = 0;
+        ret = EncodeCachedDatabase(database, &dbData, &dbSize);
+        if (OC_STACK_OK == ret)
+        {
+            ret = WritePayloadToPS(database->name, dbData, dbSize);
+        }
+        OICFree(dbData);
+    }
+    else if (resourceName)
+    {
+        ret = StoreResourceFile(ps, database, resourceName);
+    }
+    else
+    {
+        const char *resources[PS_MAX_DATABASE_RESOURCES];
+        size_t count = GetDatabaseResources(database->name, resources);
+        for (size_t i = 0; (i < count) && (OC_STACK_OK == ret); i++)
+        {
+            ret = StoreResourceFile(ps, database, resources[i]);
+        }
+    }
+    return ret;
+}
+
+static OCStackResult LoadDatabaseFile(PSCachedDatabase *database)
+{
+    uint8_t *dbData = NULL;
+    size_t dbSize = 0;
+    OCStackResult ret = OC_STACK_OK;
+
+    // A missing database is empty.
+    if ((OC_STACK_OK == ReadDatabaseFromFile(database->name, NULL, &dbData, &dbSize)) && dbSize)
+    {
+        ret = LoadCachedResources(database, dbData, dbSize);
+    }
+    OICFree(dbData);
+    return ret;
+}
+
+/**
+ * Splits a database still kept in a single file into one file per resource. The single
+ * file is removed only once every resource file is written, until then it is the one
+ * read, so an interrupted split is simply done again.
+ */
+static OCStackResult SplitDatabaseFile(const OCPersistentStorage *ps, PSCachedDatabase *database)
+{
+    OIC_LOG_V(INFO, TAG, "Splitting %s into one file per resource", database->name);
+
+    OCStackResult ret = StoreCachedDatabase(ps, OC_PS_LAYOUT_FILE_PER_RESOURCE, database, NULL);
+    VERIFY_SUCCESS_RETURN(TAG, (OC_STACK_OK == ret), ERROR, ret);
+
+    if (0 != ps->unlink(database->name))
+    {
+        // Left in place it would be split again over the next updates.
+        OIC_LOG_V(ERROR, TAG, "Failed to remove %s", database->name);
+        return OC_STACK_ERROR;
+    }
+    return OC_STACK_OK;
+}
+
+static OCStackResult LoadResourceFiles(const OCPersistentStorage *ps, PSCachedDatabase *database)
+{
+    uint8_t *dbData = NULL;
+    size_t dbSize = 0;
+    if ((OC_STACK_OK == ReadDatabaseFromFile(database->name, NULL, &dbData, &dbSize)) && dbSize)
+    {
+        OCStackResult ret = LoadCachedResources(database, dbData, dbSize);
+        OICFree(dbData);
+        VERIFY_SUCCESS_RETURN(TAG, (OC_STACK_OK == ret), ERROR, ret);
+        return SplitDatabaseFile(ps, database);
+    }
+    OICFree(dbData);
+
+    const char *resources[PS_MAX_DATABASE_RESOURCES];
+    size_t count = GetDatabaseResources(database->name, resources);
+    for (size_t i = 0; i < count; i++)
+    {
+        char *fileName = GetResourceFileName(database->name, resources[i]);
+        VERIFY_NOT_NULL_RETURN(TAG, fileName, ERROR, OC_STACK_NO_MEMORY);
+        uint8_t *data = NULL;
+        size_t size = 0;
+        // A missing file is a missing resource.
+        OCStackResult ret = ReadDatabaseFromFile(fileName, NULL, &data, &size);
+        OICFree(fileName);
+        if (OC_STACK_OK == ret)
+        {
+            ret = SetCachedResource(database, resources[i], data, size);
+            VERIFY_SUCCESS_RETURN(TAG, (OC_STACK_OK == ret), ERROR, ret);
+        }
+    }
+    return OC_STACK_OK;
+}
+
+/**
+ * Gets the cached database, reading it from PS the first time.
+ * Must be called with g_cacheMutex held.
+ *
+ * @param ps           is the persistent storage handler.
+ * @param layout       is the layout of the database.
+ * @param databaseName is the name of the database.
+ *
+ * @return the cached database, NULL on error.
+ */
+static PSCachedDatabase *GetCachedDatabase(const OCPersistentStorage *ps,
+                                           OCPersistentStorageLayout layout,
+                                           const char *databaseName)
+{
+    if ((ps != g_cacheHandler) || (layout != g_cacheLayout))
+    {
+        FreeCachedDatabases();
+        g_cacheHandler = ps;
+        g_cacheLayout = layout;
+    }
+
+    PSCachedDatabase *database = NULL;
+    LL_FOREACH(g_cachedDatabases, database)
+    {
+        if (0 == strcmp(database->name, databaseName))
+        {
+            return database;
+        }
+    }
+
+    database = (PSCachedDatabase *) OICCalloc(1, sizeof(PSCachedDatabase));
+    VERIFY_NOT_NULL_RETURN(TAG, database, ERROR, NULL);
+    database->name = OICStrdup(databaseName);
+    VERIFY_NOT_NULL(TAG, database->name, ERROR);
+
+    OCStackResult ret = (OC_PS_LAYOUT_FILE_PER_RESOURCE == layout) ?
+                        LoadResourceFiles(ps, database) : LoadDatabaseFile(database);
+    VERIFY_SUCCESS(TAG, (OC_STACK_OK == ret), ERROR);
+
+    LL_APPEND(g_cachedDatabases, database);
+    return database;
+
+exit:
+    FreeCachedDatabase(database);
+    return NULL;
+}
+
+/**
+ * Reads the database from PS
+ *
+ * @note Caller of this method MUST use OICFree() method to release memory
+ *       referenced by the data argument.
+ *
+ * @param databaseName is the name of the database to access through persistent storage.
+ * @param resourceName is the name of the field for which file content are read.
+ *                     if the value is NULL it will send the content of the whole file.
+ * @param data         is the pointer to the file contents read from the database.
+ * @param size         is the size of the file contents read.
+ *
+ * @return ::OC_STACK_OK for Success, otherwise some error value
+ */
+OCStackResult ReadDatabaseFromPS(const char *databaseName, const char *resourceName, uint8_t **data, size_t *size)
+{
+    if (!databaseName || !data || *data || !size)
+    {
+        return OC_STACK_INVALID_PARAM;
+    }
+
+    const OCPersistentStorage *ps = OCGetPersistentStorageHandler();
+    OCPersistentStorageLayout layout = OCGetPersistentStorageLayout();
+    if (!ps || (OC_PS_LAYOUT_SINGLE_FILE == layout))
+    {
+        return ReadDatabaseFromFile(databaseName, resourceName, data, size);
+    }
+
+    OCStackResult ret = OC_STACK_ERROR;
+    oc_mutex_lock(g_cacheMutex);
+    PSCachedDatabase *database = GetCachedDatabase(ps, layout, databaseName);
+    if (!database)
+    {
+        ret = OC_STACK_ERROR;
+    }
+    // As with the file, a missing resource or an empty database is an error.
+    else if (!resourceName)
+    {
+        ret = database->resources ? EncodeCachedDatabase(database, data, size) : OC_STACK_ERROR;
+    }
+    else
+    {
+        const PSCachedResource *resource = FindCachedResource(database, resourceName);
+        if (resource)
+        {
+            *data = DuplicatePayload(resource->data, resource->size);
+            *size = resource->size;
+            ret = *data ? OC_STACK_OK : OC_STACK_NO_MEMORY;
+        }
+    }
+    oc_mutex_unlock(g_cacheMutex);
+    return ret;
+}
+
+/**
+ * This method updates the database in PS
+ *
+ * @param databaseName  is the name of the database to access through persistent storage.
+ * @param resourceName  is the name of the resource that will be updated.
+ * @param payload       is the pointer to memory where the CBOR payload is located.
+ * @param size          is the size of the CBOR payload.
+ *
+ * @return ::OC_STACK_OK for Success, otherwise some error value
+ */
+OCStackResult UpdateResourceInPS(const char *databaseName, const char *resourceName, const uint8_t *payload, size_t size)
+{
+    if (!databaseName || !resourceName)
+    {
+        return OC_STACK_INVALID_PARAM;
+    }
+
+    const OCPersistentStorage *ps = OCGetPersistentStorageHandler();
+    OCPersistentStorageLayout layout = OCGetPersistentStorageLayout();
+    if (!ps || (OC_PS_LAYOUT_SINGLE_FILE == layout))
+    {
+        return UpdateResourceInFile(databaseName, resourceName, payload, size);
+    }
+
+    uint8_t *data = NULL;
+    if (payload && size)
+    {
+        data = DuplicatePayload(payload, size);
+        VERIFY_NOT_NULL_RETURN(TAG, data, ERROR, OC_STACK_NO_MEMORY);
+    }
+
+    OCStackResult ret = OC_STACK_ERROR;
+    oc_mutex_lock(g_cacheMutex);
+    PSCachedDatabase *database = GetCachedDatabase(ps, layout, databaseName);
+    if (database)
+    {
+        ret = SetCachedResource(database, resourceName, data, size);
+        if (OC_STACK_OK == ret)
+        {
+            ret = StoreCachedDatabase(ps, layout, database, resourceName);
+        }
+    }
+    else
+    {
+        OICFree(data);
+    }
+    oc_mutex_unlock(g_cacheMutex);
+    return ret;
+}
+
+/**
+ * Replaces the whole database in PS.
+ *
+ * @param databaseName is the name of the database to access through persistent storage.
+ * @param payload      is the CBOR map of all resources of the database.
+ * @param size         is the size of payload.
+ *
+ * @return ::OC_STACK_OK for Success, otherwise some error value
+ */
+static OCStackResult WriteDatabaseToPS(const char *databaseName, uint8_t *payload, size_t size)
+{
+    const OCPersistentStorage *ps = OCGetPersistentStorageHandler();
+    OCPersistentStorageLayout layout = OCGetPersistentStorageLayout();
+    if (!ps || (OC_PS_LAYOUT_SINGLE_FILE == layout))
+    {
+        return WritePayloadToPS(databaseName, payload, size);
+    }
+
+    OCStackResult ret = OC_STACK_ERROR;
+    oc_mutex_lock(g_cacheMutex);
+    PSCachedDatabase *database = GetCachedDatabase(ps, layout, databaseName);
+    if (database)
+    {
+        FreeCachedResources(database);
+        ret = LoadCachedResources(database, payload, size);
+        if (OC_STACK_OK == ret)
+        {
+            ret = StoreCachedDatabase(ps, layout, database, NULL);
+        }
+    }
+    oc_mutex_unlock(g_cacheMutex);
+    return ret;
+}
+
 /**
  * Reads the Secure Virtual Database from PS
  *
@@ -648,7 +1282,7 @@ OCStackResult ResetSecureResourceInPS(void)
             outSize = cbor_encoder_get_buffer_size(&encoder, outPayload);
         }
 
-        ret = WritePayloadToPS(SVR_DB_DAT_FILE_NAME, outPayload, outSize);
+        ret = WriteDatabaseToPS(SVR_DB_DAT_FILE_NAME, outPayload, outSize);
         VERIFY_SUCCESS(TAG, (OC_STACK_OK == ret), ERROR);
     }
 
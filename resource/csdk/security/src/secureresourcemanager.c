@@ -486,6 +486,7 @@ OCStackResult SRMInitSecureResources(void)
 void SRMDeInitSecureResources(void)
 {
     DestroySecureResources();
+    DeInitPolicyEngine();
 }
 
 /**
@@ -19,9 +19,17 @@
 //-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
 
 #include <gtest/gtest.h>
+#include <coap/utlist.h>
 #include "ocstack.h"
+#include "ocpayload.h"
+#include "oic_malloc.h"
+#include "oic_string.h"
 #include "cainterface.h"
 #include "srmresourcestrings.h"
+#include "aclresource.h"
+#include "pstatresource.h"
+#include "security_internals.h"
+#include "srmtestcommon.h"
 
 using namespace std;
 
@@ -115,3 +123,288 @@ extern OicSecDoxm_t *gDoxm;
 //     EXPECT_EQ((uint16_t)0, g_peContext.permission);
 //     EXPECT_EQ(ACCESS_DENIED_POLICY_ENGINE_ERROR, g_peContext.retVal);
 // }
+
+// Tests of the ACE index and of the decisions cached by CheckPermission().
+static const char g_lightUri[] = "/a/light";
+static const char g_fanUri[] = "/a/fan";
+static const char g_otherUri[] = "/a/other";
+
+static OicSecAce_t *NewAce(const OicUuid_t *subject, const char *href, uint16_t permission)
+{
+    OicSecAce_t *ace = (OicSecAce_t *)OICCalloc(1, sizeof(OicSecAce_t));
+    OicSecRsrc_t *rsrc = (OicSecRsrc_t *)OICCalloc(1, sizeof(OicSecRsrc_t));
+    if ((NULL == ace) || (NULL == rsrc))
+    {
+        OICFree(ace);
+        OICFree(rsrc);
+        return NULL;
+    }
+    ace->subjectType = OicSecAceUuidSubject;
+    ace->subjectuuid = *subject;
+    ace->permission = permission;
+    rsrc->href = OICStrdup(href);
+    rsrc->typeLen = 1;
+    rsrc->types = (char **)OICCalloc(1, sizeof(char *));
+    rsrc->interfaceLen = 1;
+    rsrc->interfaces = (char **)OICCalloc(1, sizeof(char *));
+    if (rsrc->types && rsrc->interfaces)
+    {
+        rsrc->types[0] = OICStrdup("oic.core");
+        rsrc->interfaces[0] = OICStrdup("oic.if.baseline");
+    }
+    LL_APPEND(ace->resources, rsrc);
+    return ace;
+}
+
+static OicSecAcl_t *NewAcl(OicSecAce_t *ace)
+{
+    OicSecAcl_t *acl = (OicSecAcl_t *)OICCalloc(1, sizeof(OicSecAcl_t));
+    if (NULL != acl)
+    {
+        memcpy(acl->rownerID.id, "1111111111111111", sizeof(acl->rownerID.id));
+        LL_APPEND(acl->aces, ace);
+    }
+    return acl;
+}
+
+// Access of the subject when the ACEs of the ACL are walked one by one.
+static bool IsGrantedByAclWalk(const OicUuid_t *subject, const char *uri, uint16_t permission)
+{
+    OicSecAce_t *savePtr = NULL;
+    const OicSecAce_t *ace = NULL;
+    while (NULL != (ace = GetACLResourceData(subject, &savePtr)))
+    {
+        const OicSecRsrc_t *rsrc = NULL;
+        LL_FOREACH(ace->resources, rsrc)
+        {
+            if ((NULL != rsrc->href) &&
+                ((0 == strcmp(uri, rsrc->href)) || (0 == strcmp(WILDCARD_RESOURCE_URI, rsrc->href))) &&
+                (permission == (permission & ace->permission)))
+            {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+class PolicyEngineCacheTest : public testing::Test
+{
+protected:
+    virtual void SetUp()
+    {
+        static OCPersistentStorage ps = OCPersistentStorage();
+        SetPersistentHandler(&ps, true);
+        ASSERT_EQ(OC_STACK_OK, InitPstatResourceToDefault());
+        ASSERT_EQ(OC_STACK_OK, SetPstatDosS(DOS_RFNOP));
+
+        // SubjectA may read the light, SubjectB may read the fan.
+        OicSecAcl_t *acl = NewAcl(NewAce(&g_subjectIdA, g_lightUri, PERMISSION_READ));
+        ASSERT_TRUE(NULL != acl);
+        OicSecAce_t *ace = NewAce(&g_subjectIdB, g_fanUri, PERMISSION_READ);
+        ASSERT_TRUE(NULL != ace);
+        LL_APPEND(acl->aces, ace);
+        EXPECT_EQ(OC_STACK_OK, SetDefaultACL(acl));
+    }
+
+    virtual void TearDown()
+    {
+        DeInitACLResource();
+        DeInitPolicyEngine();
+    }
+
+    static SRMAccessResponse_t Check(const OicUuid_t *subject, const char *uri,
+                                     uint16_t permission)
+    {
+        SRMRequestContext_t context = SRMRequestContext_t();
+        context.resourceType = NOT_A_SVR_RESOURCE;
+        OICStrcpy(context.resourceUri, sizeof(context.resourceUri), uri);
+        context.requestedPermission = permission;
+        context.secureChannel = true;
+        context.discoverable = DISCOVERABLE_TRUE;
+        context.subjectIdType = SUBJECT_ID_TYPE_UUID;
+        context.subjectUuid = *subject;
+        CheckPermission(&context);
+        return context.responseVal;
+    }
+
+    // ACE of the subject, changed below without going through the ACL resource so that
+    // a decision taken before the change can be told apart from one taken after it.
+    static OicSecAce_t *GetAce(const OicUuid_t *subject)
+    {
+        OicSecAce_t *savePtr = NULL;
+        return (OicSecAce_t *)GetACLResourceData(subject, &savePtr);
+    }
+
+    // Cache the read access of SubjectA to the light, then take the access back in gAcl.
+    static void CacheStaleGrant()
+    {
+        ASSERT_EQ(ACCESS_GRANTED, Check(&g_subjectIdA, g_lightUri, PERMISSION_READ));
+        OicSecAce_t *ace = GetAce(&g_subjectIdA);
+        ASSERT_TRUE(NULL != ace);
+        ace->permission = PERMISSION_WRITE;
+        ASSERT_EQ(ACCESS_GRANTED, Check(&g_subjectIdA, g_lightUri, PERMISSION_READ));
+    }
+};
+
+TEST_F(PolicyEngineCacheTest, CachedDecisionHitAndMiss)
+{
+    CacheStaleGrant();
+
+    // Not cached yet, so the request is checked against the ACEs as they are now.
+    EXPECT_EQ(ACCESS_GRANTED, Check(&g_subjectIdA, g_lightUri, PERMISSION_WRITE));
+    EXPECT_FALSE(IsAccessGranted(Check(&g_subjectIdA, g_fanUri, PERMISSION_READ)));
+    EXPECT_EQ(ACCESS_GRANTED, Check(&g_subjectIdB, g_fanUri, PERMISSION_READ));
+}
+
+TEST_F(PolicyEngineCacheTest, AppendAclInvalidatesCache)
+{
+    CacheStaleGrant();
+    uint32_t version = GetACLResourceVersion();
+
+    OicSecAcl_t acl = OicSecAcl_t();
+    acl.aces = NewAce(&g_subjectIdB, g_otherUri, PERMISSION_READ);
+    ASSERT_TRUE(NULL != acl.aces);
+    AppendACLObject(&acl);
+
+    EXPECT_NE(version, GetACLResourceVersion());
+    EXPECT_FALSE(IsAccessGranted(Check(&g_subjectIdA, g_lightUri, PERMISSION_READ)));
+    EXPECT_EQ(ACCESS_GRANTED, Check(&g_subjectIdB, g_otherUri, PERMISSION_READ));
+}
+
+TEST_F(PolicyEngineCacheTest, RemoveAceInvalidatesCache)
+{
+    CacheStaleGrant();
+    ASSERT_EQ(ACCESS_GRANTED, Check(&g_subjectIdB, g_fanUri, PERMISSION_READ));
+    uint32_t version = GetACLResourceVersion();
+
+    RemoveACE(&g_subjectIdB, g_fanUri);
+
+    EXPECT_NE(version, GetACLResourceVersion());
+    EXPECT_FALSE(IsAccessGranted(Check(&g_subjectIdA, g_lightUri, PERMISSION_READ)));
+    EXPECT_FALSE(IsAccessGranted(Check(&g_subjectIdB, g_fanUri, PERMISSION_READ)));
+}
+
+TEST_F(PolicyEngineCacheTest, PostAclInvalidatesCache)
+{
+    CacheStaleGrant();
+    uint32_t version = GetACLResourceVersion();
+
+    OicSecAcl_t *acl = NewAcl(NewAce(&g_subjectIdB, g_otherUri, PERMISSION_READ));
+    ASSERT_TRUE(NULL != acl);
+    size_t size = 0;
+    uint8_t *payload = NULL;
+    EXPECT_EQ(OC_STACK_OK, AclToCBORPayload(acl, OIC_SEC_ACL_V2, &payload, &size));
+    ASSERT_TRUE(NULL != payload);
+    OCSecurityPayload *securityPayload = OCSecurityPayloadCreate(payload, size);
+    ASSERT_TRUE(NULL != securityPayload);
+
+    // The ACL can only be updated while the device is provisioned.
+    ASSERT_EQ(OC_STACK_OK, SetPstatDosS(DOS_RFPRO));
+    OCEntityHandlerRequest ehReq = OCEntityHandlerRequest();
+    ehReq.method = OC_REST_POST;
+    ehReq.payload = (OCPayload *)securityPayload;
+    ACLEntityHandler(OC_REQUEST_FLAG, &ehReq, NULL);
+    ASSERT_EQ(OC_STACK_OK, SetPstatDosS(DOS_RFNOP));
+
+    EXPECT_NE(version, GetACLResourceVersion());
+    EXPECT_FALSE(IsAccessGranted(Check(&g_subjectIdA, g_lightUri, PERMISSION_READ)));
+    EXPECT_EQ(ACCESS_GRANTED, Check(&g_subjectIdB, g_otherUri, PERMISSION_READ));
+
+    OCPayloadDestroy((OCPayload *)securityPayload);
+    OICFree(payload);
+    DeleteACLList(acl);
+}
+
+TEST_F(PolicyEngineCacheTest, InstallAclInvalidatesCache)
+{
+    CacheStaleGrant();
+    uint32_t version = GetACLResourceVersion();
+
+    // InstallACL() saves the ACLs provisioned by SRPSaveACL() and by the cloud.
+    OicSecAcl_t *acl = NewAcl(NewAce(&g_subjectIdB, g_otherUri, PERMISSION_READ));
+    ASSERT_TRUE(NULL != acl);
+    InstallACL(acl);
+
+    EXPECT_NE(version, GetACLResourceVersion());
+    EXPECT_FALSE(IsAccessGranted(Check(&g_subjectIdA, g_lightUri, PERMISSION_READ)));
+    EXPECT_EQ(ACCESS_GRANTED, Check(&g_subjectIdB, g_otherUri, PERMISSION_READ));
+
+    DeleteACLList(acl);
+}
+
+TEST_F(PolicyEngineCacheTest, TimedAceIsNotCached)
+{
+    // SubjectA may read the light all day long.
+    OicSecAce_t *ace = NewAce(&g_subjectIdA, g_lightUri, PERMISSION_READ);
+    ASSERT_TRUE(NULL != ace);
+    ace->validities = (OicSecValidity_t *)OICCalloc(1, sizeof(OicSecValidity_t));
+    ASSERT_TRUE(NULL != ace->validities);
+    ace->validities->period = OICStrdup("20150630T000000/20150630T235959");
+    ace->validities->recurrences = (char **)OICCalloc(1, sizeof(char *));
+    ASSERT_TRUE(NULL != ace->validities->recurrences);
+    ace->validities->recurrences[0] = OICStrdup("FREQ=DAILY");
+    ace->validities->recurrenceLen = 1;
+    OicSecAcl_t *acl = NewAcl(ace);
+    ASSERT_TRUE(NULL != acl);
+    DeInitACLResource();
+    EXPECT_EQ(OC_STACK_OK, SetDefaultACL(acl));
+
+    EXPECT_EQ(ACCESS_GRANTED, Check(&g_subjectIdA, g_lightUri, PERMISSION_READ));
+
+    // Whether a timed ACE applies depends on the time of the request, so it is checked again.
+    ace->permission = PERMISSION_WRITE;
+    EXPECT_EQ(ACCESS_DENIED_INSUFFICIENT_PERMISSION,
+              Check(&g_subjectIdA, g_lightUri, PERMISSION_READ));
+    EXPECT_EQ(ACCESS_GRANTED, Check(&g_subjectIdA, g_lightUri, PERMISSION_WRITE));
+}
+
+#if defined(__WITH_DTLS__) || defined(__WITH_TLS__)
+TEST_F(PolicyEngineCacheTest, RoleLookupIsNotCached)
+{
+    // Not granted by the ACEs of the subject, so the ACEs of the roles asserted by the
+    // endpoint were checked, and those roles change over time.
+    EXPECT_EQ(ACCESS_DENIED_INSUFFICIENT_PERMISSION,
+              Check(&g_subjectIdA, g_lightUri, PERMISSION_WRITE));
+
+    OicSecAce_t *ace = GetAce(&g_subjectIdA);
+    ASSERT_TRUE(NULL != ace);
+    ace->permission = PERMISSION_READ | PERMISSION_WRITE;
+    EXPECT_EQ(ACCESS_GRANTED, Check(&g_subjectIdA, g_lightUri, PERMISSION_WRITE));
+}
+#endif // __WITH_DTLS__ || __WITH_TLS__
+
+TEST_F(PolicyEngineCacheTest, WildcardHrefMatchesAclWalk)
+{
+    // SubjectA may read everything, write the light and do anything with the fan.
+    OicSecAcl_t *acl = NewAcl(NewAce(&g_subjectIdA, WILDCARD_RESOURCE_URI, PERMISSION_READ));
+    ASSERT_TRUE(NULL != acl);
+    OicSecAce_t *ace = NewAce(&g_subjectIdA, g_lightUri, PERMISSION_WRITE);
+    ASSERT_TRUE(NULL != ace);
+    LL_APPEND(acl->aces, ace);
+    ace = NewAce(&g_subjectIdA, g_fanUri, PERMISSION_FULL_CONTROL);
+    ASSERT_TRUE(NULL != ace);
+    LL_APPEND(acl->aces, ace);
+    DeInitACLResource();
+    EXPECT_EQ(OC_STACK_OK, SetDefaultACL(acl));
+
+    const char *uris[] = { g_lightUri, g_fanUri, g_otherUri };
+    for (size_t i = 0; i < sizeof(uris) / sizeof(uris[0]); i++)
+    {
+        for (uint16_t permission = 1; permission <= PERMISSION_FULL_CONTROL; permission++)
+        {
+            bool expected = IsGrantedByAclWalk(&g_subjectIdA, uris[i], permission);
+
+            // Checked twice, the second decision may come from the cache.
+            EXPECT_EQ(expected, IsAccessGranted(Check(&g_subjectIdA, uris[i], permission)))
+                << uris[i] << " " << permission;
+            EXPECT_EQ(expected, IsAccessGranted(Check(&g_subjectIdA, uris[i], permission)))
+                << uris[i] << " " << permission;
+        }
+    }
+
+    // Read and write of the light are granted by different ACEs, not by a single one.
+    EXPECT_FALSE(IsAccessGranted(Check(&g_subjectIdA, g_lightUri,
+                                       PERMISSION_READ | PERMISSION_WRITE)));
+    EXPECT_TRUE(IsAccessGranted(Check(&g_subjectIdA, g_otherUri, PERMISSION_READ)));
+}
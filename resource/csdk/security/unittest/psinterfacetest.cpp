@@ -0,0 +1,205 @@
+/******************************************************************
+*
+* Copyright 2017 Open Connectivity Foundation All Rights Reserved.
+*
+*
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+******************************************************************/
+
+#include <gtest/gtest.h>
+#include <stdio.h>
+#include <string.h>
+#include "ocstack.h"
+#include "oic_malloc.h"
+#include "srmresourcestrings.h"
+#include "srmtestcommon.h"
+
+extern "C" {
+#include "psinterface.h"
+}
+
+#define PS_TEST_DATABASE "psinterface_test.dat"
+#define PS_TEST_ACL_FILE PS_TEST_DATABASE ".acl"
+#define PS_TEST_CRED_FILE PS_TEST_DATABASE ".cred"
+
+static const uint8_t s_aclPayload[] = { 0xa1, 0x61, 0x61, 0x01 };
+static const uint8_t s_credPayload[] = { 0xa1, 0x61, 0x63, 0x02 };
+
+static void RemoveTestFiles()
+{
+    remove(PS_TEST_DATABASE);
+    remove(PS_TEST_ACL_FILE);
+    remove(PS_TEST_CRED_FILE);
+}
+
+static bool FileExists(const char *path)
+{
+    FILE *fp = fopen(path, "rb");
+    if (fp)
+    {
+        fclose(fp);
+    }
+    return (NULL != fp);
+}
+
+static void ExpectResource(const char *resourceName, const uint8_t *payload, size_t size)
+{
+    uint8_t *data = NULL;
+    size_t dataSize = 0;
+    ASSERT_EQ(OC_STACK_OK, ReadDatabaseFromPS(PS_TEST_DATABASE, resourceName, &data, &dataSize));
+    ASSERT_EQ(size, dataSize);
+    EXPECT_EQ(0, memcmp(payload, data, size));
+    OICFree(data);
+}
+
+static void SetLayout(OCPersistentStorage *ps, OCPersistentStorageLayout layout)
+{
+    SetPersistentHandler(ps, true);
+    ASSERT_EQ(OC_STACK_OK, OCSetPersistentStorageLayout(layout));
+}
+
+TEST(PSInterfaceTest, SetLayoutInvalidParam)
+{
+    EXPECT_EQ(OC_STACK_INVALID_PARAM,
+              OCSetPersistentStorageLayout((OCPersistentStorageLayout) 42));
+    EXPECT_EQ(OC_PS_LAYOUT_SINGLE_FILE, OCGetPersistentStorageLayout());
+}
+
+TEST(PSInterfaceTest, CachedFileLayout)
+{
+    static OCPersistentStorage ps = OCPersistentStorage();
+    RemoveTestFiles();
+    SetLayout(&ps, OC_PS_LAYOUT_CACHED_FILE);
+
+    EXPECT_EQ(OC_STACK_OK, UpdateResourceInPS(PS_TEST_DATABASE, OIC_JSON_ACL_NAME,
+                                              s_aclPayload, sizeof(s_aclPayload)));
+    EXPECT_EQ(OC_STACK_OK, UpdateResourceInPS(PS_TEST_DATABASE, OIC_JSON_CRED_NAME,
+                                              s_credPayload, sizeof(s_credPayload)));
+    ExpectResource(OIC_JSON_ACL_NAME, s_aclPayload, sizeof(s_aclPayload));
+
+    // The file holds both resources in the single file format.
+    SetLayout(&ps, OC_PS_LAYOUT_SINGLE_FILE);
+    ExpectResource(OIC_JSON_ACL_NAME, s_aclPayload, sizeof(s_aclPayload));
+    ExpectResource(OIC_JSON_CRED_NAME, s_credPayload, sizeof(s_credPayload));
+
+    RemoveTestFiles();
+}
+
+TEST(PSInterfaceTest, FilePerResourceLayout)
+{
+    static OCPersistentStorage ps = OCPersistentStorage();
+    RemoveTestFiles();
+    SetLayout(&ps, OC_PS_LAYOUT_FILE_PER_RESOURCE);
+
+    EXPECT_EQ(OC_STACK_OK, UpdateResourceInPS(PS_TEST_DATABASE, OIC_JSON_ACL_NAME,
+                                              s_aclPayload, sizeof(s_aclPayload)));
+    EXPECT_EQ(OC_STACK_OK, UpdateResourceInPS(PS_TEST_DATABASE, OIC_JSON_CRED_NAME,
+                                              s_credPayload, sizeof(s_credPayload)));
+    EXPECT_TRUE(FileExists(PS_TEST_ACL_FILE));
+    EXPECT_TRUE(FileExists(PS_TEST_CRED_FILE));
+    EXPECT_FALSE(FileExists(PS_TEST_DATABASE));
+
+    // Read back from the files.
+    ClearPersistentStorageCache();
+    ExpectResource(OIC_JSON_ACL_NAME, s_aclPayload, sizeof(s_aclPayload));
+    ExpectResource(OIC_JSON_CRED_NAME, s_credPayload, sizeof(s_credPayload));
+
+    uint8_t *data = NULL;
+    size_t size = 0;
+    EXPECT_EQ(OC_STACK_OK, ReadDatabaseFromPS(PS_TEST_DATABASE, NULL, &data, &size));
+    EXPECT_NE((uint8_t *) NULL, data);
+    OICFree(data);
+
+    // Removing a resource removes its file.
+    EXPECT_EQ(OC_STACK_OK, UpdateResourceInPS(PS_TEST_DATABASE, OIC_JSON_CRED_NAME, NULL, 0));
+    EXPECT_FALSE(FileExists(PS_TEST_CRED_FILE));
+    data = NULL;
+    EXPECT_EQ(OC_STACK_ERROR, ReadDatabaseFromPS(PS_TEST_DATABASE, OIC_JSON_CRED_NAME,
+                                                 &data, &size));
+
+    SetLayout(&ps, OC_PS_LAYOUT_SINGLE_FILE);
+    RemoveTestFiles();
+}
+
+TEST(PSInterfaceTest, FilePerResourceSplitsSingleFile)
+{
+    static OCPersistentStorage ps = OCPersistentStorage();
+    RemoveTestFiles();
+    SetLayout(&ps, OC_PS_LAYOUT_SINGLE_FILE);
+    EXPECT_EQ(OC_STACK_OK, UpdateResourceInPS(PS_TEST_DATABASE, OIC_JSON_ACL_NAME,
+                                              s_aclPayload, sizeof(s_aclPayload)));
+
+    SetLayout(&ps, OC_PS_LAYOUT_FILE_PER_RESOURCE);
+    ExpectResource(OIC_JSON_ACL_NAME, s_aclPayload, sizeof(s_aclPayload));
+    EXPECT_TRUE(FileExists(PS_TEST_ACL_FILE));
+    EXPECT_FALSE(FileExists(PS_TEST_DATABASE));
+
+    // Read back from the resource file, the single file is not split again.
+    ClearPersistentStorageCache();
+    ExpectResource(OIC_JSON_ACL_NAME, s_aclPayload, sizeof(s_aclPayload));
+    EXPECT_FALSE(FileExists(PS_TEST_DATABASE));
+
+    SetLayout(&ps, OC_PS_LAYOUT_SINGLE_FILE);
+    RemoveTestFiles();
+}
+
+TEST(PSInterfaceTest, FilePerResourceRedoesInterruptedSplit)
+{
+    static OCPersistentStorage ps = OCPersistentStorage();
+    RemoveTestFiles();
+    SetLayout(&ps, OC_PS_LAYOUT_SINGLE_FILE);
+    EXPECT_EQ(OC_STACK_OK, UpdateResourceInPS(PS_TEST_DATABASE, OIC_JSON_ACL_NAME,
+                                              s_aclPayload, sizeof(s_aclPayload)));
+
+    // A resource file left by a split that did not complete.
+    FILE *fp = fopen(PS_TEST_CRED_FILE, "wb");
+    ASSERT_TRUE(NULL != fp);
+    EXPECT_EQ(sizeof(s_credPayload), fwrite(s_credPayload, 1, sizeof(s_credPayload), fp));
+    fclose(fp);
+
+    // The single file is still the database.
+    SetLayout(&ps, OC_PS_LAYOUT_FILE_PER_RESOURCE);
+    ExpectResource(OIC_JSON_ACL_NAME, s_aclPayload, sizeof(s_aclPayload));
+    uint8_t *data = NULL;
+    size_t size = 0;
+    EXPECT_EQ(OC_STACK_ERROR, ReadDatabaseFromPS(PS_TEST_DATABASE, OIC_JSON_CRED_NAME,
+                                                 &data, &size));
+    EXPECT_TRUE(FileExists(PS_TEST_ACL_FILE));
+    EXPECT_FALSE(FileExists(PS_TEST_CRED_FILE));
+    EXPECT_FALSE(FileExists(PS_TEST_DATABASE));
+
+    SetLayout(&ps, OC_PS_LAYOUT_SINGLE_FILE);
+    RemoveTestFiles();
+}
+
+TEST(PSInterfaceTest, UnregisterReleasesCache)
+{
+    static OCPersistentStorage ps = OCPersistentStorage();
+    RemoveTestFiles();
+    SetLayout(&ps, OC_PS_LAYOUT_CACHED_FILE);
+    EXPECT_EQ(OC_STACK_OK, UpdateResourceInPS(PS_TEST_DATABASE, OIC_JSON_ACL_NAME,
+                                              s_aclPayload, sizeof(s_aclPayload)));
+
+    // Nothing is cached without a handler.
+    EXPECT_EQ(OC_STACK_OK, OCRegisterPersistentStorageHandler(NULL));
+    ClearPersistentStorageCache();
+
+    // Registered again, the database is read back from the file.
+    SetLayout(&ps, OC_PS_LAYOUT_CACHED_FILE);
+    ExpectResource(OIC_JSON_ACL_NAME, s_aclPayload, sizeof(s_aclPayload));
+
+    SetLayout(&ps, OC_PS_LAYOUT_SINGLE_FILE);
+    RemoveTestFiles();
+}
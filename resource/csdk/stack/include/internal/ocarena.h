@@ -0,0 +1,102 @@
+/* ****************************************************************
+ *
+ * Copyright 2017 Open Connectivity Foundation All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+/**
+ * @file
+ *
+ * This file contains a bump allocator for payloads.
+ *
+ * Memory is handed out from large chunks and is never freed individually: all
+ * of it is released at once when the last reference to the arena is dropped.
+ * An arena is not thread safe.
+ */
+
+#ifndef OC_ARENA_H_
+#define OC_ARENA_H_
+
+#include <stddef.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+typedef struct OCArena OCArena;
+
+/**
+ * Create an arena. The caller owns the only reference to it.
+ *
+ * @param chunkSize     Size of the chunks memory is allocated in, 0 for the default.
+ *
+ * @return arena, NULL if out of memory.
+ */
+OCArena *OCArenaCreate(size_t chunkSize);
+
+/**
+ * Take a reference to an arena.
+ *
+ * @param arena         Arena.
+ */
+void OCArenaRetain(OCArena *arena);
+
+/**
+ * Drop a reference to an arena. The arena and all memory allocated from it are
+ * released with the last reference.
+ *
+ * @param arena         Arena.
+ */
+void OCArenaRelease(OCArena *arena);
+
+/**
+ * Allocate zero initialized memory, aligned for any basic type.
+ *
+ * @param arena         Arena.
+ * @param size          Size of the memory.
+ *
+ * @return memory, NULL if out of memory.
+ */
+void *OCArenaAlloc(OCArena *arena, size_t size);
+
+/**
+ * Copy a string into an arena.
+ *
+ * @param arena         Arena.
+ * @param str           NUL terminated string.
+ *
+ * @return copy of str, NULL if str is NULL or out of memory.
+ */
+char *OCArenaStrdup(OCArena *arena, const char *str);
+
+/**
+ * Check whether memory was allocated from an arena.
+ *
+ * @param arena         Arena.
+ * @param memory        Memory to check.
+ *
+ * @return true if memory belongs to the arena.
+ */
+bool OCArenaOwns(const OCArena *arena, const void *memory);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif // OC_ARENA_H_
@@ -105,6 +105,9 @@ typedef struct ClientCB {
     /** This is the sequence identifier the server applies to the invocation tied to 'handle'.*/
     uint32_t sequenceNumber;
 
+    /** Representation payloads are left undecoded for OCGetResponsePayloadView().*/
+    bool payloadViewOnly;
+
     /** The canonical form of the request URI associated with the call back.*/
     char * requestUri;
 
@@ -130,6 +133,15 @@ typedef struct ClientCB {
 
     /** next node in this list.*/
     struct ClientCB    *next;
+
+    /** previous node in this list.*/
+    struct ClientCB    *prev;
+
+    /** next node in the same timeout wheel slot.*/
+    struct ClientCB    *timeoutNext;
+
+    /** pointer linking to this node in the timeout wheel, NULL when not scheduled.*/
+    struct ClientCB    **timeoutLink;
 } ClientCB;
 
 //TODO: Now ocstack is directly accessing the clientCB list to process presence.
@@ -194,6 +206,27 @@ void DeleteClientCB(ClientCB *cbNode);
  */
 void DeleteClientCBList(void);
 
+/**
+ * This method is used to change the time to live of a callback node.
+ *
+ * @param[in]  cbNode               Address to client callback node.
+ * @param[in]  ttl                  time to live in coap_ticks, 0 if the callback does not expire.
+ */
+void SetClientCBTimeout(ClientCB *cbNode, uint32_t ttl);
+
+/**
+ * This method is used to delete the callback nodes past their time to live.
+ * Lookups do not check time to live, this must be called periodically.
+ */
+void DeleteTimedOutClientCBs(void);
+
+/**
+ * This method is used to check if some callback nodes have a time to live.
+ *
+ * @return true if DeleteTimedOutClientCBs() has callbacks to watch.
+ */
+bool HasClientCBTimeouts(void);
+
 /**
  * This method is used to search and retrieve a cb node in cbList using token.
  *
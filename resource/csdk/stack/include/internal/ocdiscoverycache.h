@@ -0,0 +1,116 @@
+/* ****************************************************************
+ *
+ * Copyright 2017 Open Connectivity Foundation All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+/**
+ * @file
+ *
+ * This file contains the cache of encoded /oic/res responses.
+ *
+ * A discovery response only depends on the query, the accepted format and the
+ * endpoint the request came from, as long as the resources, their bindings
+ * and the network interfaces do not change. The cache keeps the encoded
+ * responses for the most recent requests so that repeated discovery does not
+ * rebuild and encode the same payload. Any change to what the response is
+ * built from must call OCDiscoveryCacheInvalidate(), except changes of the
+ * addresses and ports of the network interfaces, which the cache checks for
+ * on each lookup.
+ */
+
+#ifndef OC_DISCOVERY_CACHE_H_
+#define OC_DISCOVERY_CACHE_H_
+
+#include "ocstack.h"
+#include "ocserverrequest.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * Number of responses kept by the cache. 0 disables the cache.
+ */
+#ifndef OC_DISCOVERY_CACHE_SIZE
+#define OC_DISCOVERY_CACHE_SIZE 8
+#endif
+
+/**
+ * Initialize the cache.
+ *
+ * @return ::OC_STACK_OK on success, some other value upon failure.
+ */
+OCStackResult OCDiscoveryCacheInit(void);
+
+/**
+ * Release the cache. Any later call is ignored until OCDiscoveryCacheInit().
+ */
+void OCDiscoveryCacheTerminate(void);
+
+/**
+ * Drop all cached responses. May be called from any thread.
+ */
+void OCDiscoveryCacheInvalidate(void);
+
+/**
+ * Check whether the response to a request may be cached.
+ *
+ * @param request   Discovery request.
+ *
+ * @return true if the response may be cached.
+ */
+bool OCDiscoveryCacheIsCacheable(const OCServerRequest *request);
+
+/**
+ * Get the cached response to a request.
+ *
+ * @param request       Discovery request.
+ * @param result        [OUT] Result of the discovery, ::OC_STACK_OK or ::OC_STACK_NO_RESOURCE.
+ * @param payload       [OUT] Copy of the encoded payload to be freed by the caller,
+ *                      NULL if the discovery found no resource.
+ * @param payloadSize   [OUT] Size of the encoded payload.
+ * @param generation    [OUT] Generation of the cache, to pass to OCDiscoveryCachePut()
+ *                      when no response was found.
+ *
+ * @return true if a response was found.
+ */
+bool OCDiscoveryCacheGet(const OCServerRequest *request, OCStackResult *result,
+                         uint8_t **payload, size_t *payloadSize, uint32_t *generation);
+
+/**
+ * Add the response to a request to the cache, replacing the oldest entry if the
+ * cache is full. The response is dropped if the cache was invalidated while it
+ * was built.
+ *
+ * @param generation    Generation returned by OCDiscoveryCacheGet() before building
+ *                      the response.
+ * @param request       Discovery request.
+ * @param result        Result of the discovery, ::OC_STACK_OK or ::OC_STACK_NO_RESOURCE.
+ * @param payload       Encoded payload, copied by the cache. NULL if the discovery
+ *                      found no resource.
+ * @param payloadSize   Size of the encoded payload.
+ */
+void OCDiscoveryCachePut(uint32_t generation, const OCServerRequest *request,
+                         OCStackResult result, const uint8_t *payload, size_t payloadSize);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif // OC_DISCOVERY_CACHE_H_
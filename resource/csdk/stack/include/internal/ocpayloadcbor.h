@@ -31,9 +31,29 @@ extern "C"
 OCStackResult OCParsePayload(OCPayload** outPayload, OCPayloadFormat format, OCPayloadType type,
         const uint8_t* payload, size_t payloadSize);
 
+/**
+ * Same as OCParsePayload(), except that a representation payload is parsed into an arena
+ * (see OCRepPayloadCreateWithArena()): its values, names, strings and arrays are bump
+ * allocated and released together when the payload is destroyed. Meant for payloads
+ * that only live as long as one request or response.
+ */
+OCStackResult OCParsePayloadInArena(OCPayload** outPayload, OCPayloadFormat format,
+        OCPayloadType type, const uint8_t* payload, size_t payloadSize);
+
+/**
+ * Arena a representation payload is allocated from, NULL if it is on the heap.
+ */
+struct OCArena* OCRepPayloadGetArena(const OCRepPayload* payload);
+
 OCStackResult OCConvertPayload(OCPayload* payload, OCPayloadFormat format,
         uint8_t** outPayload, size_t* size);
 
+/**
+ * Create a view over a received payload, see OCCborView. The view is empty unless
+ * format is one of the CBOR formats.
+ */
+OCCborView OCCborViewCreate(OCPayloadFormat format, const uint8_t* payload, size_t payloadSize);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,103 @@
+/* ****************************************************************
+ *
+ * Copyright 2017 Open Connectivity Foundation All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+/**
+ * @file
+ *
+ * This file contains the dispatch of entity handler calls to worker threads,
+ * enabled with OCSetRequestDispatchThreads().
+ *
+ * Each resource is served by a single worker, so the requests and notifications
+ * of a resource reach its entity handler one at a time and in arrival order,
+ * while different resources are handled in parallel. Dispatched requests are
+ * answered like the requests of a slow resource.
+ *
+ * While dispatch is enabled the stack structures (resource list, server requests,
+ * observers, client callbacks) are guarded by the stack lock. The stack takes it
+ * around the handling of received messages and in the APIs documented as callable
+ * from an entity handler. Entity handlers are called without it.
+ */
+
+#ifndef OC_REQUEST_DISPATCH_H_
+#define OC_REQUEST_DISPATCH_H_
+
+#include "ocstack.h"
+#include "ocresource.h"
+#include "ocserverrequest.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * Start the workers and create the stack lock.
+ *
+ * @param threadCount   Number of workers, 0 to keep calling entity handlers from the
+ *                      thread handling received messages.
+ *
+ * @return ::OC_STACK_OK on success, some other value upon failure.
+ */
+OCStackResult OCRequestDispatchStart(uint32_t threadCount);
+
+/**
+ * Stop the workers once the entity handler calls already queued are done, then
+ * free the stack lock. Must be called without holding the stack lock.
+ */
+void OCRequestDispatchStop(void);
+
+/**
+ * Check whether entity handler calls are dispatched to workers.
+ *
+ * @return true if dispatch is enabled.
+ */
+bool OCRequestDispatchIsEnabled(void);
+
+/**
+ * Queue the entity handler call of a request to the worker of its resource.
+ * Called with the stack lock held. On success the worker owns ehRequest->payload
+ * and the request is held until the entity handler returned, see HoldServerRequest().
+ *
+ * @param resource      Resource of the request.
+ * @param request       Server request, answered once the entity handler ran.
+ * @param flag          Entity handler flag.
+ * @param ehRequest     Entity handler request, copied.
+ *
+ * @return ::OC_STACK_OK on success, some other value upon failure.
+ */
+OCStackResult OCRequestDispatch(OCResource *resource, OCServerRequest *request,
+                                OCEntityHandlerFlag flag,
+                                const OCEntityHandlerRequest *ehRequest);
+
+/**
+ * Take the stack lock. Does nothing when dispatch is disabled. The lock is recursive.
+ */
+void OCStackLock(void);
+
+/**
+ * Release the stack lock.
+ */
+void OCStackUnlock(void);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif // OC_REQUEST_DISPATCH_H_
@@ -0,0 +1,162 @@
+/* ****************************************************************
+ *
+ * Copyright 2017 Open Connectivity Foundation All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+/**
+ * @file
+ *
+ * This file contains the index kept alongside the server resource list.
+ *
+ * The resource list (headResource) stays the owner of the resources and defines
+ * their order. The index maps uri and handle to resource, gives positional
+ * access in creation order, and maps resource type and interface names to the
+ * resources bound to them so that discovery filtering does not visit every
+ * resource.
+ */
+
+#ifndef OC_RESOURCE_INDEX_H_
+#define OC_RESOURCE_INDEX_H_
+
+#include "ocstack.h"
+#include "ocresource.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * Add a resource to the index. Resource uri must be set and must not change
+ * as long as the resource is indexed.
+ *
+ * @param resource  Resource to add.
+ *
+ * @return ::OC_STACK_OK on success, some other value upon failure.
+ */
+OCStackResult OCResourceIndexAdd(OCResource *resource);
+
+/**
+ * Remove a resource and its type and interface bindings from the index.
+ * Must be called before the resource types and interfaces are freed.
+ *
+ * @param resource  Resource to remove.
+ */
+void OCResourceIndexRemove(OCResource *resource);
+
+/**
+ * Remove all resources from the index and release its memory.
+ */
+void OCResourceIndexClear(void);
+
+/**
+ * Find a resource by uri.
+ *
+ * @param uri       Uri of the resource.
+ *
+ * @return Resource if found, NULL otherwise.
+ */
+OCResource *OCResourceIndexFindByUri(const char *uri);
+
+/**
+ * Check that a handle refers to an indexed resource.
+ *
+ * @param resource  Resource handle to check.
+ *
+ * @return true if the resource is indexed.
+ */
+bool OCResourceIndexContains(const OCResource *resource);
+
+/**
+ * Get the ordinal of an indexed resource. Ordinals are never reused, so unlike the
+ * handle the ordinal tells a resource from one created later at the same address.
+ * @param resource  Resource handle.
+ * @param ordinal   [OUT] Ordinal of the resource.
+ * @return true if the resource is indexed.
+ */
+bool OCResourceIndexGetOrdinal(const OCResource *resource, uint64_t *ordinal);
+
+/**
+ * Get the number of indexed resources.
+ *
+ * @return number of resources.
+ */
+size_t OCResourceIndexGetCount(void);
+
+/**
+ * Get a resource by its position in creation order.
+ *
+ * @param index     Position of the resource.
+ *
+ * @return Resource at position index, NULL if index is out of range.
+ */
+OCResource *OCResourceIndexGetAt(size_t index);
+
+/**
+ * Record that a resource type is bound to an indexed resource.
+ * Binding the same type again is ignored.
+ *
+ * @param resource          Indexed resource.
+ * @param resourceTypeName  Name of the resource type.
+ */
+void OCResourceIndexAddType(OCResource *resource, const char *resourceTypeName);
+
+/**
+ * Record that an interface is bound to an indexed resource.
+ * Binding the same interface again is ignored.
+ *
+ * @param resource          Indexed resource.
+ * @param interfaceName     Name of the interface.
+ */
+void OCResourceIndexAddInterface(OCResource *resource, const char *interfaceName);
+
+/**
+ * Get the resources bound to a resource type, in creation order.
+ * The returned array is owned by the index and is valid until the next change
+ * of the resource list.
+ *
+ * @param resourceTypeName  Name of the resource type.
+ * @param resources         [OUT] Resources bound to the type.
+ * @param count             [OUT] Number of resources.
+ *
+ * @return false if the type index is not usable and the caller must check every
+ *         resource instead, true otherwise.
+ */
+bool OCResourceIndexGetByType(const char *resourceTypeName, OCResource ***resources,
+                              size_t *count);
+
+/**
+ * Get the resources bound to an interface, in creation order.
+ * The returned array is owned by the index and is valid until the next change
+ * of the resource list.
+ *
+ * @param interfaceName     Name of the interface.
+ * @param resources         [OUT] Resources bound to the interface.
+ * @param count             [OUT] Number of resources.
+ *
+ * @return false if the interface index is not usable and the caller must check
+ *         every resource instead, true otherwise.
+ */
+bool OCResourceIndexGetByInterface(const char *interfaceName, OCResource ***resources,
+                                   size_t *count);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif // OC_RESOURCE_INDEX_H_
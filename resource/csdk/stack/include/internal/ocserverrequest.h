@@ -46,6 +46,25 @@ extern "C"
  */
 typedef OCStackResult (* OCEHResponseHandler)(OCEntityHandlerResponse * ehResponse);
 
+/**
+ * Additional destination of a notification. The response to the request is encoded
+ * once and also sent to each target, with the target token, address and QoS.
+ */
+typedef struct OCNotificationTarget
+{
+    /** Token of the observe request of the target.*/
+    uint8_t token[CA_MAX_TOKEN_LEN];
+
+    /** Token length.*/
+    uint8_t tokenLength;
+
+    /** Remote endpoint address.*/
+    OCDevAddr devAddr;
+
+    /** QoS of the notification to the target.*/
+    OCQualityOfService qos;
+} OCNotificationTarget;
+
 /**
  * following structure will be created in occoap and passed up the stack on the server side.
  */
@@ -121,6 +140,25 @@ typedef struct OCServerRequest
     /** Payload format retrieved from the received request PDU. */
     OCPayloadFormat payloadFormat;
 
+    /** Other destinations of a notification response.*/
+    OCNotificationTarget *notificationTargets;
+
+    /** Number of notification targets.*/
+    size_t numNotificationTargets;
+
+    /** Response payload already encoded in the accepted format, sent instead of
+     *  encoding the payload of the response. Owned by the request.*/
+    uint8_t *encodedPayload;
+
+    /** Size of the encoded response payload.*/
+    size_t encodedPayloadSize;
+
+    /** Set while the entity handler call is queued or running on a dispatch worker.*/
+    uint8_t held;
+
+    /** Set when the request was deleted while held, it is freed on release.*/
+    uint8_t deleted;
+
     /** Payload Size.*/
     size_t payloadSize;
 
@@ -217,6 +255,41 @@ OCServerRequest * GetServerRequestUsingToken (const CAToken_t token, uint8_t tok
  */
 void DeleteServerRequest(OCServerRequest * serverRequest);
 
+/**
+ * Keep a server request allocated until ReleaseServerRequest(), even if it is
+ * deleted meanwhile, e.g. answered by an entity handler running on a dispatch worker.
+ *
+ * @param[in]  serverRequest    server request to hold.
+ */
+void HoldServerRequest(OCServerRequest * serverRequest);
+
+/**
+ * Release a server request held with HoldServerRequest().
+ *
+ * @param[in]  serverRequest    held server request.
+ *
+ * @return false if the request was deleted while held and is now freed, true otherwise.
+ */
+bool ReleaseServerRequest(OCServerRequest * serverRequest);
+
+/**
+ * Add a destination to a notification request. The response given to the request is
+ * also sent to the target.
+ *
+ * @param[in]  serverRequest    notification request.
+ * @param[in]  token            Token of the target.
+ * @param[in]  tokenLength      Length of token.
+ * @param[in]  devAddr          Address of the target.
+ * @param[in]  qos              QoS of the notification to the target.
+ *
+ * @return ::OC_STACK_OK on success, some other value upon failure.
+ */
+OCStackResult AddServerRequestNotificationTarget(OCServerRequest *serverRequest,
+                                                 const CAToken_t token,
+                                                 uint8_t tokenLength,
+                                                 const OCDevAddr *devAddr,
+                                                 OCQualityOfService qos);
+
 /**
  * Handler function for sending a response from a single resource
  *
@@ -100,6 +100,25 @@ void OC_CALL OCPayloadDestroy(OCPayload* payload);
 // Representation Payload
 OCRepPayload* OC_CALL OCRepPayloadCreate(void);
 
+/**
+ * Create a representation payload whose value nodes and names are allocated from an arena
+ * instead of one by one on the heap. Payloads created with OCRepPayloadCreateChild() share
+ * the arena, which is released in one go once all of them are destroyed.
+ *
+ * @return created payload, NULL if out of memory.
+ */
+OCRepPayload* OC_CALL OCRepPayloadCreateWithArena(void);
+
+/**
+ * Create a representation payload allocated like parent, to be used as an object value
+ * of parent or of its children.
+ *
+ * @param parent    payload the new payload is allocated like.
+ *
+ * @return created payload, NULL if out of memory.
+ */
+OCRepPayload* OC_CALL OCRepPayloadCreateChild(const OCRepPayload* parent);
+
 size_t OC_CALL calcDimTotal(const size_t dimensions[MAX_REP_ARRAY_DEPTH]);
 
 OCRepPayload* OC_CALL OCRepPayloadClone(const OCRepPayload* payload);
@@ -302,6 +321,35 @@ void OC_CALL OCPresencePayloadDestroy(OCPresencePayload* payload);
 OCDiagnosticPayload* OC_CALL OCDiagnosticPayloadCreate(const char *message);
 void OC_CALL OCDiagnosticPayloadDestroy(OCDiagnosticPayload* payload);
 
+// CBOR View
+/**
+ * The following functions look up a property of the top level object of an OCCborView
+ * directly in the CBOR bytes, without parsing the rest of the representation.
+ * Each lookup scans the object, so they are meant for reading a few properties.
+ * All of them return false if the property is missing or has another type.
+ */
+bool OC_CALL OCCborViewHasProp(const OCCborView* view, const char* name);
+bool OC_CALL OCCborViewIsNull(const OCCborView* view, const char* name);
+
+bool OC_CALL OCCborViewGetPropInt(const OCCborView* view, const char* name, int64_t* value);
+bool OC_CALL OCCborViewGetPropDouble(const OCCborView* view, const char* name, double* value);
+bool OC_CALL OCCborViewGetPropBool(const OCCborView* view, const char* name, bool* value);
+
+/**
+ * value points into the view and is not NUL terminated, its length is returned in len.
+ * Strings sent in chunks are not contiguous and cannot be viewed.
+ */
+bool OC_CALL OCCborViewGetPropString(const OCCborView* view, const char* name,
+        const char** value, size_t* len);
+bool OC_CALL OCCborViewGetPropByteString(const OCCborView* view, const char* name,
+        const uint8_t** value, size_t* len);
+
+/**
+ * value is set to a view of the nested object, valid as long as view is.
+ */
+bool OC_CALL OCCborViewGetPropObject(const OCCborView* view, const char* name,
+        OCCborView* value);
+
 // Helper API
 OCStringLL* OC_CALL CloneOCStringLL (OCStringLL* ll);
 void OC_CALL OCFreeOCStringLL(OCStringLL* ll);
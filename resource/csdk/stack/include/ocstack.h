@@ -130,6 +130,65 @@ OCStackResult OC_CALL OCStopMulticastServer(void);
  */
 OCStackResult OC_CALL OCProcess(void);
 
+/**
+ * This function is Called in main loop of OC client or server instead of OCProcess()
+ * when more than one received message should be handled per call.
+ * All handled messages are taken from the receive queue at once.
+ *
+ * @param maxMessages       Maximum number of received messages to handle,
+ *                          0 to handle every message currently queued.
+ * @param timeoutMs         Time in milliseconds to wait for a message when none is queued,
+ *                          0 to return immediately.
+ * @param handledCount      Optional, number of received messages handled by this call.
+ *
+ * @return ::OC_STACK_OK on success, some other value upon failure.
+ */
+OCStackResult OC_CALL OCProcessEx(uint32_t maxMessages, uint32_t timeoutMs,
+                                  uint32_t *handledCount);
+
+/**
+ * This function blocks until OCProcess() has work to do: a message was received,
+ * a timer driven by OCProcess() is due, OCWakeUpProcess() was called or the timeout
+ * elapsed. It is meant to replace a fixed sleep between OCProcess() calls and must be
+ * called without holding any lock that OCProcess() callers use.
+ *
+ * @param timeoutMs         Maximum time to wait in milliseconds, 0 to return immediately.
+ *
+ * @return ::OC_STACK_OK on success, ::OC_STACK_NOTIMPL if the stack handles received
+ *         messages on its own thread, some other value upon failure.
+ */
+OCStackResult OC_CALL OCWaitForProcess(uint32_t timeoutMs);
+
+/**
+ * This function wakes up the threads blocked in OCWaitForProcess().
+ * If no thread is waiting, the next OCWaitForProcess() call returns immediately.
+ *
+ * @return ::OC_STACK_OK on success, some other value upon failure.
+ */
+OCStackResult OC_CALL OCWakeUpProcess(void);
+
+/**
+ * This function sets the number of threads calling entity handlers, to be called before
+ * the stack is initialized. By default entity handlers are called from the thread handling
+ * received messages, so a slow handler delays every other request.
+ *
+ * With threads, each resource is served by a single thread, so the requests of a resource
+ * reach its entity handler one at a time and in arrival order, while different resources
+ * are handled in parallel. Their requests are answered like those of a slow resource:
+ * confirmable requests are acknowledged first and the response is sent separately.
+ * Requests to the security resources are still handled in place.
+ *
+ * Entity handlers may then call OCDoResponse(), OCNotifyAllObservers(),
+ * OCNotifyListOfObservers(), OCDoRequest(), OCCancel(), OCCreateResource(),
+ * OCDeleteResource() and OCBindResourceHandler(). OCStop() waits for the entity handler
+ * calls already queued and must not be called from an entity handler.
+ *
+ * @param threadCount       Number of threads, 0 to call entity handlers in place.
+ *
+ * @return ::OC_STACK_OK on success, ::OC_STACK_ERROR if the stack is initialized.
+ */
+OCStackResult OC_CALL OCSetRequestDispatchThreads(uint32_t threadCount);
+
 /**
  * This function discovers or Perform requests on a specified resource
  * (specified by that Resource's respective URI).
@@ -240,14 +299,27 @@ OCStackResult OC_CALL OCCancel(OCDoHandle handle,
 
 /**
  * Register Persistent storage callback.
- * @param   persistentStorageHandler  Pointers to open, read, write, close & unlink handlers.
+ * @param   persistentStorageHandler  Pointers to open, read, write, close & unlink handlers,
+ *                                    NULL to unregister the handler.
  *
  * @return
  *     OC_STACK_OK                    No errors; Success.
  *     OC_STACK_INVALID_PARAM         Invalid parameter.
+ *     OC_STACK_NO_MEMORY             Not enough memory to cache the databases.
  */
 OCStackResult OC_CALL OCRegisterPersistentStorageHandler(OCPersistentStorage* persistentStorageHandler);
 
+/**
+ * Select how the databases are laid out in persistent storage, see ::OCPersistentStorageLayout.
+ * The databases kept in memory are dropped, they are read again with the new layout.
+ * @param   layout  Layout of the databases, ::OC_PS_LAYOUT_SINGLE_FILE by default.
+ *
+ * @return
+ *     OC_STACK_OK                    No errors; Success.
+ *     OC_STACK_INVALID_PARAM         Invalid parameter.
+ */
+OCStackResult OC_CALL OCSetPersistentStorageLayout(OCPersistentStorageLayout layout);
+
 #ifdef WITH_PRESENCE
 /**
  * When operating in  OCServer or  OCClientServer mode,
@@ -642,6 +714,45 @@ OCStackResult OC_CALL OCNotifyListOfObservers (OCResourceHandle handle,
  */
 OCStackResult OC_CALL OCDoResponse(OCEntityHandlerResponse *response);
 
+/**
+ * This function gets a view of the undecoded CBOR payload of a request, to read a few
+ * properties in place with the OCCborView* functions of ocpayload.h. The view is valid
+ * until the request is answered.
+ *
+ * @param handle     Request handle given to the entity handler.
+ * @param view       Set to the view, empty if the payload is not CBOR.
+ *
+ * @return ::OC_STACK_OK on success, some other value upon failure.
+ */
+OCStackResult OC_CALL OCGetRequestPayloadView(OCRequestHandle handle, OCCborView *view);
+
+/**
+ * This function gets a view of the undecoded CBOR payload of a response, from within
+ * the client callback it is passed to. The view is valid until the callback returns.
+ *
+ * @param response   Response given to the client callback.
+ * @param view       Set to the view, empty if the payload is not CBOR.
+ *
+ * @return ::OC_STACK_OK on success, ::OC_STACK_INVALID_PARAM if the response is not
+ *         being passed to its callback.
+ */
+OCStackResult OC_CALL OCGetResponsePayloadView(const OCClientResponse *response,
+                                               OCCborView *view);
+
+/**
+ * This function sets whether the representations received for a request are left
+ * undecoded, so that the payload of the responses is NULL and the client callback
+ * reads them with OCGetResponsePayloadView() instead. Other payloads, e.g. discovery,
+ * are still decoded. Call it right after OCDoRequest(), before the responses are
+ * processed.
+ *
+ * @param handle     Handle of the request returned by OCDoRequest().
+ * @param viewOnly   true to leave representations undecoded.
+ *
+ * @return ::OC_STACK_OK on success, ::OC_STACK_NO_RESOURCE if the request is not found.
+ */
+OCStackResult OC_CALL OCSetResponsePayloadViewOnly(OCDoHandle handle, bool viewOnly);
+
 /**
  * This function sets URI being used for proxy.
  *
@@ -862,6 +973,13 @@ OCStackResult OC_CALL OCGetPropertyValue(OCPayloadType type, const char *propNam
 */
 OCPersistentStorage *OC_CALL OCGetPersistentStorageHandler(void);
 
+/**
+* Get the layout of the databases in persistent storage.
+*
+* @return the layout selected with OCSetPersistentStorageLayout().
+*/
+OCPersistentStorageLayout OC_CALL OCGetPersistentStorageLayout(void);
+
 /**
 * This function return link local zone id related from ifindex.
 *
@@ -0,0 +1,201 @@
+/* ****************************************************************
+ *
+ * Copyright 2017 Open Connectivity Foundation All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+#include "iotivity_config.h"
+#include <stdint.h>
+#include <string.h>
+
+#include "ocarena.h"
+#include "oic_malloc.h"
+#include "experimental/logger.h"
+
+#define TAG "OIC_RI_ARENA"
+
+/**
+ * Chunk size used when none is given, large enough for a typical payload.
+ */
+#define OC_ARENA_DEFAULT_CHUNK_SIZE (4096)
+
+/**
+ * Alignment of allocations.
+ */
+typedef union
+{
+    void *p;
+    double d;
+    int64_t i;
+} OCArenaAlign;
+
+#define OC_ARENA_ROUND(size) \
+    (((size) + sizeof(OCArenaAlign) - 1) & ~(sizeof(OCArenaAlign) - 1))
+
+typedef struct OCArenaChunk
+{
+    /** Next chunk, chunks are only released with the arena. */
+    struct OCArenaChunk *next;
+    /** Usable size of the chunk. */
+    size_t size;
+    /** Bytes handed out. */
+    size_t used;
+} OCArenaChunk;
+
+#define OC_ARENA_CHUNK_HEADER OC_ARENA_ROUND(sizeof(OCArenaChunk))
+
+struct OCArena
+{
+    /** Chunk allocations are taken from, followed by the filled ones. */
+    OCArenaChunk *chunks;
+    /** Size of regular chunks. */
+    size_t chunkSize;
+    /** Number of references. */
+    size_t refCount;
+};
+
+static OCArenaChunk *OCArenaChunkCreate(size_t size)
+{
+    OCArenaChunk *chunk = (OCArenaChunk *) OICCalloc(1, OC_ARENA_CHUNK_HEADER + size);
+    if (!chunk)
+    {
+        OIC_LOG(ERROR, TAG, "Out of memory");
+        return NULL;
+    }
+    chunk->size = size;
+    return chunk;
+}
+
+OCArena *OCArenaCreate(size_t chunkSize)
+{
+    OCArena *arena = (OCArena *) OICCalloc(1, sizeof(OCArena));
+    if (!arena)
+    {
+        OIC_LOG(ERROR, TAG, "Out of memory");
+        return NULL;
+    }
+    arena->chunkSize = OC_ARENA_ROUND(chunkSize ? chunkSize : OC_ARENA_DEFAULT_CHUNK_SIZE);
+    arena->refCount = 1;
+    return arena;
+}
+
+void OCArenaRetain(OCArena *arena)
+{
+    if (arena)
+    {
+        arena->refCount++;
+    }
+}
+
+void OCArenaRelease(OCArena *arena)
+{
+    if (!arena || --arena->refCount)
+    {
+        return;
+    }
+
+    OCArenaChunk *chunk = arena->chunks;
+    while (chunk)
+    {
+        OCArenaChunk *next = chunk->next;
+        OICFree(chunk);
+        chunk = next;
+    }
+    OICFree(arena);
+}
+
+void *OCArenaAlloc(OCArena *arena, size_t size)
+{
+    if (!arena || !size || size > SIZE_MAX - OC_ARENA_CHUNK_HEADER - sizeof(OCArenaAlign))
+    {
+        return NULL;
+    }
+    size = OC_ARENA_ROUND(size);
+
+    OCArenaChunk *chunk = arena->chunks;
+    if (!chunk || (chunk->size - chunk->used) < size)
+    {
+        // Allocations bigger than a quarter chunk get a chunk of their own, kept behind
+        // the current one so that its free space is not lost.
+        if (size > arena->chunkSize / 4)
+        {
+            chunk = OCArenaChunkCreate(size);
+            if (!chunk)
+            {
+                return NULL;
+            }
+            if (arena->chunks)
+            {
+                chunk->next = arena->chunks->next;
+                arena->chunks->next = chunk;
+            }
+            else
+            {
+                arena->chunks = chunk;
+            }
+        }
+        else
+        {
+            chunk = OCArenaChunkCreate(arena->chunkSize);
+            if (!chunk)
+            {
+                return NULL;
+            }
+            chunk->next = arena->chunks;
+            arena->chunks = chunk;
+        }
+    }
+
+    void *memory = (uint8_t *) chunk + OC_ARENA_CHUNK_HEADER + chunk->used;
+    chunk->used += size;
+    return memory;
+}
+
+char *OCArenaStrdup(OCArena *arena, const char *str)
+{
+    if (!str)
+    {
+        return NULL;
+    }
+
+    size_t length = strlen(str) + 1;
+    char *copy = (char *) OCArenaAlloc(arena, length);
+    if (copy)
+    {
+        memcpy(copy, str, length);
+    }
+    return copy;
+}
+
+bool OCArenaOwns(const OCArena *arena, const void *memory)
+{
+    if (!arena || !memory)
+    {
+        return false;
+    }
+
+    uintptr_t address = (uintptr_t) memory;
+    for (const OCArenaChunk *chunk = arena->chunks; chunk; chunk = chunk->next)
+    {
+        uintptr_t start = (uintptr_t) chunk + OC_ARENA_CHUNK_HEADER;
+        if (address >= start && address < start + chunk->used)
+        {
+            return true;
+        }
+    }
+    return false;
+}
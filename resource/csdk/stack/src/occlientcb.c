@@ -24,6 +24,7 @@
 #include "experimental/logger.h"
 #include "trace.h"
 #include "oic_malloc.h"
+#include "uhashmap.h"
 #include <string.h>
 
 #ifdef HAVE_SYS_TIME_H
@@ -36,6 +37,21 @@
 /// Module Name
 #define TAG "OIC_RI_CLIENTCB"
 
+/// Number of slots of the timeout wheel, must be a power of two.
+#define CB_TIMEOUT_WHEEL_SLOTS (64)
+
+/// Time covered by one slot of the timeout wheel, in coap_ticks.
+#define CB_TIMEOUT_WHEEL_RESOLUTION (COAP_TICKS_PER_SECOND)
+
+/**
+ * Key used to look up callbacks by token.
+ */
+typedef struct
+{
+    const uint8_t *token;
+    uint8_t tokenLength;
+} ClientCBTokenKey;
+
 //-------------------------------------------------------------------------------------------------
 // Private variables
 //-------------------------------------------------------------------------------------------------
@@ -43,9 +59,152 @@
 //      This should be static variable after we make a presence feature separately.
 struct ClientCB *g_cbList = NULL;
 
+/// Token to callback index.
+static u_hashmap_t *g_cbTokenIndex = NULL;
+
+/// Handle to callback index.
+static u_hashmap_t *g_cbHandleIndex = NULL;
+
+/// Set of the callbacks in g_cbList, to validate nodes given to DeleteClientCB.
+static u_hashmap_t *g_cbNodeIndex = NULL;
+
+/**
+ * Timeout wheel. Callbacks with a TTL are kept in the slot of their TTL, so that
+ * expiry only visits the slots elapsed since the previous check.
+ */
+static ClientCB *g_cbTimeoutWheel[CB_TIMEOUT_WHEEL_SLOTS];
+
+/// Number of callbacks in the timeout wheel.
+static size_t g_cbTimeoutCount = 0;
+
+/// Slot time (TTL / CB_TIMEOUT_WHEEL_RESOLUTION) checked last by DeleteTimedOutClientCBs.
+static coap_tick_t g_cbTimeoutWheelTime = 0;
+
+static bool g_cbTimeoutWheelStarted = false;
+
 //-------------------------------------------------------------------------------------------------
 // Local functions
 //-------------------------------------------------------------------------------------------------
+static uint32_t HashClientCBToken(const void *key)
+{
+    const ClientCBTokenKey *tokenKey = (const ClientCBTokenKey *) key;
+    return u_hashmap_hash_bytes(tokenKey->token, tokenKey->tokenLength, U_HASHMAP_HASH_SEED);
+}
+
+static bool MatchClientCBToken(const void *key, const void *data)
+{
+    const ClientCBTokenKey *tokenKey = (const ClientCBTokenKey *) key;
+    const ClientCB *cbNode = (const ClientCB *) data;
+    return cbNode->tokenLength == tokenKey->tokenLength &&
+           0 == memcmp(cbNode->token, tokenKey->token, tokenKey->tokenLength);
+}
+
+static bool MatchClientCBHandle(const void *key, const void *data)
+{
+    return key == ((const ClientCB *) data)->handle;
+}
+
+static void FreeClientCBIndexes(void)
+{
+    u_hashmap_free(&g_cbTokenIndex);
+    u_hashmap_free(&g_cbHandleIndex);
+    u_hashmap_free(&g_cbNodeIndex);
+}
+
+/*
+ * This function adds a new node to the token, handle and node indexes.
+ * On failure the node is in none of them.
+ */
+static OCStackResult AddClientCBToIndexes(ClientCB *cbNode)
+{
+    if (!g_cbTokenIndex)
+    {
+        g_cbTokenIndex = u_hashmap_create(HashClientCBToken, MatchClientCBToken);
+    }
+    if (!g_cbHandleIndex)
+    {
+        g_cbHandleIndex = u_hashmap_create(u_hashmap_hash_pointer, MatchClientCBHandle);
+    }
+    if (!g_cbNodeIndex)
+    {
+        g_cbNodeIndex = u_hashmap_create(u_hashmap_hash_pointer, u_hashmap_match_pointer);
+    }
+    if (!g_cbTokenIndex || !g_cbHandleIndex || !g_cbNodeIndex)
+    {
+        return OC_STACK_NO_MEMORY;
+    }
+
+    ClientCBTokenKey tokenKey = { (const uint8_t *) cbNode->token, cbNode->tokenLength };
+    if (!u_hashmap_put(g_cbTokenIndex, &tokenKey, cbNode))
+    {
+        return OC_STACK_NO_MEMORY;
+    }
+    if (!u_hashmap_put(g_cbHandleIndex, cbNode->handle, cbNode))
+    {
+        u_hashmap_remove_data(g_cbTokenIndex, &tokenKey, cbNode);
+        return OC_STACK_NO_MEMORY;
+    }
+    if (!u_hashmap_put(g_cbNodeIndex, cbNode, cbNode))
+    {
+        u_hashmap_remove_data(g_cbTokenIndex, &tokenKey, cbNode);
+        u_hashmap_remove_data(g_cbHandleIndex, cbNode->handle, cbNode);
+        return OC_STACK_NO_MEMORY;
+    }
+    return OC_STACK_OK;
+}
+
+static void RemoveClientCBFromIndexes(ClientCB *cbNode)
+{
+    ClientCBTokenKey tokenKey = { (const uint8_t *) cbNode->token, cbNode->tokenLength };
+    u_hashmap_remove_data(g_cbTokenIndex, &tokenKey, cbNode);
+    u_hashmap_remove_data(g_cbHandleIndex, cbNode->handle, cbNode);
+    u_hashmap_remove_data(g_cbNodeIndex, cbNode, cbNode);
+}
+
+static void ScheduleClientCBTimeout(ClientCB *cbNode)
+{
+    cbNode->timeoutNext = NULL;
+    cbNode->timeoutLink = NULL;
+    if (0 == cbNode->TTL)
+    {
+        return;
+    }
+
+    coap_tick_t slotTime = cbNode->TTL / CB_TIMEOUT_WHEEL_RESOLUTION;
+    // A TTL already behind the wheel goes to the next slot checked.
+    if (g_cbTimeoutWheelStarted && slotTime < g_cbTimeoutWheelTime)
+    {
+        slotTime = g_cbTimeoutWheelTime;
+    }
+
+    ClientCB **slot = &g_cbTimeoutWheel[slotTime & (CB_TIMEOUT_WHEEL_SLOTS - 1)];
+    cbNode->timeoutNext = *slot;
+    if (*slot)
+    {
+        (*slot)->timeoutLink = &cbNode->timeoutNext;
+    }
+    *slot = cbNode;
+    cbNode->timeoutLink = slot;
+    g_cbTimeoutCount++;
+}
+
+static void UnscheduleClientCBTimeout(ClientCB *cbNode)
+{
+    if (!cbNode->timeoutLink)
+    {
+        return;
+    }
+
+    *cbNode->timeoutLink = cbNode->timeoutNext;
+    if (cbNode->timeoutNext)
+    {
+        cbNode->timeoutNext->timeoutLink = cbNode->timeoutLink;
+    }
+    cbNode->timeoutNext = NULL;
+    cbNode->timeoutLink = NULL;
+    g_cbTimeoutCount--;
+}
+
 static void DeleteClientCBInternal(ClientCB * cbNode)
 {
     assert(cbNode);
@@ -56,7 +215,9 @@ static void DeleteClientCBInternal(ClientCB * cbNode)
     OIC_TRACE_BUFFER("OIC_RI_CLIENTCB:DeleteClientCB:token:",
                      (const uint8_t *)cbNode->token, cbNode->tokenLength);
 
-    LL_DELETE(g_cbList, cbNode);
+    RemoveClientCBFromIndexes(cbNode);
+    UnscheduleClientCBTimeout(cbNode);
+    DL_DELETE(g_cbList, cbNode);
     CADestroyToken(cbNode->token);
     OICFree(cbNode->devAddr);
     OICFree(cbNode->handle);
@@ -105,31 +266,6 @@ static void DeleteClientCBInternal(ClientCB * cbNode)
     OIC_TRACE_END();
 }
 
-/*
- * This function checks if the node is past its time to live and
- * deletes it if timed-out. Calling this function with a  presence or observe
- * callback with ttl set to 0 will not delete anything as presence nodes have
- * their own mechanisms for timeouts. A null argument will cause the function to
- * silently return.
- */
-static void CheckAndDeleteTimedOutCB(ClientCB * cbNode)
-{
-    assert(cbNode);
-
-    if (cbNode->TTL == 0)
-    {
-        return;
-    }
-    coap_tick_t now;
-    coap_ticks(&now);
-
-    if (cbNode->TTL < now)
-    {
-        OIC_LOG(INFO, TAG, "Deleting timed-out callback");
-        DeleteClientCBInternal(cbNode);
-    }
-}
-
 #ifdef WITH_PRESENCE
 /**
  * Inserts a new resource type filter into this cb node.
@@ -253,6 +389,7 @@ OCStackResult AddClientCB(ClientCB** clientCB, OCCallbackData* cbData,
         cbNode->handle = *handle;
         cbNode->method = method;
         cbNode->sequenceNumber = 0;
+        cbNode->payloadViewOnly = false;
 #ifdef WITH_PRESENCE
         cbNode->presence = NULL;
         cbNode->interestingPresenceResourceType = NULL;
@@ -268,11 +405,21 @@ OCStackResult AddClientCB(ClientCB** clientCB, OCCallbackData* cbData,
         {
             cbNode->TTL = ttl;
         }
+        if (OC_STACK_OK != AddClientCBToIndexes(cbNode))
+        {
+            OIC_LOG(ERROR, TAG, "Out of memory");
+            OICFree(cbNode->options);
+            OICFree(cbNode->payload);
+            OICFree(cbNode);
+            *clientCB = NULL;
+            goto exit;
+        }
         cbNode->requestUri = requestUri;    // I own it now
         cbNode->devAddr = devAddr;          // I own it now
         OIC_LOG_V(INFO, TAG, "Added Callback for uri : %s", requestUri);
         OIC_TRACE_MARK(%s:AddClientCB:uri:%s, TAG, requestUri);
-        LL_APPEND(g_cbList, cbNode);
+        DL_APPEND(g_cbList, cbNode);
+        ScheduleClientCBTimeout(cbNode);
         *clientCB = cbNode;
     }
 #ifdef WITH_PRESENCE
@@ -319,18 +466,9 @@ exit:
 
 void DeleteClientCB(ClientCB * cbNode)
 {
-    if (cbNode)
+    if (cbNode && u_hashmap_get(g_cbNodeIndex, cbNode))
     {
-        ClientCB* out = NULL;
-        ClientCB* tmp = NULL;
-        LL_FOREACH_SAFE(g_cbList, out, tmp)
-        {
-            if (cbNode == out)
-            {
-                DeleteClientCBInternal(out);
-                break;
-            }
-        }
+        DeleteClientCBInternal(cbNode);
     }
 }
 
@@ -343,6 +481,67 @@ void DeleteClientCBList(void)
         DeleteClientCBInternal(out);
     }
     g_cbList = NULL;
+    FreeClientCBIndexes();
+    g_cbTimeoutWheelStarted = false;
+}
+
+void SetClientCBTimeout(ClientCB *cbNode, uint32_t ttl)
+{
+    if (cbNode && u_hashmap_get(g_cbNodeIndex, cbNode))
+    {
+        UnscheduleClientCBTimeout(cbNode);
+        cbNode->TTL = ttl;
+        ScheduleClientCBTimeout(cbNode);
+    }
+}
+
+void DeleteTimedOutClientCBs(void)
+{
+    coap_tick_t now;
+    coap_ticks(&now);
+    coap_tick_t nowSlotTime = now / CB_TIMEOUT_WHEEL_RESOLUTION;
+
+    if (!g_cbTimeoutWheelStarted || nowSlotTime < g_cbTimeoutWheelTime)
+    {
+        // First run or clock going backwards, check the whole wheel once.
+        g_cbTimeoutWheelTime = (nowSlotTime >= CB_TIMEOUT_WHEEL_SLOTS) ?
+                               nowSlotTime - (CB_TIMEOUT_WHEEL_SLOTS - 1) : 0;
+        g_cbTimeoutWheelStarted = true;
+    }
+    if (!g_cbTimeoutCount)
+    {
+        g_cbTimeoutWheelTime = nowSlotTime;
+        return;
+    }
+
+    // The current slot is checked again next time, its callbacks may not have expired yet.
+    coap_tick_t first = g_cbTimeoutWheelTime;
+    if (nowSlotTime - first >= CB_TIMEOUT_WHEEL_SLOTS)
+    {
+        first = nowSlotTime - (CB_TIMEOUT_WHEEL_SLOTS - 1);
+    }
+    g_cbTimeoutWheelTime = nowSlotTime;
+
+    for (coap_tick_t slotTime = first; slotTime <= nowSlotTime; slotTime++)
+    {
+        ClientCB *cbNode = g_cbTimeoutWheel[slotTime & (CB_TIMEOUT_WHEEL_SLOTS - 1)];
+        while (cbNode)
+        {
+            ClientCB *next = cbNode->timeoutNext;
+            // Callbacks of a later turn of the wheel share the slot.
+            if (cbNode->TTL < now)
+            {
+                OIC_LOG(INFO, TAG, "Deleting timed-out callback");
+                DeleteClientCBInternal(cbNode);
+            }
+            cbNode = next;
+        }
+    }
+}
+
+bool HasClientCBTimeouts(void)
+{
+    return g_cbTimeoutCount > 0;
 }
 
 ClientCB* GetClientCBUsingToken(const CAToken_t token,
@@ -357,18 +556,12 @@ ClientCB* GetClientCBUsingToken(const CAToken_t token,
     OIC_LOG (INFO, TAG, "Looking for token");
     OIC_LOG_BUFFER(INFO, TAG, (const uint8_t *)token, tokenLength);
 
-    ClientCB* out = NULL;
-    ClientCB* tmp = NULL;
-    LL_FOREACH_SAFE(g_cbList, out, tmp)
+    ClientCBTokenKey tokenKey = { (const uint8_t *) token, tokenLength };
+    ClientCB *out = (ClientCB *) u_hashmap_get(g_cbTokenIndex, &tokenKey);
+    if (out)
     {
-        /* de-annotate below line if want to see all token in g_cbList */
-        //OIC_LOG_BUFFER(INFO, TAG, (const uint8_t *)out->token, tokenLength);
-        if (memcmp(out->token, token, tokenLength) == 0)
-        {
-            OIC_LOG(INFO, TAG, "Found in callback list");
-            return out;
-        }
-        CheckAndDeleteTimedOutCB(out);
+        OIC_LOG(INFO, TAG, "Found in callback list");
+        return out;
     }
 
     OIC_LOG(INFO, TAG, "Callback Not found!");
@@ -385,16 +578,11 @@ ClientCB* GetClientCBUsingHandle(const OCDoHandle handle)
 
     OIC_LOG(INFO, TAG,  "Looking for handle");
 
-    ClientCB* out = NULL;
-    ClientCB* tmp = NULL;
-    LL_FOREACH_SAFE(g_cbList, out, tmp)
+    ClientCB *out = (ClientCB *) u_hashmap_get(g_cbHandleIndex, handle);
+    if (out)
     {
-        if (out->handle == handle)
-        {
-            OIC_LOG(INFO, TAG, "Found in callback list");
-            return out;
-        }
-        CheckAndDeleteTimedOutCB(out);
+        OIC_LOG(INFO, TAG, "Found in callback list");
+        return out;
     }
 
     OIC_LOG(INFO, TAG, "Callback Not found!");
@@ -413,8 +601,7 @@ ClientCB* GetClientCBUsingUri(const char *requestUri)
     OIC_LOG_V(INFO, TAG, "Looking for uri %s", requestUri);
 
     ClientCB* out = NULL;
-    ClientCB* tmp = NULL;
-    LL_FOREACH_SAFE(g_cbList, out, tmp)
+    LL_FOREACH(g_cbList, out)
     {
         /* de-annotate below line if want to see all URI in g_cbList */
         //OIC_LOG_V(INFO, TAG, "%s", out->requestUri);
@@ -423,7 +610,6 @@ ClientCB* GetClientCBUsingUri(const char *requestUri)
             OIC_LOG(INFO, TAG, "Found in callback list");
             return out;
         }
-        CheckAndDeleteTimedOutCB(out);
     }
 
     OIC_LOG(INFO, TAG, "Callback Not found!");
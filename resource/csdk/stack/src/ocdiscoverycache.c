@@ -0,0 +1,338 @@
+/* ****************************************************************
+ *
+ * Copyright 2017 Open Connectivity Foundation All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+#include "iotivity_config.h"
+#include <string.h>
+
+#include "ocdiscoverycache.h"
+#include "oic_malloc.h"
+#include "oic_string.h"
+#include "octhread.h"
+#include "uhashmap.h"
+#include "cainterface.h"
+#include "experimental/ocrandom.h"
+#include "experimental/logger.h"
+
+#define TAG "OIC_RI_DISCOVERYCACHE"
+
+#if OC_DISCOVERY_CACHE_SIZE > 0
+
+/**
+ * Cached response. The key is the query and what the response depends on in the
+ * request: the accepted format, and the endpoint which selects the endpoints
+ * and ports listed for each resource.
+ */
+typedef struct OCDiscoveryCacheEntry
+{
+    char *query;
+    OCPayloadFormat acceptFormat;
+    uint16_t acceptVersion;
+    OCTransportAdapter adapter;
+    OCTransportFlags flags;
+    uint32_t ifindex;
+    OCStackResult result;
+    uint8_t *payload;
+    size_t payloadSize;
+} OCDiscoveryCacheEntry;
+
+static oc_mutex g_cacheMutex = NULL;
+static OCDiscoveryCacheEntry g_entries[OC_DISCOVERY_CACHE_SIZE];
+
+/** Next entry to replace. */
+static size_t g_nextEntry = 0;
+
+/** Incremented on each invalidation. */
+static uint32_t g_generation = 0;
+
+/** Device id the responses were built with, the sid of the payload. */
+static char g_sid[UUID_STRING_SIZE];
+
+/** Hash of the network interfaces the responses were built with, see HashNetworks(). */
+static uint32_t g_networkHash = 0;
+
+static void ClearEntries(void)
+{
+    for (size_t i = 0; i < OC_DISCOVERY_CACHE_SIZE; i++)
+    {
+        OICFree(g_entries[i].query);
+        OICFree(g_entries[i].payload);
+    }
+    memset(g_entries, 0, sizeof(g_entries));
+    g_nextEntry = 0;
+    g_generation++;
+}
+
+static bool MatchEntry(const OCDiscoveryCacheEntry *entry, const OCServerRequest *request)
+{
+    return entry->query &&
+           (entry->acceptFormat == request->acceptFormat) &&
+           (entry->acceptVersion == request->acceptVersion) &&
+           (entry->adapter == request->devAddr.adapter) &&
+           (entry->flags == request->devAddr.flags) &&
+           (entry->ifindex == request->devAddr.ifindex) &&
+           (0 == strcmp(entry->query, request->query));
+}
+
+/*
+ * The device id changes when the device is onboarded, the responses built
+ * before carry the former one.
+ */
+static void CheckDeviceId(void)
+{
+    const char *sid = OCGetServerInstanceIDString();
+    if (sid && (0 != strncmp(g_sid, sid, sizeof(g_sid))))
+    {
+        ClearEntries();
+        OICStrcpy(g_sid, sizeof(g_sid), sid);
+    }
+}
+
+/*
+ * Hash the local endpoints listed in the responses. An interface is only reported
+ * once as up (CA_INTERFACE_UP), its address or port may still change later.
+ */
+static uint32_t HashNetworks(void)
+{
+    CAEndpoint_t *info = NULL;
+    size_t size = 0;
+    uint32_t hash = U_HASHMAP_HASH_SEED;
+    if (CA_STATUS_OK != CAGetNetworkInformation(&info, &size))
+    {
+        return hash;
+    }
+
+    for (size_t i = 0; i < size; i++)
+    {
+        const CAEndpoint_t *ep = &info[i];
+        hash = u_hashmap_hash_bytes(&ep->adapter, sizeof(ep->adapter), hash);
+        hash = u_hashmap_hash_bytes(&ep->flags, sizeof(ep->flags), hash);
+        hash = u_hashmap_hash_bytes(&ep->port, sizeof(ep->port), hash);
+        hash = u_hashmap_hash_bytes(&ep->ifindex, sizeof(ep->ifindex), hash);
+        hash = u_hashmap_hash_bytes(ep->addr, strlen(ep->addr), hash);
+    }
+    OICFree(info);
+    return hash;
+}
+
+/*
+ * The responses list the addresses and ports of the local interfaces, those
+ * built before an interface changed list stale ones.
+ */
+static void CheckNetworks(uint32_t networkHash)
+{
+    if (networkHash != g_networkHash)
+    {
+        ClearEntries();
+        g_networkHash = networkHash;
+    }
+}
+
+OCStackResult OCDiscoveryCacheInit(void)
+{
+    if (!g_cacheMutex)
+    {
+        g_cacheMutex = oc_mutex_new();
+        if (!g_cacheMutex)
+        {
+            OIC_LOG(ERROR, TAG, "Failed to create the discovery cache mutex");
+            return OC_STACK_NO_MEMORY;
+        }
+    }
+    return OC_STACK_OK;
+}
+
+void OCDiscoveryCacheTerminate(void)
+{
+    if (g_cacheMutex)
+    {
+        ClearEntries();
+        memset(g_sid, 0, sizeof(g_sid));
+        g_networkHash = 0;
+        oc_mutex_free(g_cacheMutex);
+        g_cacheMutex = NULL;
+    }
+}
+
+void OCDiscoveryCacheInvalidate(void)
+{
+    if (g_cacheMutex)
+    {
+        oc_mutex_lock(g_cacheMutex);
+        ClearEntries();
+        oc_mutex_unlock(g_cacheMutex);
+    }
+}
+
+bool OCDiscoveryCacheIsCacheable(const OCServerRequest *request)
+{
+    if (!g_cacheMutex || !request)
+    {
+        return false;
+    }
+
+    // Other formats are not encoded by the stack.
+    switch (request->acceptFormat)
+    {
+        case OC_FORMAT_UNDEFINED:
+        case OC_FORMAT_CBOR:
+        case OC_FORMAT_VND_OCF_CBOR:
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool OCDiscoveryCacheGet(const OCServerRequest *request, OCStackResult *result,
+                         uint8_t **payload, size_t *payloadSize, uint32_t *generation)
+{
+    if (!OCDiscoveryCacheIsCacheable(request) || !result || !payload || !payloadSize ||
+        !generation)
+    {
+        return false;
+    }
+
+    // Outside of the lock, the adapters are queried.
+    uint32_t networkHash = HashNetworks();
+
+    bool found = false;
+    oc_mutex_lock(g_cacheMutex);
+    CheckDeviceId();
+    CheckNetworks(networkHash);
+    for (size_t i = 0; i < OC_DISCOVERY_CACHE_SIZE; i++)
+    {
+        const OCDiscoveryCacheEntry *entry = &g_entries[i];
+        if (MatchEntry(entry, request))
+        {
+            *payload = NULL;
+            if (entry->payload)
+            {
+                *payload = (uint8_t *) OICMalloc(entry->payloadSize);
+                if (!*payload)
+                {
+                    break;
+                }
+                memcpy(*payload, entry->payload, entry->payloadSize);
+            }
+            *payloadSize = entry->payloadSize;
+            *result = entry->result;
+            found = true;
+            break;
+        }
+    }
+    *generation = g_generation;
+    oc_mutex_unlock(g_cacheMutex);
+    return found;
+}
+
+void OCDiscoveryCachePut(uint32_t generation, const OCServerRequest *request,
+                         OCStackResult result, const uint8_t *payload, size_t payloadSize)
+{
+    if (!OCDiscoveryCacheIsCacheable(request) || (!payload && payloadSize))
+    {
+        return;
+    }
+
+    char *query = OICStrdup(request->query);
+    uint8_t *payloadCopy = NULL;
+    if (payload)
+    {
+        payloadCopy = (uint8_t *) OICMalloc(payloadSize);
+        if (payloadCopy)
+        {
+            memcpy(payloadCopy, payload, payloadSize);
+        }
+    }
+    if (!query || (payload && !payloadCopy))
+    {
+        OIC_LOG(WARNING, TAG, "Not enough memory to cache the discovery response");
+        OICFree(query);
+        OICFree(payloadCopy);
+        return;
+    }
+
+    oc_mutex_lock(g_cacheMutex);
+    if (generation != g_generation)
+    {
+        // The response was built from resources or networks which have changed since.
+        oc_mutex_unlock(g_cacheMutex);
+        OICFree(query);
+        OICFree(payloadCopy);
+        return;
+    }
+
+    OCDiscoveryCacheEntry *entry = &g_entries[g_nextEntry];
+    g_nextEntry = (g_nextEntry + 1) % OC_DISCOVERY_CACHE_SIZE;
+    OICFree(entry->query);
+    OICFree(entry->payload);
+    entry->query = query;
+    entry->acceptFormat = request->acceptFormat;
+    entry->acceptVersion = request->acceptVersion;
+    entry->adapter = request->devAddr.adapter;
+    entry->flags = request->devAddr.flags;
+    entry->ifindex = request->devAddr.ifindex;
+    entry->result = result;
+    entry->payload = payloadCopy;
+    entry->payloadSize = payloadSize;
+    oc_mutex_unlock(g_cacheMutex);
+}
+
+#else // OC_DISCOVERY_CACHE_SIZE > 0
+
+OCStackResult OCDiscoveryCacheInit(void)
+{
+    return OC_STACK_OK;
+}
+
+void OCDiscoveryCacheTerminate(void)
+{
+}
+
+void OCDiscoveryCacheInvalidate(void)
+{
+}
+
+bool OCDiscoveryCacheIsCacheable(const OCServerRequest *request)
+{
+    OC_UNUSED(request);
+    return false;
+}
+
+bool OCDiscoveryCacheGet(const OCServerRequest *request, OCStackResult *result,
+                         uint8_t **payload, size_t *payloadSize, uint32_t *generation)
+{
+    OC_UNUSED(request);
+    OC_UNUSED(result);
+    OC_UNUSED(payload);
+    OC_UNUSED(payloadSize);
+    OC_UNUSED(generation);
+    return false;
+}
+
+void OCDiscoveryCachePut(uint32_t generation, const OCServerRequest *request,
+                         OCStackResult result, const uint8_t *payload, size_t payloadSize)
+{
+    OC_UNUSED(generation);
+    OC_UNUSED(request);
+    OC_UNUSED(result);
+    OC_UNUSED(payload);
+    OC_UNUSED(payloadSize);
+}
+
+#endif // OC_DISCOVERY_CACHE_SIZE > 0
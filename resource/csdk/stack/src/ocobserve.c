@@ -95,17 +95,82 @@ static OCQualityOfService DetermineObserverQoS(OCMethod method,
     return decidedQoS;
 }
 
+/**
+ * Check if two observers receive the same notification payload, i.e. they requested
+ * the same query, accept format and accept version.
+ */
+static bool IsSameNotification(const ResourceObserver *observer, const ResourceObserver *other)
+{
+    if (observer->acceptFormat != other->acceptFormat ||
+        observer->acceptVersion != other->acceptVersion)
+    {
+        return false;
+    }
+    if (!observer->query || !other->query)
+    {
+        return observer->query == other->query;
+    }
+    return 0 == strcmp(observer->query, other->query);
+}
+
+/**
+ * Add the observers following observer in the list which receive the same notification
+ * as targets of the request, so that the entity handler runs and the payload is encoded
+ * only once for all of them.
+ *
+ * @param request Notification request for observer.
+ * @param observer Observer the request was created for.
+ * @param method RESTful method.
+ * @param appQoS Quality of service requested by the application.
+ * @param grouped Flags of the observers already notified, indexed from observer.
+ */
+static void AddObserveNotificationTargets(OCServerRequest *request,
+                                          ResourceObserver *observer,
+                                          OCMethod method,
+                                          OCQualityOfService appQoS,
+                                          bool *grouped)
+{
+    size_t index = 1;
+    for (ResourceObserver *other = observer->next; other; other = other->next, index++)
+    {
+        if (grouped[index] || !IsSameNotification(observer, other))
+        {
+            continue;
+        }
+
+        OCQualityOfService qos = DetermineObserverQoS(method, other, appQoS);
+        if (OC_STACK_OK != AddServerRequestNotificationTarget(request, other->token,
+                                                              other->tokenLength,
+                                                              &other->devAddr, qos))
+        {
+            // The remaining observers are notified one by one.
+            return;
+        }
+        grouped[index] = true;
+        // Reset Observer TTL.
+        other->TTL = GetTicks(MAX_OBSERVER_TTL_SECONDS * MILLISECONDS_PER_SECOND);
+    }
+}
+
 /**
  * Create a get request and pass to entityhandler to notify specific observer.
  *
  * @param observer Observer that need to be notified.
  * @param qos Quality of service of resource.
+ * @param method RESTful method.
+ * @param appQoS Quality of service requested by the application, for grouped observers.
+ * @param grouped Flags of the observers already notified, indexed from observer. If not
+ *                NULL, the following observers receiving the same notification are
+ *                notified with the same response and flagged.
  *
  * @return ::OC_STACK_OK on success, some other value upon failure.
  */
 static OCStackResult SendObserveNotification(ResourceObserver *observer,
                                              uint32_t sequenceNum,
-                                             OCQualityOfService qos)
+                                             OCQualityOfService qos,
+                                             OCMethod method,
+                                             OCQualityOfService appQoS,
+                                             bool *grouped)
 {
     OCStackResult result = OC_STACK_ERROR;
     OCServerRequest * request = NULL;
@@ -120,6 +185,10 @@ static OCStackResult SendObserveNotification(ResourceObserver *observer,
     if (request)
     {
         request->observeResult = OC_STACK_OK;
+        if (result == OC_STACK_OK && grouped)
+        {
+            AddObserveNotificationTargets(request, observer, method, appQoS, grouped);
+        }
         if (result == OC_STACK_OK)
         {
             ResourceHandling resHandling = OC_RESOURCE_VIRTUAL;
@@ -160,16 +229,48 @@ OCStackResult SendAllObserverNotification (OCMethod method, OCResource *resPtr,
     ResourceObserver * resourceObserver = resPtr->observersHead;
     OCServerRequest * request = NULL;
     bool observeErrorFlag = false;
+    OCQualityOfService appQoS = qos;
+
+    // Observers of a resource with an entity handler which asked for the same payload get
+    // the response to a single request. Virtual resources build their payload from the
+    // address of the requester, and routing adds per destination options, so their
+    // observers are notified one by one.
+    bool *grouped = NULL;
+    size_t observerCount = 0;
+#if !defined (ROUTING_GATEWAY) && !defined (ROUTING_EP)
+#ifdef WITH_PRESENCE
+    if (method != OC_REST_PRESENCE)
+#endif
+    {
+        if (OC_UNKNOWN_URI == GetTypeOfVirtualURI(resPtr->uri))
+        {
+            for (ResourceObserver *obs = resPtr->observersHead; obs; obs = obs->next)
+            {
+                observerCount++;
+            }
+            // On allocation failure observers are notified one by one.
+            grouped = (observerCount > 1) ? (bool *) OICCalloc(observerCount, sizeof(bool)) :
+                                            NULL;
+        }
+    }
+#endif
+    size_t index = 0;
 
     // Find clients that are observing this resource
-    while (resourceObserver)
+    for (; resourceObserver; resourceObserver = resourceObserver->next, index++)
     {
+        if (grouped && grouped[index])
+        {
+            // Already notified with a previous observer.
+            continue;
+        }
 #ifdef WITH_PRESENCE
         if (method != OC_REST_PRESENCE)
         {
 #endif
-            qos = DetermineObserverQoS(method, resourceObserver, qos);
-            result = SendObserveNotification(resourceObserver, resPtr->sequenceNum, qos);
+            qos = DetermineObserverQoS(method, resourceObserver, appQoS);
+            result = SendObserveNotification(resourceObserver, resPtr->sequenceNum, qos,
+                                             method, appQoS, grouped ? &grouped[index] : NULL);
 #ifdef WITH_PRESENCE
         }
         else
@@ -193,6 +294,7 @@ OCStackResult SendAllObserverNotification (OCMethod method, OCResource *resPtr,
 
                 if (!presenceResBuf)
                 {
+                    OICFree(grouped);
                     return OC_STACK_NO_MEMORY;
                 }
 
@@ -217,9 +319,8 @@ OCStackResult SendAllObserverNotification (OCMethod method, OCResource *resPtr,
         {
             observeErrorFlag = true;
         }
-
-        resourceObserver = resourceObserver->next;
     }
+    OICFree(grouped);
 
     if (observeErrorFlag)
     {
@@ -449,7 +550,8 @@ static void CheckTimedOutObserver(ResourceObserver* observer, OCResource *resour
     {
         // Send confirmable notification message to observer.
         OIC_LOG(INFO, TAG, "Sending High-QoS notification to observer");
-        SendObserveNotification(observer, resource->sequenceNum, OC_HIGH_QOS);
+        SendObserveNotification(observer, resource->sequenceNum, OC_HIGH_QOS,
+                                OC_REST_GET, OC_HIGH_QOS, NULL);
     }
 }
 
@@ -35,12 +35,50 @@
 #include "ocendpoint.h"
 #include "cacommon.h"
 #include "ocstack.h"
+#include "ocarena.h"
+#include "ocpayloadcbor.h"
+#include "uhashmap.h"
 
 #define TAG "OIC_RI_PAYLOAD"
 #define CSV_SEPARATOR ','
 #define MASK_SECURE_FAMS (OC_FLAG_SECURE | OC_MASK_FAMS)
 
-static void OCFreeRepPayloadValueContents(OCRepPayloadValue* val);
+/**
+ * Number of values from which a representation payload is indexed by name.
+ */
+#define OC_REP_PAYLOAD_INDEX_THRESHOLD (8)
+
+/**
+ * Name index of the values of a representation payload.
+ */
+typedef struct OCRepPayloadIndex
+{
+    /** Values by name. */
+    u_hashmap_t *byName;
+    /** Last value of the list, new values are appended after it. */
+    OCRepPayloadValue *tail;
+} OCRepPayloadIndex;
+
+/**
+ * State of a representation payload private to the OCRepPayload functions. Every
+ * OCRepPayload is allocated as the first member of one by OCRepPayloadCreate*(), so
+ * the layout of the public struct does not change.
+ */
+typedef struct OCRepPayloadRecord
+{
+    OCRepPayload payload;
+    /** Index of the values by name, NULL if they are searched linearly. */
+    OCRepPayloadIndex* index;
+    /** Arena the payload and its values are allocated from, NULL if they are on the heap. */
+    OCArena* arena;
+} OCRepPayloadRecord;
+
+static OCRepPayloadRecord* OCRepPayloadGetRecord(const OCRepPayload* payload)
+{
+    return (OCRepPayloadRecord*)payload;
+}
+
+static void OCFreeRepPayloadValueContents(OCArena* arena, OCRepPayloadValue* val);
 
 void OC_CALL OCPayloadDestroy(OCPayload* payload)
 {
@@ -78,18 +116,60 @@ void OC_CALL OCPayloadDestroy(OCPayload* payload)
 
 OCRepPayload* OC_CALL OCRepPayloadCreate(void)
 {
-    OCRepPayload* payload = (OCRepPayload*)OICCalloc(1, sizeof(OCRepPayload));
+    OCRepPayloadRecord* record = (OCRepPayloadRecord*)OICCalloc(1, sizeof(OCRepPayloadRecord));
 
-    if (!payload)
+    if (!record)
+    {
+        return NULL;
+    }
+
+    record->payload.base.type = PAYLOAD_TYPE_REPRESENTATION;
+
+    return &record->payload;
+}
+
+static OCRepPayload* OCRepPayloadCreateInArena(OCArena* arena)
+{
+    OCRepPayloadRecord* record = (OCRepPayloadRecord*)OCArenaAlloc(arena,
+                                                                  sizeof(OCRepPayloadRecord));
+
+    if (!record)
     {
         return NULL;
     }
 
-    payload->base.type = PAYLOAD_TYPE_REPRESENTATION;
+    OCArenaRetain(arena);
+    record->payload.base.type = PAYLOAD_TYPE_REPRESENTATION;
+    record->arena = arena;
+
+    return &record->payload;
+}
+
+OCRepPayload* OC_CALL OCRepPayloadCreateWithArena(void)
+{
+    OCArena* arena = OCArenaCreate(0);
+    OCRepPayload* payload = OCRepPayloadCreateInArena(arena);
 
+    // The payload holds its own reference.
+    OCArenaRelease(arena);
     return payload;
 }
 
+OCArena* OCRepPayloadGetArena(const OCRepPayload* payload)
+{
+    return payload ? OCRepPayloadGetRecord(payload)->arena : NULL;
+}
+
+OCRepPayload* OC_CALL OCRepPayloadCreateChild(const OCRepPayload* parent)
+{
+    OCArena* arena = OCRepPayloadGetArena(parent);
+    if (arena)
+    {
+        return OCRepPayloadCreateInArena(arena);
+    }
+    return OCRepPayloadCreate();
+}
+
 void OC_CALL OCRepPayloadAppend(OCRepPayload* parent, OCRepPayload* child)
 {
     if (!parent)
@@ -106,6 +186,66 @@ void OC_CALL OCRepPayloadAppend(OCRepPayload* parent, OCRepPayload* child)
     child->next = NULL;
 }
 
+static uint32_t OCRepPayloadIndexHash(const void* key)
+{
+    return u_hashmap_hash_string(key);
+}
+
+static bool OCRepPayloadIndexMatch(const void* key, const void* data)
+{
+    return 0 == strcmp((const char*)key, ((const OCRepPayloadValue*)data)->name);
+}
+
+static void OCRepPayloadIndexFree(OCRepPayload* payload)
+{
+    OCRepPayloadRecord* record = OCRepPayloadGetRecord(payload);
+    if (!record->index)
+    {
+        return;
+    }
+
+    u_hashmap_free(&record->index->byName);
+    if (!record->arena)
+    {
+        OICFree(record->index);
+    }
+    record->index = NULL;
+}
+
+/**
+ * Index the values of a payload by name. Failing to do so is not an error, the
+ * payload values are then searched linearly.
+ */
+static void OCRepPayloadIndexBuild(OCRepPayload* payload)
+{
+    OCRepPayloadRecord* record = OCRepPayloadGetRecord(payload);
+    OCRepPayloadIndex* index = record->arena ?
+        (OCRepPayloadIndex*)OCArenaAlloc(record->arena, sizeof(OCRepPayloadIndex)) :
+        (OCRepPayloadIndex*)OICCalloc(1, sizeof(OCRepPayloadIndex));
+    if (!index)
+    {
+        return;
+    }
+    record->index = index;
+
+    index->byName = u_hashmap_create(OCRepPayloadIndexHash, OCRepPayloadIndexMatch);
+    if (!index->byName)
+    {
+        OCRepPayloadIndexFree(payload);
+        return;
+    }
+
+    for (OCRepPayloadValue* val = payload->values; val; val = val->next)
+    {
+        if (!u_hashmap_put(index->byName, val->name, val))
+        {
+            OCRepPayloadIndexFree(payload);
+            return;
+        }
+        index->tail = val;
+    }
+}
+
 static OCRepPayloadValue* OC_CALL OCRepPayloadFindValue(const OCRepPayload* payload, const char* name)
 {
     if (!payload || !name)
@@ -113,6 +253,12 @@ static OCRepPayloadValue* OC_CALL OCRepPayloadFindValue(const OCRepPayload* payl
         return NULL;
     }
 
+    const OCRepPayloadIndex* index = OCRepPayloadGetRecord(payload)->index;
+    if (index)
+    {
+        return (OCRepPayloadValue*)u_hashmap_get(index->byName, name);
+    }
+
     OCRepPayloadValue* val = payload->values;
     while(val)
     {
@@ -225,7 +371,19 @@ exit:
     return;
 }
 
-static void OCFreeRepPayloadValueContents(OCRepPayloadValue* val)
+/**
+ * Free memory referenced by a value. Memory of the arena of the payload, if it has
+ * one, is left to the arena.
+ */
+static void OCRepPayloadFreeMemory(OCArena* arena, void* memory)
+{
+    if (!arena || !OCArenaOwns(arena, memory))
+    {
+        OICFree(memory);
+    }
+}
+
+static void OCFreeRepPayloadValueContents(OCArena* arena, OCRepPayloadValue* val)
 {
     if (!val)
     {
@@ -234,11 +392,11 @@ static void OCFreeRepPayloadValueContents(OCRepPayloadValue* val)
 
     if (val->type == OCREP_PROP_STRING)
     {
-        OICFree(val->str);
+        OCRepPayloadFreeMemory(arena, val->str);
     }
     else if (val->type == OCREP_PROP_BYTE_STRING)
     {
-        OICFree(val->ocByteStr.bytes);
+        OCRepPayloadFreeMemory(arena, val->ocByteStr.bytes);
     }
     else if (val->type == OCREP_PROP_OBJECT)
     {
@@ -254,31 +412,31 @@ static void OCFreeRepPayloadValueContents(OCRepPayloadValue* val)
             case OCREP_PROP_BOOL:
                 // Since this is a union, iArray will
                 // point to all of the above
-                OICFree(val->arr.iArray);
+                OCRepPayloadFreeMemory(arena, val->arr.iArray);
                 break;
             case OCREP_PROP_STRING:
                 for(size_t i = 0; i < dimTotal; ++i)
                 {
-                    OICFree(val->arr.strArray[i]);
+                    OCRepPayloadFreeMemory(arena, val->arr.strArray[i]);
                 }
-                OICFree(val->arr.strArray);
+                OCRepPayloadFreeMemory(arena, val->arr.strArray);
                 break;
             case OCREP_PROP_BYTE_STRING:
                 for (size_t i = 0; i < dimTotal; ++i)
                 {
                     if (val->arr.ocByteStrArray[i].bytes)
                     {
-                        OICFree(val->arr.ocByteStrArray[i].bytes);
+                        OCRepPayloadFreeMemory(arena, val->arr.ocByteStrArray[i].bytes);
                     }
                 }
-                OICFree(val->arr.ocByteStrArray);
+                OCRepPayloadFreeMemory(arena, val->arr.ocByteStrArray);
                 break;
             case OCREP_PROP_OBJECT: // This case is the temporary fix for string input
                 for(size_t i = 0; i< dimTotal; ++i)
                 {
                     OCRepPayloadDestroy(val->arr.objArray[i]);
                 }
-                OICFree(val->arr.objArray);
+                OCRepPayloadFreeMemory(arena, val->arr.objArray);
                 break;
             case OCREP_PROP_NULL:
             case OCREP_PROP_ARRAY:
@@ -289,17 +447,23 @@ static void OCFreeRepPayloadValueContents(OCRepPayloadValue* val)
     }
 }
 
-static void OC_CALL OCFreeRepPayloadValue(OCRepPayloadValue* val)
+/**
+ * Free a list of values. Values allocated from an arena only have their contents
+ * freed, the arena releases the rest.
+ */
+static void OC_CALL OCFreeRepPayloadValue(OCRepPayloadValue* val, OCArena* arena)
 {
-    if (!val)
+    while (val)
     {
-        return;
+        OCRepPayloadValue* next = val->next;
+        OCFreeRepPayloadValueContents(arena, val);
+        if (!arena)
+        {
+            OICFree(val->name);
+            OICFree(val);
+        }
+        val = next;
     }
-
-    OICFree(val->name);
-    OCFreeRepPayloadValueContents(val);
-    OCFreeRepPayloadValue(val->next);
-    OICFree(val);
 }
 static OCRepPayloadValue* OC_CALL OCRepPayloadValueClone (OCRepPayloadValue* source)
 {
@@ -329,7 +493,7 @@ static OCRepPayloadValue* OC_CALL OCRepPayloadValueClone (OCRepPayloadValue* sou
         destIter->next = (OCRepPayloadValue*) OICCalloc(1, sizeof(OCRepPayloadValue));
         if (!destIter->next)
         {
-            OCFreeRepPayloadValue (headOfClone);
+            OCFreeRepPayloadValue (headOfClone, NULL);
             return NULL;
         }
 
@@ -343,64 +507,110 @@ static OCRepPayloadValue* OC_CALL OCRepPayloadValueClone (OCRepPayloadValue* sou
     return headOfClone;
 }
 
-static OCRepPayloadValue* OC_CALL OCRepPayloadFindAndSetValue(OCRepPayload* payload, const char* name,
+static OCRepPayloadValue* OCRepPayloadValueCreate(OCRepPayload* payload, const char* name,
         OCRepPayloadPropType type)
 {
-    if (!payload || !name)
+    OCRepPayloadValue* val = NULL;
+    OCArena* arena = OCRepPayloadGetRecord(payload)->arena;
+
+    if (arena)
     {
-        return NULL;
+        val = (OCRepPayloadValue*)OCArenaAlloc(arena, sizeof(OCRepPayloadValue));
+        if (!val)
+        {
+            return NULL;
+        }
+        val->name = OCArenaStrdup(arena, name);
+        if (!val->name)
+        {
+            return NULL;
+        }
     }
-
-    OCRepPayloadValue* val = payload->values;
-    if (val == NULL)
+    else
     {
-        payload->values = (OCRepPayloadValue*)OICCalloc(1, sizeof(OCRepPayloadValue));
-        if (!payload->values)
+        val = (OCRepPayloadValue*)OICCalloc(1, sizeof(OCRepPayloadValue));
+        if (!val)
         {
             return NULL;
         }
-        payload->values->name = OICStrdup(name);
-        if (!payload->values->name)
+        val->name = OICStrdup(name);
+        if (!val->name)
         {
-            OICFree(payload->values);
-            payload->values = NULL;
+            OICFree(val);
             return NULL;
         }
-        payload->values->type =type;
-        return payload->values;
     }
 
-    while(val)
+    val->type = type;
+    return val;
+}
+
+static OCRepPayloadValue* OC_CALL OCRepPayloadFindAndSetValue(OCRepPayload* payload, const char* name,
+        OCRepPayloadPropType type)
+{
+    if (!payload || !name)
     {
-        if (0 == strcmp(val->name, name))
+        return NULL;
+    }
+
+    OCRepPayloadRecord* record = OCRepPayloadGetRecord(payload);
+    OCRepPayloadValue* tail = NULL;
+    size_t count = 0;
+    if (record->index)
+    {
+        OCRepPayloadValue* val = (OCRepPayloadValue*)u_hashmap_get(record->index->byName, name);
+        if (val)
         {
-            OCFreeRepPayloadValueContents(val);
+            OCFreeRepPayloadValueContents(record->arena, val);
             val->type = type;
             return val;
         }
-        else if (val->next == NULL)
+        tail = record->index->tail;
+    }
+    else
+    {
+        for (OCRepPayloadValue* val = payload->values; val; val = val->next)
         {
-            val->next = (OCRepPayloadValue*)OICCalloc(1, sizeof(OCRepPayloadValue));
-            if (!val->next)
+            if (0 == strcmp(val->name, name))
             {
-                return NULL;
+                OCFreeRepPayloadValueContents(record->arena, val);
+                val->type = type;
+                return val;
             }
-            val->next->name = OICStrdup(name);
-            if (!val->next->name)
-            {
-                OICFree(val->next);
-                val->next = NULL;
-                return NULL;
-            }
-            val->next->type =type;
-            return val->next;
+            tail = val;
+            count++;
         }
+    }
 
-        val = val->next;
+    OCRepPayloadValue* val = OCRepPayloadValueCreate(payload, name, type);
+    if (!val)
+    {
+        return NULL;
     }
 
-    OIC_LOG(ERROR, TAG, "FindAndSetValue reached point after while loop, pointer corruption?");
-    return NULL;
+    if (tail)
+    {
+        tail->next = val;
+    }
+    else
+    {
+        payload->values = val;
+    }
+
+    if (record->index)
+    {
+        record->index->tail = val;
+        if (!u_hashmap_put(record->index->byName, val->name, val))
+        {
+            OCRepPayloadIndexFree(payload);
+        }
+    }
+    else if (count + 1 >= OC_REP_PAYLOAD_INDEX_THRESHOLD)
+    {
+        OCRepPayloadIndexBuild(payload);
+    }
+
+    return val;
 }
 
 bool OC_CALL OCRepPayloadAddResourceType(OCRepPayload* payload, const char* resourceType)
@@ -1601,6 +1811,10 @@ OCRepPayload* OC_CALL OCRepPayloadClone (const OCRepPayload* payload)
     clone->types = CloneOCStringLL (payload->types);
     clone->interfaces = CloneOCStringLL (payload->interfaces);
     clone->values = OCRepPayloadValueClone (payload->values);
+    if (OCRepPayloadGetRecord(payload)->index)
+    {
+        OCRepPayloadIndexBuild(clone);
+    }
 
     return clone;
 }
@@ -1624,6 +1838,10 @@ OCRepPayload* OC_CALL OCRepPayloadBatchClone(const OCRepPayload* repPayload)
     clone->types  = CloneOCStringLL(repPayload->types);
     clone->interfaces  = CloneOCStringLL(repPayload->interfaces);
     clone->values = OCRepPayloadValueClone(repPayload->values);
+    if (OCRepPayloadGetRecord(repPayload)->index)
+    {
+        OCRepPayloadIndexBuild(clone);
+    }
     OCRepPayloadSetPropObjectAsOwner(newPayload, OC_RSRVD_REPRESENTATION, clone);
 
     return newPayload;
@@ -1639,9 +1857,18 @@ void OC_CALL OCRepPayloadDestroy(OCRepPayload* payload)
     OICFree(payload->uri);
     OCFreeOCStringLL(payload->types);
     OCFreeOCStringLL(payload->interfaces);
-    OCFreeRepPayloadValue(payload->values);
+    OCArena* arena = OCRepPayloadGetRecord(payload)->arena;
+    OCRepPayloadIndexFree(payload);
+    OCFreeRepPayloadValue(payload->values, arena);
     OCRepPayloadDestroy(payload->next);
-    OICFree(payload);
+    if (arena)
+    {
+        OCArenaRelease(arena);
+    }
+    else
+    {
+        OICFree(payload);
+    }
 }
 
 OCDiscoveryPayload* OC_CALL OCDiscoveryPayloadCreate(void)
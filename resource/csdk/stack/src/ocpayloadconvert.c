@@ -21,6 +21,8 @@
 #include "ocpayloadcbor.h"
 #include "platform_features.h"
 #include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
 #include "oic_malloc.h"
 #include "oic_string.h"
 #include "experimental/logger.h"
@@ -43,19 +45,13 @@
 
 // Functions all return either a CborError, or a negative version of the OC_STACK return values
 static int64_t OCConvertPayloadHelper(OCPayload *payload, OCPayloadFormat format,
-        uint8_t *outPayload, size_t *size);
+        CborEncoder *encoder);
 static int64_t OCConvertDiscoveryPayload(OCDiscoveryPayload *payload, OCPayloadFormat format,
-        uint8_t *outPayload, size_t *size);
-static int64_t OCConvertRepPayload(OCRepPayload *payload, uint8_t *outPayload, size_t *size);
+        CborEncoder *encoder);
+static int64_t OCConvertRepPayload(OCRepPayload *payload, CborEncoder *encoder);
 static int64_t OCConvertRepMap(CborEncoder *map, const OCRepPayload *payload);
-static int64_t OCConvertPresencePayload(OCPresencePayload *payload, uint8_t *outPayload,
-        size_t *size);
-static int64_t OCConvertDiagnosticPayload(OCDiagnosticPayload *payload, uint8_t *outPayload,
-        size_t *size);
-static int64_t OCConvertSecurityPayload(OCSecurityPayload *payload, uint8_t *outPayload,
-        size_t *size);
-static int64_t OCConvertIntrospectionPayload(OCIntrospectionPayload *payload, uint8_t *outPayload,
-        size_t *size);
+static int64_t OCConvertPresencePayload(OCPresencePayload *payload, CborEncoder *encoder);
+static int64_t OCConvertDiagnosticPayload(OCDiagnosticPayload *payload, CborEncoder *encoder);
 static int64_t OCConvertSingleRepPayloadValue(CborEncoder *parent, const OCRepPayloadValue *value);
 static int64_t OCConvertSingleRepPayload(CborEncoder *parent, const OCRepPayload *payload);
 static int64_t OCConvertArray(CborEncoder *parent, const OCRepPayloadValueArray *valArray);
@@ -65,145 +61,157 @@ static int64_t AddTextStringToMap(CborEncoder *map, const char *key, size_t keyl
 static int64_t ConditionalAddTextStringToMap(CborEncoder *map, const char *key, size_t keylen,
         const char *value);
 
+/**
+ * Output buffer of the encoder. It grows as tinycbor appends to it so that a
+ * payload is encoded once whatever its size.
+ */
+typedef struct
+{
+    uint8_t *data;      /**< Encoded bytes. */
+    size_t size;        /**< Number of bytes encoded so far. */
+    size_t capacity;    /**< Allocated size of data. */
+} OCPayloadBuffer;
+
+static CborError OCPayloadBufferWrite(void *token, const void *data, size_t len,
+        CborEncoderAppendType appendType)
+{
+    OC_UNUSED(appendType);
+    OCPayloadBuffer *buffer = (OCPayloadBuffer *)token;
+
+    if (len > buffer->capacity - buffer->size)
+    {
+        size_t capacity = buffer->capacity ? buffer->capacity : INIT_SIZE;
+        while (len > capacity - buffer->size)
+        {
+            if (capacity > SIZE_MAX / 2)
+            {
+                return CborErrorOutOfMemory;
+            }
+            capacity *= 2;
+        }
+        uint8_t *grown = (uint8_t *)OICRealloc(buffer->data, capacity);
+        if (!grown)
+        {
+            return CborErrorOutOfMemory;
+        }
+        buffer->data = grown;
+        buffer->capacity = capacity;
+    }
+
+    memcpy(buffer->data + buffer->size, data, len);
+    buffer->size += len;
+    return CborNoError;
+}
+
+static OCStackResult OCCopyPayloadBytes(const uint8_t *bytes, size_t len,
+        uint8_t **outPayload, size_t *size)
+{
+    uint8_t *out = (uint8_t *)OICCalloc(1, len ? len : 1);
+    if (!out)
+    {
+        OIC_LOG(ERROR, TAG, "Failed to allocate payload");
+        return OC_STACK_NO_MEMORY;
+    }
+    if (len)
+    {
+        memcpy(out, bytes, len);
+    }
+    *outPayload = out;
+    *size = len;
+    return OC_STACK_OK;
+}
+
 OCStackResult OCConvertPayload(OCPayload* payload, OCPayloadFormat format,
         uint8_t** outPayload, size_t* size)
 {
-    // TinyCbor Version 47a78569c0 or better on master is required for the re-allocation
-    // strategy to work.  If you receive the following assertion error, please do a git-pull
-    // from the extlibs/tinycbor/tinycbor directory
-    #define CborNeedsUpdating  (((unsigned int)CborErrorOutOfMemory) < ((unsigned int)CborErrorDataTooLarge))
-    OC_STATIC_ASSERT(!CborNeedsUpdating, "tinycbor needs to be updated to at least 47a78569c0");
-    #undef CborNeedsUpdating
-
     OCStackResult ret = OC_STACK_INVALID_PARAM;
-    int64_t err = CborErrorOutOfMemory;
-    uint8_t *out = NULL;
-    size_t curSize = INIT_SIZE;
+    int64_t err = CborNoError;
+    OCPayloadBuffer buffer = { NULL, 0, 0 };
+    CborEncoder encoder;
 
     VERIFY_PARAM_NON_NULL(TAG, payload, "Input param, payload is NULL");
     VERIFY_PARAM_NON_NULL(TAG, outPayload, "OutPayload parameter is NULL");
     VERIFY_PARAM_NON_NULL(TAG, size, "size parameter is NULL");
 
     OIC_LOG_V(INFO, TAG, "Converting payload of type %d", payload->type);
+
+    // Security and introspection payloads are already encoded.
     if (PAYLOAD_TYPE_SECURITY == payload->type)
     {
-        size_t securityPayloadSize = ((OCSecurityPayload *)payload)->payloadSize;
-        if (securityPayloadSize > 0)
-        {
-            curSize = securityPayloadSize;
-        }
+        OCSecurityPayload *securityPayload = (OCSecurityPayload *)payload;
+        return OCCopyPayloadBytes(securityPayload->securityData, securityPayload->payloadSize,
+                                  outPayload, size);
     }
     if (PAYLOAD_TYPE_INTROSPECTION == payload->type)
     {
-        size_t introspectionPayloadSize = ((OCIntrospectionPayload *)payload)->cborPayload.len;
-        if (introspectionPayloadSize > 0)
-        {
-            curSize = introspectionPayloadSize;
-        }
+        OCIntrospectionPayload *introspectionPayload = (OCIntrospectionPayload *)payload;
+        return OCCopyPayloadBytes(introspectionPayload->cborPayload.bytes,
+                                  introspectionPayload->cborPayload.len, outPayload, size);
     }
 
-    ret = OC_STACK_NO_MEMORY;
-
-    for (;;)
-    {
-        out = (uint8_t *)OICCalloc(1, curSize);
-        VERIFY_PARAM_NON_NULL(TAG, out, "Failed to allocate payload");
-        err = OCConvertPayloadHelper(payload, format, out, &curSize);
-
-        if ((CborErrorOutOfMemory & err) == 0)
-        {
-            break;
-        }
-
-        OICFree(out);
-    }
+    cbor_encoder_init_writer(&encoder, OCPayloadBufferWrite, &buffer);
+    err = OCConvertPayloadHelper(payload, format, &encoder);
 
     if (err == CborNoError)
     {
-        if ((curSize < INIT_SIZE) &&
-            (PAYLOAD_TYPE_SECURITY != payload->type) &&
-            (PAYLOAD_TYPE_INTROSPECTION != payload->type))
+        // Give back the unused part of the last growth.
+        if (buffer.size < buffer.capacity)
         {
-            uint8_t *out2 = (uint8_t *)OICRealloc(out, curSize);
-            VERIFY_PARAM_NON_NULL(TAG, out2, "Failed to increase payload size");
-            out = out2;
+            uint8_t *out = (uint8_t *)OICRealloc(buffer.data, buffer.size ? buffer.size : 1);
+            if (out)
+            {
+                buffer.data = out;
+            }
         }
 
-        *size = curSize;
-        *outPayload = out;
+        *size = buffer.size;
+        *outPayload = buffer.data;
         OIC_LOG_V(DEBUG, TAG, "Payload Size: %zd Payload : ", *size);
         OIC_LOG_BUFFER(DEBUG, TAG, *outPayload, *size);
         return OC_STACK_OK;
     }
 
-    //TODO: Proper conversion from CborError to OCStackResult.
-    ret = (OCStackResult)-err;
+    if (err & CborErrorOutOfMemory)
+    {
+        ret = OC_STACK_NO_MEMORY;
+    }
+    else
+    {
+        //TODO: Proper conversion from CborError to OCStackResult.
+        ret = (OCStackResult)-err;
+    }
 
 exit:
-    OICFree(out);
+    OICFree(buffer.data);
     return ret;
 }
 
 static int64_t OCConvertPayloadHelper(OCPayload* payload, OCPayloadFormat format,
-        uint8_t* outPayload, size_t* size)
+        CborEncoder* encoder)
 {
     switch(payload->type)
     {
         case PAYLOAD_TYPE_DISCOVERY:
-            return OCConvertDiscoveryPayload((OCDiscoveryPayload*)payload, format,
-                    outPayload, size);
+            return OCConvertDiscoveryPayload((OCDiscoveryPayload*)payload, format, encoder);
         case PAYLOAD_TYPE_REPRESENTATION:
-            return OCConvertRepPayload((OCRepPayload*)payload, outPayload, size);
+            return OCConvertRepPayload((OCRepPayload*)payload, encoder);
         case PAYLOAD_TYPE_PRESENCE:
-            return OCConvertPresencePayload((OCPresencePayload*)payload, outPayload, size);
+            return OCConvertPresencePayload((OCPresencePayload*)payload, encoder);
         case PAYLOAD_TYPE_DIAGNOSTIC:
-            return OCConvertDiagnosticPayload((OCDiagnosticPayload*)payload, outPayload, size);
-        case PAYLOAD_TYPE_SECURITY:
-            return OCConvertSecurityPayload((OCSecurityPayload*)payload, outPayload, size);
-        case PAYLOAD_TYPE_INTROSPECTION:
-            return OCConvertIntrospectionPayload((OCIntrospectionPayload*)payload,
-                                                 outPayload, size);
+            return OCConvertDiagnosticPayload((OCDiagnosticPayload*)payload, encoder);
         default:
             OIC_LOG_V(INFO, TAG, "ConvertPayload default %d", payload->type);
             return CborErrorUnknownType;
     }
 }
 
-static int64_t checkError(int64_t err, CborEncoder* encoder, uint8_t* outPayload, size_t* size)
+static int64_t checkError(int64_t err)
 {
-    if (err & CborErrorOutOfMemory)
-    {
-        *size += cbor_encoder_get_extra_bytes_needed(encoder);
-        return err;
-    }
-    else if (err != CborNoError)
+    if (err != CborNoError)
     {
         OIC_LOG_V(ERROR, TAG, "Convert Payload failed : %s", cbor_error_string(err));
-        return err;
     }
-    else
-    {
-        *size = cbor_encoder_get_buffer_size(encoder, outPayload);
-        return err;
-    }
-}
-
-static int64_t OCConvertSecurityPayload(OCSecurityPayload* payload, uint8_t* outPayload,
-        size_t* size)
-{
-    memcpy(outPayload, payload->securityData, payload->payloadSize);
-    *size = payload->payloadSize;
-
-    return CborNoError;
-}
-
-static int64_t OCConvertIntrospectionPayload(OCIntrospectionPayload *payload,
-        uint8_t *outPayload, size_t *size)
-{
-    memcpy(outPayload, payload->cborPayload.bytes, payload->cborPayload.len);
-    *size = payload->cborPayload.len;
-
-    return CborNoError;
+    return err;
 }
 
 static int64_t OCStringLLJoin(CborEncoder *map, char *type, OCStringLL *val)
@@ -360,13 +368,10 @@ exit:
 }
 
 static int64_t OCConvertDiscoveryPayloadCbor(OCDiscoveryPayload *payload,
-                                             uint8_t *outPayload, size_t *size)
+                                             CborEncoder *encoder)
 {
-    CborEncoder encoder;
     int64_t err = CborNoError;
 
-    cbor_encoder_init(&encoder, outPayload, *size, 0);
-
     /*
     The format for the payload is "modelled" as JSON.
 
@@ -402,7 +407,7 @@ static int64_t OCConvertDiscoveryPayloadCbor(OCDiscoveryPayload *payload,
         arrayCount++;
     }
     CborEncoder rootArray;
-    err |= cbor_encoder_create_array(&encoder, &rootArray, arrayCount);
+    err |= cbor_encoder_create_array(encoder, &rootArray, arrayCount);
     VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, err, "Failed creating discovery root array");
 
     while (payload && payload->resources)
@@ -478,21 +483,18 @@ static int64_t OCConvertDiscoveryPayloadCbor(OCDiscoveryPayload *payload,
     }
 
     // Close the final root array.
-    err |= cbor_encoder_close_container(&encoder, &rootArray);
+    err |= cbor_encoder_close_container(encoder, &rootArray);
     VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, err, "Failed closing root array");
 
 exit:
-    return checkError(err, &encoder, outPayload, size);
+    return checkError(err);
 }
 
 static int64_t OCConvertDiscoveryPayloadVndOcfCbor(OCDiscoveryPayload *payload,
-                                                   uint8_t *outPayload, size_t *size)
+                                                   CborEncoder *encoder)
 {
-    CborEncoder encoder;
     int64_t err = CborNoError;
 
-    cbor_encoder_init(&encoder, outPayload, *size, 0);
-
     /*
     The format for the payload is "modelled" as JSON.
 
@@ -516,7 +518,7 @@ static int64_t OCConvertDiscoveryPayloadVndOcfCbor(OCDiscoveryPayload *payload,
     if (isBaseline)
     {
         // Open the root array
-        err |= cbor_encoder_create_array(&encoder, &rootArray, 1);
+        err |= cbor_encoder_create_array(encoder, &rootArray, 1);
         VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, err, "Failed creating discovery root array");
 
         // Open the root map
@@ -545,7 +547,7 @@ static int64_t OCConvertDiscoveryPayloadVndOcfCbor(OCDiscoveryPayload *payload,
     }
     else
     {
-        err |= cbor_encoder_create_array(&encoder, &linkArray, CborIndefiniteLength);
+        err |= cbor_encoder_create_array(encoder, &linkArray, CborIndefiniteLength);
         VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, err, "Failed creating discovery root array");
     }
 
@@ -674,30 +676,30 @@ static int64_t OCConvertDiscoveryPayloadVndOcfCbor(OCDiscoveryPayload *payload,
         VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, err, "Failed closing root map");
 
         // Close the final root array.
-        err |= cbor_encoder_close_container(&encoder, &rootArray);
+        err |= cbor_encoder_close_container(encoder, &rootArray);
         VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, err, "Failed closing root map");
     }
     else
     {
         // Close the final root array.
-        err |= cbor_encoder_close_container(&encoder, &linkArray);
+        err |= cbor_encoder_close_container(encoder, &linkArray);
         VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, err, "Failed closing root array");
     }
 
 exit:
-    return checkError(err, &encoder, outPayload, size);
+    return checkError(err);
 }
 
 static int64_t OCConvertDiscoveryPayload(OCDiscoveryPayload *payload, OCPayloadFormat format,
-                                         uint8_t *outPayload, size_t *size)
+                                         CborEncoder *encoder)
 {
     if (OC_FORMAT_VND_OCF_CBOR == format)
     {
-        return OCConvertDiscoveryPayloadVndOcfCbor(payload, outPayload, size);
+        return OCConvertDiscoveryPayloadVndOcfCbor(payload, encoder);
     }
     else
     {
-        return OCConvertDiscoveryPayloadCbor(payload, outPayload, size);
+        return OCConvertDiscoveryPayloadCbor(payload, encoder);
     }
 }
 
@@ -935,13 +937,10 @@ exit:
     return err;
 }
 
-static int64_t OCConvertRepPayload(OCRepPayload *payload, uint8_t *outPayload, size_t *size)
+static int64_t OCConvertRepPayload(OCRepPayload *payload, CborEncoder *encoder)
 {
-    CborEncoder encoder;
     int64_t err = CborNoError;
 
-    cbor_encoder_init(&encoder, outPayload, *size, 0);
-
     size_t arrayCount = 0;
     for (OCRepPayload *temp = payload; temp; temp = temp->next)
     {
@@ -950,14 +949,14 @@ static int64_t OCConvertRepPayload(OCRepPayload *payload, uint8_t *outPayload, s
     CborEncoder rootArray;
     if (arrayCount > 1)
     {
-        err |= cbor_encoder_create_array(&encoder, &rootArray, arrayCount);
+        err |= cbor_encoder_create_array(encoder, &rootArray, arrayCount);
         VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, err, "Failed adding rep root map");
     }
 
     while (payload != NULL && (err == CborNoError))
     {
         CborEncoder rootMap;
-        err |= cbor_encoder_create_map(((arrayCount == 1)? &encoder: &rootArray),
+        err |= cbor_encoder_create_map(((arrayCount == 1)? encoder: &rootArray),
                                             &rootMap, CborIndefiniteLength);
         VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, err, "Failed creating root map");
 
@@ -965,30 +964,27 @@ static int64_t OCConvertRepPayload(OCRepPayload *payload, uint8_t *outPayload, s
         VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, err, "Failed setting rep payload");
 
         // Close main array
-        err |= cbor_encoder_close_container(((arrayCount == 1) ? &encoder: &rootArray),
+        err |= cbor_encoder_close_container(((arrayCount == 1) ? encoder: &rootArray),
                 &rootMap);
         VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, err, "Failed closing root map");
         payload = payload->next;
     }
     if (arrayCount > 1)
     {
-        err |= cbor_encoder_close_container(&encoder, &rootArray);
+        err |= cbor_encoder_close_container(encoder, &rootArray);
         VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, err, "Failed closing root array");
     }
 
 exit:
-    return checkError(err, &encoder, outPayload, size);
+    return checkError(err);
 }
 
-static int64_t OCConvertPresencePayload(OCPresencePayload *payload, uint8_t *outPayload,
-        size_t *size)
+static int64_t OCConvertPresencePayload(OCPresencePayload *payload, CborEncoder *encoder)
 {
     int64_t err = CborNoError;
-    CborEncoder encoder;
 
-    cbor_encoder_init(&encoder, outPayload, *size, 0);
     CborEncoder map;
-    err |= cbor_encoder_create_map(&encoder, &map, CborIndefiniteLength);
+    err |= cbor_encoder_create_map(encoder, &map, CborIndefiniteLength);
     VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, err, "Failed creating presence map");
 
     // Sequence Number
@@ -1018,27 +1014,23 @@ static int64_t OCConvertPresencePayload(OCPresencePayload *payload, uint8_t *out
     }
 
     // Close Map
-    err |= cbor_encoder_close_container(&encoder, &map);
+    err |= cbor_encoder_close_container(encoder, &map);
     VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, err, "Failed closing presence map");
 
 exit:
-    return checkError(err, &encoder, outPayload, size);
+    return checkError(err);
 }
 
-static int64_t OCConvertDiagnosticPayload(OCDiagnosticPayload *payload, uint8_t *outPayload,
-        size_t *size)
+static int64_t OCConvertDiagnosticPayload(OCDiagnosticPayload *payload, CborEncoder *encoder)
 {
     int64_t err = CborNoError;
-    CborEncoder encoder;
-
-    cbor_encoder_init(&encoder, outPayload, *size, 0);
 
     // Message
-    err |= cbor_encode_text_string(&encoder, payload->message, strlen(payload->message));
+    err |= cbor_encode_text_string(encoder, payload->message, strlen(payload->message));
     VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, err, "Failed adding message");
 
 exit:
-    return checkError(err, &encoder, outPayload, size);
+    return checkError(err);
 }
 
 static int64_t AddTextStringToMap(CborEncoder* map, const char* key, size_t keylen,
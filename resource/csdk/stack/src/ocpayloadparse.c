@@ -37,6 +37,7 @@
 #include "experimental/payload_logging.h"
 #include "platform_features.h"
 #include "ocendpoint.h"
+#include "ocarena.h"
 
 #define TAG "OIC_RI_PAYLOADPARSE"
 
@@ -45,16 +46,22 @@
  */
 #define UINT64_MAX_STRLEN 20
 
+/*
+ * Size of the buffer property names are parsed into, longer names are allocated.
+ */
+#define NAME_BUFFER_SIZE 64
+
 static OCStackResult OCParseDiscoveryPayload(OCPayload **outPayload, OCPayloadFormat format,
         CborValue *arrayVal);
-static CborError OCParseSingleRepPayload(OCRepPayload **outPayload, CborValue *repParent, bool isRoot);
-static OCStackResult OCParseRepPayload(OCPayload **outPayload, CborValue *arrayVal);
+static CborError OCParseSingleRepPayload(OCRepPayload **outPayload, CborValue *repParent, bool isRoot,
+        const OCRepPayload *parent);
+static OCStackResult OCParseRepPayload(OCPayload **outPayload, CborValue *arrayVal, bool inArena);
 static OCStackResult OCParsePresencePayload(OCPayload **outPayload, CborValue *arrayVal);
 static OCStackResult OCParseDiagnosticPayload(OCPayload **outPayload, CborValue *arrayVal);
 static OCStackResult OCParseSecurityPayload(OCPayload **outPayload, const uint8_t *payload, size_t size);
 
-OCStackResult OCParsePayload(OCPayload **outPayload, OCPayloadFormat payloadFormat,
-        OCPayloadType payloadType, const uint8_t *payload, size_t payloadSize)
+static OCStackResult OCParsePayloadHelper(OCPayload **outPayload, OCPayloadFormat payloadFormat,
+        OCPayloadType payloadType, const uint8_t *payload, size_t payloadSize, bool inArena)
 {
     OCStackResult result = OC_STACK_MALFORMED_RESPONSE;
     CborError err;
@@ -77,7 +84,7 @@ OCStackResult OCParsePayload(OCPayload **outPayload, OCPayloadFormat payloadForm
             result = OCParseDiscoveryPayload(outPayload, payloadFormat, &rootValue);
             break;
         case PAYLOAD_TYPE_REPRESENTATION:
-            result = OCParseRepPayload(outPayload, &rootValue);
+            result = OCParseRepPayload(outPayload, &rootValue, inArena);
             break;
         case PAYLOAD_TYPE_PRESENCE:
             result = OCParsePresencePayload(outPayload, &rootValue);
@@ -100,6 +107,72 @@ exit:
     return result;
 }
 
+OCStackResult OCParsePayload(OCPayload **outPayload, OCPayloadFormat payloadFormat,
+        OCPayloadType payloadType, const uint8_t *payload, size_t payloadSize)
+{
+    return OCParsePayloadHelper(outPayload, payloadFormat, payloadType, payload, payloadSize,
+                                false);
+}
+
+OCStackResult OCParsePayloadInArena(OCPayload **outPayload, OCPayloadFormat payloadFormat,
+        OCPayloadType payloadType, const uint8_t *payload, size_t payloadSize)
+{
+    return OCParsePayloadHelper(outPayload, payloadFormat, payloadType, payload, payloadSize,
+                                true);
+}
+
+/**
+ * Copy a text or byte string value. The copy is allocated from the arena of owner if it
+ * has one, and must then be freed with OCParseFree().
+ */
+static CborError OCParseDupString(const OCRepPayload *owner, const CborValue *value,
+        void **out, size_t *len)
+{
+    bool isText = cbor_value_is_text_string(value);
+    OCArena *arena = OCRepPayloadGetArena(owner);
+
+    if (!arena)
+    {
+        return isText ? cbor_value_dup_text_string(value, (char **)out, len, NULL) :
+                        cbor_value_dup_byte_string(value, (uint8_t **)out, len, NULL);
+    }
+
+    CborError err = cbor_value_calculate_string_length(value, len);
+    if (CborNoError != err)
+    {
+        return err;
+    }
+
+    size_t size = *len + 1;
+    if (size < *len)
+    {
+        return CborErrorDataTooLarge;
+    }
+    void *copy = OCArenaAlloc(arena, size);
+    if (!copy)
+    {
+        return CborErrorOutOfMemory;
+    }
+
+    err = isText ? cbor_value_copy_text_string(value, (char *)copy, &size, NULL) :
+                   cbor_value_copy_byte_string(value, (uint8_t *)copy, &size, NULL);
+    if (CborNoError == err)
+    {
+        *out = copy;
+        *len = size;
+    }
+    return err;
+}
+
+static void OCParseFree(const OCRepPayload *owner, void *memory)
+{
+    OCArena *arena = OCRepPayloadGetArena(owner);
+    if (!arena || !OCArenaOwns(arena, memory))
+    {
+        OICFree(memory);
+    }
+}
+
 static OCStackResult OCParseSecurityPayload(OCPayload** outPayload, const uint8_t *payload,
         size_t size)
 {
@@ -818,7 +891,8 @@ static size_t arrayStep(size_t dimensions[MAX_REP_ARRAY_DEPTH], size_t elementNu
 }
 
 static CborError OCParseArrayFillArray(const CborValue *parent,
-        size_t dimensions[MAX_REP_ARRAY_DEPTH], OCRepPayloadPropType type, void *targetArray)
+        size_t dimensions[MAX_REP_ARRAY_DEPTH], OCRepPayloadPropType type, void *targetArray,
+        const OCRepPayload *owner)
 {
     CborValue insideArray;
 
@@ -851,7 +925,7 @@ static CborError OCParseArrayFillArray(const CborValue *parent,
                     else
                     {
                         err = OCParseArrayFillArray(&insideArray, newdim, type,
-                            &(((int64_t*)targetArray)[arrayStep(dimensions, i)]));
+                            &(((int64_t*)targetArray)[arrayStep(dimensions, i)]), owner);
                     }
                     break;
                 case OCREP_PROP_DOUBLE:
@@ -874,7 +948,7 @@ static CborError OCParseArrayFillArray(const CborValue *parent,
                     else
                     {
                         err = OCParseArrayFillArray(&insideArray, newdim, type,
-                            &(((double*)targetArray)[arrayStep(dimensions, i)]));
+                            &(((double*)targetArray)[arrayStep(dimensions, i)]), owner);
                     }
                     break;
                 case OCREP_PROP_BOOL:
@@ -885,39 +959,39 @@ static CborError OCParseArrayFillArray(const CborValue *parent,
                     else
                     {
                         err = OCParseArrayFillArray(&insideArray, newdim, type,
-                            &(((bool*)targetArray)[arrayStep(dimensions, i)]));
+                            &(((bool*)targetArray)[arrayStep(dimensions, i)]), owner);
                     }
                     break;
                 case OCREP_PROP_STRING:
                     if (dimensions[1] == 0)
                     {
-                        err = cbor_value_dup_text_string(&insideArray, &tempStr, &tempLen, NULL);
+                        err = OCParseDupString(owner, &insideArray, (void **)&tempStr, &tempLen);
                         ((char**)targetArray)[i] = tempStr;
                         tempStr = NULL;
                     }
                     else
                     {
                         err = OCParseArrayFillArray(&insideArray, newdim, type,
-                            &(((char**)targetArray)[arrayStep(dimensions, i)]));
+                            &(((char**)targetArray)[arrayStep(dimensions, i)]), owner);
                     }
                     break;
                 case OCREP_PROP_BYTE_STRING:
                     if (dimensions[1] == 0)
                     {
-                        err = cbor_value_dup_byte_string(&insideArray, &(ocByteStr.bytes),
-                                &(ocByteStr.len), NULL);
+                        err = OCParseDupString(owner, &insideArray, (void **)&(ocByteStr.bytes),
+                                &(ocByteStr.len));
                         ((OCByteString*)targetArray)[i] = ocByteStr;
                     }
                     else
                     {
                         err = OCParseArrayFillArray(&insideArray, newdim, type,
-                                &(((OCByteString*)targetArray)[arrayStep(dimensions, i)]));
+                                &(((OCByteString*)targetArray)[arrayStep(dimensions, i)]), owner);
                     }
                     break;
                 case OCREP_PROP_OBJECT:
                     if (dimensions[1] == 0)
                     {
-                        err = OCParseSingleRepPayload(&tempPl, &insideArray, false);
+                        err = OCParseSingleRepPayload(&tempPl, &insideArray, false, owner);
                         ((OCRepPayload**)targetArray)[i] = tempPl;
                         tempPl = NULL;
                         noAdvance = true;
@@ -925,7 +999,7 @@ static CborError OCParseArrayFillArray(const CborValue *parent,
                     else
                     {
                         err = OCParseArrayFillArray(&insideArray, newdim, type,
-                            &(((OCRepPayload**)targetArray)[arrayStep(dimensions, i)]));
+                            &(((OCRepPayload**)targetArray)[arrayStep(dimensions, i)]), owner);
                     }
                     break;
                 default:
@@ -970,10 +1044,19 @@ static CborError OCParseArray(OCRepPayload *out, const char *name, CborValue *co
 
     dimTotal = calcDimTotal(dimensions);
     allocSize = getAllocSize(type);
-    arr = OICCalloc(dimTotal, allocSize);
+    OCArena *arena = OCRepPayloadGetArena(out);
+    if (arena)
+    {
+        arr = (allocSize && dimTotal <= SIZE_MAX / allocSize) ?
+            OCArenaAlloc(arena, dimTotal * allocSize) : NULL;
+    }
+    else
+    {
+        arr = OICCalloc(dimTotal, allocSize);
+    }
     VERIFY_PARAM_NON_NULL(TAG, arr, "Array Parse allocation failed");
 
-    res = OCParseArrayFillArray(container, dimensions, type, arr);
+    res = OCParseArrayFillArray(container, dimensions, type, arr, out);
     VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, err, "Failed parse array");
 
     switch (type)
@@ -1008,14 +1091,14 @@ exit:
     {
         for(size_t i = 0; i < dimTotal; ++i)
         {
-            OICFree(((char**)arr)[i]);
+            OCParseFree(out, ((char**)arr)[i]);
         }
     }
     if (type == OCREP_PROP_BYTE_STRING)
     {
         for(size_t i = 0; i < dimTotal; ++i)
         {
-            OICFree(((OCByteString*)arr)[i].bytes);
+            OCParseFree(out, ((OCByteString*)arr)[i].bytes);
         }
     }
     if (type == OCREP_PROP_OBJECT)
@@ -1025,13 +1108,15 @@ exit:
             OCRepPayloadDestroy(((OCRepPayload**)arr)[i]);
         }
     }
-    OICFree(arr);
+    OCParseFree(out, arr);
     return err;
 }
 
-static CborError OCParseSingleRepPayload(OCRepPayload **outPayload, CborValue *objMap, bool isRoot)
+static CborError OCParseSingleRepPayload(OCRepPayload **outPayload, CborValue *objMap, bool isRoot,
+        const OCRepPayload *parent)
 {
     CborError err = CborUnknownError;
+    char nameBuffer[NAME_BUFFER_SIZE];
     char *name = NULL;
     bool res = false;
     VERIFY_PARAM_NON_NULL(TAG, outPayload, "Invalid Parameter outPayload");
@@ -1041,7 +1126,7 @@ static CborError OCParseSingleRepPayload(OCRepPayload **outPayload, CborValue *o
     {
         if (!*outPayload)
         {
-            *outPayload = OCRepPayloadCreate();
+            *outPayload = OCRepPayloadCreateChild(parent);
             if (!*outPayload)
             {
                 return CborErrorOutOfMemory;
@@ -1060,7 +1145,17 @@ static CborError OCParseSingleRepPayload(OCRepPayload **outPayload, CborValue *o
         {
             if (cbor_value_is_map(objMap) && cbor_value_is_text_string(&repMap))
             {
-                err = cbor_value_dup_text_string(&repMap, &name, &len, NULL);
+                // Most names fit the local buffer, only longer ones are allocated.
+                len = sizeof(nameBuffer);
+                err = cbor_value_copy_text_string(&repMap, nameBuffer, &len, NULL);
+                if (CborErrorOutOfMemory == err)
+                {
+                    err = cbor_value_dup_text_string(&repMap, &name, &len, NULL);
+                }
+                else if (CborNoError == err)
+                {
+                    name = nameBuffer;
+                }
                 VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, err, "Failed finding tag name in the map");
                 err = cbor_value_advance(&repMap);
                 VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, err, "Failed advancing rootMap");
@@ -1071,15 +1166,18 @@ static CborError OCParseSingleRepPayload(OCRepPayload **outPayload, CborValue *o
                     (0 == strcmp(OC_RSRVD_INTERFACE, name))))
                 {
                     err = cbor_value_advance(&repMap);
-                    free(name);  // Free *TinyCBOR allocated* string.
+                    if (name != nameBuffer)
+                    {
+                        free(name);  // Free *TinyCBOR allocated* string.
+                    }
                     name = NULL;
                     continue;
                 }
             }
             else if (cbor_value_is_array(objMap))
             {
-                name = (char*)OICCalloc(UINT64_MAX_STRLEN + 1, sizeof(char));
-                VERIFY_PARAM_NON_NULL(TAG, name, "Failed allocating tag name in the map");
+                OC_STATIC_ASSERT(NAME_BUFFER_SIZE > UINT64_MAX_STRLEN, "Name buffer is too small");
+                name = nameBuffer;
 #ifdef PRIu64
                 snprintf(name, UINT64_MAX_STRLEN + 1, "%" PRIu64, arrayIndex);
 #else
@@ -1095,7 +1193,7 @@ static CborError OCParseSingleRepPayload(OCRepPayload **outPayload, CborValue *o
                 else
                 {
                     err = CborErrorDataTooLarge;
-                    OICFree(name);
+                    name = NULL;
                     continue;
                 }
 #endif
@@ -1133,7 +1231,7 @@ static CborError OCParseSingleRepPayload(OCRepPayload **outPayload, CborValue *o
                 case CborTextStringType:
                     {
                         char *strval = NULL;
-                        err = cbor_value_dup_text_string(&repMap, &strval, &len, NULL);
+                        err = OCParseDupString(curPayload, &repMap, (void **)&strval, &len);
                         VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, err, "Failed getting string value");
                         res = OCRepPayloadSetPropStringAsOwner(curPayload, name, strval);
                     }
@@ -1141,7 +1239,7 @@ static CborError OCParseSingleRepPayload(OCRepPayload **outPayload, CborValue *o
                 case CborByteStringType:
                     {
                         uint8_t* bytestrval = NULL;
-                        err = cbor_value_dup_byte_string(&repMap, &bytestrval, &len, NULL);
+                        err = OCParseDupString(curPayload, &repMap, (void **)&bytestrval, &len);
                         VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, err, "Failed getting byte string value");
                         OCByteString tmp = {.bytes = bytestrval, .len = len};
                         res = OCRepPayloadSetPropByteStringAsOwner(curPayload, name, &tmp);
@@ -1150,7 +1248,7 @@ static CborError OCParseSingleRepPayload(OCRepPayload **outPayload, CborValue *o
                 case CborMapType:
                     {
                         OCRepPayload *pl = NULL;
-                        err = OCParseSingleRepPayload(&pl, &repMap, false);
+                        err = OCParseSingleRepPayload(&pl, &repMap, false, curPayload);
                         VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, err, "Failed setting parse single rep");
                         res = OCRepPayloadSetPropObjectAsOwner(curPayload, name, pl);
                     }
@@ -1162,7 +1260,7 @@ static CborError OCParseSingleRepPayload(OCRepPayload **outPayload, CborValue *o
                         // OCParseArray will fail if the array contains mixed types, try
                         // to parse as payload with non-negative integer value names
                         OCRepPayload *pl = NULL;
-                        err = OCParseSingleRepPayload(&pl, &repMap, false);
+                        err = OCParseSingleRepPayload(&pl, &repMap, false, curPayload);
                         VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, err, "Failed setting parse single rep");
                         res = OCRepPayloadSetPropObjectAsOwner(curPayload, name, pl);
                     }
@@ -1182,7 +1280,10 @@ static CborError OCParseSingleRepPayload(OCRepPayload **outPayload, CborValue *o
                 err = cbor_value_advance(&repMap);
                 VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, err, "Failed advance repMap");
             }
-            OICFree(name);
+            if (name != nameBuffer)
+            {
+                OICFree(name);
+            }
             name = NULL;
             ++arrayIndex;
         }
@@ -1195,13 +1296,16 @@ static CborError OCParseSingleRepPayload(OCRepPayload **outPayload, CborValue *o
     }
 
 exit:
-    OICFree(name);
+    if (name != nameBuffer)
+    {
+        OICFree(name);
+    }
     OCRepPayloadDestroy(*outPayload);
     *outPayload = NULL;
     return err;
 }
 
-static OCStackResult OCParseRepPayload(OCPayload **outPayload, CborValue *root)
+static OCStackResult OCParseRepPayload(OCPayload **outPayload, CborValue *root, bool inArena)
 {
     OCStackResult ret = OC_STACK_INVALID_PARAM;
     CborError err;
@@ -1221,7 +1325,15 @@ static OCStackResult OCParseRepPayload(OCPayload **outPayload, CborValue *root)
     }
     while (cbor_value_is_valid(&rootMap))
     {
-        temp = OCRepPayloadCreate();
+        if (rootPayload)
+        {
+            // Payloads of a batch share the allocation of the first one.
+            temp = OCRepPayloadCreateChild(rootPayload);
+        }
+        else
+        {
+            temp = inArena ? OCRepPayloadCreateWithArena() : OCRepPayloadCreate();
+        }
         ret = OC_STACK_NO_MEMORY;
         VERIFY_PARAM_NON_NULL(TAG, temp, "Failed allocating memory");
 
@@ -1268,7 +1380,7 @@ static OCStackResult OCParseRepPayload(OCPayload **outPayload, CborValue *root)
 
         if (cbor_value_is_map(&rootMap))
         {
-            err = OCParseSingleRepPayload(&temp, &rootMap, true);
+            err = OCParseSingleRepPayload(&temp, &rootMap, true, NULL);
             VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, err, "Failed to parse single rep payload");
         }
 
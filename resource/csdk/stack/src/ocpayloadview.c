@@ -0,0 +1,218 @@
+/* ****************************************************************
+ *
+ * Copyright 2017 Open Connectivity Foundation All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+#include "iotivity_config.h"
+#include <string.h>
+
+#include "ocpayload.h"
+#include "ocpayloadcbor.h"
+#include "experimental/logger.h"
+
+#define TAG "OIC_RI_PAYLOADVIEW"
+
+/*
+ * Mask of the additional information in the initial byte of a CBOR item.
+ */
+#define CBOR_ADDITIONAL_INFO_MASK 0x1f
+
+OCCborView OCCborViewCreate(OCPayloadFormat format, const uint8_t *payload, size_t payloadSize)
+{
+    OCCborView view = { NULL, 0 };
+    if (payload && payloadSize &&
+        (OC_FORMAT_CBOR == format || OC_FORMAT_VND_OCF_CBOR == format))
+    {
+        view.data = payload;
+        view.size = payloadSize;
+    }
+    return view;
+}
+
+/*
+ * Find the value of a property. A representation received as an array, e.g. a batch
+ * response, is looked up in its first element.
+ */
+static bool OCCborViewFind(const OCCborView *view, const char *name, CborValue *value)
+{
+    if (!view || !view->data || !name)
+    {
+        return false;
+    }
+
+    CborParser parser;
+    CborValue root;
+    CborValue first;
+    if (CborNoError != cbor_parser_init(view->data, view->size, 0, &parser, &root))
+    {
+        return false;
+    }
+    const CborValue *map = &root;
+    if (cbor_value_is_array(&root))
+    {
+        if (CborNoError != cbor_value_enter_container(&root, &first))
+        {
+            return false;
+        }
+        map = &first;
+    }
+    if (!cbor_value_is_map(map))
+    {
+        return false;
+    }
+    if (CborNoError != cbor_value_map_find_value(map, name, value))
+    {
+        OIC_LOG_V(ERROR, TAG, "Malformed payload looking up %s", name);
+        return false;
+    }
+    return cbor_value_is_valid(value);
+}
+
+/*
+ * Locate the contents of a definite length text or byte string in the view.
+ */
+static bool OCCborViewGetStringBytes(const CborValue *value, const uint8_t **bytes, size_t *len)
+{
+    if (!cbor_value_is_length_known(value) ||
+        CborNoError != cbor_value_get_string_length(value, len))
+    {
+        // Chunked strings are not contiguous.
+        return false;
+    }
+
+    const uint8_t *item = cbor_value_get_next_byte(value);
+    size_t headerSize;
+    switch (item[0] & CBOR_ADDITIONAL_INFO_MASK)
+    {
+        case 24:
+            headerSize = 2;
+            break;
+        case 25:
+            headerSize = 3;
+            break;
+        case 26:
+            headerSize = 5;
+            break;
+        case 27:
+            headerSize = 9;
+            break;
+        default:
+            headerSize = 1;
+            break;
+    }
+    *bytes = item + headerSize;
+    return true;
+}
+
+bool OC_CALL OCCborViewHasProp(const OCCborView *view, const char *name)
+{
+    CborValue value;
+    return OCCborViewFind(view, name, &value);
+}
+
+bool OC_CALL OCCborViewIsNull(const OCCborView *view, const char *name)
+{
+    CborValue value;
+    return OCCborViewFind(view, name, &value) && cbor_value_is_null(&value);
+}
+
+bool OC_CALL OCCborViewGetPropInt(const OCCborView *view, const char *name, int64_t *value)
+{
+    CborValue cborValue;
+    if (!value || !OCCborViewFind(view, name, &cborValue) || !cbor_value_is_integer(&cborValue))
+    {
+        return false;
+    }
+    return CborNoError == cbor_value_get_int64(&cborValue, value);
+}
+
+bool OC_CALL OCCborViewGetPropDouble(const OCCborView *view, const char *name, double *value)
+{
+    CborValue cborValue;
+    if (!value || !OCCborViewFind(view, name, &cborValue))
+    {
+        return false;
+    }
+    if (cbor_value_is_double(&cborValue))
+    {
+        return CborNoError == cbor_value_get_double(&cborValue, value);
+    }
+    if (cbor_value_is_integer(&cborValue))
+    {
+        int64_t i;
+        if (CborNoError == cbor_value_get_int64(&cborValue, &i))
+        {
+            *value = (double) i;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool OC_CALL OCCborViewGetPropBool(const OCCborView *view, const char *name, bool *value)
+{
+    CborValue cborValue;
+    if (!value || !OCCborViewFind(view, name, &cborValue) || !cbor_value_is_boolean(&cborValue))
+    {
+        return false;
+    }
+    return CborNoError == cbor_value_get_boolean(&cborValue, value);
+}
+
+bool OC_CALL OCCborViewGetPropString(const OCCborView *view, const char *name,
+                                     const char **value, size_t *len)
+{
+    CborValue cborValue;
+    if (!value || !len || !OCCborViewFind(view, name, &cborValue) ||
+        !cbor_value_is_text_string(&cborValue))
+    {
+        return false;
+    }
+    return OCCborViewGetStringBytes(&cborValue, (const uint8_t **) value, len);
+}
+
+bool OC_CALL OCCborViewGetPropByteString(const OCCborView *view, const char *name,
+                                         const uint8_t **value, size_t *len)
+{
+    CborValue cborValue;
+    if (!value || !len || !OCCborViewFind(view, name, &cborValue) ||
+        !cbor_value_is_byte_string(&cborValue))
+    {
+        return false;
+    }
+    return OCCborViewGetStringBytes(&cborValue, value, len);
+}
+
+bool OC_CALL OCCborViewGetPropObject(const OCCborView *view, const char *name, OCCborView *value)
+{
+    CborValue cborValue;
+    if (!value || !OCCborViewFind(view, name, &cborValue) || !cbor_value_is_map(&cborValue))
+    {
+        return false;
+    }
+
+    // The object spans from its first byte to the first byte of whatever follows it.
+    CborValue next = cborValue;
+    if (CborNoError != cbor_value_advance(&next))
+    {
+        return false;
+    }
+    value->data = cbor_value_get_next_byte(&cborValue);
+    value->size = (size_t) (cbor_value_get_next_byte(&next) - value->data);
+    return true;
+}
@@ -0,0 +1,309 @@
+/* ****************************************************************
+ *
+ * Copyright 2017 Open Connectivity Foundation All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+#include "iotivity_config.h"
+#include <string.h>
+
+#include "ocrequestdispatch.h"
+#include "ocresourcehandler.h"
+#include "ocresourceindex.h"
+#include "ocstackinternal.h"
+#include "ocpayload.h"
+#include "octhread.h"
+#include "uhashmap.h"
+#include "oic_malloc.h"
+#include "experimental/logger.h"
+
+#define TAG "OIC_RI_REQUESTDISPATCH"
+
+/**
+ * Entity handler call queued to a worker.
+ */
+typedef struct OCDispatchJob
+{
+    struct OCDispatchJob *next;
+    OCResource *resource;
+    /** Ordinal of the resource in the index, see OCResourceIndexGetOrdinal(). */
+    uint64_t resourceOrdinal;
+    OCServerRequest *request;
+    OCEntityHandlerFlag flag;
+    OCEntityHandlerRequest ehRequest;
+} OCDispatchJob;
+
+typedef struct OCDispatchWorker
+{
+    oc_thread thread;
+    oc_mutex mutex;
+    oc_cond cond;
+    OCDispatchJob *head;
+    OCDispatchJob *tail;
+    bool stop;
+} OCDispatchWorker;
+
+static OCDispatchWorker *g_workers = NULL;
+static uint32_t g_workerCount = 0;
+
+/**
+ * Guards the stack structures while dispatch is enabled, NULL otherwise.
+ */
+static oc_mutex g_stackLock = NULL;
+
+void OCStackLock(void)
+{
+    if (g_stackLock)
+    {
+        oc_mutex_lock(g_stackLock);
+    }
+}
+
+void OCStackUnlock(void)
+{
+    if (g_stackLock)
+    {
+        oc_mutex_unlock(g_stackLock);
+    }
+}
+
+bool OCRequestDispatchIsEnabled(void)
+{
+    return (0 != g_workerCount);
+}
+
+/**
+ * Answer a request once its entity handler returned, like HandleResourceWithEntityHandler()
+ * and OCHandleRequests() do for a handler called in place. Called with the stack lock held.
+ */
+static void CompleteDispatchedRequest(OCDispatchJob *job, bool resourceFound,
+                                      OCEntityHandlerResult ehResult)
+{
+    OCServerRequest *request = job->request;
+    if (!ReleaseServerRequest(request))
+    {
+        // The entity handler answered the request.
+        return;
+    }
+
+    OCStackResult result = EntityHandlerCodeToOCStackCode(ehResult);
+    if (OC_STACK_SLOW_RESOURCE == result || OCResultToSuccess(result))
+    {
+        // Answered later with OCDoResponse().
+        return;
+    }
+
+    if (request->notificationFlag)
+    {
+        DeleteServerRequest(request);
+        return;
+    }
+
+    OIC_LOG_V(ERROR, TAG, "Entity handler failed: %d", ehResult);
+    OCEntityHandlerResponse response = { .ehResult = ehResult };
+    response.requestHandle = (OCRequestHandle) request;
+    response.resourceHandle = resourceFound ? (OCResourceHandle) job->resource : NULL;
+    if (OC_STACK_OK != request->ehResponseHandler(&response))
+    {
+        OIC_LOG(ERROR, TAG, "Error sending the entity handler failure");
+    }
+}
+
+static void RunDispatchJob(OCDispatchJob *job)
+{
+    OCEntityHandler entityHandler = NULL;
+    void *callbackParam = NULL;
+
+    // The resource may have been deleted since the request was queued, and another
+    // resource may have been created at the same address.
+    OCStackLock();
+    uint64_t ordinal = 0;
+    bool resourceFound = OCResourceIndexGetOrdinal(job->resource, &ordinal) &&
+                         (ordinal == job->resourceOrdinal);
+    if (resourceFound)
+    {
+        entityHandler = job->resource->entityHandler;
+        callbackParam = job->resource->entityHandlerCallbackParam;
+    }
+    OCStackUnlock();
+
+    OCEntityHandlerResult ehResult = OC_EH_RESOURCE_NOT_FOUND;
+    if (entityHandler)
+    {
+        ehResult = entityHandler(job->flag, &job->ehRequest, callbackParam);
+    }
+
+    // The payload may refer to the request, which is freed on release.
+    OCPayloadDestroy(job->ehRequest.payload);
+
+    OCStackLock();
+    CompleteDispatchedRequest(job, resourceFound, ehResult);
+    OCStackUnlock();
+
+    OICFree(job);
+}
+
+static void *DispatchWorkerRun(void *arg)
+{
+    OCDispatchWorker *worker = (OCDispatchWorker *) arg;
+
+    oc_mutex_lock(worker->mutex);
+    while (true)
+    {
+        while (!worker->head && !worker->stop)
+        {
+            oc_cond_wait(worker->cond, worker->mutex);
+        }
+        if (!worker->head)
+        {
+            // Stopped, with every queued call done.
+            break;
+        }
+
+        OCDispatchJob *job = worker->head;
+        worker->head = job->next;
+        if (!worker->head)
+        {
+            worker->tail = NULL;
+        }
+
+        oc_mutex_unlock(worker->mutex);
+        RunDispatchJob(job);
+        oc_mutex_lock(worker->mutex);
+    }
+    oc_mutex_unlock(worker->mutex);
+    return NULL;
+}
+
+OCStackResult OCRequestDispatchStart(uint32_t threadCount)
+{
+    if (0 == threadCount)
+    {
+        return OC_STACK_OK;
+    }
+
+    g_stackLock = oc_mutex_new_recursive();
+    g_workers = (OCDispatchWorker *) OICCalloc(threadCount, sizeof(OCDispatchWorker));
+    if (!g_stackLock || !g_workers)
+    {
+        OIC_LOG(ERROR, TAG, "Failed to create the dispatch workers");
+        OCRequestDispatchStop();
+        return OC_STACK_NO_MEMORY;
+    }
+
+    for (uint32_t i = 0; i < threadCount; i++)
+    {
+        OCDispatchWorker *worker = &g_workers[i];
+        worker->mutex = oc_mutex_new();
+        worker->cond = oc_cond_new();
+        if (!worker->mutex || !worker->cond ||
+            (OC_THREAD_SUCCESS != oc_thread_new(&worker->thread, DispatchWorkerRun, worker)))
+        {
+            OIC_LOG(ERROR, TAG, "Failed to start a dispatch worker");
+            oc_cond_free(worker->cond);
+            oc_mutex_free(worker->mutex);
+            worker->cond = NULL;
+            worker->mutex = NULL;
+            OCRequestDispatchStop();
+            return OC_STACK_ERROR;
+        }
+        g_workerCount++;
+    }
+
+    OIC_LOG_V(INFO, TAG, "Entity handlers called from %u workers", threadCount);
+    return OC_STACK_OK;
+}
+
+void OCRequestDispatchStop(void)
+{
+    for (uint32_t i = 0; i < g_workerCount; i++)
+    {
+        OCDispatchWorker *worker = &g_workers[i];
+        oc_mutex_lock(worker->mutex);
+        worker->stop = true;
+        oc_cond_signal(worker->cond);
+        oc_mutex_unlock(worker->mutex);
+    }
+
+    for (uint32_t i = 0; i < g_workerCount; i++)
+    {
+        OCDispatchWorker *worker = &g_workers[i];
+        oc_thread_wait(worker->thread);
+        oc_thread_free(worker->thread);
+        oc_cond_free(worker->cond);
+        oc_mutex_free(worker->mutex);
+    }
+
+    OICFree(g_workers);
+    g_workers = NULL;
+    g_workerCount = 0;
+
+    if (g_stackLock)
+    {
+        oc_mutex_free(g_stackLock);
+        g_stackLock = NULL;
+    }
+}
+
+OCStackResult OCRequestDispatch(OCResource *resource, OCServerRequest *request,
+                                OCEntityHandlerFlag flag,
+                                const OCEntityHandlerRequest *ehRequest)
+{
+    if (!resource || !request || !ehRequest)
+    {
+        return OC_STACK_INVALID_PARAM;
+    }
+    if (!g_workerCount)
+    {
+        return OC_STACK_ERROR;
+    }
+
+    uint64_t ordinal = 0;
+    if (!OCResourceIndexGetOrdinal(resource, &ordinal))
+    {
+        return OC_STACK_NO_RESOURCE;
+    }
+
+    OCDispatchJob *job = (OCDispatchJob *) OICCalloc(1, sizeof(OCDispatchJob));
+    if (!job)
+    {
+        OIC_LOG(ERROR, TAG, "Out of memory");
+        return OC_STACK_NO_MEMORY;
+    }
+    job->resource = resource;
+    job->resourceOrdinal = ordinal;
+    job->request = request;
+    job->flag = flag;
+    job->ehRequest = *ehRequest;
+    HoldServerRequest(request);
+
+    OCDispatchWorker *worker = &g_workers[u_hashmap_hash_pointer(resource) % g_workerCount];
+    oc_mutex_lock(worker->mutex);
+    if (worker->tail)
+    {
+        worker->tail->next = job;
+    }
+    else
+    {
+        worker->head = job;
+    }
+    worker->tail = job;
+    oc_cond_signal(worker->cond);
+    oc_mutex_unlock(worker->mutex);
+
+    return OC_STACK_OK;
+}
@@ -41,6 +41,9 @@
 
 #include "ocresource.h"
 #include "ocresourcehandler.h"
+#include "ocresourceindex.h"
+#include "ocrequestdispatch.h"
+#include "ocdiscoverycache.h"
 #include "ocobserve.h"
 #include "occollection.h"
 #include "oic_malloc.h"
@@ -1307,17 +1310,12 @@ OCResource *OC_CALL FindResourceByUri(const char* resourceUri)
         return NULL;
     }
 
-    OCResource * pointer = headResource;
-    while (pointer)
+    OCResource *pointer = OCResourceIndexFindByUri(resourceUri);
+    if (!pointer)
     {
-        if (strcmp(resourceUri, pointer->uri) == 0)
-        {
-            return pointer;
-        }
-        pointer = pointer->next;
+        OIC_LOG_V(INFO, TAG, "Resource %s not found", resourceUri);
     }
-    OIC_LOG_V(INFO, TAG, "Resource %s not found", resourceUri);
-    return NULL;
+    return pointer;
 }
 
 OCStackResult CheckRequestsEndpoint(const OCDevAddr *reqDevAddr,
@@ -1620,6 +1618,43 @@ static bool includeThisResourceInResponse(OCResource *resource,
            resourceMatchesRTFilter(resource, resourceTypeFilter);
 }
 
+/*
+ * Get the resources a filtered discovery has to check, in creation order, from the
+ * resource type or interface index. Returns false when the filters do not narrow down
+ * the resources (no filter, oic.if.ll or oic.if.baseline) or the index is not usable,
+ * the whole resource list must be checked then.
+ */
+static bool getDiscoveryCandidates(char *interfaceFilter, char *resourceTypeFilter,
+                                   OCResource ***candidates, size_t *candidateCount)
+{
+    OCResource **typeCandidates = NULL;
+    size_t typeCount = 0;
+    bool byType = resourceTypeFilter && *resourceTypeFilter &&
+                  OCResourceIndexGetByType(resourceTypeFilter, &typeCandidates, &typeCount);
+
+    OCResource **interfaceCandidates = NULL;
+    size_t interfaceCount = 0;
+    bool byInterface = interfaceFilter && *interfaceFilter &&
+                       0 != strcmp(interfaceFilter, OC_RSRVD_INTERFACE_LL) &&
+                       0 != strcmp(interfaceFilter, OC_RSRVD_INTERFACE_DEFAULT) &&
+                       OCResourceIndexGetByInterface(interfaceFilter, &interfaceCandidates,
+                                                     &interfaceCount);
+
+    if (byType && (!byInterface || typeCount <= interfaceCount))
+    {
+        *candidates = typeCandidates;
+        *candidateCount = typeCount;
+        return true;
+    }
+    if (byInterface)
+    {
+        *candidates = interfaceCandidates;
+        *candidateCount = interfaceCount;
+        return true;
+    }
+    return false;
+}
+
 static OCStackResult SendNonPersistantDiscoveryResponse(OCServerRequest *request,
                                 OCPayload *discoveryPayload, OCEntityHandlerResult ehResult)
 {
@@ -1940,49 +1975,83 @@ static OCStackResult HandleVirtualResource (OCServerRequest *request, OCResource
             goto exit;
         }
 
-        CAEndpoint_t *networkInfo = NULL;
-        size_t infoSize = 0;
-
-        CAResult_t caResult = CAGetNetworkInformation(&networkInfo, &infoSize);
-        if (CA_STATUS_FAILED == caResult)
+        bool cacheable = (OC_WELL_KNOWN_URI == virtualUriInRequest) &&
+                         OCDiscoveryCacheIsCacheable(request);
+#ifdef RD_SERVER
+        // Resources published to the resource directory change without invalidating the cache.
+        cacheable = cacheable && !OCGetResourceHandleAtUri(OC_RSRVD_RD_URI);
+#endif
+        uint32_t cacheGeneration = 0;
+        if (cacheable && OCDiscoveryCacheGet(request, &discoveryResult, &request->encodedPayload,
+                                             &request->encodedPayloadSize, &cacheGeneration))
         {
-            OIC_LOG(ERROR, TAG, "CAGetNetworkInformation has error on parsing network infomation");
-            return OC_STACK_ERROR;
+            OIC_LOG(INFO, TAG, "Sending the cached discovery response");
         }
+        else
+        {
+            CAEndpoint_t *networkInfo = NULL;
+            size_t infoSize = 0;
 
-        discoveryResult = getQueryParamsForFiltering (virtualUriInRequest, request->query,
-                &interfaceQuery, &resourceTypeQuery);
-        VERIFY_SUCCESS(discoveryResult);
+            CAResult_t caResult = CAGetNetworkInformation(&networkInfo, &infoSize);
+            if (CA_STATUS_FAILED == caResult)
+            {
+                OIC_LOG(ERROR, TAG, "CAGetNetworkInformation has error on parsing network infomation");
+                return OC_STACK_ERROR;
+            }
 
-        if (!interfaceQuery && !resourceTypeQuery)
-        {
-            // If no query is sent, default interface is used i.e. oic.if.ll.
-            interfaceQuery = OICStrdup(OC_RSRVD_INTERFACE_LL);
-        }
+            discoveryResult = getQueryParamsForFiltering (virtualUriInRequest, request->query,
+                    &interfaceQuery, &resourceTypeQuery);
+            VERIFY_SUCCESS(discoveryResult);
 
-        discoveryResult = discoveryPayloadCreateAndAddDeviceId(&payload);
-        VERIFY_PARAM_NON_NULL(TAG, payload, "Failed creating Discovery Payload.");
-        VERIFY_SUCCESS(discoveryResult);
+            if (!interfaceQuery && !resourceTypeQuery)
+            {
+                // If no query is sent, default interface is used i.e. oic.if.ll.
+                interfaceQuery = OICStrdup(OC_RSRVD_INTERFACE_LL);
+            }
 
-        OCDiscoveryPayload *discPayload = (OCDiscoveryPayload *)payload;
-        if (interfaceQuery && 0 == strcmp(interfaceQuery, OC_RSRVD_INTERFACE_DEFAULT))
-        {
-            discoveryResult = addDiscoveryBaselineCommonProperties(discPayload);
+            discoveryResult = discoveryPayloadCreateAndAddDeviceId(&payload);
+            VERIFY_PARAM_NON_NULL(TAG, payload, "Failed creating Discovery Payload.");
             VERIFY_SUCCESS(discoveryResult);
-        }
-        OCResourceProperty prop = OC_DISCOVERABLE;
+
+            OCDiscoveryPayload *discPayload = (OCDiscoveryPayload *)payload;
+            if (interfaceQuery && 0 == strcmp(interfaceQuery, OC_RSRVD_INTERFACE_DEFAULT))
+            {
+                discoveryResult = addDiscoveryBaselineCommonProperties(discPayload);
+                VERIFY_SUCCESS(discoveryResult);
+            }
+            OCResourceProperty prop = OC_DISCOVERABLE;
 #ifdef MQ_BROKER
-        prop = (OC_MQ_BROKER_URI == virtualUriInRequest) ? OC_MQ_BROKER : prop;
+            prop = (OC_MQ_BROKER_URI == virtualUriInRequest) ? OC_MQ_BROKER : prop;
 #endif
-        for (; resource && discoveryResult == OC_STACK_OK; resource = resource->next)
-        {
-            // This case will handle when no resource type and it is oic.if.ll.
-            // Do not assume check if the query is ll
-            if (!resourceTypeQuery &&
-                (interfaceQuery && 0 == strcmp(interfaceQuery, OC_RSRVD_INTERFACE_LL)))
+            OCResource **candidates = NULL;
+            size_t candidateCount = 0;
+            size_t candidateIndex = 0;
+            bool indexed = getDiscoveryCandidates(interfaceQuery, resourceTypeQuery,
+                                                  &candidates, &candidateCount);
+            if (indexed)
+            {
+                resource = candidateCount ? candidates[0] : NULL;
+            }
+            for (; resource && discoveryResult == OC_STACK_OK;
+                 resource = indexed ? ((++candidateIndex < candidateCount) ?
+                                       candidates[candidateIndex] : NULL) : resource->next)
             {
-                // Only include discoverable type
-                if (resource->resourceProperties & prop)
+                // This case will handle when no resource type and it is oic.if.ll.
+                // Do not assume check if the query is ll
+                if (!resourceTypeQuery &&
+                    (interfaceQuery && 0 == strcmp(interfaceQuery, OC_RSRVD_INTERFACE_LL)))
+                {
+                    // Only include discoverable type
+                    if (resource->resourceProperties & prop)
+                    {
+                        discoveryResult = BuildVirtualResourceResponse(resource,
+                                                                       discPayload,
+                                                                       &request->devAddr,
+                                                                       networkInfo,
+                                                                       infoSize);
+                    }
+                }
+                else if (includeThisResourceInResponse(resource, interfaceQuery, resourceTypeQuery))
                 {
                     discoveryResult = BuildVirtualResourceResponse(resource,
                                                                    discPayload,
@@ -1990,35 +2059,43 @@ static OCStackResult HandleVirtualResource (OCServerRequest *request, OCResource
                                                                    networkInfo,
                                                                    infoSize);
                 }
+                else
+                {
+                    discoveryResult = OC_STACK_OK;
+                }
             }
-            else if (includeThisResourceInResponse(resource, interfaceQuery, resourceTypeQuery))
+            if (discPayload->resources == NULL)
             {
-                discoveryResult = BuildVirtualResourceResponse(resource,
-                                                               discPayload,
-                                                               &request->devAddr,
-                                                               networkInfo,
-                                                               infoSize);
+                discoveryResult = OC_STACK_NO_RESOURCE;
+                OCPayloadDestroy(payload);
+                payload = NULL;
             }
-            else
+
+            if (networkInfo)
             {
-                discoveryResult = OC_STACK_OK;
+                OICFree(networkInfo);
             }
-        }
-        if (discPayload->resources == NULL)
-        {
-            discoveryResult = OC_STACK_NO_RESOURCE;
-            OCPayloadDestroy(payload);
-            payload = NULL;
-        }
-
-        if (networkInfo)
-        {
-            OICFree(networkInfo);
-        }
 #ifdef RD_SERVER
-        discoveryResult = findResourcesAtRD(interfaceQuery, resourceTypeQuery, &request->devAddr,
-                (OCDiscoveryPayload **)&payload);
+            discoveryResult = findResourcesAtRD(interfaceQuery, resourceTypeQuery, &request->devAddr,
+                    (OCDiscoveryPayload **)&payload);
 #endif
+
+            if (cacheable && (OC_STACK_OK == discoveryResult))
+            {
+                // Encode here rather than when sending to keep a copy of the response.
+                if (OC_STACK_OK == OCConvertPayload(payload, request->acceptFormat,
+                                                    &request->encodedPayload,
+                                                    &request->encodedPayloadSize))
+                {
+                    OCDiscoveryCachePut(cacheGeneration, request, discoveryResult,
+                                        request->encodedPayload, request->encodedPayloadSize);
+                }
+            }
+            else if (cacheable && (OC_STACK_NO_RESOURCE == discoveryResult))
+            {
+                OCDiscoveryCachePut(cacheGeneration, request, discoveryResult, NULL, 0);
+            }
+        }
     }
     else if (virtualUriInRequest == OC_DEVICE_URI)
     {
@@ -2195,6 +2272,12 @@ HandleResourceWithEntityHandler(OCServerRequest *request,
     OCEntityHandlerRequest ehRequest = {0};
 
     OIC_LOG(INFO, TAG, "Entering HandleResourceWithEntityHandler");
+    if (request && request->held)
+    {
+        OIC_LOG(INFO, TAG, "Request already queued to its entity handler");
+        return OC_STACK_SLOW_RESOURCE;
+    }
+
     OCPayloadType type = PAYLOAD_TYPE_REPRESENTATION;
     // check the security resource
     if (request && request->resourceUrl && SRMIsSecurityResourceURI(request->resourceUrl))
@@ -2307,6 +2390,24 @@ HandleResourceWithEntityHandler(OCServerRequest *request,
         goto exit;
     }
 
+    // Security resources are handled in place, the access checks read them.
+    if (PAYLOAD_TYPE_SECURITY != type && OCRequestDispatchIsEnabled())
+    {
+        result = OCRequestDispatch(resource, request, ehFlag, &ehRequest);
+        if (OC_STACK_OK == result)
+        {
+            // The payload belongs to the worker, which answers like a slow resource.
+            ehRequest.payload = NULL;
+            if (!request->notificationFlag)
+            {
+                request->slowFlag = 1;
+                result = OC_STACK_SLOW_RESOURCE;
+            }
+            goto exit;
+        }
+        OIC_LOG(ERROR, TAG, "Dispatch failed, calling the entity handler in place");
+    }
+
     ehResult = resource->entityHandler(ehFlag, &ehRequest, resource->entityHandlerCallbackParam);
     if(ehResult == OC_EH_SLOW)
     {
@@ -2656,6 +2757,9 @@ static OCStackResult SetAttributeInternal(OCResource *resource,
     }
     VERIFY_PARAM_NON_NULL(TAG, resAttrib->attrValue, "Failed allocating attribute value");
 
+    // The device name is part of baseline discovery responses.
+    OCDiscoveryCacheInvalidate();
+
     // The resource has changed from what is stored in the database. Update the database to
     // reflect the new value.
     if (updateDatabase)
@@ -2732,6 +2836,7 @@ static OCStackResult IsDatabaseUpdateNeeded(const char *attribute, const void *v
 
 OCStackResult OC_CALL OCSetAttribute(OCResource *resource, const char *attribute, const void *value)
 {
+    OCStackLock();
     bool updateDatabase = false;
 
     // Check to see if we also need to update the database for this attribute. If the current
@@ -2745,7 +2850,9 @@ OCStackResult OC_CALL OCSetAttribute(OCResource *resource, const char *attribute
         updateDatabase = false;
     }
 
-    return SetAttributeInternal(resource, attribute, value, updateDatabase);
+    OCStackResult result = SetAttributeInternal(resource, attribute, value, updateDatabase);
+    OCStackUnlock();
+    return result;
 }
 
 OCStackResult OC_CALL OCSetPropertyValue(OCPayloadType type, const char *prop, const void *value)
@@ -2763,6 +2870,7 @@ OCStackResult OC_CALL OCSetPropertyValue(OCPayloadType type, const char *prop, c
     if (PAYLOAD_TYPE_DEVICE == type || PAYLOAD_TYPE_PLATFORM == type)
     {
         const char *pathType = (type == PAYLOAD_TYPE_DEVICE) ? OC_RSRVD_DEVICE_URI : OC_RSRVD_PLATFORM_URI;
+        OCStackLock();
         OCResource *resource = FindResourceByUri(pathType);
         if (!resource)
         {
@@ -2772,6 +2880,7 @@ OCStackResult OC_CALL OCSetPropertyValue(OCPayloadType type, const char *prop, c
         {
             res = OCSetAttribute(resource, prop, value);
         }
+        OCStackUnlock();
     }
 
     return res;
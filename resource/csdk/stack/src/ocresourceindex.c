@@ -0,0 +1,503 @@
+/* ****************************************************************
+ *
+ * Copyright 2017 Open Connectivity Foundation All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+#include "iotivity_config.h"
+#include <string.h>
+
+#include "ocresourceindex.h"
+#include "uhashmap.h"
+#include "oic_malloc.h"
+#include "oic_string.h"
+#include "experimental/logger.h"
+
+#define TAG "OIC_RI_RESOURCEINDEX"
+
+/** Initial capacity of the resource arrays. */
+#define RESOURCE_INDEX_INITIAL_CAPACITY 8
+
+/**
+ * Indexed resource. The ordinal records the creation order, it is never reused
+ * so that any array sorted by ordinal lists resources in creation order.
+ */
+typedef struct OCResourceIndexEntry
+{
+    OCResource *resource;
+    uint64_t ordinal;
+} OCResourceIndexEntry;
+
+/**
+ * Resources bound to one resource type or interface name, sorted by ordinal.
+ */
+typedef struct OCResourceIndexTag
+{
+    char *name;
+    OCResource **resources;
+    uint64_t *ordinals;
+    size_t count;
+    size_t capacity;
+} OCResourceIndexTag;
+
+/**
+ * Name to ::OCResourceIndexTag table. A table which failed to record a binding
+ * is no longer complete and is not used until the index is emptied.
+ */
+typedef struct OCResourceIndexTagTable
+{
+    u_hashmap_t *tags;
+    bool valid;
+} OCResourceIndexTagTable;
+
+/** Uri to ::OCResourceIndexEntry. */
+static u_hashmap_t *g_uriIndex = NULL;
+
+/** Resource handle to ::OCResourceIndexEntry. */
+static u_hashmap_t *g_handleIndex = NULL;
+
+/** Entries sorted by ordinal. */
+static OCResourceIndexEntry **g_orderedEntries = NULL;
+static size_t g_orderedCount = 0;
+static size_t g_orderedCapacity = 0;
+
+static uint64_t g_nextOrdinal = 0;
+
+static OCResourceIndexTagTable g_typeIndex = { NULL, true };
+static OCResourceIndexTagTable g_interfaceIndex = { NULL, true };
+
+static bool MatchEntryUri(const void *key, const void *data)
+{
+    return 0 == strcmp((const char *) key, ((const OCResourceIndexEntry *) data)->resource->uri);
+}
+
+static bool MatchEntryHandle(const void *key, const void *data)
+{
+    return key == ((const OCResourceIndexEntry *) data)->resource;
+}
+
+static bool MatchTagName(const void *key, const void *data)
+{
+    return 0 == strcmp((const char *) key, ((const OCResourceIndexTag *) data)->name);
+}
+
+/**
+ * Position of the first element of a sorted ordinal array not lower than ordinal.
+ */
+static size_t LowerBound(const uint64_t *ordinals, size_t count, uint64_t ordinal)
+{
+    size_t low = 0;
+    size_t high = count;
+    while (low < high)
+    {
+        size_t middle = low + (high - low) / 2;
+        if (ordinals[middle] < ordinal)
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+    return low;
+}
+
+static size_t EntryLowerBound(uint64_t ordinal)
+{
+    size_t low = 0;
+    size_t high = g_orderedCount;
+    while (low < high)
+    {
+        size_t middle = low + (high - low) / 2;
+        if (g_orderedEntries[middle]->ordinal < ordinal)
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+    return low;
+}
+
+static void FreeTag(OCResourceIndexTag *tag)
+{
+    if (tag)
+    {
+        OICFree(tag->name);
+        OICFree(tag->resources);
+        OICFree(tag->ordinals);
+        OICFree(tag);
+    }
+}
+
+static bool FreeTagVisitor(void *data, void *ctx)
+{
+    OC_UNUSED(ctx);
+    FreeTag((OCResourceIndexTag *) data);
+    return true;
+}
+
+static void ClearTagTable(OCResourceIndexTagTable *table)
+{
+    u_hashmap_foreach(table->tags, FreeTagVisitor, NULL);
+    u_hashmap_free(&table->tags);
+    table->valid = true;
+}
+
+static bool GrowTag(OCResourceIndexTag *tag)
+{
+    size_t capacity = tag->capacity ? tag->capacity * 2 : RESOURCE_INDEX_INITIAL_CAPACITY;
+
+    OCResource **resources =
+        (OCResource **) OICRealloc(tag->resources, capacity * sizeof(OCResource *));
+    if (!resources)
+    {
+        return false;
+    }
+    tag->resources = resources;
+
+    uint64_t *ordinals = (uint64_t *) OICRealloc(tag->ordinals, capacity * sizeof(uint64_t));
+    if (!ordinals)
+    {
+        return false;
+    }
+    tag->ordinals = ordinals;
+
+    tag->capacity = capacity;
+    return true;
+}
+
+static void AddToTagTable(OCResourceIndexTagTable *table, OCResource *resource, const char *name)
+{
+    if (!resource || !name || !table->valid)
+    {
+        return;
+    }
+
+    const OCResourceIndexEntry *entry =
+        (const OCResourceIndexEntry *) u_hashmap_get(g_handleIndex, resource);
+    if (!entry)
+    {
+        // Bindings made before the resource is indexed are recorded by OCResourceIndexAdd.
+        return;
+    }
+
+    if (!table->tags)
+    {
+        table->tags = u_hashmap_create(u_hashmap_hash_string, MatchTagName);
+        if (!table->tags)
+        {
+            goto error;
+        }
+    }
+
+    OCResourceIndexTag *tag = (OCResourceIndexTag *) u_hashmap_get(table->tags, name);
+    if (!tag)
+    {
+        tag = (OCResourceIndexTag *) OICCalloc(1, sizeof(OCResourceIndexTag));
+        if (!tag)
+        {
+            goto error;
+        }
+        tag->name = OICStrdup(name);
+        if (!tag->name || !u_hashmap_put(table->tags, tag->name, tag))
+        {
+            FreeTag(tag);
+            goto error;
+        }
+    }
+
+    size_t position = LowerBound(tag->ordinals, tag->count, entry->ordinal);
+    if (position < tag->count && tag->ordinals[position] == entry->ordinal)
+    {
+        return;
+    }
+
+    if (tag->count == tag->capacity && !GrowTag(tag))
+    {
+        goto error;
+    }
+
+    memmove(&tag->resources[position + 1], &tag->resources[position],
+            (tag->count - position) * sizeof(OCResource *));
+    memmove(&tag->ordinals[position + 1], &tag->ordinals[position],
+            (tag->count - position) * sizeof(uint64_t));
+    tag->resources[position] = resource;
+    tag->ordinals[position] = entry->ordinal;
+    tag->count++;
+    return;
+
+error:
+    OIC_LOG_V(ERROR, TAG, "Failed to index %s of %s, filtering falls back to full scan",
+              name, resource->uri);
+    table->valid = false;
+}
+
+static void RemoveFromTagTable(OCResourceIndexTagTable *table, const char *name, uint64_t ordinal)
+{
+    OCResourceIndexTag *tag = (OCResourceIndexTag *) u_hashmap_get(table->tags, name);
+    if (!tag)
+    {
+        return;
+    }
+
+    size_t position = LowerBound(tag->ordinals, tag->count, ordinal);
+    if (position >= tag->count || tag->ordinals[position] != ordinal)
+    {
+        return;
+    }
+
+    tag->count--;
+    memmove(&tag->resources[position], &tag->resources[position + 1],
+            (tag->count - position) * sizeof(OCResource *));
+    memmove(&tag->ordinals[position], &tag->ordinals[position + 1],
+            (tag->count - position) * sizeof(uint64_t));
+
+    if (!tag->count)
+    {
+        u_hashmap_remove_data(table->tags, name, tag);
+        FreeTag(tag);
+    }
+}
+
+static bool GetFromTagTable(const OCResourceIndexTagTable *table, const char *name,
+                            OCResource ***resources, size_t *count)
+{
+    if (!table->valid || !name || !resources || !count)
+    {
+        return false;
+    }
+
+    const OCResourceIndexTag *tag = (const OCResourceIndexTag *) u_hashmap_get(table->tags, name);
+    *resources = tag ? tag->resources : NULL;
+    *count = tag ? tag->count : 0;
+    return true;
+}
+
+OCStackResult OCResourceIndexAdd(OCResource *resource)
+{
+    if (!resource || !resource->uri)
+    {
+        return OC_STACK_INVALID_PARAM;
+    }
+
+    if (!g_uriIndex)
+    {
+        g_uriIndex = u_hashmap_create(u_hashmap_hash_string, MatchEntryUri);
+    }
+    if (!g_handleIndex)
+    {
+        g_handleIndex = u_hashmap_create(u_hashmap_hash_pointer, MatchEntryHandle);
+    }
+    if (!g_uriIndex || !g_handleIndex)
+    {
+        return OC_STACK_NO_MEMORY;
+    }
+
+    if (u_hashmap_get(g_uriIndex, resource->uri) || u_hashmap_get(g_handleIndex, resource))
+    {
+        OIC_LOG_V(ERROR, TAG, "Resource %s already indexed", resource->uri);
+        return OC_STACK_INVALID_PARAM;
+    }
+
+    if (g_orderedCount == g_orderedCapacity)
+    {
+        size_t capacity = g_orderedCapacity ? g_orderedCapacity * 2 :
+                          RESOURCE_INDEX_INITIAL_CAPACITY;
+        OCResourceIndexEntry **entries = (OCResourceIndexEntry **)
+            OICRealloc(g_orderedEntries, capacity * sizeof(OCResourceIndexEntry *));
+        if (!entries)
+        {
+            return OC_STACK_NO_MEMORY;
+        }
+        g_orderedEntries = entries;
+        g_orderedCapacity = capacity;
+    }
+
+    OCResourceIndexEntry *entry = (OCResourceIndexEntry *) OICMalloc(sizeof(OCResourceIndexEntry));
+    if (!entry)
+    {
+        return OC_STACK_NO_MEMORY;
+    }
+    entry->resource = resource;
+    entry->ordinal = g_nextOrdinal++;
+
+    if (!u_hashmap_put(g_uriIndex, resource->uri, entry))
+    {
+        OICFree(entry);
+        return OC_STACK_NO_MEMORY;
+    }
+    if (!u_hashmap_put(g_handleIndex, resource, entry))
+    {
+        u_hashmap_remove_data(g_uriIndex, resource->uri, entry);
+        OICFree(entry);
+        return OC_STACK_NO_MEMORY;
+    }
+    g_orderedEntries[g_orderedCount++] = entry;
+
+    for (OCResourceType *rtPtr = resource->rsrcType; rtPtr; rtPtr = rtPtr->next)
+    {
+        AddToTagTable(&g_typeIndex, resource, rtPtr->resourcetypename);
+    }
+    for (OCResourceInterface *ifPtr = resource->rsrcInterface; ifPtr; ifPtr = ifPtr->next)
+    {
+        AddToTagTable(&g_interfaceIndex, resource, ifPtr->name);
+    }
+
+    return OC_STACK_OK;
+}
+
+void OCResourceIndexRemove(OCResource *resource)
+{
+    OCResourceIndexEntry *entry =
+        (OCResourceIndexEntry *) u_hashmap_remove(g_handleIndex, resource);
+    if (!entry)
+    {
+        return;
+    }
+    u_hashmap_remove_data(g_uriIndex, resource->uri, entry);
+
+    for (OCResourceType *rtPtr = resource->rsrcType; rtPtr; rtPtr = rtPtr->next)
+    {
+        RemoveFromTagTable(&g_typeIndex, rtPtr->resourcetypename, entry->ordinal);
+    }
+    for (OCResourceInterface *ifPtr = resource->rsrcInterface; ifPtr; ifPtr = ifPtr->next)
+    {
+        RemoveFromTagTable(&g_interfaceIndex, ifPtr->name, entry->ordinal);
+    }
+
+    size_t position = EntryLowerBound(entry->ordinal);
+    if (position < g_orderedCount && g_orderedEntries[position] == entry)
+    {
+        g_orderedCount--;
+        memmove(&g_orderedEntries[position], &g_orderedEntries[position + 1],
+                (g_orderedCount - position) * sizeof(OCResourceIndexEntry *));
+    }
+    OICFree(entry);
+
+    if (!g_orderedCount)
+    {
+        // Every binding is gone, an incomplete table is complete again.
+        ClearTagTable(&g_typeIndex);
+        ClearTagTable(&g_interfaceIndex);
+    }
+}
+
+void OCResourceIndexClear(void)
+{
+    for (size_t i = 0; i < g_orderedCount; i++)
+    {
+        OICFree(g_orderedEntries[i]);
+    }
+    OICFree(g_orderedEntries);
+    g_orderedEntries = NULL;
+    g_orderedCount = 0;
+    g_orderedCapacity = 0;
+
+    u_hashmap_free(&g_uriIndex);
+    u_hashmap_free(&g_handleIndex);
+    ClearTagTable(&g_typeIndex);
+    ClearTagTable(&g_interfaceIndex);
+}
+
+OCResource *OCResourceIndexFindByUri(const char *uri)
+{
+    if (!uri)
+    {
+        return NULL;
+    }
+
+    const OCResourceIndexEntry *entry = (const OCResourceIndexEntry *) u_hashmap_get(g_uriIndex, uri);
+    return entry ? entry->resource : NULL;
+}
+
+bool OCResourceIndexContains(const OCResource *resource)
+{
+    return resource && u_hashmap_get(g_handleIndex, resource);
+}
+
+bool OCResourceIndexGetOrdinal(const OCResource *resource, uint64_t *ordinal)
+{
+    const OCResourceIndexEntry *entry =
+        resource ? (const OCResourceIndexEntry *) u_hashmap_get(g_handleIndex, resource) : NULL;
+    if (!entry || !ordinal)
+    {
+        return false;
+    }
+    *ordinal = entry->ordinal;
+    return true;
+}
+
+size_t OCResourceIndexGetCount(void)
+{
+    return g_orderedCount;
+}
+
+OCResource *OCResourceIndexGetAt(size_t index)
+{
+    return (index < g_orderedCount) ? g_orderedEntries[index]->resource : NULL;
+}
+
+void OCResourceIndexAddType(OCResource *resource, const char *resourceTypeName)
+{
+    if (!resource || !resourceTypeName)
+    {
+        return;
+    }
+
+    // Only index a type the resource really holds, removal walks the resource list.
+    for (OCResourceType *rtPtr = resource->rsrcType; rtPtr; rtPtr = rtPtr->next)
+    {
+        if (0 == strcmp(rtPtr->resourcetypename, resourceTypeName))
+        {
+            AddToTagTable(&g_typeIndex, resource, resourceTypeName);
+            return;
+        }
+    }
+}
+
+void OCResourceIndexAddInterface(OCResource *resource, const char *interfaceName)
+{
+    if (!resource || !interfaceName)
+    {
+        return;
+    }
+
+    for (OCResourceInterface *ifPtr = resource->rsrcInterface; ifPtr; ifPtr = ifPtr->next)
+    {
+        if (0 == strcmp(ifPtr->name, interfaceName))
+        {
+            AddToTagTable(&g_interfaceIndex, resource, interfaceName);
+            return;
+        }
+    }
+}
+
+bool OCResourceIndexGetByType(const char *resourceTypeName, OCResource ***resources,
+                              size_t *count)
+{
+    return GetFromTagTable(&g_typeIndex, resourceTypeName, resources, count);
+}
+
+bool OCResourceIndexGetByInterface(const char *interfaceName, OCResource ***resources,
+                                   size_t *count)
+{
+    return GetFromTagTable(&g_interfaceIndex, interfaceName, resources, count);
+}
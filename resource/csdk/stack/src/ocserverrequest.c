@@ -188,6 +188,81 @@ static OCStackResult OCSendResponse (const CAEndpoint_t *object, CAResponseInfo_
     return OC_STACK_OK;
 }
 
+/**
+ * Send a response, on all adapters if the endpoint does not select one.
+ *
+ * @param[in]  object           CA remote endpoint.
+ * @param[in]  responseInfo     CA response info.
+ *
+ * @return ::OC_STACK_OK on success, some other value upon failure.
+ */
+static OCStackResult SendResponseToEndpoint(const CAEndpoint_t *object,
+                                            CAResponseInfo_t *responseInfo)
+{
+    OCStackResult result = OC_STACK_OK;
+    CAEndpoint_t endpoint = *object;
+
+#ifdef WITH_PRESENCE
+    CATransportAdapter_t CAConnTypes[] = {
+                            CA_ADAPTER_IP,
+                            CA_ADAPTER_GATT_BTLE,
+                            CA_ADAPTER_RFCOMM_BTEDR,
+                            CA_ADAPTER_NFC
+#ifdef RA_ADAPTER
+                            , CA_ADAPTER_REMOTE_ACCESS
+#endif
+                            , CA_ADAPTER_TCP
+                        };
+
+    size_t size = sizeof(CAConnTypes)/ sizeof(CATransportAdapter_t);
+
+    CATransportAdapter_t adapter = endpoint.adapter;
+    // Default adapter, try to send response out on all adapters.
+    if (adapter == CA_DEFAULT_ADAPTER)
+    {
+        adapter =
+            (CATransportAdapter_t)(
+                CA_ADAPTER_IP           |
+                CA_ADAPTER_GATT_BTLE    |
+                CA_ADAPTER_RFCOMM_BTEDR |
+                CA_ADAPTER_NFC
+#ifdef RA_ADAP
+                | CA_ADAPTER_REMOTE_ACCESS
+#endif
+                | CA_ADAPTER_TCP
+            );
+    }
+
+    OCStackResult tempResult = OC_STACK_OK;
+
+    for(size_t i = 0; i < size; i++ )
+    {
+        endpoint.adapter = (CATransportAdapter_t)(adapter & CAConnTypes[i]);
+        if(endpoint.adapter)
+        {
+            //The result is set to OC_STACK_OK only if OCSendResponse succeeds in sending the
+            //response on all the n/w interfaces else it is set to OC_STACK_ERROR
+            tempResult = OCSendResponse(&endpoint, responseInfo);
+        }
+        if(OC_STACK_OK != tempResult)
+        {
+            result = tempResult;
+        }
+    }
+#else
+
+    OIC_LOG(INFO, TAG, "Calling OCSendResponse with:");
+    OIC_LOG_V(INFO, TAG, "\tEndpoint address: %s", endpoint.addr);
+    OIC_LOG_V(INFO, TAG, "\tEndpoint adapter: %s", endpoint.adapter);
+    OIC_LOG_V(INFO, TAG, "\tResponse result : %s", responseInfo->result);
+    OIC_LOG_V(INFO, TAG, "\tResponse for uri: %s", responseInfo->info.resourceUri);
+
+    result = OCSendResponse(&endpoint, responseInfo);
+#endif
+
+    return result;
+}
+
 static CAPayloadFormat_t OCToCAPayloadFormat (OCPayloadFormat ocFormat)
 {
     switch (ocFormat)
@@ -404,18 +479,86 @@ OCServerRequest * GetServerRequestUsingToken (const CAToken_t token, uint8_t tok
     return out;
 }
 
+static void FreeServerRequest(OCServerRequest * serverRequest)
+{
+    OICFree(serverRequest->requestToken);
+    OICFree(serverRequest->notificationTargets);
+    OICFree(serverRequest->encodedPayload);
+    OICFree(serverRequest);
+}
+
 void DeleteServerRequest(OCServerRequest * serverRequest)
 {
-    if (serverRequest)
+    if (serverRequest && !serverRequest->deleted)
     {
         RBL_REMOVE(ServerRequestTree, &g_serverRequestTree, serverRequest);
-        OICFree(serverRequest->requestToken);
-        OICFree(serverRequest);
-        serverRequest = NULL;
+        if (serverRequest->held)
+        {
+            // Freed by ReleaseServerRequest().
+            serverRequest->deleted = 1;
+        }
+        else
+        {
+            FreeServerRequest(serverRequest);
+        }
         OIC_LOG(INFO, TAG, "Server Request Removed");
     }
 }
 
+void HoldServerRequest(OCServerRequest * serverRequest)
+{
+    if (serverRequest)
+    {
+        serverRequest->held = 1;
+    }
+}
+
+bool ReleaseServerRequest(OCServerRequest * serverRequest)
+{
+    if (!serverRequest)
+    {
+        return false;
+    }
+
+    serverRequest->held = 0;
+    if (serverRequest->deleted)
+    {
+        FreeServerRequest(serverRequest);
+        return false;
+    }
+    return true;
+}
+
+OCStackResult AddServerRequestNotificationTarget(OCServerRequest *serverRequest,
+                                                 const CAToken_t token,
+                                                 uint8_t tokenLength,
+                                                 const OCDevAddr *devAddr,
+                                                 OCQualityOfService qos)
+{
+    if (!serverRequest || !devAddr || (tokenLength && !token) || tokenLength > CA_MAX_TOKEN_LEN)
+    {
+        return OC_STACK_INVALID_PARAM;
+    }
+
+    OCNotificationTarget *targets = (OCNotificationTarget *) OICRealloc(
+            serverRequest->notificationTargets,
+            (serverRequest->numNotificationTargets + 1) * sizeof(OCNotificationTarget));
+    if (!targets)
+    {
+        OIC_LOG(ERROR, TAG, "Memory alloc for notification target failed");
+        return OC_STACK_NO_MEMORY;
+    }
+    serverRequest->notificationTargets = targets;
+
+    OCNotificationTarget *target = &targets[serverRequest->numNotificationTargets];
+    memcpy(target->token, token, tokenLength);
+    target->tokenLength = tokenLength;
+    target->devAddr = *devAddr;
+    target->qos = qos;
+    serverRequest->numNotificationTargets++;
+    return OC_STACK_OK;
+}
+
 OCStackResult FormOCEntityHandlerRequest(OCEntityHandlerRequest * entityHandlerRequest,
                                          OCRequestHandle request,
                                          OCMethod method,
@@ -445,7 +588,8 @@ OCStackResult FormOCEntityHandlerRequest(OCEntityHandlerRequest * entityHandlerR
 
         if(payload && payloadSize)
         {
-            if(OCParsePayload(&entityHandlerRequest->payload, payloadFormat, payloadType,
+            // The payload only lives as long as the request, parse it in one arena.
+            if(OCParsePayloadInArena(&entityHandlerRequest->payload, payloadFormat, payloadType,
                         payload, payloadSize) != OC_STACK_OK)
             {
                 return OC_STACK_ERROR;
@@ -714,9 +858,9 @@ OCStackResult HandleSingleResponse(OCEntityHandlerResponse * ehResponse)
     responseInfo.info.payloadFormat = CA_FORMAT_UNDEFINED;
 
     // Put the JSON prefix and suffix around the payload
-    if(ehResponse->payload)
+    if(ehResponse->payload || serverRequest->encodedPayload)
     {
-        if (ehResponse->payload->type == PAYLOAD_TYPE_PRESENCE)
+        if (ehResponse->payload && ehResponse->payload->type == PAYLOAD_TYPE_PRESENCE)
         {
             responseInfo.isMulticast = true;
         }
@@ -731,7 +875,15 @@ OCStackResult HandleSingleResponse(OCEntityHandlerResponse * ehResponse)
                 // No preference set by the client, so default to CBOR then
             case OC_FORMAT_CBOR:
             case OC_FORMAT_VND_OCF_CBOR:
-                if((result = OCConvertPayload(ehResponse->payload, serverRequest->acceptFormat,
+                if (serverRequest->encodedPayload)
+                {
+                    // Already encoded in the accepted format.
+                    responseInfo.info.payload = serverRequest->encodedPayload;
+                    responseInfo.info.payloadSize = serverRequest->encodedPayloadSize;
+                    serverRequest->encodedPayload = NULL;
+                    serverRequest->encodedPayloadSize = 0;
+                }
+                else if((result = OCConvertPayload(ehResponse->payload, serverRequest->acceptFormat,
                                 &responseInfo.info.payload, &responseInfo.info.payloadSize))
                         != OC_STACK_OK)
                 {
@@ -740,7 +892,7 @@ OCStackResult HandleSingleResponse(OCEntityHandlerResponse * ehResponse)
                     return result;
                 }
                 // Add CONTENT_FORMAT OPT if payload exist
-                if (ehResponse->payload->type != PAYLOAD_TYPE_DIAGNOSTIC &&
+                if ((!ehResponse->payload || ehResponse->payload->type != PAYLOAD_TYPE_DIAGNOSTIC) &&
                         responseInfo.info.payloadSize > 0)
                 {
                     responseInfo.info.payloadFormat = OCToCAPayloadFormat(
@@ -766,64 +918,26 @@ OCStackResult HandleSingleResponse(OCEntityHandlerResponse * ehResponse)
         }
     }
 
-#ifdef WITH_PRESENCE
-    CATransportAdapter_t CAConnTypes[] = {
-                            CA_ADAPTER_IP,
-                            CA_ADAPTER_GATT_BTLE,
-                            CA_ADAPTER_RFCOMM_BTEDR,
-                            CA_ADAPTER_NFC
-#ifdef RA_ADAPTER
-                            , CA_ADAPTER_REMOTE_ACCESS
-#endif
-                            , CA_ADAPTER_TCP
-                        };
-
-    size_t size = sizeof(CAConnTypes)/ sizeof(CATransportAdapter_t);
+    result = SendResponseToEndpoint(&responseEndpoint, &responseInfo);
 
-    CATransportAdapter_t adapter = responseEndpoint.adapter;
-    // Default adapter, try to send response out on all adapters.
-    if (adapter == CA_DEFAULT_ADAPTER)
+    // The encoded payload and options are shared by all targets of a notification.
+    for (size_t i = 0; i < serverRequest->numNotificationTargets; i++)
     {
-        adapter =
-            (CATransportAdapter_t)(
-                CA_ADAPTER_IP           |
-                CA_ADAPTER_GATT_BTLE    |
-                CA_ADAPTER_RFCOMM_BTEDR |
-                CA_ADAPTER_NFC
-#ifdef RA_ADAP
-                | CA_ADAPTER_REMOTE_ACCESS
-#endif
-                | CA_ADAPTER_TCP
-            );
-    }
+        const OCNotificationTarget *target = &serverRequest->notificationTargets[i];
+        CAEndpoint_t targetEndpoint = {.adapter = CA_DEFAULT_ADAPTER};
+        CopyDevAddrToEndpoint(&target->devAddr, &targetEndpoint);
 
-    result = OC_STACK_OK;
-    OCStackResult tempResult = OC_STACK_OK;
+        memcpy(responseInfo.info.token, target->token, target->tokenLength);
+        responseInfo.info.tokenLength = target->tokenLength;
+        responseInfo.info.type = (OC_HIGH_QOS == target->qos) ? CA_MSG_CONFIRM :
+                                                                CA_MSG_NONCONFIRM;
 
-    for(size_t i = 0; i < size; i++ )
-    {
-        responseEndpoint.adapter = (CATransportAdapter_t)(adapter & CAConnTypes[i]);
-        if(responseEndpoint.adapter)
+        OCStackResult targetResult = SendResponseToEndpoint(&targetEndpoint, &responseInfo);
+        if (OC_STACK_OK != targetResult)
         {
-            //The result is set to OC_STACK_OK only if OCSendResponse succeeds in sending the
-            //response on all the n/w interfaces else it is set to OC_STACK_ERROR
-            tempResult = OCSendResponse(&responseEndpoint, &responseInfo);
-        }
-        if(OC_STACK_OK != tempResult)
-        {
-            result = tempResult;
+            result = targetResult;
         }
     }
-#else
-
-    OIC_LOG(INFO, TAG, "Calling OCSendResponse with:");
-    OIC_LOG_V(INFO, TAG, "\tEndpoint address: %s", responseEndpoint.addr);
-    OIC_LOG_V(INFO, TAG, "\tEndpoint adapter: %s", responseEndpoint.adapter);
-    OIC_LOG_V(INFO, TAG, "\tResponse result : %s", responseInfo.result);
-    OIC_LOG_V(INFO, TAG, "\tResponse for uri: %s", responseInfo.info.resourceUri);
-
-    result = OCSendResponse(&responseEndpoint, &responseInfo);
-#endif
 
     OICFree(responseInfo.info.payload);
     OICFree(responseInfo.info.options);
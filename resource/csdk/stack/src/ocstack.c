@@ -48,6 +48,9 @@
 #include "ocstack.h"
 #include "ocstackinternal.h"
 #include "ocresourcehandler.h"
+#include "ocresourceindex.h"
+#include "ocrequestdispatch.h"
+#include "ocdiscoverycache.h"
 #include "occlientcb.h"
 #include "ocobserve.h"
 #include "experimental/ocrandom.h"
@@ -128,6 +131,17 @@ typedef enum
 } OCPresenceState;
 #endif
 
+/**
+ * Client response being passed to its callback, with the bytes it was received in.
+ * Responses delivered from within a callback are stacked with previous.
+ */
+typedef struct OCDeliveredResponse
+{
+    const OCClientResponse *response;
+    OCCborView view;
+    struct OCDeliveredResponse *previous;
+} OCDeliveredResponse;
+
 //-----------------------------------------------------------------------------
 // Private variables
 //-----------------------------------------------------------------------------
@@ -149,8 +163,22 @@ static OCPresenceState presenceState = OC_PRESENCE_UNINITIALIZED;
 static PresenceResource presenceResource = {0};
 static uint8_t PresenceTimeOutSize = 0;
 static uint32_t PresenceTimeOut[] = {50, 75, 85, 95, 100};
+// Ticks of the earliest client presence timeout, computed by OCProcessPresence.
+static uint32_t g_presenceNextTimeout = UINT32_MAX;
 #endif
 
+// Upper bound in milliseconds for OCWaitForProcess, updated at the end of every
+// OCProcess call so that the timers it drives are serviced on time. Holds a uint32_t,
+// only accessed with oc_atomic since OCWaitForProcess may run on another thread.
+static volatile int32_t g_processWaitLimitMs = (int32_t) UINT32_MAX;
+
+// Client responses being passed to their callbacks, for OCGetResponsePayloadView.
+// Only accessed under the stack lock.
+static OCDeliveredResponse *g_deliveredResponse = NULL;
+
+// Number of threads calling entity handlers, set with OCSetRequestDispatchThreads.
+static uint32_t g_requestDispatchThreads = 0;
+
 static OCMode myStackMode;
 #ifdef RA_ADAPTER
 //TODO: revisit this design
@@ -164,6 +192,8 @@ static const char CORESPEC[] = "core";
 
 // Persistent Storage callback handler for open/read/write/close/unlink
 static OCPersistentStorage *g_PersistentStorageHandler = NULL;
+// Layout of the databases in persistent storage
+static OCPersistentStorageLayout g_PersistentStorageLayout = OC_PS_LAYOUT_SINGLE_FILE;
 // Number of users of OCStack, based on the successful calls to OCInit2 prior to OCStop
 // The variable must not be declared static because it is also referenced by the unit test
 uint32_t g_ocStackStartCount = 0;
@@ -193,6 +223,12 @@ bool g_multicastServerStopped = false;
 
 #define MILLISECONDS_PER_SECOND   (1000)
 
+/**
+ * Longest time OCWaitForProcess() blocks while OCProcess() has periodic work to do
+ * (keep alive, ping, routing). Those timers have a granularity of seconds.
+ */
+#define OC_PROCESS_TIMER_PERIOD_MS (1000)
+
 //-----------------------------------------------------------------------------
 // Private internal function prototypes
 //-----------------------------------------------------------------------------
@@ -1720,6 +1756,12 @@ void OC_CALL OCHandleResponse(const CAEndpoint_t* endPoint, const CAResponseInfo
 
             response->result = CAResponseToOCStackResult(responseInfo->result);
 
+            OCDeliveredResponse delivered = { response,
+                OCCborViewCreate(CAToOCPayloadFormat(responseInfo->info.payloadFormat),
+                                 (const uint8_t *) responseInfo->info.payload,
+                                 responseInfo->info.payloadSize),
+                g_deliveredResponse };
+
             if(responseInfo->info.payload &&
                responseInfo->info.payloadSize)
             {
@@ -1820,11 +1862,19 @@ void OC_CALL OCHandleResponse(const CAEndpoint_t* endPoint, const CAResponseInfo
                     return;
                 }
 
+                if (cbNode->payloadViewOnly && PAYLOAD_TYPE_REPRESENTATION == type &&
+                    delivered.view.data)
+                {
+                    // The application reads it with OCGetResponsePayloadView().
+                    OIC_LOG(DEBUG, TAG, "Payload is left undecoded for its view");
+                }
                 // In case of error, still want application to receive the error message.
-                if (OCResultToSuccess(response->result) || PAYLOAD_TYPE_REPRESENTATION == type ||
-                        PAYLOAD_TYPE_DIAGNOSTIC == type)
+                else if (OCResultToSuccess(response->result) ||
+                         PAYLOAD_TYPE_REPRESENTATION == type ||
+                         PAYLOAD_TYPE_DIAGNOSTIC == type)
                 {
-                    if (OC_STACK_OK != OCParsePayload(&response->payload,
+                    // The payload is destroyed once the callback returns.
+                    if (OC_STACK_OK != OCParsePayloadInArena(&response->payload,
                             CAToOCPayloadFormat(responseInfo->info.payloadFormat),
                             type,
                             responseInfo->info.payload,
@@ -1948,9 +1998,11 @@ void OC_CALL OCHandleResponse(const CAEndpoint_t* endPoint, const CAResponseInfo
                     HandleBatchResponse(cbNode->requestUri, (OCRepPayload **)&response->payload);
                 }
 
+                g_deliveredResponse = &delivered;
                 OCStackApplicationResult appFeedback = cbNode->callBack(cbNode->context,
                                                                         cbNode->handle,
                                                                         response);
+                g_deliveredResponse = delivered.previous;
                 cbNode->sequenceNumber = response->sequenceNumber;
 
                 if (appFeedback == OC_STACK_DELETE_TRANSACTION)
@@ -1960,8 +2012,8 @@ void OC_CALL OCHandleResponse(const CAEndpoint_t* endPoint, const CAResponseInfo
                 else
                 {
                     // To keep discovery callbacks active.
-                    cbNode->TTL = GetTicks(MAX_CB_TIMEOUT_SECONDS *
-                                            MILLISECONDS_PER_SECOND);
+                    SetClientCBTimeout(cbNode, GetTicks(MAX_CB_TIMEOUT_SECONDS *
+                                                        MILLISECONDS_PER_SECOND));
                 }
             }
 
@@ -2084,7 +2136,9 @@ void HandleCAResponses(const CAEndpoint_t* endPoint, const CAResponseInfo_t* res
         (CAEndpoint_t *)endPoint);
 #endif
 
+    OCStackLock();
     OCHandleResponse(endPoint, responseInfo);
+    OCStackUnlock();
 
     OIC_LOG(INFO, TAG, "Exit HandleCAResponses");
     OIC_TRACE_END();
@@ -2101,6 +2155,7 @@ void HandleCAErrorResponse(const CAEndpoint_t *endPoint, const CAErrorInfo_t *er
 
     OIC_LOG(INFO, TAG, "Enter HandleCAErrorResponse");
     OIC_TRACE_BEGIN(%s:HandleCAErrorResponse, TAG);
+    OCStackLock();
 
     ClientCB *cbNode = GetClientCBUsingToken(errorInfo->info.token,
                                              errorInfo->info.tokenLength);
@@ -2112,6 +2167,7 @@ void HandleCAErrorResponse(const CAEndpoint_t *endPoint, const CAErrorInfo_t *er
         if (!response)
         {
             OIC_LOG(ERROR, TAG, "Allocating memory for response failed");
+            OCStackUnlock();
             OIC_TRACE_END();
             return;
         }
@@ -2147,6 +2203,7 @@ void HandleCAErrorResponse(const CAEndpoint_t *endPoint, const CAErrorInfo_t *er
         }
     }
 
+    OCStackUnlock();
     OIC_LOG(INFO, TAG, "Exit HandleCAErrorResponse");
     OIC_TRACE_END();
 }
@@ -2604,14 +2661,18 @@ void HandleCARequests(const CAEndpoint_t* endPoint, const CARequestInfo_t* reque
         CAResponseInfo_t respInfo = {.result = CA_EMPTY,
                                      .info.messageId = requestInfo->info.messageId,
                                      .info.type = CA_MSG_ACKNOWLEDGE};
+        OCStackLock();
         OCHandleResponse(endPoint, &respInfo);
+        OCStackUnlock();
     }
     else
 #endif
 #endif
     {
         // Normal handling of the packet
+        OCStackLock();
         OCHandleRequests(endPoint, requestInfo);
+        OCStackUnlock();
     }
     OIC_LOG(INFO, TAG, "Exit HandleCARequests");
     OIC_TRACE_END();
@@ -2748,6 +2809,12 @@ OCStackResult OCInitializeInternal(OCMode mode, OCTransportFlags serverFlags,
     result = InitializeScheduleResourceList();
     VERIFY_SUCCESS(result, OC_STACK_OK);
 
+    result = OCRequestDispatchStart(g_requestDispatchThreads);
+    VERIFY_SUCCESS(result, OC_STACK_OK);
+
+    result = OCDiscoveryCacheInit();
+    VERIFY_SUCCESS(result, OC_STACK_OK);
+
     result = CAResultToOCResult(CAInitialize((CATransportAdapter_t)transportType));
     VERIFY_SUCCESS(result, OC_STACK_OK);
 
@@ -2829,9 +2896,11 @@ exit:
     if(result != OC_STACK_OK)
     {
         OIC_LOG(ERROR, TAG, "Stack initialization error");
+        OCRequestDispatchStop();
         TerminateScheduleResourceList();
         deleteAllResources();
         CATerminate();
+        OCDiscoveryCacheTerminate();
         stackState = OC_STACK_UNINITIALIZED;
     }
     return result;
@@ -2871,6 +2940,9 @@ OCStackResult OCDeInitializeInternal(void)
 {
     assert(stackState == OC_STACK_INITIALIZED);
 
+    // Let the entity handlers already queued answer their requests.
+    OCRequestDispatchStop();
+
 #ifdef WITH_PRESENCE
     // Ensure that the TTL associated with ANY and ALL presence notifications originating from
     // here send with the code "OC_STACK_PRESENCE_STOPPED" result.
@@ -2901,10 +2973,12 @@ OCStackResult OCDeInitializeInternal(void)
     TerminateScheduleResourceList();
     // Free memory dynamically allocated for resources
     deleteAllResources();
+    ClearPersistentStorageCache();
     // Remove all the client callbacks
     DeleteClientCBList();
     // Terminate connectivity-abstraction layer.
     CATerminate();
+    OCDiscoveryCacheTerminate();
 
 #if defined(TCP_ADAPTER) && defined(WITH_CLOUD)
     // Terminate the Connection Manager
@@ -2936,6 +3010,17 @@ OCStackResult OC_CALL OCStopMulticastServer(void)
     return OC_STACK_OK;
 }
 
+OCStackResult OC_CALL OCSetRequestDispatchThreads(uint32_t threadCount)
+{
+    if (stackState != OC_STACK_UNINITIALIZED)
+    {
+        OIC_LOG(ERROR, TAG, "OCStack is initialized. Cannot change the dispatch threads.");
+        return OC_STACK_ERROR;
+    }
+    g_requestDispatchThreads = threadCount;
+    return OC_STACK_OK;
+}
+
 CAMessageType_t qualityOfServiceToMessageType(OCQualityOfService qos)
 {
     switch (qos)
@@ -3243,16 +3328,16 @@ static void assertRolesCB(void* ctx, bool hasError)
 /**
  * Discover or Perform requests on a specified resource
  */
-OCStackResult OC_CALL OCDoRequest(OCDoHandle *handle,
-                                  OCMethod method,
-                                  const char *requestUri,
-                                  const OCDevAddr *destination,
-                                  OCPayload* payload,
-                                  OCConnectivityType connectivityType,
-                                  OCQualityOfService qos,
-                                  OCCallbackData *cbData,
-                                  OCHeaderOption *options,
-                                  uint8_t numOptions)
+static OCStackResult OCDoRequestInternal(OCDoHandle *handle,
+                                         OCMethod method,
+                                         const char *requestUri,
+                                         const OCDevAddr *destination,
+                                         OCPayload* payload,
+                                         OCConnectivityType connectivityType,
+                                         OCQualityOfService qos,
+                                         OCCallbackData *cbData,
+                                         OCHeaderOption *options,
+                                         uint8_t numOptions)
 {
     OIC_LOG(INFO, TAG, "Entering OCDoResource");
 
@@ -3707,8 +3792,27 @@ exit:
     return result;
 }
 
-OCStackResult OC_CALL OCCancel(OCDoHandle handle, OCQualityOfService qos, OCHeaderOption * options,
-        uint8_t numOptions)
+OCStackResult OC_CALL OCDoRequest(OCDoHandle *handle,
+                                  OCMethod method,
+                                  const char *requestUri,
+                                  const OCDevAddr *destination,
+                                  OCPayload* payload,
+                                  OCConnectivityType connectivityType,
+                                  OCQualityOfService qos,
+                                  OCCallbackData *cbData,
+                                  OCHeaderOption *options,
+                                  uint8_t numOptions)
+{
+    OCStackLock();
+    OCStackResult result = OCDoRequestInternal(handle, method, requestUri, destination, payload,
+                                               connectivityType, qos, cbData, options,
+                                               numOptions);
+    OCStackUnlock();
+    return result;
+}
+
+static OCStackResult OCCancelInternal(OCDoHandle handle, OCQualityOfService qos,
+        OCHeaderOption * options, uint8_t numOptions)
 {
     /*
      * This ftn is implemented one of two ways in the case of observation:
@@ -3814,12 +3918,22 @@ OCStackResult OC_CALL OCCancel(OCDoHandle handle, OCQualityOfService qos, OCHead
     return ret;
 }
 
+OCStackResult OC_CALL OCCancel(OCDoHandle handle, OCQualityOfService qos, OCHeaderOption * options,
+        uint8_t numOptions)
+{
+    OCStackLock();
+    OCStackResult result = OCCancelInternal(handle, qos, options, numOptions);
+    OCStackUnlock();
+    return result;
+}
+
 /**
  * @brief   Register Persistent storage callback.
  * @param[in] persistentStorageHandler  Pointers to open, read, write, close & unlink handlers.
  * @return
  *     OC_STACK_OK    - No errors; Success
  *     OC_STACK_INVALID_PARAM - Invalid parameter
+ *     OC_STACK_NO_MEMORY - Not enough memory to cache the databases
  */
 OCStackResult OC_CALL OCRegisterPersistentStorageHandler(OCPersistentStorage* persistentStorageHandler)
 {
@@ -3835,8 +3949,19 @@ OCStackResult OC_CALL OCRegisterPersistentStorageHandler(OCPersistentStorage* pe
             OIC_LOG(ERROR, TAG, "The persistent storage handler is invalid");
             return OC_STACK_INVALID_PARAM;
         }
+
+        OCStackResult result = InitPersistentStorageInterface();
+        if (OC_STACK_OK != result)
+        {
+            return result;
+        }
+        g_PersistentStorageHandler = persistentStorageHandler;
+    }
+    else
+    {
+        g_PersistentStorageHandler = NULL;
+        DeinitPersistentStorageInterface();
     }
-    g_PersistentStorageHandler = persistentStorageHandler;
     return OC_STACK_OK;
 }
 
@@ -3845,6 +3970,25 @@ OCPersistentStorage *OC_CALL OCGetPersistentStorageHandler(void)
     return g_PersistentStorageHandler;
 }
 
+OCStackResult OC_CALL OCSetPersistentStorageLayout(OCPersistentStorageLayout layout)
+{
+    if ((OC_PS_LAYOUT_SINGLE_FILE != layout) &&
+        (OC_PS_LAYOUT_CACHED_FILE != layout) &&
+        (OC_PS_LAYOUT_FILE_PER_RESOURCE != layout))
+    {
+        OIC_LOG(ERROR, TAG, "Invalid persistent storage layout");
+        return OC_STACK_INVALID_PARAM;
+    }
+    g_PersistentStorageLayout = layout;
+    ClearPersistentStorageCache();
+    return OC_STACK_OK;
+}
+
+OCPersistentStorageLayout OC_CALL OCGetPersistentStorageLayout(void)
+{
+    return g_PersistentStorageLayout;
+}
+
 #ifdef WITH_PRESENCE
 
 OCStackResult OCProcessPresence(void)
@@ -3859,6 +4003,8 @@ OCStackResult OCProcessPresence(void)
     OCClientResponse clientResponse;
     OCStackApplicationResult cbResult = OC_STACK_DELETE_TRANSACTION;
 
+    g_presenceNextTimeout = UINT32_MAX;
+
     LL_FOREACH_SAFE(g_cbList, cbNode, cbTemp)
     {
         if (OC_REST_PRESENCE != cbNode->method || !cbNode->presence)
@@ -3873,7 +4019,7 @@ OCStackResult OCProcessPresence(void)
 
         if (cbNode->presence->TTLlevel > PresenceTimeOutSize)
         {
-            goto exit;
+            continue;
         }
 
         if (cbNode->presence->TTLlevel < PresenceTimeOutSize)
@@ -3902,10 +4048,15 @@ OCStackResult OCProcessPresence(void)
             {
                 DeleteClientCB(cbNode);
             }
+            continue;
         }
 
         if (now < cbNode->presence->timeOut[cbNode->presence->TTLlevel])
         {
+            if (cbNode->presence->timeOut[cbNode->presence->TTLlevel] < g_presenceNextTimeout)
+            {
+                g_presenceNextTimeout = cbNode->presence->timeOut[cbNode->presence->TTLlevel];
+            }
             continue;
         }
 
@@ -3932,17 +4083,68 @@ OCStackResult OCProcessPresence(void)
 
         cbNode->presence->TTLlevel++;
         OIC_LOG_V(DEBUG, TAG, "moving to TTL level %d", cbNode->presence->TTLlevel);
+
+        // the last level has no timeout of its own, it is reported on the next pass.
+        if (cbNode->presence->TTLlevel >= PresenceTimeOutSize)
+        {
+            g_presenceNextTimeout = now;
+        }
+        else if (cbNode->presence->timeOut[cbNode->presence->TTLlevel] < g_presenceNextTimeout)
+        {
+            g_presenceNextTimeout = cbNode->presence->timeOut[cbNode->presence->TTLlevel];
+        }
     }
 exit:
     if (result != OC_STACK_OK)
     {
         OIC_LOG(ERROR, TAG, "OCProcessPresence error");
+        // retry on the next pass
+        g_presenceNextTimeout = 0;
     }
 
     return result;
 }
 #endif // WITH_PRESENCE
 
+/**
+ * Compute how long OCWaitForProcess may block before the timers driven by
+ * OCProcess need servicing.
+ */
+static void UpdateProcessWaitLimit(void)
+{
+    uint32_t limitMs = UINT32_MAX;
+
+#ifdef WITH_PRESENCE
+    if (UINT32_MAX != g_presenceNextTimeout)
+    {
+        uint32_t now = GetTicks(0);
+        limitMs = (g_presenceNextTimeout <= now) ? 0 :
+                  (uint32_t) (((uint64_t) (g_presenceNextTimeout - now) * MILLISECONDS_PER_SECOND)
+                              / COAP_TICKS_PER_SECOND);
+    }
+#endif
+
+#if defined(TCP_ADAPTER) || defined(ROUTING_GATEWAY)
+    if (OC_PROCESS_TIMER_PERIOD_MS < limitMs)
+    {
+        limitMs = OC_PROCESS_TIMER_PERIOD_MS;
+    }
+#endif
+
+    // Client callbacks time out with a resolution of one second.
+    if (HasClientCBTimeouts() && OC_PROCESS_TIMER_PERIOD_MS < limitMs)
+    {
+        limitMs = OC_PROCESS_TIMER_PERIOD_MS;
+    }
+
+    int32_t previous;
+    do
+    {
+        previous = oc_atomic_add(&g_processWaitLimitMs, 0);
+    }
+    while (!oc_atomic_cmpxchg(&g_processWaitLimitMs, previous, (int32_t) limitMs));
+}
+
 OCStackResult OC_CALL OCProcess(void)
 {
     if (stackState == OC_STACK_UNINITIALIZED)
@@ -3951,10 +4153,53 @@ OCStackResult OC_CALL OCProcess(void)
         return OC_STACK_ERROR;
     }
 #ifdef WITH_PRESENCE
+    OCStackLock();
     OCProcessPresence();
+    OCStackUnlock();
 #endif
     CAHandleRequestResponse();
 
+    OCStackLock();
+#ifdef ROUTING_GATEWAY
+    RMProcess();
+#endif
+
+#ifdef TCP_ADAPTER
+    ProcessKeepAlive();
+    CAProcessPing();
+#endif
+    DeleteTimedOutClientCBs();
+    UpdateProcessWaitLimit();
+    OCStackUnlock();
+    return OC_STACK_OK;
+}
+
+OCStackResult OC_CALL OCProcessEx(uint32_t maxMessages, uint32_t timeoutMs,
+                                  uint32_t *handledCount)
+{
+    if (handledCount)
+    {
+        *handledCount = 0;
+    }
+
+    if (stackState == OC_STACK_UNINITIALIZED)
+    {
+        OIC_LOG(ERROR, TAG, "OCProcessEx has failed. ocstack is not initialized");
+        return OC_STACK_ERROR;
+    }
+#ifdef WITH_PRESENCE
+    OCStackLock();
+    OCProcessPresence();
+    OCStackUnlock();
+#endif
+    CAResult_t caResult = CAHandleRequestResponseBatch(maxMessages, timeoutMs, handledCount);
+    if (CA_STATUS_OK != caResult)
+    {
+        OIC_LOG_V(ERROR, TAG, "CAHandleRequestResponseBatch failed: %d", caResult);
+        return CAResultToOCResult(caResult);
+    }
+
+    OCStackLock();
 #ifdef ROUTING_GATEWAY
     RMProcess();
 #endif
@@ -3963,9 +4208,40 @@ OCStackResult OC_CALL OCProcess(void)
     ProcessKeepAlive();
     CAProcessPing();
 #endif
+    DeleteTimedOutClientCBs();
+    UpdateProcessWaitLimit();
+    OCStackUnlock();
     return OC_STACK_OK;
 }
 
+OCStackResult OC_CALL OCWaitForProcess(uint32_t timeoutMs)
+{
+    if (stackState == OC_STACK_UNINITIALIZED)
+    {
+        OIC_LOG(ERROR, TAG, "OCWaitForProcess has failed. ocstack is not initialized");
+        return OC_STACK_ERROR;
+    }
+
+    uint32_t waitMs = (uint32_t) oc_atomic_add(&g_processWaitLimitMs, 0);
+    if (timeoutMs < waitMs)
+    {
+        waitMs = timeoutMs;
+    }
+
+    return CAResultToOCResult(CAWaitForRequestResponse(waitMs));
+}
+
+OCStackResult OC_CALL OCWakeUpProcess(void)
+{
+    if (stackState == OC_STACK_UNINITIALIZED)
+    {
+        OIC_LOG(ERROR, TAG, "OCWakeUpProcess has failed. ocstack is not initialized");
+        return OC_STACK_ERROR;
+    }
+
+    return CAResultToOCResult(CAWakeUpRequestResponseWait());
+}
+
 #ifdef WITH_PRESENCE
 OCStackResult OC_CALL OCStartPresence(const uint32_t ttl)
 {
@@ -4082,7 +4358,7 @@ OCStackResult OC_CALL OCCreateResource(OCResourceHandle *handle,
                                   OC_ALL);
 }
 
-OCStackResult OC_CALL OCCreateResourceWithEp(OCResourceHandle *handle,
+static OCStackResult OCCreateResourceWithEpInternal(OCResourceHandle *handle,
         const char *resourceTypeName,
         const char *resourceInterfaceName,
         const char *uri, OCEntityHandler entityHandler,
@@ -4166,21 +4442,11 @@ OCStackResult OC_CALL OCCreateResourceWithEp(OCResourceHandle *handle,
         return OC_STACK_INVALID_PARAM;
     }
 
-    // If the headResource is NULL, then no resources have been created...
-    pointer = headResource;
-    if (pointer)
+    // Repeated URLs are not allowed.  If a repeat is found, exit with an error
+    if (OCResourceIndexFindByUri(uri))
     {
-        // At least one resources is in the resource list, so we need to search for
-        // repeated URLs, which are not allowed.  If a repeat is found, exit with an error
-        while (pointer)
-        {
-            if (strncmp(uri, pointer->uri, MAX_URI_LENGTH) == 0)
-            {
-                OIC_LOG_V(ERROR, TAG, "Resource %s already exists", uri);
-                return OC_STACK_INVALID_PARAM;
-            }
-            pointer = pointer->next;
-        }
+        OIC_LOG_V(ERROR, TAG, "Resource %s already exists", uri);
+        return OC_STACK_INVALID_PARAM;
     }
     // Create the pointer and insert it into the resource list
     pointer = (OCResource *) OICCalloc(1, sizeof(OCResource));
@@ -4201,6 +4467,13 @@ OCStackResult OC_CALL OCCreateResourceWithEp(OCResourceHandle *handle,
         goto exit;
     }
 
+    result = OCResourceIndexAdd(pointer);
+    if (result != OC_STACK_OK)
+    {
+        OIC_LOG(ERROR, TAG, "Error indexing resource");
+        goto exit;
+    }
+
     // Set resource to nonsecure if caller did not specify
     if ((resourceProperties & OC_MASK_RESOURCE_SECURE) == 0)
     {
@@ -4272,7 +4545,24 @@ exit:
     return result;
 }
 
-OCStackResult OC_CALL OCBindResource(
+OCStackResult OC_CALL OCCreateResourceWithEp(OCResourceHandle *handle,
+        const char *resourceTypeName,
+        const char *resourceInterfaceName,
+        const char *uri, OCEntityHandler entityHandler,
+        void *callbackParam,
+        uint8_t resourceProperties,
+        OCTpsSchemeFlags resourceTpsTypes)
+{
+    OCStackLock();
+    OCStackResult result = OCCreateResourceWithEpInternal(handle, resourceTypeName,
+                                                          resourceInterfaceName, uri,
+                                                          entityHandler, callbackParam,
+                                                          resourceProperties, resourceTpsTypes);
+    OCStackUnlock();
+    return result;
+}
+
+static OCStackResult OCBindResourceInternal(
         OCResourceHandle collectionHandle, OCResourceHandle resourceHandle)
 {
     OCResource *resource = NULL;
@@ -4330,6 +4620,7 @@ OCStackResult OC_CALL OCBindResource(
     }
 
     OIC_LOG(INFO, TAG, "resource bound");
+    OCDiscoveryCacheInvalidate();
 
 #ifdef WITH_PRESENCE
     if (presenceResource.handle)
@@ -4343,7 +4634,16 @@ OCStackResult OC_CALL OCBindResource(
     return OC_STACK_OK;
 }
 
-OCStackResult OC_CALL OCUnBindResource(
+OCStackResult OC_CALL OCBindResource(
+        OCResourceHandle collectionHandle, OCResourceHandle resourceHandle)
+{
+    OCStackLock();
+    OCStackResult result = OCBindResourceInternal(collectionHandle, resourceHandle);
+    OCStackUnlock();
+    return result;
+}
+
+static OCStackResult OCUnBindResourceInternal(
         OCResourceHandle collectionHandle, OCResourceHandle resourceHandle)
 {
     OCResource *resource = NULL;
@@ -4407,6 +4707,7 @@ OCStackResult OC_CALL OCUnBindResource(
             }
 
             OIC_LOG(INFO, TAG, "resource unbound");
+            OCDiscoveryCacheInvalidate();
 
             // Send notification when resource is unbounded successfully.
 #ifdef WITH_PRESENCE
@@ -4437,6 +4738,15 @@ OCStackResult OC_CALL OCUnBindResource(
     return OC_STACK_ERROR;
 }
 
+OCStackResult OC_CALL OCUnBindResource(
+        OCResourceHandle collectionHandle, OCResourceHandle resourceHandle)
+{
+    OCStackLock();
+    OCStackResult result = OCUnBindResourceInternal(collectionHandle, resourceHandle);
+    OCStackUnlock();
+    return result;
+}
+
 static bool ValidateResourceTypeInterface(const char *resourceItemName)
 {
     if (!resourceItemName)
@@ -4509,6 +4819,8 @@ OCStackResult BindResourceTypeToResource(OCResource* resource,
     pointer->next = NULL;
 
     insertResourceType(resource, pointer);
+    OCResourceIndexAddType(resource, resourceTypeName);
+    OCDiscoveryCacheInvalidate();
     result = OC_STACK_OK;
 
 exit:
@@ -4555,6 +4867,8 @@ OCStackResult BindResourceInterfaceToResource(OCResource* resource,
 
     // Bind the resourceinterface to the resource
     insertResourceInterface(resource, pointer);
+    OCResourceIndexAddInterface(resource, resourceInterfaceName);
+    OCDiscoveryCacheInvalidate();
 
     result = OC_STACK_OK;
 
@@ -4596,10 +4910,11 @@ OCStackResult BindTpsTypeToResource(OCResource* resource,
 
     OIC_LOG_V(INFO, TAG, "Binding %d TPS flags to %s", supportedTps, resource->uri);
     resource->endpointType = supportedTps;
+    OCDiscoveryCacheInvalidate();
     return result;
 }
 
-OCStackResult OC_CALL OCBindResourceTypeToResource(OCResourceHandle handle,
+static OCStackResult OCBindResourceTypeToResourceInternal(OCResourceHandle handle,
         const char *resourceTypeName)
 {
 
@@ -4626,7 +4941,16 @@ OCStackResult OC_CALL OCBindResourceTypeToResource(OCResourceHandle handle,
     return result;
 }
 
-OCStackResult OC_CALL OCBindResourceInterfaceToResource(OCResourceHandle handle,
+OCStackResult OC_CALL OCBindResourceTypeToResource(OCResourceHandle handle,
+        const char *resourceTypeName)
+{
+    OCStackLock();
+    OCStackResult result = OCBindResourceTypeToResourceInternal(handle, resourceTypeName);
+    OCStackUnlock();
+    return result;
+}
+
+static OCStackResult OCBindResourceInterfaceToResourceInternal(OCResourceHandle handle,
         const char *resourceInterfaceName)
 {
 
@@ -4653,32 +4977,29 @@ OCStackResult OC_CALL OCBindResourceInterfaceToResource(OCResourceHandle handle,
     return result;
 }
 
-OCStackResult OC_CALL OCGetNumberOfResources(uint8_t *numResources)
+OCStackResult OC_CALL OCBindResourceInterfaceToResource(OCResourceHandle handle,
+        const char *resourceInterfaceName)
 {
-    OCResource *pointer = headResource;
+    OCStackLock();
+    OCStackResult result = OCBindResourceInterfaceToResourceInternal(handle,
+                                                                     resourceInterfaceName);
+    OCStackUnlock();
+    return result;
+}
 
+OCStackResult OC_CALL OCGetNumberOfResources(uint8_t *numResources)
+{
     VERIFY_NON_NULL(numResources, ERROR, OC_STACK_INVALID_PARAM);
-    *numResources = 0;
-    while (pointer)
-    {
-        *numResources = *numResources + 1;
-        pointer = pointer->next;
-    }
+    *numResources = (uint8_t) OCResourceIndexGetCount();
     return OC_STACK_OK;
 }
 
 OCResourceHandle OC_CALL OCGetResourceHandle(uint8_t index)
 {
-    OCResource *pointer = headResource;
-
-    for( uint8_t i = 0; i < index && pointer; ++i)
-    {
-        pointer = pointer->next;
-    }
-    return (OCResourceHandle) pointer;
+    return (OCResourceHandle) OCResourceIndexGetAt(index);
 }
 
-OCStackResult OC_CALL OCDeleteResource(OCResourceHandle handle)
+static OCStackResult OCDeleteResourceInternal(OCResourceHandle handle)
 {
     if (!handle)
     {
@@ -4702,6 +5023,14 @@ OCStackResult OC_CALL OCDeleteResource(OCResourceHandle handle)
     return OC_STACK_OK;
 }
 
+OCStackResult OC_CALL OCDeleteResource(OCResourceHandle handle)
+{
+    OCStackLock();
+    OCStackResult result = OCDeleteResourceInternal(handle);
+    OCStackUnlock();
+    return result;
+}
+
 const char *OC_CALL OCGetResourceUri(OCResourceHandle handle)
 {
     OCResource *resource = NULL;
@@ -4726,7 +5055,7 @@ OCResourceProperty OC_CALL OCGetResourceProperties(OCResourceHandle handle)
     return (OCResourceProperty)-1;
 }
 
-OCStackResult OC_CALL OCSetResourceProperties(OCResourceHandle handle, uint8_t resourceProperties)
+static OCStackResult OCSetResourcePropertiesInternal(OCResourceHandle handle, uint8_t resourceProperties)
 {
     OCResource *resource = NULL;
 
@@ -4737,10 +5066,19 @@ OCStackResult OC_CALL OCSetResourceProperties(OCResourceHandle handle, uint8_t r
         return OC_STACK_NO_RESOURCE;
     }
     resource->resourceProperties = (OCResourceProperty) (resource->resourceProperties | resourceProperties);
+    OCDiscoveryCacheInvalidate();
     return OC_STACK_OK;
 }
 
-OCStackResult OC_CALL OCClearResourceProperties(OCResourceHandle handle, uint8_t resourceProperties)
+OCStackResult OC_CALL OCSetResourceProperties(OCResourceHandle handle, uint8_t resourceProperties)
+{
+    OCStackLock();
+    OCStackResult result = OCSetResourcePropertiesInternal(handle, resourceProperties);
+    OCStackUnlock();
+    return result;
+}
+
+static OCStackResult OCClearResourcePropertiesInternal(OCResourceHandle handle, uint8_t resourceProperties)
 {
     OCResource *resource = NULL;
 
@@ -4751,9 +5089,18 @@ OCStackResult OC_CALL OCClearResourceProperties(OCResourceHandle handle, uint8_t
         return OC_STACK_NO_RESOURCE;
     }
     resource->resourceProperties = (OCResourceProperty) (resource->resourceProperties & ~resourceProperties);
+    OCDiscoveryCacheInvalidate();
     return OC_STACK_OK;
 }
 
+OCStackResult OC_CALL OCClearResourceProperties(OCResourceHandle handle, uint8_t resourceProperties)
+{
+    OCStackLock();
+    OCStackResult result = OCClearResourcePropertiesInternal(handle, resourceProperties);
+    OCStackUnlock();
+    return result;
+}
+
 OCStackResult OC_CALL OCGetNumberOfResourceTypes(OCResourceHandle handle,
         uint8_t *numResourceTypes)
 {
@@ -4855,7 +5202,7 @@ OCResourceHandle OC_CALL OCGetResourceHandleFromCollection(OCResourceHandle coll
     return NULL;
 }
 
-OCStackResult OC_CALL OCBindResourceHandler(OCResourceHandle handle,
+static OCStackResult OCBindResourceHandlerInternal(OCResourceHandle handle,
         OCEntityHandler entityHandler,
         void* callbackParam)
 {
@@ -4887,6 +5234,16 @@ OCStackResult OC_CALL OCBindResourceHandler(OCResourceHandle handle,
     return OC_STACK_OK;
 }
 
+OCStackResult OC_CALL OCBindResourceHandler(OCResourceHandle handle,
+        OCEntityHandler entityHandler,
+        void* callbackParam)
+{
+    OCStackLock();
+    OCStackResult result = OCBindResourceHandlerInternal(handle, entityHandler, callbackParam);
+    OCStackUnlock();
+    return result;
+}
+
 OCEntityHandler OC_CALL OCGetResourceHandler(OCResourceHandle handle)
 {
     OCResource *resource = NULL;
@@ -4959,7 +5316,7 @@ OCStackResult SendStopNotification(void)
 }
 
 #endif // WITH_PRESENCE
-OCStackResult OC_CALL OCNotifyAllObservers(OCResourceHandle handle, OCQualityOfService qos)
+static OCStackResult OCNotifyAllObserversInternal(OCResourceHandle handle, OCQualityOfService qos)
 {
     OCResource *resPtr = NULL;
     OCStackResult result = OC_STACK_ERROR;
@@ -4997,8 +5354,16 @@ OCStackResult OC_CALL OCNotifyAllObservers(OCResourceHandle handle, OCQualityOfS
     }
 }
 
-OCStackResult
-OC_CALL OCNotifyListOfObservers (OCResourceHandle handle,
+OCStackResult OC_CALL OCNotifyAllObservers(OCResourceHandle handle, OCQualityOfService qos)
+{
+    OCStackLock();
+    OCStackResult result = OCNotifyAllObserversInternal(handle, qos);
+    OCStackUnlock();
+    return result;
+}
+
+static OCStackResult
+OCNotifyListOfObserversInternal (OCResourceHandle handle,
                                  OCObservationId  *obsIdList,
                                  uint8_t          numberOfIds,
                                  const OCRepPayload       *payload,
@@ -5027,6 +5392,20 @@ OC_CALL OCNotifyListOfObservers (OCResourceHandle handle,
             payload, maxAge, qos));
 }
 
+OCStackResult
+OC_CALL OCNotifyListOfObservers (OCResourceHandle handle,
+                                 OCObservationId  *obsIdList,
+                                 uint8_t          numberOfIds,
+                                 const OCRepPayload       *payload,
+                                 OCQualityOfService qos)
+{
+    OCStackLock();
+    OCStackResult result = OCNotifyListOfObserversInternal(handle, obsIdList, numberOfIds,
+                                                           payload, qos);
+    OCStackUnlock();
+    return result;
+}
+
 OCStackResult OC_CALL OCDoResponse(OCEntityHandlerResponse *ehResponse)
 {
     OIC_TRACE_BEGIN(%s:OCDoResponse, TAG);
@@ -5045,13 +5424,71 @@ OCStackResult OC_CALL OCDoResponse(OCEntityHandlerResponse *ehResponse)
     if(serverRequest)
     {
         // response handler in ocserverrequest.c. Usually HandleSingleResponse.
+        OCStackLock();
         result = serverRequest->ehResponseHandler(ehResponse);
+        OCStackUnlock();
     }
 
     OIC_TRACE_END();
     return result;
 }
 
+OCStackResult OC_CALL OCGetRequestPayloadView(OCRequestHandle handle, OCCborView *view)
+{
+    VERIFY_NON_NULL(handle, ERROR, OC_STACK_INVALID_PARAM);
+    VERIFY_NON_NULL(view, ERROR, OC_STACK_INVALID_PARAM);
+
+    // The request owns the received bytes until it is answered.
+    OCServerRequest *serverRequest = (OCServerRequest *)handle;
+    *view = OCCborViewCreate(serverRequest->payloadFormat, serverRequest->payload,
+                             serverRequest->payloadSize);
+    return OC_STACK_OK;
+}
+
+OCStackResult OC_CALL OCGetResponsePayloadView(const OCClientResponse *response,
+                                               OCCborView *view)
+{
+    VERIFY_NON_NULL(response, ERROR, OC_STACK_INVALID_PARAM);
+    VERIFY_NON_NULL(view, ERROR, OC_STACK_INVALID_PARAM);
+
+    OCStackResult result = OC_STACK_INVALID_PARAM;
+    OCStackLock();
+    // The stack owns the received bytes until the callback returns.
+    for (OCDeliveredResponse *delivered = g_deliveredResponse; delivered;
+         delivered = delivered->previous)
+    {
+        if (delivered->response == response)
+        {
+            *view = delivered->view;
+            result = OC_STACK_OK;
+            break;
+        }
+    }
+    OCStackUnlock();
+
+    if (OC_STACK_OK != result)
+    {
+        OIC_LOG(ERROR, TAG, "Response is not being passed to its callback");
+    }
+    return result;
+}
+
+OCStackResult OC_CALL OCSetResponsePayloadViewOnly(OCDoHandle handle, bool viewOnly)
+{
+    VERIFY_NON_NULL(handle, ERROR, OC_STACK_INVALID_PARAM);
+
+    OCStackResult result = OC_STACK_NO_RESOURCE;
+    OCStackLock();
+    ClientCB *cbNode = GetClientCBUsingHandle(handle);
+    if (cbNode)
+    {
+        cbNode->payloadViewOnly = viewOnly;
+        result = OC_STACK_OK;
+    }
+    OCStackUnlock();
+    return result;
+}
+
 //-----------------------------------------------------------------------------
 // Private internal function definitions
 //-----------------------------------------------------------------------------
@@ -5094,6 +5531,7 @@ OCStackResult OCChangeResourceProperty(OCResourceProperty * inputProperty,
     {
         *inputProperty = (OCResourceProperty) (*inputProperty | resourceProperties);
     }
+    OCDiscoveryCacheInvalidate();
     return OC_STACK_OK;
 }
 #endif
@@ -5104,6 +5542,7 @@ OCStackResult initResources(void)
 
     headResource = NULL;
     tailResource = NULL;
+    OCResourceIndexClear();
     // Init Virtual Resources
 #ifdef WITH_PRESENCE
     presenceResource.presenceTTL = OC_DEFAULT_PRESENCE_TTL_SECONDS;
@@ -5261,17 +5700,7 @@ void insertResource(OCResource *resource)
 
 OCResource *findResource(OCResource *resource)
 {
-    OCResource *pointer = headResource;
-
-    while (pointer)
-    {
-        if (pointer == resource)
-        {
-            return resource;
-        }
-        pointer = pointer->next;
-    }
-    return NULL;
+    return OCResourceIndexContains(resource) ? resource : NULL;
 }
 
 void deleteAllResources(void)
@@ -5307,6 +5736,8 @@ void deleteAllResources(void)
     deleteResource((OCResource *) presenceResource.handle);
     memset(&presenceResource, 0, sizeof(presenceResource));
 #endif // WITH_PRESENCE
+
+    OCResourceIndexClear();
 }
 
 OCStackResult deleteResource(OCResource *resource)
@@ -5364,6 +5795,8 @@ OCStackResult deleteResource(OCResource *resource)
                 prev->next = temp->next;
             }
 
+            OCResourceIndexRemove(temp);
+            OCDiscoveryCacheInvalidate();
             deleteResourceElements(temp);
             OICFree(temp);
             temp = NULL;
@@ -5872,6 +6305,7 @@ OCStackResult OC_CALL OCBindResourceInsToResource(OCResourceHandle handle, int64
     }
 
     resource->ins = ins;
+    OCDiscoveryCacheInvalidate();
 
     return OC_STACK_OK;
 }
@@ -6022,18 +6456,12 @@ OCResourceHandle OC_CALL OCGetResourceHandleAtUri(const char *uri)
         return NULL;
     }
 
-    OCResource *pointer = headResource;
-
-    while (pointer)
+    OCResource *pointer = OCResourceIndexFindByUri(uri);
+    if (pointer)
     {
-        if (strncmp(uri, pointer->uri, MAX_URI_LENGTH) == 0)
-        {
-            OIC_LOG_V(DEBUG, TAG, "Found Resource %s", uri);
-            return pointer;
-        }
-        pointer = pointer->next;
+        OIC_LOG_V(DEBUG, TAG, "Found Resource %s", uri);
     }
-    return NULL;
+    return pointer;
 }
 
 static OCStackResult SetHeaderOption(CAHeaderOption_t *caHdrOpt, size_t numOptions,
@@ -6148,6 +6576,9 @@ void OCDefaultAdapterStateChangedHandler(CATransportAdapter_t adapter, bool enab
 
     OC_UNUSED(adapter);
     OC_UNUSED(enabled);
+
+    // The endpoints listed in discovery responses depend on the network interfaces.
+    OCDiscoveryCacheInvalidate();
 }
 
 void OCDefaultConnectionStateChangedHandler(const CAEndpoint_t *info, bool isConnected)
@@ -53,23 +53,31 @@ static const char *gRDPath = "RD.db";
 
 static sqlite3 *gRDDB = NULL;
 
-/* Column indices of RD_DEVICE_LINK_LIST table */
-static const uint8_t ins_index = 0;
+/*
+ * Columns of the links returned to discovery. The resource types, interfaces and endpoints
+ * of each link are aggregated into a single value so that one query returns the whole link.
+ * Endpoints are aggregated as "ep" RD_PAIR_SEPARATOR "pri".
+ */
+#define RD_VALUE_SEPARATOR '\x1f'
+#define RD_PAIR_SEPARATOR '\x1e'
+#define RD_LINK_COLUMNS \
+    "RD_DEVICE_LINK_LIST.ins, RD_DEVICE_LINK_LIST.href, RD_DEVICE_LINK_LIST.rel, " \
+    "RD_DEVICE_LINK_LIST.anchor, RD_DEVICE_LINK_LIST.bm, " \
+    "(SELECT group_concat(rt, char(31)) FROM RD_LINK_RT " \
+        "WHERE RD_LINK_RT.LINK_ID=RD_DEVICE_LINK_LIST.ins), " \
+    "(SELECT group_concat(if, char(31)) FROM RD_LINK_IF " \
+        "WHERE RD_LINK_IF.LINK_ID=RD_DEVICE_LINK_LIST.ins), " \
+    "(SELECT group_concat(ep || char(30) || pri, char(31)) FROM RD_LINK_EP " \
+        "WHERE RD_LINK_EP.LINK_ID=RD_DEVICE_LINK_LIST.ins)"
+
+/* Column indices of RD_LINK_COLUMNS */
 static const uint8_t href_index = 1;
 static const uint8_t rel_index = 2;
 static const uint8_t anchor_index = 3;
 static const uint8_t bm_index = 4;
-static const uint8_t d_index = 5;
-
-/* Column indices of RD_LINK_RT table */
-static const uint8_t rt_value_index = 0;
-
-/* Column indices of RD_LINK_IF table */
-static const uint8_t if_value_index = 0;
-
-/* Column indices of RD_LINK_EP table */
-static const uint8_t ep_value_index = 0;
-static const uint8_t pri_value_index = 1;
+static const uint8_t rt_index = 5;
+static const uint8_t if_index = 6;
+static const uint8_t ep_index = 7;
 
 #define VERIFY_SQLITE(arg) \
 if (SQLITE_OK != (arg)) \
@@ -134,7 +142,28 @@ exit:
     return result;
 }
 
-/* stmt is of form "SELECT * FROM RD_DEVICE_LINK_LIST ..." */
+/*
+ * Append the values of a column built with group_concat(value, char(RD_VALUE_SEPARATOR)).
+ * The buffer is modified.
+ */
+static OCStackResult appendStringLLValues(OCStringLL **type, unsigned char *values)
+{
+    OCStackResult result = OC_STACK_OK;
+    unsigned char *value = values;
+    while (value && (OC_STACK_OK == result))
+    {
+        unsigned char *next = (unsigned char *)strchr((char *)value, RD_VALUE_SEPARATOR);
+        if (next)
+        {
+            *next++ = '\0';
+        }
+        result = appendStringLL(type, value);
+        value = next;
+    }
+    return result;
+}
+
+/* stmt is of form "SELECT " RD_LINK_COLUMNS " FROM RD_DEVICE_LINK_LIST ..." */
 static OCStackResult ResourcePayloadCreate(sqlite3_stmt *stmt, OCDevAddr *devAddr,
         OCDiscoveryPayload *discPayload)
 {
@@ -147,22 +176,27 @@ static OCStackResult ResourcePayloadCreate(sqlite3_stmt *stmt, OCDevAddr *devAdd
     OCStackResult result;
     OCResourcePayload *resourcePayload = NULL;
     OCEndpointPayload *epPayload = NULL;
-    sqlite3_stmt *stmtRT = NULL;
-    sqlite3_stmt *stmtIF = NULL;
-    sqlite3_stmt *stmtEP = NULL;
-    sqlite3_stmt *stmtDI = NULL;
+    char *values = NULL;
+    CAEndpoint_t *networkInfo = NULL;
+    size_t infoSize = 0;
+    if (devAddr)
+    {
+        CAResult_t caResult = CAGetNetworkInformation(&networkInfo, &infoSize);
+        if (CA_STATUS_FAILED == caResult)
+        {
+            OIC_LOG(WARNING, TAG, "CAGetNetworkInformation has error on parsing network infomation");
+        }
+    }
     while (SQLITE_ROW == res)
     {
         resourcePayload = (OCResourcePayload *)OICCalloc(1, sizeof(OCResourcePayload));
         VERIFY_NON_NULL(resourcePayload);
 
-        sqlite3_int64 id = sqlite3_column_int64(stmt, ins_index);
         const unsigned char *uri = sqlite3_column_text(stmt, href_index);
         const unsigned char *rel = sqlite3_column_text(stmt, rel_index);
         const unsigned char *anchor = sqlite3_column_text(stmt, anchor_index);
         sqlite3_int64 bitmap = sqlite3_column_int64(stmt, bm_index);
-        sqlite3_int64 deviceId = sqlite3_column_int64(stmt, d_index);
-        OIC_LOG_V(DEBUG, TAG, " %s %" PRId64, uri, (int64_t) deviceId);
+        OIC_LOG_V(DEBUG, TAG, " %s", uri);
 
         resourcePayload->uri = OICStrdup((char *)uri);
         VERIFY_NON_NULL(resourcePayload->uri)
@@ -177,66 +211,64 @@ static OCStackResult ResourcePayloadCreate(sqlite3_stmt *stmt, OCDevAddr *devAdd
             VERIFY_NON_NULL(resourcePayload->anchor);
         }
 
-        const char rt[] = "SELECT rt FROM RD_LINK_RT WHERE LINK_ID=@id";
-        int rtSize = (int)sizeof(rt);
-        VERIFY_SQLITE(sqlite3_prepare_v2(gRDDB, rt, rtSize, &stmtRT, NULL));
-        VERIFY_SQLITE(sqlite3_bind_int64(stmtRT, sqlite3_bind_parameter_index(stmtRT, "@id"), id));
-        while (SQLITE_ROW == sqlite3_step(stmtRT))
+        const unsigned char *rts = sqlite3_column_text(stmt, rt_index);
+        if (rts)
         {
-            const unsigned char *tempRt = sqlite3_column_text(stmtRT, rt_value_index);
-            result = appendStringLL(&resourcePayload->types, tempRt);
+            values = OICStrdup((const char *)rts);
+            VERIFY_NON_NULL(values);
+            result = appendStringLLValues(&resourcePayload->types, (unsigned char *)values);
             if (OC_STACK_OK != result)
             {
                 goto exit;
             }
+            OICFree(values);
+            values = NULL;
         }
-        VERIFY_SQLITE(sqlite3_finalize(stmtRT));
-        stmtRT = NULL;
-
-        const char itf[] = "SELECT if FROM RD_LINK_IF WHERE LINK_ID=@id";
-        int itfSize = (int)sizeof(itf);
-        VERIFY_SQLITE(sqlite3_prepare_v2(gRDDB, itf, itfSize, &stmtIF, NULL));
-        VERIFY_SQLITE(sqlite3_bind_int64(stmtIF, sqlite3_bind_parameter_index(stmtIF, "@id"), id));
-        while (SQLITE_ROW == sqlite3_step(stmtIF))
+
+        const unsigned char *itfs = sqlite3_column_text(stmt, if_index);
+        if (itfs)
         {
-            const unsigned char *tempItf = sqlite3_column_text(stmtIF, if_value_index);
-            result = appendStringLL(&resourcePayload->interfaces, tempItf);
+            values = OICStrdup((const char *)itfs);
+            VERIFY_NON_NULL(values);
+            result = appendStringLLValues(&resourcePayload->interfaces, (unsigned char *)values);
             if (OC_STACK_OK != result)
             {
                 goto exit;
             }
+            OICFree(values);
+            values = NULL;
         }
-        VERIFY_SQLITE(sqlite3_finalize(stmtIF));
-        stmtIF = NULL;
 
         resourcePayload->bitmap = (uint8_t)(bitmap & (OC_OBSERVABLE | OC_DISCOVERABLE));
 
-        CAEndpoint_t *networkInfo = NULL;
-        size_t infoSize = 0;
-        if (devAddr)
+        const unsigned char *eps = sqlite3_column_text(stmt, ep_index);
+        if (eps)
         {
-            CAResult_t caResult = CAGetNetworkInformation(&networkInfo, &infoSize);
-            if (CA_STATUS_FAILED == caResult)
-            {
-                OIC_LOG(WARNING, TAG, "CAGetNetworkInformation has error on parsing network infomation");
-            }
+            values = OICStrdup((const char *)eps);
+            VERIFY_NON_NULL(values);
         }
-        const char ep[] = "SELECT ep,pri FROM RD_LINK_EP WHERE LINK_ID=@id";
-        int epSize = (int)sizeof(ep);
-        VERIFY_SQLITE(sqlite3_prepare_v2(gRDDB, ep, epSize, &stmtEP, NULL));
-        VERIFY_SQLITE(sqlite3_bind_int64(stmtEP, sqlite3_bind_parameter_index(stmtEP, "@id"), id));
-        while (SQLITE_ROW == sqlite3_step(stmtEP))
+        char *tempEp = values;
+        while (tempEp)
         {
+            char *next = strchr(tempEp, RD_VALUE_SEPARATOR);
+            if (next)
+            {
+                *next++ = '\0';
+            }
+            char *tempPri = strchr(tempEp, RD_PAIR_SEPARATOR);
+            if (tempPri)
+            {
+                *tempPri++ = '\0';
+            }
+
             epPayload = (OCEndpointPayload *)OICCalloc(1, sizeof(OCEndpointPayload));
             VERIFY_NON_NULL(epPayload);
-            const unsigned char *tempEp = sqlite3_column_text(stmtEP, ep_value_index);
-            result = OCParseEndpointString((const char *)tempEp, epPayload);
+            result = OCParseEndpointString(tempEp, epPayload);
             if (OC_STACK_OK != result)
             {
                 goto exit;
             }
-            sqlite3_int64 pri = sqlite3_column_int64(stmtEP, pri_value_index);
-            epPayload->pri = (uint16_t)pri;
+            epPayload->pri = tempPri ? (uint16_t)strtol(tempPri, NULL, 10) : 0;
             bool includeEp = true;
             if (devAddr)
             {
@@ -269,31 +301,10 @@ static OCStackResult ResourcePayloadCreate(sqlite3_stmt *stmt, OCDevAddr *devAdd
                 OICFree(epPayload);
             }
             epPayload = NULL;
+            tempEp = next;
         }
-        VERIFY_SQLITE(sqlite3_finalize(stmtEP));
-        stmtEP = NULL;
-        if (networkInfo)
-        {
-            OICFree(networkInfo);
-        }
-
-        const char di[] = "SELECT di FROM RD_DEVICE_LIST "
-            "INNER JOIN RD_DEVICE_LINK_LIST ON RD_DEVICE_LINK_LIST.DEVICE_ID = RD_DEVICE_LIST.ID "
-            "WHERE RD_DEVICE_LINK_LIST.DEVICE_ID=@deviceId";
-        int diSize = (int)sizeof(di);
-        const uint8_t di_index = 0;
-        VERIFY_SQLITE(sqlite3_prepare_v2(gRDDB, di, diSize, &stmtDI, NULL));
-        VERIFY_SQLITE(sqlite3_bind_int64(stmtDI, sqlite3_bind_parameter_index(stmtDI, "@deviceId"), deviceId));
-        res = sqlite3_step(stmtDI);
-        if (SQLITE_ROW == res || SQLITE_DONE == res)
-        {
-            const unsigned char *tempDi = sqlite3_column_text(stmtDI, di_index);
-            OIC_LOG_V(DEBUG, TAG, " %s", tempDi);
-            discPayload->sid = OICStrdup((char *)tempDi);
-            VERIFY_NON_NULL(discPayload->sid);
-        }
-        VERIFY_SQLITE(sqlite3_finalize(stmtDI));
-        stmtDI = NULL;
+        OICFree(values);
+        values = NULL;
 
         OCDiscoveryPayloadAddNewResource(discPayload, resourcePayload);
         resourcePayload = NULL;
@@ -302,10 +313,8 @@ static OCStackResult ResourcePayloadCreate(sqlite3_stmt *stmt, OCDevAddr *devAdd
     result = OC_STACK_OK;
 
 exit:
-    sqlite3_finalize(stmtDI);
-    sqlite3_finalize(stmtEP);
-    sqlite3_finalize(stmtIF);
-    sqlite3_finalize(stmtRT);
+    OICFree(networkInfo);
+    OICFree(values);
     OICFree(epPayload);
     OCDiscoveryResourceDestroy(resourcePayload);
     return result;
@@ -341,7 +350,7 @@ static OCStackResult CheckResources(const char *interfaceType, const char *resou
         if (!interfaceType || 0 == strcmp(interfaceType, OC_RSRVD_INTERFACE_LL) ||
                 0 == strcmp(interfaceType, OC_RSRVD_INTERFACE_DEFAULT))
         {
-            const char input[] = "SELECT * FROM RD_DEVICE_LINK_LIST "
+            const char input[] = "SELECT " RD_LINK_COLUMNS " FROM RD_DEVICE_LINK_LIST "
                                 "INNER JOIN RD_DEVICE_LIST ON RD_DEVICE_LINK_LIST.DEVICE_ID=RD_DEVICE_LIST.ID "
                                 "INNER JOIN RD_LINK_RT ON RD_DEVICE_LINK_LIST.INS=RD_LINK_RT.LINK_ID "
                                 "WHERE RD_DEVICE_LIST.di LIKE @di AND RD_LINK_RT.rt LIKE @resourceType";
@@ -354,7 +363,7 @@ static OCStackResult CheckResources(const char *interfaceType, const char *resou
         }
         else
         {
-            const char input[] = "SELECT * FROM RD_DEVICE_LINK_LIST "
+            const char input[] = "SELECT " RD_LINK_COLUMNS " FROM RD_DEVICE_LINK_LIST "
                                 "INNER JOIN RD_DEVICE_LIST ON RD_DEVICE_LINK_LIST.DEVICE_ID=RD_DEVICE_LIST.ID "
                                 "INNER JOIN RD_LINK_RT ON RD_DEVICE_LINK_LIST.INS=RD_LINK_RT.LINK_ID "
                                 "INNER JOIN RD_LINK_IF ON RD_DEVICE_LINK_LIST.INS=RD_LINK_IF.LINK_ID "
@@ -377,7 +386,7 @@ static OCStackResult CheckResources(const char *interfaceType, const char *resou
         if (0 == strcmp(interfaceType, OC_RSRVD_INTERFACE_LL) ||
                 0 == strcmp(interfaceType, OC_RSRVD_INTERFACE_DEFAULT))
         {
-            const char input[] = "SELECT * FROM RD_DEVICE_LINK_LIST "
+            const char input[] = "SELECT " RD_LINK_COLUMNS " FROM RD_DEVICE_LINK_LIST "
                                 "INNER JOIN RD_DEVICE_LIST ON RD_DEVICE_LINK_LIST.DEVICE_ID=RD_DEVICE_LIST.ID "
                                 "WHERE RD_DEVICE_LIST.di LIKE @di";
             int inputSize = (int)sizeof(input);
@@ -387,7 +396,7 @@ static OCStackResult CheckResources(const char *interfaceType, const char *resou
         }
         else
         {
-            const char input[] = "SELECT * FROM RD_DEVICE_LINK_LIST "
+            const char input[] = "SELECT " RD_LINK_COLUMNS " FROM RD_DEVICE_LINK_LIST "
                                 "INNER JOIN RD_DEVICE_LIST ON RD_DEVICE_LINK_LIST.DEVICE_ID=RD_DEVICE_LIST.ID "
                                 "INNER JOIN RD_LINK_IF ON RD_DEVICE_LINK_LIST.INS=RD_LINK_IF.LINK_ID "
                                 "WHERE RD_DEVICE_LIST.di LIKE @di AND RD_LINK_IF.if LIKE @interfaceType";
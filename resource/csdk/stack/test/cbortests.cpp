@@ -27,6 +27,8 @@ extern "C"
     #include "ocpayloadcbor.h"
     #include "experimental/logger.h"
     #include "oic_malloc.h"
+    #include "oic_string.h"
+    #include "oic_time.h"
 }
 
 #include <gtest/gtest.h>
@@ -46,6 +48,7 @@ extern "C"
 #include <string.h>
 
 #include <iostream>
+#include <string>
 #include <stdint.h>
 
 #include "gtest_helper.h"
@@ -432,3 +435,329 @@ TEST(CborEmptyArrayTest, EmptyArrayArraySetGetTest)
     OCRepPayloadDestroy(payload_in);
 }
 
+
+static OCRepPayload *CreateRepPayloadOfSize(size_t size)
+{
+    OCRepPayload *payload = OCRepPayloadCreate();
+    if (!payload)
+    {
+        return NULL;
+    }
+    OCRepPayloadSetUri(payload, "/a/bench");
+
+    char name[16];
+    std::string value(48, 'v');
+    for (size_t i = 0; i * 64 < size; i++)
+    {
+        snprintf(name, sizeof(name), "p%zu", i);
+        OCRepPayloadSetPropString(payload, name, value.c_str());
+    }
+    return payload;
+}
+
+static OCDiscoveryPayload *CreateDiscoveryPayloadOfSize(size_t size)
+{
+    OCDiscoveryPayload *payload = OCDiscoveryPayloadCreate();
+    if (!payload)
+    {
+        return NULL;
+    }
+    payload->sid = OICStrdup("0685B960-736F-46F7-BEC0-9E6CBD61ADC1");
+
+    char uri[32];
+    for (size_t i = 0; i * 96 < size; i++)
+    {
+        OCResourcePayload *resource = (OCResourcePayload *)OICCalloc(1, sizeof(OCResourcePayload));
+        if (!resource)
+        {
+            break;
+        }
+        snprintf(uri, sizeof(uri), "/a/bench/%zu", i);
+        resource->uri = OICStrdup(uri);
+        OCResourcePayloadAddStringLL(&resource->types, "core.bench");
+        OCResourcePayloadAddStringLL(&resource->interfaces, "oic.if.baseline");
+        resource->bitmap = OC_DISCOVERABLE | OC_OBSERVABLE;
+        OCDiscoveryPayloadAddNewResource(payload, resource);
+    }
+    return payload;
+}
+
+TEST(CborConvertBenchmark, ConvertPayloadSizes)
+{
+    const size_t sizes[] = { 100, 1024, 4096, 16384, 65536 };
+    const int rounds = 100;
+
+    for (size_t size : sizes)
+    {
+        OCPayload *payloads[] = {
+            (OCPayload *) CreateRepPayloadOfSize(size),
+            (OCPayload *) CreateDiscoveryPayloadOfSize(size)
+        };
+        for (OCPayload *payload : payloads)
+        {
+            ASSERT_TRUE(payload != NULL);
+
+            uint8_t *cbor = NULL;
+            size_t cborSize = 0;
+            uint64_t start = OICGetCurrentTime(TIME_IN_US);
+            for (int round = 0; round < rounds; round++)
+            {
+                OICFree(cbor);
+                cbor = NULL;
+                ASSERT_EQ(OC_STACK_OK, OCConvertPayload(payload, OC_FORMAT_CBOR, &cbor,
+                                                        &cborSize));
+            }
+            uint64_t elapsed = OICGetCurrentTime(TIME_IN_US) - start;
+
+            std::cout << ((PAYLOAD_TYPE_DISCOVERY == payload->type) ? "Discovery" : "Rep")
+                      << " payload of " << cborSize << " bytes: "
+                      << (double) elapsed / rounds << " us per conversion" << std::endl;
+
+            // The result must round trip whatever the size it was encoded to.
+            OCPayload *parsed = NULL;
+            EXPECT_EQ(OC_STACK_OK, OCParsePayload(&parsed, OC_FORMAT_CBOR, payload->type,
+                                                  cbor, cborSize));
+            OCPayloadDestroy(parsed);
+
+            OICFree(cbor);
+            OCPayloadDestroy(payload);
+        }
+    }
+}
+
+static void CheckManyProperties(OCRepPayload *payload)
+{
+    const int64_t count = 200;
+    char name[16];
+
+    for (int64_t i = 0; i < count; i++)
+    {
+        snprintf(name, sizeof(name), "p%d", (int) i);
+        ASSERT_TRUE(OCRepPayloadSetPropInt(payload, name, i));
+    }
+    // Setting existing properties replaces them in place.
+    for (int64_t i = 0; i < count; i += 2)
+    {
+        snprintf(name, sizeof(name), "p%d", (int) i);
+        ASSERT_TRUE(OCRepPayloadSetPropString(payload, name, "even"));
+    }
+
+    OCRepPayload *child = OCRepPayloadCreateChild(payload);
+    ASSERT_TRUE(child != NULL);
+    EXPECT_TRUE(OCRepPayloadSetPropBool(child, "member", true));
+    EXPECT_TRUE(OCRepPayloadSetPropObjectAsOwner(payload, "child", child));
+
+    // Values keep the order they were first set in.
+    int64_t index = 0;
+    for (OCRepPayloadValue *value = payload->values; value && index < count; value = value->next)
+    {
+        snprintf(name, sizeof(name), "p%d", (int) index);
+        EXPECT_STREQ(name, value->name);
+        index++;
+    }
+    EXPECT_EQ(count, index);
+
+    OCRepPayload *clone = OCRepPayloadClone(payload);
+    ASSERT_TRUE(clone != NULL);
+    for (int64_t i = 0; i < count; i++)
+    {
+        snprintf(name, sizeof(name), "p%d", (int) i);
+        if (i % 2)
+        {
+            int64_t value = 0;
+            EXPECT_TRUE(OCRepPayloadGetPropInt(clone, name, &value));
+            EXPECT_EQ(i, value);
+        }
+        else
+        {
+            char *value = NULL;
+            EXPECT_TRUE(OCRepPayloadGetPropString(clone, name, &value));
+            EXPECT_STREQ("even", value);
+            OICFree(value);
+        }
+    }
+    EXPECT_TRUE(OCRepPayloadIsNull(clone, "missing"));
+
+    OCRepPayload *object = NULL;
+    EXPECT_TRUE(OCRepPayloadGetPropObject(clone, "child", &object));
+    bool member = false;
+    EXPECT_TRUE(OCRepPayloadGetPropBool(object, "member", &member));
+    EXPECT_TRUE(member);
+    OCRepPayloadDestroy(object);
+    OCRepPayloadDestroy(clone);
+}
+
+TEST(CborRepPayloadTest, IndexedProperties)
+{
+    OCRepPayload *payload = OCRepPayloadCreate();
+    ASSERT_TRUE(payload != NULL);
+    CheckManyProperties(payload);
+    OCRepPayloadDestroy(payload);
+}
+
+TEST(CborRepPayloadTest, ArenaProperties)
+{
+    OCRepPayload *payload = OCRepPayloadCreateWithArena();
+    ASSERT_TRUE(payload != NULL);
+    CheckManyProperties(payload);
+
+    uint8_t *cbor = NULL;
+    size_t cborSize = 0;
+    EXPECT_EQ(OC_STACK_OK, OCConvertPayload((OCPayload *) payload, OC_FORMAT_CBOR, &cbor,
+                                            &cborSize));
+    OCPayload *parsed = NULL;
+    EXPECT_EQ(OC_STACK_OK, OCParsePayload(&parsed, OC_FORMAT_CBOR, PAYLOAD_TYPE_REPRESENTATION,
+                                          cbor, cborSize));
+    int64_t value = 0;
+    EXPECT_TRUE(OCRepPayloadGetPropInt((OCRepPayload *) parsed, "p199", &value));
+    EXPECT_EQ(199, value);
+
+    OCPayloadDestroy(parsed);
+    OICFree(cbor);
+    OCRepPayloadDestroy(payload);
+}
+
+TEST(CborRepPayloadTest, ParseInArena)
+{
+    OCRepPayload *payload_in = OCRepPayloadCreate();
+    ASSERT_TRUE(payload_in != NULL);
+    EXPECT_TRUE(OCRepPayloadSetUri(payload_in, "/a/arena"));
+    EXPECT_TRUE(OCRepPayloadSetPropString(payload_in, "string", "value"));
+    EXPECT_TRUE(OCRepPayloadSetPropString(payload_in,
+        "a property name too long to be parsed into the local name buffer", "long"));
+    uint8_t bytes[] = { 0x1, 0x2, 0x3 };
+    OCByteString byteString = { bytes, sizeof(bytes) };
+    EXPECT_TRUE(OCRepPayloadSetPropByteString(payload_in, "bytes", byteString));
+    const char *strArray[] = { "one", "two" };
+    size_t dim[MAX_REP_ARRAY_DEPTH] = { 2, 0, 0 };
+    EXPECT_TRUE(OCRepPayloadSetStringArray(payload_in, "strings", strArray, dim));
+    OCRepPayload *obj = OCRepPayloadCreate();
+    ASSERT_TRUE(obj != NULL);
+    EXPECT_TRUE(OCRepPayloadSetPropInt(obj, "member", 7));
+    EXPECT_TRUE(OCRepPayloadSetPropObjectAsOwner(payload_in, "object", obj));
+
+    uint8_t *cbor = NULL;
+    size_t cborSize = 0;
+    ASSERT_EQ(OC_STACK_OK, OCConvertPayload((OCPayload *) payload_in, OC_FORMAT_CBOR, &cbor,
+                                            &cborSize));
+    OCRepPayloadDestroy(payload_in);
+
+    OCPayload *parsed = NULL;
+    ASSERT_EQ(OC_STACK_OK, OCParsePayloadInArena(&parsed, OC_FORMAT_CBOR,
+                                                 PAYLOAD_TYPE_REPRESENTATION, cbor, cborSize));
+    OICFree(cbor);
+    OCRepPayload *payload_out = (OCRepPayload *) parsed;
+    ASSERT_TRUE(OCRepPayloadGetArena(payload_out) != NULL);
+    EXPECT_STREQ("/a/arena", payload_out->uri);
+
+    char *str = NULL;
+    EXPECT_TRUE(OCRepPayloadGetPropString(payload_out, "string", &str));
+    EXPECT_STREQ("value", str);
+    OICFree(str);
+    EXPECT_TRUE(OCRepPayloadGetPropString(payload_out,
+        "a property name too long to be parsed into the local name buffer", &str));
+    EXPECT_STREQ("long", str);
+    OICFree(str);
+
+    // Values can be replaced, the arena copies are left to the arena.
+    EXPECT_TRUE(OCRepPayloadSetPropString(payload_out, "string", "replaced"));
+    EXPECT_TRUE(OCRepPayloadGetPropString(payload_out, "string", &str));
+    EXPECT_STREQ("replaced", str);
+    OICFree(str);
+
+    OCByteString byteStringOut = { NULL, 0 };
+    EXPECT_TRUE(OCRepPayloadGetPropByteString(payload_out, "bytes", &byteStringOut));
+    ASSERT_EQ(sizeof(bytes), byteStringOut.len);
+    EXPECT_EQ(0, memcmp(bytes, byteStringOut.bytes, byteStringOut.len));
+    OICFree(byteStringOut.bytes);
+
+    char **strArrayOut = NULL;
+    size_t dimOut[MAX_REP_ARRAY_DEPTH] = { 0 };
+    EXPECT_TRUE(OCRepPayloadGetStringArray(payload_out, "strings", &strArrayOut, dimOut));
+    ASSERT_EQ(2u, dimOut[0]);
+    EXPECT_STREQ("one", strArrayOut[0]);
+    EXPECT_STREQ("two", strArrayOut[1]);
+    for (size_t i = 0; i < dimOut[0]; ++i)
+    {
+        OICFree(strArrayOut[i]);
+    }
+    OICFree(strArrayOut);
+
+    OCRepPayload *objOut = NULL;
+    EXPECT_TRUE(OCRepPayloadGetPropObject(payload_out, "object", &objOut));
+    int64_t member = 0;
+    EXPECT_TRUE(OCRepPayloadGetPropInt(objOut, "member", &member));
+    EXPECT_EQ(7, member);
+    OCRepPayloadDestroy(objOut);
+
+    OCPayloadDestroy(parsed);
+}
+
+TEST(CborRepPayloadTest, CborView)
+{
+    OCRepPayload *payload_in = OCRepPayloadCreate();
+    ASSERT_TRUE(payload_in != NULL);
+    EXPECT_TRUE(OCRepPayloadSetPropInt(payload_in, "int", -300));
+    EXPECT_TRUE(OCRepPayloadSetPropDouble(payload_in, "double", 1.5));
+    EXPECT_TRUE(OCRepPayloadSetPropBool(payload_in, "bool", true));
+    EXPECT_TRUE(OCRepPayloadSetNull(payload_in, "null"));
+    std::string longString(300, 'x');
+    EXPECT_TRUE(OCRepPayloadSetPropString(payload_in, "string", longString.c_str()));
+    uint8_t bytes[] = { 0x1, 0x2, 0x3 };
+    OCByteString byteString = { bytes, sizeof(bytes) };
+    EXPECT_TRUE(OCRepPayloadSetPropByteString(payload_in, "bytes", byteString));
+    OCRepPayload *obj = OCRepPayloadCreate();
+    ASSERT_TRUE(obj != NULL);
+    EXPECT_TRUE(OCRepPayloadSetPropInt(obj, "member", 7));
+    EXPECT_TRUE(OCRepPayloadSetPropObjectAsOwner(payload_in, "object", obj));
+    EXPECT_TRUE(OCRepPayloadSetPropInt(payload_in, "last", 1));
+
+    uint8_t *cbor = NULL;
+    size_t cborSize = 0;
+    ASSERT_EQ(OC_STACK_OK, OCConvertPayload((OCPayload *) payload_in, OC_FORMAT_CBOR, &cbor,
+                                            &cborSize));
+    OCRepPayloadDestroy(payload_in);
+
+    OCCborView view = OCCborViewCreate(OC_FORMAT_JSON, cbor, cborSize);
+    EXPECT_TRUE(view.data == NULL);
+    EXPECT_FALSE(OCCborViewHasProp(&view, "int"));
+    view = OCCborViewCreate(OC_FORMAT_CBOR, cbor, cborSize);
+    EXPECT_TRUE(view.data == cbor);
+
+    int64_t i = 0;
+    EXPECT_TRUE(OCCborViewGetPropInt(&view, "int", &i));
+    EXPECT_EQ(-300, i);
+    double d = 0;
+    EXPECT_TRUE(OCCborViewGetPropDouble(&view, "double", &d));
+    EXPECT_EQ(1.5, d);
+    EXPECT_TRUE(OCCborViewGetPropDouble(&view, "int", &d));
+    EXPECT_EQ(-300, d);
+    bool b = false;
+    EXPECT_TRUE(OCCborViewGetPropBool(&view, "bool", &b));
+    EXPECT_TRUE(b);
+    EXPECT_TRUE(OCCborViewIsNull(&view, "null"));
+    EXPECT_FALSE(OCCborViewIsNull(&view, "int"));
+
+    const char *str = NULL;
+    size_t len = 0;
+    EXPECT_TRUE(OCCborViewGetPropString(&view, "string", &str, &len));
+    EXPECT_EQ(longString, std::string(str, len));
+    EXPECT_TRUE(str > (const char *) cbor && str < (const char *) cbor + cborSize);
+    const uint8_t *outBytes = NULL;
+    EXPECT_TRUE(OCCborViewGetPropByteString(&view, "bytes", &outBytes, &len));
+    ASSERT_EQ(sizeof(bytes), len);
+    EXPECT_EQ(0, memcmp(bytes, outBytes, len));
+
+    EXPECT_FALSE(OCCborViewGetPropInt(&view, "string", &i));
+    EXPECT_FALSE(OCCborViewHasProp(&view, "missing"));
+
+    OCCborView objView;
+    EXPECT_TRUE(OCCborViewGetPropObject(&view, "object", &objView));
+    EXPECT_TRUE(OCCborViewGetPropInt(&objView, "member", &i));
+    EXPECT_EQ(7, i);
+    EXPECT_FALSE(OCCborViewHasProp(&objView, "last"));
+    EXPECT_TRUE(OCCborViewGetPropInt(&view, "last", &i));
+    EXPECT_EQ(1, i);
+
+    OICFree(cbor);
+}
@@ -29,6 +29,8 @@ extern "C"
     #include "oic_string.h"
     #include "oic_time.h"
     #include "ocresourcehandler.h"
+    #include "ocobserve.h"
+    #include "ocdiscoverycache.h"
     #include "occollection.h"
     #include "mbedtls/ssl_ciphersuites.h"
     #include "octypes.h"
@@ -53,7 +55,10 @@ extern "C"
 #include <stdio.h>
 #include <string.h>
 
+#include <algorithm>
 #include <iostream>
+#include <string>
+#include <vector>
 #include <stdint.h>
 
 #include "gtest_helper.h"
@@ -299,6 +304,725 @@ TEST(StackStart, StackStartSuccessiveInits)
     EXPECT_EQ(0u, g_ocStackStartCount);
 }
 
+TEST(StackProcess, ProcessExUninitialized)
+{
+    itst::DeadmanTimer killSwitch(SHORT_TEST_TIMEOUT);
+    uint32_t handled = 1;
+    EXPECT_EQ(OC_STACK_ERROR, OCProcessEx(0, 0, &handled));
+    EXPECT_EQ(0u, handled);
+}
+
+TEST(StackProcess, ProcessExEmptyQueue)
+{
+    itst::DeadmanTimer killSwitch(SHORT_TEST_TIMEOUT);
+    EXPECT_EQ(OC_STACK_OK, OCInit("127.0.0.1", 5683, OC_CLIENT_SERVER));
+    uint32_t handled = 1;
+    EXPECT_EQ(OC_STACK_OK, OCProcessEx(0, 0, &handled));
+    EXPECT_EQ(0u, handled);
+    EXPECT_EQ(OC_STACK_OK, OCProcessEx(16, 10, NULL));
+    EXPECT_EQ(OC_STACK_OK, OCStop());
+}
+
+TEST(StackProcess, RequestDispatchThreads)
+{
+    itst::DeadmanTimer killSwitch(SHORT_TEST_TIMEOUT);
+    EXPECT_EQ(OC_STACK_OK, OCSetRequestDispatchThreads(2));
+    EXPECT_EQ(OC_STACK_OK, OCInit("127.0.0.1", 5683, OC_SERVER));
+    EXPECT_EQ(OC_STACK_ERROR, OCSetRequestDispatchThreads(0));
+
+    OCResourceHandle handle;
+    EXPECT_EQ(OC_STACK_OK, OCCreateResource(&handle,
+                                            "core.led",
+                                            "core.rw",
+                                            "/a/led",
+                                            0,
+                                            NULL,
+                                            OC_DISCOVERABLE|OC_OBSERVABLE));
+    EXPECT_EQ(OC_STACK_OK, OCProcess());
+    EXPECT_EQ(OC_STACK_OK, OCDeleteResource(handle));
+
+    EXPECT_EQ(OC_STACK_OK, OCStop());
+    EXPECT_EQ(OC_STACK_OK, OCSetRequestDispatchThreads(0));
+}
+
+#define DISPATCH_REQUEST_COUNT 5
+
+// Requests seen by the entity handlers of the dispatch tests.
+struct DispatchRecord
+{
+    std::mutex mutex;
+    std::condition_variable cond;
+    std::vector<int64_t> sequences[2];
+    std::vector<std::thread::id> threads;
+    bool blocked;
+    bool released;
+    size_t responses;
+    std::vector<OCStackResult> results;
+};
+
+static DispatchRecord s_dispatch;
+
+static OCEntityHandlerResult DispatchRequest(OCEntityHandlerFlag flag,
+        OCEntityHandlerRequest *request, void *ctx)
+{
+    OC_UNUSED(flag);
+    int64_t sequence = -1;
+    EXPECT_TRUE(OCRepPayloadGetPropInt((OCRepPayload *) request->payload, "seq", &sequence));
+    {
+        std::lock_guard<std::mutex> lock(s_dispatch.mutex);
+        s_dispatch.sequences[(intptr_t) ctx].push_back(sequence);
+        s_dispatch.threads.push_back(std::this_thread::get_id());
+    }
+
+    // The request is deleted once answered, while the worker still holds it.
+    OCEntityHandlerResponse response;
+    memset(&response, 0, sizeof(response));
+    response.requestHandle = request->requestHandle;
+    response.resourceHandle = request->resource;
+    response.ehResult = OC_EH_OK;
+    EXPECT_EQ(OC_STACK_OK, OCDoResponse(&response));
+    return OC_EH_OK;
+}
+
+static OCEntityHandlerResult DispatchBlockedRequest(OCEntityHandlerFlag flag,
+        OCEntityHandlerRequest *request, void *ctx)
+{
+    OC_UNUSED(flag);
+    OC_UNUSED(request);
+    OC_UNUSED(ctx);
+    std::unique_lock<std::mutex> lock(s_dispatch.mutex);
+    s_dispatch.blocked = true;
+    s_dispatch.cond.notify_all();
+    s_dispatch.cond.wait(lock, []{ return s_dispatch.released; });
+
+    // Not answered, the stack answers once the handler returned.
+    return OC_EH_ERROR;
+}
+
+static OCEntityHandlerResult DispatchUnexpectedRequest(OCEntityHandlerFlag flag,
+        OCEntityHandlerRequest *request, void *ctx)
+{
+    OC_UNUSED(flag);
+    OC_UNUSED(request);
+    OC_UNUSED(ctx);
+    ADD_FAILURE() << "Request of a deleted resource handled by its successor";
+    return OC_EH_ERROR;
+}
+
+static OCStackApplicationResult DispatchResponse(void *ctx, OCDoHandle handle,
+        OCClientResponse *response)
+{
+    OC_UNUSED(ctx);
+    OC_UNUSED(handle);
+    std::lock_guard<std::mutex> lock(s_dispatch.mutex);
+    s_dispatch.responses++;
+    s_dispatch.results.push_back(response->result);
+    return OC_STACK_DELETE_TRANSACTION;
+}
+
+static void ResetDispatchRecord()
+{
+    std::lock_guard<std::mutex> lock(s_dispatch.mutex);
+    s_dispatch.sequences[0].clear();
+    s_dispatch.sequences[1].clear();
+    s_dispatch.threads.clear();
+    s_dispatch.blocked = false;
+    s_dispatch.released = false;
+    s_dispatch.responses = 0;
+    s_dispatch.results.clear();
+}
+
+static void PostSequence(const char *uri, int64_t sequence)
+{
+    OCRepPayload *payload = OCRepPayloadCreate();
+    ASSERT_TRUE(payload != NULL);
+    EXPECT_TRUE(OCRepPayloadSetPropInt(payload, "seq", sequence));
+    OCCallbackData cbData;
+    cbData.cb = DispatchResponse;
+    cbData.context = NULL;
+    cbData.cd = NULL;
+    EXPECT_EQ(OC_STACK_OK, OCDoRequest(NULL, OC_REST_POST, uri, NULL, (OCPayload *) payload,
+            CT_DEFAULT, OC_HIGH_QOS, &cbData, NULL, 0));
+    OCRepPayloadDestroy(payload);
+}
+
+// Call OCProcess() until the condition holds or the timeout expired.
+template <typename Condition>
+static bool ProcessUntil(Condition condition, long timeoutMs)
+{
+    uint64_t startTime = OICGetCurrentTime(TIME_IN_MS);
+    while (true)
+    {
+        {
+            std::lock_guard<std::mutex> lock(s_dispatch.mutex);
+            if (condition())
+            {
+                return true;
+            }
+        }
+        if ((long) (OICGetCurrentTime(TIME_IN_MS) - startTime) > timeoutMs)
+        {
+            return false;
+        }
+        OCProcess();
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+}
+
+TEST(StackProcess, RequestDispatchEndToEnd)
+{
+    itst::DeadmanTimer killSwitch(SHORT_TEST_TIMEOUT);
+    ResetDispatchRecord();
+    EXPECT_EQ(OC_STACK_OK, OCSetRequestDispatchThreads(2));
+    EXPECT_EQ(OC_STACK_OK, OCInit("127.0.0.1", 5683, OC_CLIENT_SERVER));
+
+    OCResourceHandle light;
+    OCResourceHandle fan;
+    EXPECT_EQ(OC_STACK_OK, OCCreateResource(&light, "core.light", "oic.if.baseline", "/a/light",
+            DispatchRequest, (void *) 0, OC_DISCOVERABLE));
+    EXPECT_EQ(OC_STACK_OK, OCCreateResource(&fan, "core.fan", "oic.if.baseline", "/a/fan",
+            DispatchRequest, (void *) 1, OC_DISCOVERABLE));
+
+    for (int64_t i = 0; i < DISPATCH_REQUEST_COUNT; i++)
+    {
+        PostSequence("127.0.0.1:5683/a/light", i);
+        PostSequence("127.0.0.1:5683/a/fan", i);
+    }
+    EXPECT_TRUE(ProcessUntil([]{ return 2 * DISPATCH_REQUEST_COUNT == s_dispatch.responses; },
+            3000));
+
+    {
+        std::lock_guard<std::mutex> lock(s_dispatch.mutex);
+        for (size_t r = 0; r < 2; r++)
+        {
+            ASSERT_EQ((size_t) DISPATCH_REQUEST_COUNT, s_dispatch.sequences[r].size());
+            for (int64_t i = 0; i < DISPATCH_REQUEST_COUNT; i++)
+            {
+                EXPECT_EQ(i, s_dispatch.sequences[r][i]);
+            }
+        }
+        for (size_t i = 0; i < s_dispatch.threads.size(); i++)
+        {
+            EXPECT_NE(std::this_thread::get_id(), s_dispatch.threads[i]);
+        }
+        for (size_t i = 0; i < s_dispatch.results.size(); i++)
+        {
+            EXPECT_EQ(OC_STACK_RESOURCE_CHANGED, s_dispatch.results[i]);
+        }
+    }
+
+    EXPECT_EQ(OC_STACK_OK, OCStop());
+    EXPECT_EQ(OC_STACK_OK, OCSetRequestDispatchThreads(0));
+}
+
+TEST(StackProcess, RequestDispatchDeletedResource)
+{
+    itst::DeadmanTimer killSwitch(SHORT_TEST_TIMEOUT);
+    ResetDispatchRecord();
+
+    // A single worker, so the request to /a/fan waits behind the one to /a/light.
+    EXPECT_EQ(OC_STACK_OK, OCSetRequestDispatchThreads(1));
+    EXPECT_EQ(OC_STACK_OK, OCInit("127.0.0.1", 5683, OC_CLIENT_SERVER));
+
+    OCResourceHandle light;
+    OCResourceHandle fan;
+    EXPECT_EQ(OC_STACK_OK, OCCreateResource(&light, "core.light", "oic.if.baseline", "/a/light",
+            DispatchBlockedRequest, NULL, OC_DISCOVERABLE));
+    EXPECT_EQ(OC_STACK_OK, OCCreateResource(&fan, "core.fan", "oic.if.baseline", "/a/fan",
+            DispatchUnexpectedRequest, NULL, OC_DISCOVERABLE));
+
+    PostSequence("127.0.0.1:5683/a/light", 0);
+    EXPECT_TRUE(ProcessUntil([]{ return s_dispatch.blocked; }, 2000));
+    PostSequence("127.0.0.1:5683/a/fan", 1);
+
+    // Let the request to /a/fan reach the queue of the worker.
+    ProcessUntil([]{ return false; }, 300);
+
+    // Delete the resource, and likely reuse its memory, while its request is queued.
+    EXPECT_EQ(OC_STACK_OK, OCDeleteResource(fan));
+    EXPECT_EQ(OC_STACK_OK, OCCreateResource(&fan, "core.fan", "oic.if.baseline", "/a/fan",
+            DispatchUnexpectedRequest, NULL, OC_DISCOVERABLE));
+    {
+        std::lock_guard<std::mutex> lock(s_dispatch.mutex);
+        s_dispatch.released = true;
+        s_dispatch.cond.notify_all();
+    }
+
+    EXPECT_TRUE(ProcessUntil([]{ return 2 == s_dispatch.responses; }, 3000));
+    {
+        std::lock_guard<std::mutex> lock(s_dispatch.mutex);
+        ASSERT_EQ(2u, s_dispatch.results.size());
+        EXPECT_NE(OC_STACK_RESOURCE_CHANGED, s_dispatch.results[0]);
+        EXPECT_EQ(OC_STACK_NO_RESOURCE, s_dispatch.results[1]);
+    }
+
+    EXPECT_EQ(OC_STACK_OK, OCStop());
+    EXPECT_EQ(OC_STACK_OK, OCSetRequestDispatchThreads(0));
+}
+
+// Handle what is pending, e.g. the network events queued by OCInit().
+static void ProcessPending()
+{
+    for (int i = 0; i < 10; i++)
+    {
+        EXPECT_EQ(OC_STACK_OK, OCProcess());
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+}
+
+TEST(StackProcess, WaitForProcessTimesOut)
+{
+    itst::DeadmanTimer killSwitch(SHORT_TEST_TIMEOUT);
+    EXPECT_EQ(OC_STACK_OK, OCInit("127.0.0.1", 5683, OC_CLIENT_SERVER));
+    ProcessPending();
+
+    uint64_t startTime = OICGetCurrentTime(TIME_IN_MS);
+    OCStackResult result = OCWaitForProcess(200);
+    uint64_t elapsed = OICGetCurrentTime(TIME_IN_MS) - startTime;
+    if (OC_STACK_NOTIMPL != result)
+    {
+        EXPECT_EQ(OC_STACK_OK, result);
+        EXPECT_LE(150u, elapsed);
+        EXPECT_GT(1000u, elapsed);
+    }
+
+    EXPECT_EQ(OC_STACK_OK, OCStop());
+}
+
+TEST(StackProcess, WaitForProcessWakesOnEvent)
+{
+    itst::DeadmanTimer killSwitch(SHORT_TEST_TIMEOUT);
+    ResetDispatchRecord();
+    EXPECT_EQ(OC_STACK_OK, OCInit("127.0.0.1", 5683, OC_CLIENT_SERVER));
+    ProcessPending();
+    if (OC_STACK_NOTIMPL == OCWaitForProcess(0))
+    {
+        // The stack handles received messages on its own thread.
+        EXPECT_EQ(OC_STACK_OK, OCStop());
+        return;
+    }
+
+    // Woken up from another thread.
+    uint64_t elapsed = 0;
+    std::thread waiter([&elapsed]
+    {
+        uint64_t startTime = OICGetCurrentTime(TIME_IN_MS);
+        EXPECT_EQ(OC_STACK_OK, OCWaitForProcess(3000));
+        elapsed = OICGetCurrentTime(TIME_IN_MS) - startTime;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_EQ(OC_STACK_OK, OCWakeUpProcess());
+    waiter.join();
+    EXPECT_GT(500u, elapsed);
+
+    // Woken up by the request and its response, the wait is otherwise limited to one
+    // second while the client callback may time out.
+    OCResourceHandle light;
+    EXPECT_EQ(OC_STACK_OK, OCCreateResource(&light, "core.light", "oic.if.baseline", "/a/light",
+            DispatchRequest, (void *) 0, OC_DISCOVERABLE));
+    uint64_t startTime = OICGetCurrentTime(TIME_IN_MS);
+    PostSequence("127.0.0.1:5683/a/light", 0);
+    while (0 == s_dispatch.responses &&
+           (OICGetCurrentTime(TIME_IN_MS) - startTime) < 3000)
+    {
+        EXPECT_EQ(OC_STACK_OK, OCWaitForProcess(3000));
+        EXPECT_EQ(OC_STACK_OK, OCProcess());
+    }
+    EXPECT_EQ(1u, s_dispatch.responses);
+    EXPECT_GT(500u, OICGetCurrentTime(TIME_IN_MS) - startTime);
+
+    EXPECT_EQ(OC_STACK_OK, OCStop());
+}
+
+#define OBSERVER_COUNT 4
+
+// Requests and notifications of the observe tests. Without dispatch threads the entity
+// handler and the client callbacks run on the OCProcess() thread.
+struct ObserveRecord
+{
+    size_t requests;
+    std::vector<OCStackResult> results[OBSERVER_COUNT];
+    std::vector<uint32_t> sequences[OBSERVER_COUNT];
+};
+
+static ObserveRecord s_observe;
+
+static OCEntityHandlerResult ObserveRequest(OCEntityHandlerFlag flag,
+        OCEntityHandlerRequest *request, void *ctx)
+{
+    OC_UNUSED(flag);
+    OC_UNUSED(ctx);
+    s_observe.requests++;
+
+    OCRepPayload *payload = OCRepPayloadCreate();
+    EXPECT_TRUE(OCRepPayloadSetPropInt(payload, "value", (int64_t) s_observe.requests));
+    OCEntityHandlerResponse response;
+    memset(&response, 0, sizeof(response));
+    response.requestHandle = request->requestHandle;
+    response.resourceHandle = request->resource;
+    response.ehResult = OC_EH_OK;
+    response.payload = (OCPayload *) payload;
+    EXPECT_EQ(OC_STACK_OK, OCDoResponse(&response));
+    OCRepPayloadDestroy(payload);
+    return OC_EH_OK;
+}
+
+static OCStackApplicationResult ObserveResponse(void *ctx, OCDoHandle handle,
+        OCClientResponse *response)
+{
+    OC_UNUSED(handle);
+    size_t observer = (size_t) (intptr_t) ctx;
+    s_observe.results[observer].push_back(response->result);
+    s_observe.sequences[observer].push_back(response->sequenceNumber);
+    return OC_STACK_KEEP_TRANSACTION;
+}
+
+static void ResetObserveRecord()
+{
+    s_observe.requests = 0;
+    for (size_t i = 0; i < OBSERVER_COUNT; i++)
+    {
+        s_observe.results[i].clear();
+        s_observe.sequences[i].clear();
+    }
+}
+
+static bool ObserversResponded(size_t begin, size_t end, size_t count)
+{
+    for (size_t i = begin; i < end; i++)
+    {
+        if (s_observe.results[i].size() < count)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Register the observers [begin, end), each with its own token.
+static void ObserveLight(size_t begin, size_t end)
+{
+    for (size_t i = begin; i < end; i++)
+    {
+        OCCallbackData cbData;
+        cbData.cb = ObserveResponse;
+        cbData.context = (void *) (intptr_t) i;
+        cbData.cd = NULL;
+        EXPECT_EQ(OC_STACK_OK, OCDoRequest(NULL, OC_REST_OBSERVE, "127.0.0.1:5683/a/light",
+                NULL, NULL, CT_DEFAULT, OC_LOW_QOS, &cbData, NULL, 0));
+    }
+    EXPECT_TRUE(ProcessUntil([begin, end]{ return ObserversResponded(begin, end, 1); }, 3000));
+}
+
+// Check that each observer got the notification, newer than its registration.
+static void ExpectNotified()
+{
+    for (size_t i = 0; i < OBSERVER_COUNT; i++)
+    {
+        ASSERT_EQ(2u, s_observe.results[i].size()) << "observer " << i;
+        EXPECT_EQ(OC_STACK_OK, s_observe.results[i][1]) << "observer " << i;
+        EXPECT_LT(s_observe.sequences[i][0], s_observe.sequences[i][1]) << "observer " << i;
+    }
+}
+
+TEST(StackObserve, GroupedNotificationReachesEveryObserver)
+{
+    itst::DeadmanTimer killSwitch(SHORT_TEST_TIMEOUT);
+    ResetObserveRecord();
+    EXPECT_EQ(OC_STACK_OK, OCInit("127.0.0.1", 5683, OC_CLIENT_SERVER));
+
+    OCResourceHandle light;
+    EXPECT_EQ(OC_STACK_OK, OCCreateResource(&light, "core.light", "oic.if.baseline", "/a/light",
+            ObserveRequest, NULL, OC_DISCOVERABLE | OC_OBSERVABLE));
+    ObserveLight(0, OBSERVER_COUNT);
+
+    // The observers asked for the same representation, the entity handler runs once.
+    size_t requests = s_observe.requests;
+    EXPECT_EQ(OC_STACK_OK, OCNotifyAllObservers(light, OC_NA_QOS));
+    EXPECT_TRUE(ProcessUntil([]{ return ObserversResponded(0, OBSERVER_COUNT, 2); }, 3000));
+    EXPECT_EQ(requests + 1, s_observe.requests);
+    ExpectNotified();
+
+    EXPECT_EQ(OC_STACK_OK, OCStop());
+}
+
+TEST(StackObserve, FailedNotificationTargetDoesNotDropOthers)
+{
+    itst::DeadmanTimer killSwitch(SHORT_TEST_TIMEOUT);
+    ResetObserveRecord();
+    EXPECT_EQ(OC_STACK_OK, OCInit("127.0.0.1", 5683, OC_CLIENT_SERVER));
+
+    OCResourceHandle light;
+    EXPECT_EQ(OC_STACK_OK, OCCreateResource(&light, "core.light", "oic.if.baseline", "/a/light",
+            ObserveRequest, NULL, OC_DISCOVERABLE | OC_OBSERVABLE));
+    ObserveLight(0, OBSERVER_COUNT / 2);
+
+    // An observer between the others, with the same query and accept options, whose
+    // notification cannot be sent.
+    OCResource *resource = (OCResource *) light;
+    ResourceObserver *first = resource->observersHead;
+    ASSERT_TRUE(first != NULL);
+    OCObservationId obsId = 0;
+    EXPECT_EQ(OC_STACK_OK, GenerateObserverId(&obsId));
+    char token[] = { 'u', 'n', 'r', 'e', 'a', 'c', 'h', 'd' };
+    OCDevAddr unreachable = first->devAddr;
+    OICStrcpy(unreachable.addr, sizeof(unreachable.addr), "invalid");
+    EXPECT_EQ(OC_STACK_OK, AddObserver(first->resUri, first->query, obsId, token, sizeof(token),
+            resource, OC_LOW_QOS, first->acceptFormat, first->acceptVersion, &unreachable));
+
+    ObserveLight(OBSERVER_COUNT / 2, OBSERVER_COUNT);
+
+    size_t requests = s_observe.requests;
+    EXPECT_EQ(OC_STACK_OK, OCNotifyAllObservers(light, OC_NA_QOS));
+    EXPECT_TRUE(ProcessUntil([]{ return ObserversResponded(0, OBSERVER_COUNT, 2); }, 3000));
+    EXPECT_EQ(requests + 1, s_observe.requests);
+    ExpectNotified();
+
+    EXPECT_EQ(OC_STACK_OK, OCStop());
+}
+
+// Responses of the discovery cache tests, received on the OCProcess() thread.
+struct DiscoveryRecord
+{
+    size_t responses;
+    OCStackResult result;
+    std::string sid;
+    std::vector<std::string> uris;
+};
+
+static DiscoveryRecord s_discovery;
+
+static OCStackApplicationResult DiscoveryResponse(void *ctx, OCDoHandle handle,
+        OCClientResponse *response)
+{
+    OC_UNUSED(ctx);
+    OC_UNUSED(handle);
+    s_discovery.responses++;
+    s_discovery.result = response->result;
+    OCDiscoveryPayload *payload = (OCDiscoveryPayload *) response->payload;
+    if (payload && (PAYLOAD_TYPE_DISCOVERY == payload->base.type))
+    {
+        s_discovery.sid = payload->sid ? payload->sid : "";
+        for (OCResourcePayload *res = payload->resources; res; res = res->next)
+        {
+            s_discovery.uris.push_back(res->uri);
+        }
+    }
+    return OC_STACK_DELETE_TRANSACTION;
+}
+
+// Send a unicast discovery request with the query and wait for its response.
+static void Discover(const char *query)
+{
+    s_discovery.responses = 0;
+    s_discovery.result = OC_STACK_ERROR;
+    s_discovery.sid.clear();
+    s_discovery.uris.clear();
+
+    std::string uri = std::string("127.0.0.1:5683") + OC_RSRVD_WELL_KNOWN_URI + query;
+    OCCallbackData cbData;
+    cbData.cb = DiscoveryResponse;
+    cbData.context = NULL;
+    cbData.cd = NULL;
+    EXPECT_EQ(OC_STACK_OK, OCDoRequest(NULL, OC_REST_DISCOVER, uri.c_str(), NULL, NULL,
+            CT_DEFAULT, OC_LOW_QOS, &cbData, NULL, 0));
+    EXPECT_TRUE(ProcessUntil([]{ return 0 != s_discovery.responses; }, 3000));
+}
+
+static bool Discovered(const char *uri)
+{
+    return s_discovery.uris.end() !=
+           std::find(s_discovery.uris.begin(), s_discovery.uris.end(), uri);
+}
+
+TEST(StackDiscoveryCache, CachedResponseIsReused)
+{
+    itst::DeadmanTimer killSwitch(SHORT_TEST_TIMEOUT);
+    EXPECT_EQ(OC_STACK_OK, OCInit("127.0.0.1", 5683, OC_CLIENT_SERVER));
+
+    OCResourceHandle light;
+    EXPECT_EQ(OC_STACK_OK, OCCreateResource(&light, "core.light", "oic.if.baseline", "/a/light",
+            entityHandler, NULL, OC_DISCOVERABLE));
+    Discover("");
+    EXPECT_EQ(OC_STACK_OK, s_discovery.result);
+    EXPECT_TRUE(Discovered("/a/light"));
+
+    // Changed behind the back of the cache, the cached response is still sent.
+    OCResource *resource = (OCResource *) light;
+    resource->resourceProperties =
+        (OCResourceProperty) (resource->resourceProperties & ~OC_DISCOVERABLE);
+    Discover("");
+    EXPECT_EQ(OC_STACK_OK, s_discovery.result);
+    EXPECT_TRUE(Discovered("/a/light"));
+
+    // A request with another query is not answered from the cache.
+    Discover("?if=oic.if.ll");
+    EXPECT_FALSE(Discovered("/a/light"));
+
+    OCDiscoveryCacheInvalidate();
+    Discover("");
+    EXPECT_FALSE(Discovered("/a/light"));
+
+    EXPECT_EQ(OC_STACK_OK, OCStop());
+}
+
+TEST(StackDiscoveryCache, InvalidatedByResourceChanges)
+{
+    itst::DeadmanTimer killSwitch(SHORT_TEST_TIMEOUT);
+    EXPECT_EQ(OC_STACK_OK, OCInit("127.0.0.1", 5683, OC_CLIENT_SERVER));
+
+    OCResourceHandle light;
+    EXPECT_EQ(OC_STACK_OK, OCCreateResource(&light, "core.light", "oic.if.baseline", "/a/light",
+            entityHandler, NULL, OC_DISCOVERABLE));
+    Discover("");
+    EXPECT_TRUE(Discovered("/a/light"));
+    EXPECT_FALSE(Discovered("/a/fan"));
+
+    // Created
+    OCResourceHandle fan;
+    EXPECT_EQ(OC_STACK_OK, OCCreateResource(&fan, "core.fan", "oic.if.baseline", "/a/fan",
+            entityHandler, NULL, OC_DISCOVERABLE));
+    Discover("");
+    EXPECT_TRUE(Discovered("/a/light"));
+    EXPECT_TRUE(Discovered("/a/fan"));
+
+    // Type bound, the response cached without a match is dropped.
+    Discover("?rt=core.heater");
+    EXPECT_NE(OC_STACK_OK, s_discovery.result);
+    EXPECT_TRUE(s_discovery.uris.empty());
+    EXPECT_EQ(OC_STACK_OK, OCBindResourceTypeToResource(fan, "core.heater"));
+    Discover("?rt=core.heater");
+    EXPECT_EQ(OC_STACK_OK, s_discovery.result);
+    EXPECT_TRUE(Discovered("/a/fan"));
+
+    // Properties changed
+    EXPECT_EQ(OC_STACK_OK, OCClearResourceProperties(fan, OC_DISCOVERABLE));
+    Discover("");
+    EXPECT_TRUE(Discovered("/a/light"));
+    EXPECT_FALSE(Discovered("/a/fan"));
+
+    // Deleted
+    EXPECT_EQ(OC_STACK_OK, OCDeleteResource(light));
+    Discover("");
+    EXPECT_FALSE(Discovered("/a/light"));
+
+    EXPECT_EQ(OC_STACK_OK, OCStop());
+}
+
+TEST(StackDiscoveryCache, ResponseCarriesCurrentDeviceId)
+{
+    itst::DeadmanTimer killSwitch(SHORT_TEST_TIMEOUT);
+    EXPECT_EQ(OC_STACK_OK, OCInit("127.0.0.1", 5683, OC_CLIENT_SERVER));
+
+    OCResourceHandle light;
+    EXPECT_EQ(OC_STACK_OK, OCCreateResource(&light, "core.light", "oic.if.baseline", "/a/light",
+            entityHandler, NULL, OC_DISCOVERABLE));
+    Discover("");
+    std::string formerSid = OCGetServerInstanceIDString();
+    EXPECT_EQ(formerSid, s_discovery.sid);
+
+    // As when the device is onboarded, the id changes without invalidating the cache.
+    OCUUIdentity formerId;
+    ASSERT_EQ(OC_STACK_OK, OCGetDeviceId(&formerId));
+    OCUUIdentity deviceId;
+    memset(deviceId.id, 0x5a, sizeof(deviceId.id));
+    OCSetDeviceId(&deviceId);
+    std::string sid = OCGetServerInstanceIDString();
+    ASSERT_NE(formerSid, sid);
+
+    Discover("");
+    EXPECT_EQ(sid, s_discovery.sid);
+    EXPECT_TRUE(Discovered("/a/light"));
+
+    OCSetDeviceId(&formerId);
+    EXPECT_EQ(OC_STACK_OK, OCStop());
+}
+
+#ifdef RD_SERVER
+TEST(StackDiscoveryCache, NotUsedByResourceDirectory)
+{
+    itst::DeadmanTimer killSwitch(SHORT_TEST_TIMEOUT);
+    EXPECT_EQ(OC_STACK_OK, OCInit("127.0.0.1", 5683, OC_CLIENT_SERVER));
+
+    // Resources published to the directory change without invalidating the cache.
+    OCResourceHandle rd;
+    EXPECT_EQ(OC_STACK_OK, OCCreateResource(&rd, OC_RSRVD_RESOURCE_TYPE_RD,
+            OC_RSRVD_INTERFACE_DEFAULT, OC_RSRVD_RD_URI, entityHandler, NULL, OC_DISCOVERABLE));
+    OCResourceHandle light;
+    EXPECT_EQ(OC_STACK_OK, OCCreateResource(&light, "core.light", "oic.if.baseline", "/a/light",
+            entityHandler, NULL, OC_DISCOVERABLE));
+    Discover("");
+    EXPECT_TRUE(Discovered("/a/light"));
+
+    OCResource *resource = (OCResource *) light;
+    resource->resourceProperties =
+        (OCResourceProperty) (resource->resourceProperties & ~OC_DISCOVERABLE);
+    Discover("");
+    EXPECT_FALSE(Discovered("/a/light"));
+
+    EXPECT_EQ(OC_STACK_OK, OCStop());
+}
+#endif
+
+// Bind a new type to the resource from the worker, while discovery is being served.
+static OCEntityHandlerResult DispatchBindRequest(OCEntityHandlerFlag flag,
+        OCEntityHandlerRequest *request, void *ctx)
+{
+    OC_UNUSED(flag);
+    OC_UNUSED(ctx);
+    int64_t sequence = -1;
+    EXPECT_TRUE(OCRepPayloadGetPropInt((OCRepPayload *) request->payload, "seq", &sequence));
+    std::string type = "core.bound" + std::to_string(sequence);
+    EXPECT_EQ(OC_STACK_OK, OCBindResourceTypeToResource(request->resource, type.c_str()));
+    {
+        std::lock_guard<std::mutex> lock(s_dispatch.mutex);
+        s_dispatch.sequences[0].push_back(sequence);
+    }
+
+    OCEntityHandlerResponse response;
+    memset(&response, 0, sizeof(response));
+    response.requestHandle = request->requestHandle;
+    response.resourceHandle = request->resource;
+    response.ehResult = OC_EH_OK;
+    EXPECT_EQ(OC_STACK_OK, OCDoResponse(&response));
+    return OC_EH_OK;
+}
+
+TEST(StackProcess, RequestDispatchBindsTypeDuringDiscovery)
+{
+    itst::DeadmanTimer killSwitch(SHORT_TEST_TIMEOUT);
+    ResetDispatchRecord();
+    EXPECT_EQ(OC_STACK_OK, OCSetRequestDispatchThreads(2));
+    EXPECT_EQ(OC_STACK_OK, OCInit("127.0.0.1", 5683, OC_CLIENT_SERVER));
+
+    OCResourceHandle light;
+    EXPECT_EQ(OC_STACK_OK, OCCreateResource(&light, "core.light", "oic.if.baseline", "/a/light",
+            DispatchBindRequest, NULL, OC_DISCOVERABLE));
+
+    // The types are bound by the workers while OCProcess() builds the discovery responses.
+    for (int64_t i = 0; i < DISPATCH_REQUEST_COUNT; i++)
+    {
+        PostSequence("127.0.0.1:5683/a/light", i);
+        Discover("");
+        EXPECT_TRUE(Discovered("/a/light"));
+    }
+    EXPECT_TRUE(ProcessUntil([]{ return DISPATCH_REQUEST_COUNT == s_dispatch.responses; },
+            3000));
+
+    uint8_t numResourceTypes = 0;
+    EXPECT_EQ(OC_STACK_OK, OCGetNumberOfResourceTypes(light, &numResourceTypes));
+    EXPECT_EQ(1 + DISPATCH_REQUEST_COUNT, numResourceTypes);
+    for (int64_t i = 0; i < DISPATCH_REQUEST_COUNT; i++)
+    {
+        std::string query = "?rt=core.bound" + std::to_string(i);
+        Discover(query.c_str());
+        EXPECT_TRUE(Discovered("/a/light")) << query;
+    }
+
+    EXPECT_EQ(OC_STACK_OK, OCStop());
+    EXPECT_EQ(OC_STACK_OK, OCSetRequestDispatchThreads(0));
+}
+
 TEST(StackStart, SetPlatformInfoValid)
 {
     itst::DeadmanTimer killSwitch(SHORT_TEST_TIMEOUT);
@@ -1508,6 +2232,191 @@ TEST(StackResource, StackTestResourceDiscoverManyResources)
     EXPECT_EQ(OC_STACK_OK, OCStop());
 }
 
+TEST(StackResource, ResourceLookupAfterDelete)
+{
+    itst::DeadmanTimer killSwitch(SHORT_TEST_TIMEOUT);
+    OIC_LOG(INFO, TAG, "Starting ResourceLookupAfterDelete test");
+    InitStack(OC_SERVER);
+
+    uint8_t numResources = 0;
+    EXPECT_EQ(OC_STACK_OK, OCGetNumberOfResources(&numResources));
+
+    OCResourceHandle handle1;
+    EXPECT_EQ(OC_STACK_OK, OCCreateResource(&handle1,
+                                            "core.led",
+                                            "core.rw",
+                                            "/a/led1",
+                                            0,
+                                            NULL,
+                                            OC_DISCOVERABLE));
+    OCResourceHandle handle2;
+    EXPECT_EQ(OC_STACK_OK, OCCreateResource(&handle2,
+                                            "core.led",
+                                            "core.rw",
+                                            "/a/led2",
+                                            0,
+                                            NULL,
+                                            OC_DISCOVERABLE));
+    EXPECT_EQ(handle1, OCGetResourceHandleAtUri("/a/led1"));
+    EXPECT_EQ(handle2, OCGetResourceHandleAtUri("/a/led2"));
+    EXPECT_EQ(handle1, OCGetResourceHandle(numResources));
+    EXPECT_EQ(handle2, OCGetResourceHandle(numResources + 1));
+
+    EXPECT_EQ(OC_STACK_OK, OCDeleteResource(handle1));
+    EXPECT_EQ(NULL, OCGetResourceHandleAtUri("/a/led1"));
+    EXPECT_EQ(handle2, OCGetResourceHandle(numResources));
+    EXPECT_EQ(NULL, OCGetResourceHandle(numResources + 1));
+    EXPECT_EQ(OC_STACK_ERROR, OCDeleteResource(handle1));
+
+    // The uri can be used again once the resource is deleted
+    EXPECT_EQ(OC_STACK_OK, OCCreateResource(&handle1,
+                                            "core.led",
+                                            "core.rw",
+                                            "/a/led1",
+                                            0,
+                                            NULL,
+                                            OC_DISCOVERABLE));
+    EXPECT_EQ(handle1, OCGetResourceHandleAtUri("/a/led1"));
+    EXPECT_EQ(handle1, OCGetResourceHandle(numResources + 1));
+
+    EXPECT_EQ(OC_STACK_OK, OCStop());
+}
+
+TEST(StackResource, ResourceLookupBenchmark)
+{
+    itst::DeadmanTimer killSwitch(LONG_TEST_TIMEOUT);
+    OIC_LOG(INFO, TAG, "Starting ResourceLookupBenchmark test");
+    InitStack(OC_SERVER);
+
+    const int resourceCount = 10000;
+    const int lookupRounds = 10;
+    char uri[MAX_URI_LENGTH];
+    std::vector<OCResourceHandle> handles(resourceCount);
+
+    for (int i = 0; i < resourceCount; i++)
+    {
+        snprintf(uri, sizeof(uri), "/bench/%d", i);
+        ASSERT_EQ(OC_STACK_OK, OCCreateResource(&handles[i],
+                                                (i % 2) ? "core.light" : "core.fan",
+                                                "core.rw",
+                                                uri,
+                                                0,
+                                                NULL,
+                                                OC_DISCOVERABLE));
+    }
+
+    uint64_t start = OICGetCurrentTime(TIME_IN_US);
+    for (int round = 0; round < lookupRounds; round++)
+    {
+        for (int i = 0; i < resourceCount; i++)
+        {
+            snprintf(uri, sizeof(uri), "/bench/%d", i);
+            ASSERT_EQ(handles[i], OCGetResourceHandleAtUri(uri));
+        }
+    }
+    uint64_t elapsed = OICGetCurrentTime(TIME_IN_US) - start;
+
+    std::cout << "Uri lookup with " << resourceCount << " resources: "
+              << (double) elapsed * 1000 / (resourceCount * lookupRounds)
+              << " ns per lookup" << std::endl;
+
+    start = OICGetCurrentTime(TIME_IN_US);
+    for (int i = 0; i < resourceCount; i++)
+    {
+        ASSERT_EQ(OC_STACK_OK, OCDeleteResource(handles[i]));
+    }
+    elapsed = OICGetCurrentTime(TIME_IN_US) - start;
+
+    std::cout << "Deleting " << resourceCount << " resources: "
+              << elapsed / 1000 << " ms" << std::endl;
+
+    EXPECT_EQ(OC_STACK_OK, OCStop());
+}
+
+static ClientCB *AddTestClientCB(uint8_t id, uint32_t ttl)
+{
+    OCCallbackData cbData;
+    cbData.cb = asyncDoResourcesCallback;
+    cbData.context = (void*)DEFAULT_CONTEXT_VALUE;
+    cbData.cd = NULL;
+
+    CAToken_t token = (CAToken_t)OICCalloc(1, CA_MAX_TOKEN_LEN);
+    token[0] = (char)id;
+    OCDoHandle handle = (OCDoHandle)OICMalloc(1);
+
+    ClientCB *cbNode = NULL;
+    EXPECT_EQ(OC_STACK_OK, AddClientCB(&cbNode, &cbData, CA_MSG_CONFIRM, token, CA_MAX_TOKEN_LEN,
+                                       NULL, 0, NULL, 0, CA_FORMAT_UNDEFINED, &handle,
+                                       OC_REST_GET, NULL, OICStrdup("/a/led"), NULL, ttl));
+    return cbNode;
+}
+
+TEST(StackClientCB, LookupByTokenAndHandle)
+{
+    itst::DeadmanTimer killSwitch(SHORT_TEST_TIMEOUT);
+
+    ClientCB *cbNodes[100];
+    for (uint8_t i = 0; i < 100; i++)
+    {
+        cbNodes[i] = AddTestClientCB(i, 0);
+        ASSERT_TRUE(NULL != cbNodes[i]);
+    }
+
+    char token[CA_MAX_TOKEN_LEN] = { 0 };
+    for (uint8_t i = 0; i < 100; i++)
+    {
+        token[0] = (char)i;
+        EXPECT_EQ(cbNodes[i], GetClientCBUsingToken(token, CA_MAX_TOKEN_LEN));
+        EXPECT_EQ(cbNodes[i], GetClientCBUsingHandle(cbNodes[i]->handle));
+    }
+
+    OCDoHandle handle = cbNodes[10]->handle;
+    DeleteClientCB(cbNodes[10]);
+    token[0] = 10;
+    EXPECT_EQ(NULL, GetClientCBUsingToken(token, CA_MAX_TOKEN_LEN));
+    EXPECT_EQ(NULL, GetClientCBUsingHandle(handle));
+    token[0] = 11;
+    EXPECT_EQ(cbNodes[11], GetClientCBUsingToken(token, CA_MAX_TOKEN_LEN));
+
+    DeleteClientCBList();
+    EXPECT_EQ(NULL, GetClientCBUsingToken(token, CA_MAX_TOKEN_LEN));
+}
+
+TEST(StackClientCB, DeleteTimedOut)
+{
+    itst::DeadmanTimer killSwitch(SHORT_TEST_TIMEOUT);
+
+    uint32_t now = GetTicks(0);
+    ClientCB *expired = AddTestClientCB(1, now - 1);
+    ClientCB *active = AddTestClientCB(2, GetTicks(60 * MILLISECONDS_PER_SECOND));
+    ClientCB *noTimeout = AddTestClientCB(3, 0);
+    ClientCB *renewed = AddTestClientCB(4, now - 1);
+    ASSERT_TRUE(NULL != expired && NULL != active && NULL != noTimeout && NULL != renewed);
+    EXPECT_TRUE(HasClientCBTimeouts());
+
+    SetClientCBTimeout(renewed, GetTicks(60 * MILLISECONDS_PER_SECOND));
+
+    // Lookups do not delete expired callbacks
+    char token[CA_MAX_TOKEN_LEN] = { 0 };
+    token[0] = 1;
+    EXPECT_EQ(expired, GetClientCBUsingToken(token, CA_MAX_TOKEN_LEN));
+
+    DeleteTimedOutClientCBs();
+    EXPECT_EQ(NULL, GetClientCBUsingToken(token, CA_MAX_TOKEN_LEN));
+    token[0] = 2;
+    EXPECT_EQ(active, GetClientCBUsingToken(token, CA_MAX_TOKEN_LEN));
+    token[0] = 3;
+    EXPECT_EQ(noTimeout, GetClientCBUsingToken(token, CA_MAX_TOKEN_LEN));
+    token[0] = 4;
+    EXPECT_EQ(renewed, GetClientCBUsingToken(token, CA_MAX_TOKEN_LEN));
+
+    DeleteClientCB(active);
+    DeleteClientCB(renewed);
+    EXPECT_FALSE(HasClientCBTimeouts());
+
+    DeleteClientCBList();
+}
+
 TEST_F(OCDevicePropertiesTests, DevicePropertiesToCBORPayloadllNULL)
 {
     EXPECT_EQ(OC_STACK_INVALID_PARAM, DevicePropertiesToCBORPayload(NULL, NULL, NULL));
@@ -3231,6 +4140,159 @@ TEST(DiagnosticPayload, DISABLED_EndToEnd)
     OCStop();
 }
 
+TEST(RequestPayloadView, InvalidParams)
+{
+    OCCborView view;
+    EXPECT_EQ(OC_STACK_INVALID_PARAM, OCGetRequestPayloadView(NULL, &view));
+    EXPECT_EQ(OC_STACK_INVALID_PARAM, OCGetRequestPayloadView((OCRequestHandle) &view, NULL));
+}
+
+static OCEntityHandlerResult PayloadViewRequest(OCEntityHandlerFlag flag,
+        OCEntityHandlerRequest *request, void *ctx)
+{
+    OC_UNUSED(flag);
+    OC_UNUSED(ctx);
+    OCCborView view;
+    EXPECT_EQ(OC_STACK_OK, OCGetRequestPayloadView(request->requestHandle, &view));
+    int64_t power = 0;
+    EXPECT_TRUE(OCCborViewGetPropInt(&view, "power", &power));
+    EXPECT_EQ(42, power);
+    const char *state = NULL;
+    size_t stateLen = 0;
+    EXPECT_TRUE(OCCborViewGetPropString(&view, "state", &state, &stateLen));
+    EXPECT_EQ("on", std::string(state, stateLen));
+
+    OCEntityHandlerResponse response;
+    memset(&response, 0, sizeof(response));
+    response.requestHandle = request->requestHandle;
+    response.ehResult = OC_EH_OK;
+    EXPECT_EQ(OC_STACK_OK, OCDoResponse(&response));
+    return OC_EH_OK;
+}
+
+static OCStackApplicationResult PayloadViewResponse(void *ctx, OCDoHandle handle,
+        OCClientResponse *response)
+{
+    OC_UNUSED(ctx);
+    OC_UNUSED(handle);
+    EXPECT_EQ(OC_STACK_RESOURCE_CHANGED, response->result);
+    return OC_STACK_DELETE_TRANSACTION;
+}
+
+TEST(RequestPayloadView, EndToEnd)
+{
+    EXPECT_EQ(OC_STACK_OK, OCInit("127.0.0.1", 5683, OC_CLIENT_SERVER));
+    itst::DeadmanTimer killSwitch(SHORT_TEST_TIMEOUT);
+
+    OCResourceHandle handle;
+    EXPECT_EQ(OC_STACK_OK, OCCreateResource(&handle, "core.light", "oic.if.baseline", "/a/light",
+            PayloadViewRequest, NULL, OC_DISCOVERABLE));
+
+    OCRepPayload *payload = OCRepPayloadCreate();
+    ASSERT_TRUE(payload != NULL);
+    EXPECT_TRUE(OCRepPayloadSetPropInt(payload, "power", 42));
+    EXPECT_TRUE(OCRepPayloadSetPropString(payload, "state", "on"));
+
+    itst::Callback payloadViewCB(&PayloadViewResponse);
+    EXPECT_EQ(OC_STACK_OK, OCDoRequest(NULL, OC_REST_POST, "127.0.0.1:5683/a/light", NULL,
+            (OCPayload *) payload, CT_DEFAULT, OC_HIGH_QOS, payloadViewCB, NULL, 0));
+    EXPECT_EQ(OC_STACK_OK, payloadViewCB.Wait(3));
+    OCRepPayloadDestroy(payload);
+
+    OCStop();
+}
+
+TEST(ResponsePayloadView, InvalidParams)
+{
+    EXPECT_EQ(OC_STACK_OK, OCInit("127.0.0.1", 5683, OC_CLIENT_SERVER));
+
+    OCClientResponse response;
+    memset(&response, 0, sizeof(response));
+    OCCborView view;
+    EXPECT_EQ(OC_STACK_INVALID_PARAM, OCGetResponsePayloadView(NULL, &view));
+    EXPECT_EQ(OC_STACK_INVALID_PARAM, OCGetResponsePayloadView(&response, NULL));
+    // Only the response being passed to its callback has a view.
+    EXPECT_EQ(OC_STACK_INVALID_PARAM, OCGetResponsePayloadView(&response, &view));
+
+    EXPECT_EQ(OC_STACK_INVALID_PARAM, OCSetResponsePayloadViewOnly(NULL, true));
+    uint8_t unknown[CA_MAX_TOKEN_LEN] = { 0 };
+    EXPECT_EQ(OC_STACK_NO_RESOURCE, OCSetResponsePayloadViewOnly((OCDoHandle) unknown, true));
+
+    OCStop();
+}
+
+static OCEntityHandlerResult ResponsePayloadViewRequest(OCEntityHandlerFlag flag,
+        OCEntityHandlerRequest *request, void *ctx)
+{
+    OC_UNUSED(flag);
+    OC_UNUSED(ctx);
+    OCRepPayload *payload = OCRepPayloadCreate();
+    EXPECT_TRUE(payload != NULL);
+    EXPECT_TRUE(OCRepPayloadSetPropInt(payload, "power", 42));
+    EXPECT_TRUE(OCRepPayloadSetPropString(payload, "state", "on"));
+
+    OCEntityHandlerResponse response;
+    memset(&response, 0, sizeof(response));
+    response.requestHandle = request->requestHandle;
+    response.ehResult = OC_EH_OK;
+    response.payload = (OCPayload *) payload;
+    EXPECT_EQ(OC_STACK_OK, OCDoResponse(&response));
+    OCRepPayloadDestroy(payload);
+    return OC_EH_OK;
+}
+
+static bool s_responseDecoded;
+
+static OCStackApplicationResult ResponsePayloadViewResponse(void *ctx, OCDoHandle handle,
+        OCClientResponse *response)
+{
+    OC_UNUSED(ctx);
+    OC_UNUSED(handle);
+    EXPECT_EQ(OC_STACK_OK, response->result);
+    EXPECT_EQ(s_responseDecoded, NULL != response->payload);
+
+    OCCborView view;
+    EXPECT_EQ(OC_STACK_OK, OCGetResponsePayloadView(response, &view));
+    int64_t power = 0;
+    EXPECT_TRUE(OCCborViewGetPropInt(&view, "power", &power));
+    EXPECT_EQ(42, power);
+    const char *state = NULL;
+    size_t stateLen = 0;
+    EXPECT_TRUE(OCCborViewGetPropString(&view, "state", &state, &stateLen));
+    EXPECT_EQ("on", std::string(state, stateLen));
+    return OC_STACK_DELETE_TRANSACTION;
+}
+
+static void GetResponsePayloadView(bool viewOnly)
+{
+    EXPECT_EQ(OC_STACK_OK, OCInit("127.0.0.1", 5683, OC_CLIENT_SERVER));
+    itst::DeadmanTimer killSwitch(SHORT_TEST_TIMEOUT);
+
+    OCResourceHandle resource;
+    EXPECT_EQ(OC_STACK_OK, OCCreateResource(&resource, "core.light", "oic.if.baseline",
+            "/a/light", ResponsePayloadViewRequest, NULL, OC_DISCOVERABLE));
+
+    s_responseDecoded = !viewOnly;
+    OCDoHandle handle = NULL;
+    itst::Callback responseViewCB(&ResponsePayloadViewResponse);
+    EXPECT_EQ(OC_STACK_OK, OCDoRequest(&handle, OC_REST_GET, "127.0.0.1:5683/a/light", NULL,
+            NULL, CT_DEFAULT, OC_HIGH_QOS, responseViewCB, NULL, 0));
+    EXPECT_EQ(OC_STACK_OK, OCSetResponsePayloadViewOnly(handle, viewOnly));
+    EXPECT_EQ(OC_STACK_OK, responseViewCB.Wait(3));
+
+    OCStop();
+}
+
+TEST(ResponsePayloadView, DecodedResponse)
+{
+    GetResponsePayloadView(false);
+}
+
+TEST(ResponsePayloadView, ViewOnlyResponse)
+{
+    GetResponsePayloadView(true);
+}
+
 // Mostly copy-paste from ca_api_unittest.cpp
 TEST(OCIpv6ScopeLevel, getMulticastScope)
 {
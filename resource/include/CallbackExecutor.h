@@ -0,0 +1,101 @@
+//******************************************************************
+//
+// Copyright 2017 Open Connectivity Foundation All Rights Reserved.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+
+/**
+ * @file
+ *
+ * This file contains the executor running the callbacks of the client API.
+ */
+
+#ifndef OC_CALLBACK_EXECUTOR_H_
+#define OC_CALLBACK_EXECUTOR_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <OCApi.h>
+
+namespace OC
+{
+    /**
+     * Runs callbacks as configured by CallbackExecution.
+     *
+     * With CallbackExecution::ThreadPool, callbacks posted with the same key run in the
+     * order they were posted, one at a time, since each key is served by a single worker.
+     */
+    class CallbackExecutor
+    {
+    public:
+        typedef std::shared_ptr<CallbackExecutor> Ptr;
+        typedef std::function<void()> Task;
+
+        /**
+         * @param execution     How callbacks are run.
+         * @param threadCount   Number of workers for CallbackExecution::ThreadPool,
+         *                      0 for DEFAULT_CALLBACK_THREAD_COUNT.
+         */
+        CallbackExecutor(CallbackExecution execution, unsigned int threadCount);
+        ~CallbackExecutor();
+
+        CallbackExecutor(const CallbackExecutor&) = delete;
+        CallbackExecutor& operator=(const CallbackExecutor&) = delete;
+
+        /**
+         * Run a callback with no ordering to other callbacks.
+         */
+        void post(Task task);
+
+        /**
+         * Run a callback after the callbacks posted before with the same key,
+         * e.g. the notifications of an observation.
+         */
+        void post(const void* key, Task task);
+
+        CallbackExecution getExecution() const
+        {
+            return m_execution;
+        }
+
+    private:
+        struct Worker
+        {
+            std::thread thread;
+            std::mutex mutex;
+            std::condition_variable cond;
+            std::deque<Task> tasks;
+            bool stop = false;
+        };
+
+        static void run(Worker& worker);
+        void enqueue(Worker& worker, Task task);
+
+        CallbackExecution m_execution;
+        std::vector<std::unique_ptr<Worker>> m_workers;
+        std::atomic<size_t> m_nextWorker;
+    };
+}
+
+#endif // OC_CALLBACK_EXECUTOR_H_
@@ -79,6 +79,14 @@ namespace OC
                         OCConnectivityType connectivityType,
                         GetCallback& callback, QualityOfService QoS)=0;
 
+        virtual OCStackResult GetResourceRepresentationView(
+                        const OCDevAddr& devAddr,
+                        const std::string& uri,
+                        const QueryParamsMap& queryParams,
+                        const HeaderOptions& headerOptions,
+                        OCConnectivityType connectivityType,
+                        GetViewCallback& callback, QualityOfService QoS)=0;
+
         virtual OCStackResult PutResourceRepresentation(
                         const OCDevAddr& devAddr,
                         const std::string& uri,
@@ -27,6 +27,7 @@
 #include <iostream>
 
 #include <OCApi.h>
+#include <CallbackExecutor.h>
 #include <IClientWrapper.h>
 #include <InitializeException.h>
 #include <ResourceInitException.h>
@@ -38,22 +39,36 @@ namespace OC
         struct GetContext
         {
             GetCallback callback;
-            GetContext(GetCallback cb) : callback(cb){}
+            CallbackExecutor::Ptr executor;
+            GetContext(GetCallback cb, CallbackExecutor::Ptr ex)
+                : callback(cb), executor(ex){}
+        };
+
+        struct GetViewContext
+        {
+            GetViewCallback callback;
+            CallbackExecutor::Ptr executor;
+            GetViewContext(GetViewCallback cb, CallbackExecutor::Ptr ex)
+                : callback(cb), executor(ex){}
         };
 
         struct SetContext
         {
             PutCallback callback;
-            SetContext(PutCallback cb) : callback(cb){}
+            CallbackExecutor::Ptr executor;
+            SetContext(PutCallback cb, CallbackExecutor::Ptr ex)
+                : callback(cb), executor(ex){}
         };
 
         struct ListenContext
         {
             FindCallback callback;
             std::weak_ptr<IClientWrapper> clientWrapper;
+            CallbackExecutor::Ptr executor;
 
-            ListenContext(FindCallback cb, std::weak_ptr<IClientWrapper> cw)
-                : callback(cb), clientWrapper(cw){}
+            ListenContext(FindCallback cb, std::weak_ptr<IClientWrapper> cw,
+                          CallbackExecutor::Ptr ex)
+                : callback(cb), clientWrapper(cw), executor(ex){}
         };
 
         struct ListenErrorContext
@@ -61,19 +76,23 @@ namespace OC
             FindCallback callback;
             FindErrorCallback errorCallback;
             std::weak_ptr<IClientWrapper> clientWrapper;
+            CallbackExecutor::Ptr executor;
 
             ListenErrorContext(FindCallback cb1, FindErrorCallback cb2,
-                               std::weak_ptr<IClientWrapper> cw)
-                : callback(cb1), errorCallback(cb2), clientWrapper(cw){}
+                               std::weak_ptr<IClientWrapper> cw,
+                               CallbackExecutor::Ptr ex)
+                : callback(cb1), errorCallback(cb2), clientWrapper(cw), executor(ex){}
         };
 
         struct ListenResListContext
         {
             FindResListCallback callback;
             std::weak_ptr<IClientWrapper> clientWrapper;
+            CallbackExecutor::Ptr executor;
 
-            ListenResListContext(FindResListCallback cb, std::weak_ptr<IClientWrapper> cw)
-                : callback(cb), clientWrapper(cw){}
+            ListenResListContext(FindResListCallback cb, std::weak_ptr<IClientWrapper> cw,
+                                 CallbackExecutor::Ptr ex)
+                : callback(cb), clientWrapper(cw), executor(ex){}
         };
 
         struct ListenResListWithErrorContext
@@ -81,36 +100,46 @@ namespace OC
             FindResListCallback callback;
             FindErrorCallback errorCallback;
             std::weak_ptr<IClientWrapper> clientWrapper;
+            CallbackExecutor::Ptr executor;
 
             ListenResListWithErrorContext(FindResListCallback cb1, FindErrorCallback cb2,
-                               std::weak_ptr<IClientWrapper> cw)
-                : callback(cb1), errorCallback(cb2), clientWrapper(cw){}
+                               std::weak_ptr<IClientWrapper> cw,
+                               CallbackExecutor::Ptr ex)
+                : callback(cb1), errorCallback(cb2), clientWrapper(cw), executor(ex){}
         };
 
         struct DeviceListenContext
         {
             FindDeviceCallback callback;
             IClientWrapper::Ptr clientWrapper;
-            DeviceListenContext(FindDeviceCallback cb, IClientWrapper::Ptr cw)
-                    : callback(cb), clientWrapper(cw){}
+            CallbackExecutor::Ptr executor;
+            DeviceListenContext(FindDeviceCallback cb, IClientWrapper::Ptr cw,
+                                CallbackExecutor::Ptr ex)
+                    : callback(cb), clientWrapper(cw), executor(ex){}
         };
 
         struct SubscribePresenceContext
         {
             SubscribeCallback callback;
-            SubscribePresenceContext(SubscribeCallback cb) : callback(cb){}
+            CallbackExecutor::Ptr executor;
+            SubscribePresenceContext(SubscribeCallback cb, CallbackExecutor::Ptr ex)
+                : callback(cb), executor(ex){}
         };
 
         struct DeleteContext
         {
             DeleteCallback callback;
-            DeleteContext(DeleteCallback cb) : callback(cb){}
+            CallbackExecutor::Ptr executor;
+            DeleteContext(DeleteCallback cb, CallbackExecutor::Ptr ex)
+                : callback(cb), executor(ex){}
         };
 
         struct ObserveContext
         {
             ObserveCallback callback;
-            ObserveContext(ObserveCallback cb) : callback(cb){}
+            CallbackExecutor::Ptr executor;
+            ObserveContext(ObserveCallback cb, CallbackExecutor::Ptr ex)
+                : callback(cb), executor(ex){}
         };
 
 #ifdef WITH_MQ
@@ -118,8 +147,10 @@ namespace OC
         {
             MQTopicCallback callback;
             std::weak_ptr<IClientWrapper> clientWrapper;
-            MQTopicContext(MQTopicCallback cb, std::weak_ptr<IClientWrapper> cw)
-                : callback(cb), clientWrapper(cw){}
+            CallbackExecutor::Ptr executor;
+            MQTopicContext(MQTopicCallback cb, std::weak_ptr<IClientWrapper> cw,
+                           CallbackExecutor::Ptr ex)
+                : callback(cb), clientWrapper(cw), executor(ex){}
         };
 #endif
     }
@@ -161,6 +192,13 @@ namespace OC
             OCConnectivityType connectivityType,
             GetCallback& callback, QualityOfService QoS);
 
+        virtual OCStackResult GetResourceRepresentationView(
+            const OCDevAddr& devAddr,
+            const std::string& uri,
+            const QueryParamsMap& queryParams, const HeaderOptions& headerOptions,
+            OCConnectivityType connectivityType,
+            GetViewCallback& callback, QualityOfService QoS);
+
         virtual OCStackResult PutResourceRepresentation(
             const OCDevAddr& devAddr,
             const std::string& uri,
@@ -244,6 +282,7 @@ namespace OC
 
     private:
         PlatformConfig  m_cfg;
+        CallbackExecutor::Ptr m_callbackExecutor;
     };
 }
 
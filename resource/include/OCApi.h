@@ -131,6 +131,29 @@ namespace OC
         NaQos       = OC_NA_QOS
     };
 
+    /**
+     * How the client API runs the callbacks of the application.
+     */
+    enum class CallbackExecution
+    {
+        /** Each callback runs in a new thread. */
+        Thread,
+
+        /**
+         * Callbacks run in a fixed pool of threads. The notifications of an observation
+         * are delivered in order, one at a time.
+         */
+        ThreadPool,
+
+        /**
+         * Callbacks run in the thread processing the stack, which they must not block.
+         */
+        Inline
+    };
+
+    /** Number of threads of CallbackExecution::ThreadPool when none is configured. */
+    const unsigned int DEFAULT_CALLBACK_THREAD_COUNT = 4;
+
     /**
      *  Data structure to provide the configuration.
      */
@@ -175,6 +198,15 @@ namespace OC
          */
         bool                       useLegacyCleanup;
 
+        /** how the callbacks of the client API are run. */
+        CallbackExecution          callbackExecution;
+
+        /** number of threads of CallbackExecution::ThreadPool, 0 for the default. */
+        unsigned int               callbackThreadCount;
+
+        /** number of threads calling entity handlers, 0 to call them from the process thread. */
+        unsigned int               requestDispatchThreadCount;
+
         public:
             PlatformConfig(const ServiceType serviceType_,
             const ModeType mode_,
@@ -188,7 +220,10 @@ namespace OC
                 port(0),
                 QoS(QualityOfService::NaQos),
                 ps(ps_),
-                useLegacyCleanup(false)
+                useLegacyCleanup(false),
+                callbackExecution(CallbackExecution::Thread),
+                callbackThreadCount(0),
+                requestDispatchThreadCount(0)
         {}
             /* @deprecated: Use a non deprecated constructor. */
             OC_DEPRECATED_MSG(
@@ -204,7 +239,10 @@ namespace OC
                 port(0),
                 QoS(QualityOfService::NaQos),
                 ps(nullptr),
-                useLegacyCleanup(true)
+                useLegacyCleanup(true),
+                callbackExecution(CallbackExecution::Thread),
+                callbackThreadCount(0),
+                requestDispatchThreadCount(0)
         {}
             /* @deprecated: Use a non deprecated constructor. */
             OC_DEPRECATED_MSG(
@@ -225,7 +263,10 @@ namespace OC
                 port(0),
                 QoS(QoS_),
                 ps(ps_),
-                useLegacyCleanup(true)
+                useLegacyCleanup(true),
+                callbackExecution(CallbackExecution::Thread),
+                callbackThreadCount(0),
+                requestDispatchThreadCount(0)
         {}
             /* @deprecated: Use a non deprecated constructor. */
             OC_DEPRECATED_MSG(
@@ -246,7 +287,10 @@ namespace OC
                 port(port_),
                 QoS(QoS_),
                 ps(ps_),
-                useLegacyCleanup(true)
+                useLegacyCleanup(true),
+                callbackExecution(CallbackExecution::Thread),
+                callbackThreadCount(0),
+                requestDispatchThreadCount(0)
         {}
             /* @deprecated: Use a non deprecated constructor. */
             OC_DEPRECATED_MSG(
@@ -267,7 +311,10 @@ namespace OC
                 ipAddress(ipAddress_),
                 port(port_),
                 QoS(QoS_),
-                ps(ps_)
+                ps(ps_),
+                callbackExecution(CallbackExecution::Thread),
+                callbackThreadCount(0),
+                requestDispatchThreadCount(0)
         {}
             PlatformConfig(const ServiceType serviceType_,
                            const ModeType mode_,
@@ -283,7 +330,10 @@ namespace OC
                 port(0),
                 QoS(QoS_),
                 ps(ps_),
-                useLegacyCleanup(true)
+                useLegacyCleanup(true),
+                callbackExecution(CallbackExecution::Thread),
+                callbackThreadCount(0),
+                requestDispatchThreadCount(0)
         {}
             /* @deprecated: Use a non deprecated constructor. */
             OC_DEPRECATED_MSG(
@@ -305,7 +355,10 @@ namespace OC
                 port(0),
                 QoS(QoS_),
                 ps(ps_),
-                useLegacyCleanup(true)
+                useLegacyCleanup(true),
+                callbackExecution(CallbackExecution::Thread),
+                callbackThreadCount(0),
+                requestDispatchThreadCount(0)
         {}
 
     };
@@ -391,6 +444,9 @@ namespace OC
     typedef std::function<void(const HeaderOptions&,
                                 const OCRepresentation&, const int)> GetCallback;
 
+    typedef std::function<void(const HeaderOptions&,
+                                const OCRepresentationView&, const int)> GetViewCallback;
+
     typedef std::function<void(const HeaderOptions&,
                                 const OCRepresentation&, const int)> PostCallback;
 
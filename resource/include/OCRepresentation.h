@@ -32,6 +32,7 @@
 #include <sstream>
 #include <vector>
 #include <map>
+#include <memory>
 
 #include <AttributeValue.h>
 #include <StringConstants.h>
@@ -56,6 +57,57 @@ namespace OC
         DefaultChild
     };
 
+    /**
+     * Read only view of a CBOR encoded representation, see OCCborView, e.g. of a
+     * request payload from OCGetRequestPayloadView() or of the response given to the
+     * callback of OCResource::getView(). Attributes are decoded from
+     * the bytes on each lookup instead of being copied into an OCRepresentation
+     * first, which is cheaper when only a few attributes of a large representation
+     * are read. The view shares one copy of the bytes, so it can be kept after the
+     * callback it was created in returns.
+     */
+    class OCRepresentationView
+    {
+        public:
+            OCRepresentationView(): m_view() {}
+
+            OCRepresentationView(const uint8_t* data, size_t size)
+                : m_view()
+            {
+                if (data && size)
+                {
+                    m_buffer = std::make_shared<const std::vector<uint8_t>>(data, data + size);
+                    m_view.data = m_buffer->data();
+                    m_view.size = m_buffer->size();
+                }
+            }
+
+            bool empty() const;
+
+            bool hasAttribute(const std::string& str) const;
+
+            bool isNULL(const std::string& str) const;
+
+            /**
+             *  Retrieve the attribute value associated with the supplied name
+             *
+             *  @param str Name of the attribute
+             *  @param val Value of the attribute, a view of the received bytes
+             *        for an object
+             *  @return true if the attribute was found with the type of val.
+             */
+            bool getValue(const std::string& str, int& val) const;
+            bool getValue(const std::string& str, double& val) const;
+            bool getValue(const std::string& str, bool& val) const;
+            bool getValue(const std::string& str, std::string& val) const;
+            bool getValue(const std::string& str, std::vector<uint8_t>& val) const;
+            bool getValue(const std::string& str, OCRepresentationView& val) const;
+
+        private:
+            std::shared_ptr<const std::vector<uint8_t>> m_buffer;
+            OCCborView m_view;
+    };
+
     class MessageContainer
     {
         public:
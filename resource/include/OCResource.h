@@ -170,6 +170,21 @@ namespace OC
         OCStackResult get(const QueryParamsMap& queryParametersMap, GetCallback attributeHandler,
                           QualityOfService QoS);
 
+        /**
+        * Function to get the attributes of a resource as a view of the received CBOR,
+        * which is not decoded into an OCRepresentation. This is cheaper when only a few
+        * attributes of a large representation are read.
+        * @param queryParametersMap map which can have the query parameter name and value
+        * @param attributeHandler handles callback
+        *        The callback function will be invoked with a view of the representation,
+        *        empty if none was received, and the result from this Get operation.
+        * @param QoS the quality of communication
+        * @return Returns  ::OC_STACK_OK on success, some other value upon failure.
+        * @note OCStackResult is defined in ocstack.h.
+        */
+        OCStackResult getView(const QueryParamsMap& queryParametersMap,
+                              GetViewCallback attributeHandler, QualityOfService QoS);
+
         /**
         * Function to get the attributes of a resource.
         *
@@ -94,6 +94,15 @@ namespace OC
             GetCallback& /*callback*/, QualityOfService /*QoS*/)
             {return OC_STACK_NOTIMPL;}
 
+        virtual OCStackResult GetResourceRepresentationView(
+            const OCDevAddr& /*devAddr*/,
+            const std::string& /*uri*/,
+            const QueryParamsMap& /*queryParams*/,
+            const HeaderOptions& /*headerOptions*/,
+            OCConnectivityType /*connectivityType*/,
+            GetViewCallback& /*callback*/, QualityOfService /*QoS*/)
+            {return OC_STACK_NOTIMPL;}
+
         virtual OCStackResult PutResourceRepresentation(
             const OCDevAddr& /*devAddr*/,
             const std::string& /*uri*/,
@@ -0,0 +1,276 @@
+//******************************************************************
+//
+// Copyright 2017 Open Connectivity Foundation All Rights Reserved.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+
+#include "oc_logger.h"
+#include "targets/oc_async_logger.h"
+#include "ocatomic.h"
+#include "octhread.h"
+#include "oic_string.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if (OC_ASYNC_LOGGER_QUEUE_SIZE & (OC_ASYNC_LOGGER_QUEUE_SIZE - 1)) != 0
+#error "OC_ASYNC_LOGGER_QUEUE_SIZE must be a power of two"
+#endif
+
+#define OC_ASYNC_LOGGER_QUEUE_MASK (OC_ASYNC_LOGGER_QUEUE_SIZE - 1)
+
+/* How long the writer thread sleeps when the ring buffer is empty. */
+#define OC_ASYNC_LOGGER_WAIT_US (10 * 1000)
+
+/*
+ * A slot is free for the message at position p when its sequence is p, and
+ * holds that message when its sequence is p + 1.
+ */
+typedef struct
+{
+    volatile int32_t sequence;
+    int level;
+    char message[OC_ASYNC_LOGGER_MESSAGE_SIZE];
+} oc_async_log_entry;
+
+typedef struct
+{
+    oc_log_ctx_t *target;
+    oc_async_log_entry entries[OC_ASYNC_LOGGER_QUEUE_SIZE];
+
+    /* Next position to write, shared by the logging threads. */
+    volatile int32_t enqueue_pos;
+
+    /* Next position to read, only updated by the writer thread. */
+    volatile int32_t dequeue_pos;
+
+    volatile int32_t dropped;
+    volatile int32_t running;
+
+    /* Held by the writer thread while it writes to the target. */
+    oc_mutex mutex;
+    oc_cond wake_cond;
+    oc_cond drained_cond;
+    oc_thread thread;
+} oc_async_logger_ctx;
+
+static int32_t oc_async_logger_distance(int32_t from, int32_t to)
+{
+    return (int32_t) ((uint32_t) to - (uint32_t) from);
+}
+
+/* Write the messages available in the ring buffer, only called by one thread at a time. */
+static void oc_async_logger_drain(oc_async_logger_ctx *lctx)
+{
+    for (;;)
+    {
+        int32_t pos = lctx->dequeue_pos;
+        oc_async_log_entry *entry = &lctx->entries[pos & OC_ASYNC_LOGGER_QUEUE_MASK];
+        int32_t sequence = oc_atomic_add(&entry->sequence, 0);
+        if (oc_async_logger_distance(pos, sequence) != 1)
+        {
+            return;
+        }
+
+        oc_log_write_level(lctx->target, (oc_log_level) entry->level, entry->message);
+
+        /* Release the slot for the message one lap later. */
+        oc_atomic_add(&entry->sequence, OC_ASYNC_LOGGER_QUEUE_SIZE - 1);
+        oc_atomic_increment(&lctx->dequeue_pos);
+    }
+}
+
+static void *oc_async_logger_run(void *arg)
+{
+    oc_async_logger_ctx *lctx = (oc_async_logger_ctx *) arg;
+
+    oc_mutex_lock(lctx->mutex);
+    while (oc_atomic_add(&lctx->running, 0))
+    {
+        oc_async_logger_drain(lctx);
+        oc_cond_broadcast(lctx->drained_cond);
+
+        /*
+         * The logging threads signal without the mutex so that they never block
+         * on it, a missed wake up only delays the messages until the timeout.
+         */
+        oc_cond_wait_for(lctx->wake_cond, lctx->mutex, OC_ASYNC_LOGGER_WAIT_US);
+    }
+    oc_mutex_unlock(lctx->mutex);
+    return NULL;
+}
+
+oc_log_ctx_t *OC_CALL oc_make_async_logger(oc_log_ctx_t *target)
+{
+    return oc_log_make_ctx(
+            target,
+            OC_LOG_ALL,
+            oc_async_logger_init,
+            oc_async_logger_destroy,
+            oc_async_logger_flush,
+            oc_async_logger_set_level,
+            oc_async_logger_write,
+            oc_async_logger_set_module
+        );
+}
+
+size_t OC_CALL oc_async_logger_dropped(oc_log_ctx_t *ctx)
+{
+    if (!ctx || !ctx->ctx)
+    {
+        return 0;
+    }
+
+    oc_async_logger_ctx *lctx = (oc_async_logger_ctx *) ctx->ctx;
+    return (size_t) oc_atomic_add(&lctx->dropped, 0);
+}
+
+int oc_async_logger_init(oc_log_ctx_t *ctx, void *world)
+{
+    oc_log_ctx_t *target = (oc_log_ctx_t *) world;
+    if (!target)
+    {
+        return 0;
+    }
+
+    oc_async_logger_ctx *lctx = (oc_async_logger_ctx *) calloc(1, sizeof(oc_async_logger_ctx));
+    if (!lctx)
+    {
+        return 0;
+    }
+
+    lctx->target = target;
+    for (int32_t i = 0; i < OC_ASYNC_LOGGER_QUEUE_SIZE; i++)
+    {
+        lctx->entries[i].sequence = i;
+    }
+    lctx->running = 1;
+
+    lctx->mutex = oc_mutex_new();
+    lctx->wake_cond = oc_cond_new();
+    lctx->drained_cond = oc_cond_new();
+    if (!lctx->mutex || !lctx->wake_cond || !lctx->drained_cond ||
+        (OC_THREAD_SUCCESS != oc_thread_new(&lctx->thread, oc_async_logger_run, lctx)))
+    {
+        oc_cond_free(lctx->drained_cond);
+        oc_cond_free(lctx->wake_cond);
+        oc_mutex_free(lctx->mutex);
+        free(lctx);
+        return 0;
+    }
+
+    ctx->ctx = (void *) lctx;
+    return 1;
+}
+
+void oc_async_logger_destroy(oc_log_ctx_t *ctx)
+{
+    oc_async_logger_ctx *lctx = (oc_async_logger_ctx *) ctx->ctx;
+
+    oc_mutex_lock(lctx->mutex);
+    oc_atomic_cmpxchg(&lctx->running, 1, 0);
+    oc_cond_signal(lctx->wake_cond);
+    oc_mutex_unlock(lctx->mutex);
+
+    oc_thread_wait(lctx->thread);
+    oc_thread_free(lctx->thread);
+
+    /* Messages logged after the thread exited. */
+    oc_async_logger_drain(lctx);
+    oc_log_flush(lctx->target);
+    oc_log_destroy(lctx->target);
+
+    oc_cond_free(lctx->drained_cond);
+    oc_cond_free(lctx->wake_cond);
+    oc_mutex_free(lctx->mutex);
+    free(lctx);
+}
+
+void oc_async_logger_flush(oc_log_ctx_t *ctx)
+{
+    oc_async_logger_ctx *lctx = (oc_async_logger_ctx *) ctx->ctx;
+
+    /* Wait for the messages logged before the call to be written. */
+    int32_t end = oc_atomic_add(&lctx->enqueue_pos, 0);
+
+    oc_mutex_lock(lctx->mutex);
+    while (oc_atomic_add(&lctx->running, 0) &&
+           (oc_async_logger_distance(oc_atomic_add(&lctx->dequeue_pos, 0), end) > 0))
+    {
+        oc_cond_signal(lctx->wake_cond);
+        oc_cond_wait_for(lctx->drained_cond, lctx->mutex, OC_ASYNC_LOGGER_WAIT_US);
+    }
+    oc_log_flush(lctx->target);
+    oc_mutex_unlock(lctx->mutex);
+}
+
+void oc_async_logger_set_level(oc_log_ctx_t *ctx, const int level)
+{
+    oc_async_logger_ctx *lctx = (oc_async_logger_ctx *) ctx->ctx;
+
+    oc_mutex_lock(lctx->mutex);
+    oc_log_set_level(lctx->target, (oc_log_level) level);
+    oc_mutex_unlock(lctx->mutex);
+}
+
+size_t oc_async_logger_write(oc_log_ctx_t *ctx, const int level, const char *msg)
+{
+    oc_async_logger_ctx *lctx = (oc_async_logger_ctx *) ctx->ctx;
+    oc_async_log_entry *entry = NULL;
+    int32_t pos;
+
+    /* Claim the slot at the write position, unless the writer thread is a lap behind. */
+    for (;;)
+    {
+        pos = oc_atomic_add(&lctx->enqueue_pos, 0);
+        entry = &lctx->entries[pos & OC_ASYNC_LOGGER_QUEUE_MASK];
+        int32_t distance = oc_async_logger_distance(pos, oc_atomic_add(&entry->sequence, 0));
+        if (0 == distance)
+        {
+            if (oc_atomic_cmpxchg(&lctx->enqueue_pos, pos, (int32_t) ((uint32_t) pos + 1)))
+            {
+                break;
+            }
+        }
+        else if (distance < 0)
+        {
+            oc_atomic_increment(&lctx->dropped);
+            return 0;
+        }
+    }
+
+    entry->level = level;
+    OICStrcpy(entry->message, sizeof(entry->message), msg);
+    size_t written = 1 + strlen(entry->message);
+
+    /* Publish the message, the slot must not be accessed after this. */
+    oc_atomic_increment(&entry->sequence);
+    oc_cond_signal(lctx->wake_cond);
+
+    return written;
+}
+
+int oc_async_logger_set_module(oc_log_ctx_t *ctx, const char *module_name)
+{
+    oc_async_logger_ctx *lctx = (oc_async_logger_ctx *) ctx->ctx;
+
+    oc_mutex_lock(lctx->mutex);
+    int result = oc_log_set_module(lctx->target, module_name);
+    oc_mutex_unlock(lctx->mutex);
+    return result;
+}
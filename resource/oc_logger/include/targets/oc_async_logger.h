@@ -0,0 +1,68 @@
+//******************************************************************
+//
+// Copyright 2017 Open Connectivity Foundation All Rights Reserved.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+
+#ifndef OC_ASYNC_LOGGER_H_
+#define OC_ASYNC_LOGGER_H_
+
+#include "oc_logger.h"
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/*
+ * Asynchronous logger: messages are copied into a ring buffer by the logging
+ * thread without taking a lock, and written to a target logger by a background
+ * thread. Messages are truncated to OC_ASYNC_LOGGER_MESSAGE_SIZE, and dropped when
+ * the ring buffer is full rather than blocking the logging thread.
+ */
+
+/* Number of messages held by the ring buffer, a power of two. */
+#ifndef OC_ASYNC_LOGGER_QUEUE_SIZE
+#define OC_ASYNC_LOGGER_QUEUE_SIZE 256
+#endif
+
+/* Maximum size of a message, including the terminating null. */
+#ifndef OC_ASYNC_LOGGER_MESSAGE_SIZE
+#define OC_ASYNC_LOGGER_MESSAGE_SIZE 256
+#endif
+
+/*
+ * Make an asynchronous logger writing to target, e.g. the context returned by
+ * oc_make_console_logger(). On success the asynchronous logger owns target and
+ * destroys it with oc_log_destroy(). Returns 0 on failure.
+ */
+oc_log_ctx_t *OC_CALL oc_make_async_logger(oc_log_ctx_t *target);
+
+/* Number of messages dropped because the ring buffer was full. */
+size_t OC_CALL oc_async_logger_dropped(oc_log_ctx_t *ctx);
+
+int oc_async_logger_init(oc_log_ctx_t *ctx, void *world);
+void oc_async_logger_destroy(oc_log_ctx_t *ctx);
+void oc_async_logger_flush(oc_log_ctx_t *ctx);
+void oc_async_logger_set_level(oc_log_ctx_t *ctx, const int level);
+size_t oc_async_logger_write(oc_log_ctx_t *ctx, const int level, const char *msg);
+int oc_async_logger_set_module(oc_log_ctx_t *ctx, const char *module_name);
+
+#ifdef __cplusplus
+ } // extern "C"
+#endif
+
+#endif
@@ -0,0 +1,190 @@
+//******************************************************************
+//
+// Copyright 2017 Open Connectivity Foundation All Rights Reserved.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+
+#include "oc_logger.h"
+#include "targets/oc_async_logger.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Messages written to the target of the asynchronous logger, by its writer thread.
+struct TargetRecord
+{
+    std::mutex mutex;
+    std::condition_variable cond;
+    bool blocked;
+    bool released;
+    std::vector<std::string> messages;
+    std::vector<int> levels;
+    size_t flushes;
+    bool destroyed;
+};
+
+static int TargetInit(oc_log_ctx_t *ctx, void *world)
+{
+    ctx->ctx = world;
+    return 1;
+}
+
+static void TargetDestroy(oc_log_ctx_t *ctx)
+{
+    TargetRecord *record = (TargetRecord *) ctx->ctx;
+    std::lock_guard<std::mutex> lock(record->mutex);
+    record->destroyed = true;
+}
+
+static void TargetFlush(oc_log_ctx_t *ctx)
+{
+    TargetRecord *record = (TargetRecord *) ctx->ctx;
+    std::lock_guard<std::mutex> lock(record->mutex);
+    record->flushes++;
+}
+
+static void TargetSetLevel(oc_log_ctx_t *, const int)
+{
+}
+
+// Wait until released if the target is blocked, which holds the writer thread.
+static size_t TargetWrite(oc_log_ctx_t *ctx, const int level, const char *msg)
+{
+    TargetRecord *record = (TargetRecord *) ctx->ctx;
+    std::unique_lock<std::mutex> lock(record->mutex);
+    record->cond.wait(lock, [record]{ return !record->blocked || record->released; });
+    record->messages.push_back(msg);
+    record->levels.push_back(level);
+    return 1 + strlen(msg);
+}
+
+static int TargetSetModule(oc_log_ctx_t *, const char *)
+{
+    return 1;
+}
+
+class AsyncLoggerF : public testing::Test {
+protected:
+    virtual void SetUp()
+    {
+        record.blocked = false;
+        record.released = false;
+        record.flushes = 0;
+        record.destroyed = false;
+
+        oc_log_ctx_t *target = oc_log_make_ctx(&record, OC_LOG_ALL, TargetInit, TargetDestroy,
+                                               TargetFlush, TargetSetLevel, TargetWrite,
+                                               TargetSetModule);
+        ASSERT_TRUE(NULL != target);
+        logger = oc_make_async_logger(target);
+        ASSERT_TRUE(NULL != logger);
+    }
+
+    virtual void TearDown()
+    {
+        oc_log_destroy(logger);
+    }
+
+    static std::string Message(size_t i)
+    {
+        return "message " + std::to_string(i);
+    }
+
+    TargetRecord record;
+    oc_log_ctx_t *logger;
+};
+
+TEST_F(AsyncLoggerF, FlushWritesInOrder)
+{
+    for (size_t i = 0; i < 10; i++)
+    {
+        EXPECT_EQ(Message(i).size() + 1,
+                  oc_log_write_level(logger, (i % 2) ? OC_LOG_ERROR : OC_LOG_DEBUG,
+                                     Message(i).c_str()));
+    }
+    oc_log_flush(logger);
+
+    std::lock_guard<std::mutex> lock(record.mutex);
+    ASSERT_EQ(10u, record.messages.size());
+    for (size_t i = 0; i < 10; i++)
+    {
+        EXPECT_EQ(Message(i), record.messages[i]);
+        EXPECT_EQ((i % 2) ? OC_LOG_ERROR : OC_LOG_DEBUG, record.levels[i]);
+    }
+    EXPECT_LE(1u, record.flushes);
+    EXPECT_EQ(0u, oc_async_logger_dropped(logger));
+}
+
+TEST_F(AsyncLoggerF, LongMessageIsTruncated)
+{
+    std::string message(2 * OC_ASYNC_LOGGER_MESSAGE_SIZE, 'x');
+    EXPECT_EQ((size_t) OC_ASYNC_LOGGER_MESSAGE_SIZE, oc_log_write(logger, message.c_str()));
+    oc_log_flush(logger);
+
+    std::lock_guard<std::mutex> lock(record.mutex);
+    ASSERT_EQ(1u, record.messages.size());
+    EXPECT_EQ(message.substr(0, OC_ASYNC_LOGGER_MESSAGE_SIZE - 1), record.messages[0]);
+}
+
+TEST_F(AsyncLoggerF, FullRingDropsAndTeardownWritesQueued)
+{
+    const size_t count = OC_ASYNC_LOGGER_QUEUE_SIZE + 10;
+    {
+        std::lock_guard<std::mutex> lock(record.mutex);
+        record.blocked = true;
+    }
+
+    // The writer thread is held by the first message, no slot is released meanwhile.
+    size_t written = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        if (0 != oc_log_write(logger, Message(i).c_str()))
+        {
+            written++;
+        }
+    }
+    EXPECT_EQ((size_t) OC_ASYNC_LOGGER_QUEUE_SIZE, written);
+    EXPECT_EQ(count - OC_ASYNC_LOGGER_QUEUE_SIZE, oc_async_logger_dropped(logger));
+
+    // Release the target while the logger is destroyed with the ring still full.
+    std::thread release([this]
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        std::lock_guard<std::mutex> lock(record.mutex);
+        record.released = true;
+        record.cond.notify_all();
+    });
+    oc_log_destroy(logger);
+    logger = NULL;
+    release.join();
+
+    std::lock_guard<std::mutex> lock(record.mutex);
+    ASSERT_EQ((size_t) OC_ASYNC_LOGGER_QUEUE_SIZE, record.messages.size());
+    for (size_t i = 0; i < OC_ASYNC_LOGGER_QUEUE_SIZE; i++)
+    {
+        EXPECT_EQ(Message(i), record.messages[i]);
+    }
+    EXPECT_LE(1u, record.flushes);
+    EXPECT_TRUE(record.destroyed);
+}
@@ -0,0 +1,150 @@
+//******************************************************************
+//
+// Copyright 2017 Open Connectivity Foundation All Rights Reserved.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+
+#include "iotivity_config.h"
+
+#include "CallbackExecutor.h"
+#include "experimental/logger.h"
+
+#define TAG "OIC_CALLBACK_EXECUTOR"
+
+namespace OC
+{
+    CallbackExecutor::CallbackExecutor(CallbackExecution execution, unsigned int threadCount)
+        : m_execution(execution), m_nextWorker(0)
+    {
+        if (m_execution != CallbackExecution::ThreadPool)
+        {
+            return;
+        }
+
+        if (0 == threadCount)
+        {
+            threadCount = DEFAULT_CALLBACK_THREAD_COUNT;
+        }
+
+        for (unsigned int i = 0; i < threadCount; i++)
+        {
+            m_workers.emplace_back(new Worker());
+            Worker& worker = *m_workers.back();
+            worker.thread = std::thread(&CallbackExecutor::run, std::ref(worker));
+        }
+    }
+
+    CallbackExecutor::~CallbackExecutor()
+    {
+        for (auto& worker : m_workers)
+        {
+            {
+                std::lock_guard<std::mutex> lock(worker->mutex);
+                worker->stop = true;
+            }
+            worker->cond.notify_one();
+        }
+
+        for (auto& worker : m_workers)
+        {
+            // The last reference may be released by a callback, e.g. one stopping the
+            // platform, which must not wait for itself.
+            if (worker->thread.get_id() == std::this_thread::get_id())
+            {
+                OIC_LOG(WARNING, TAG, "Executor destroyed by its own callback");
+                worker->thread.detach();
+                worker.release();
+            }
+            else
+            {
+                worker->thread.join();
+            }
+        }
+    }
+
+    void CallbackExecutor::post(Task task)
+    {
+        if (m_workers.empty())
+        {
+            post(nullptr, std::move(task));
+            return;
+        }
+
+        enqueue(*m_workers[m_nextWorker++ % m_workers.size()], std::move(task));
+    }
+
+    void CallbackExecutor::post(const void* key, Task task)
+    {
+        switch (m_execution)
+        {
+            case CallbackExecution::Inline:
+                task();
+                break;
+
+            case CallbackExecution::ThreadPool:
+                if (!m_workers.empty())
+                {
+                    enqueue(*m_workers[std::hash<const void*>()(key) % m_workers.size()],
+                            std::move(task));
+                    break;
+                }
+                // fall through
+
+            case CallbackExecution::Thread:
+            default:
+                std::thread(std::move(task)).detach();
+                break;
+        }
+    }
+
+    void CallbackExecutor::enqueue(Worker& worker, Task task)
+    {
+        {
+            std::lock_guard<std::mutex> lock(worker.mutex);
+            worker.tasks.push_back(std::move(task));
+        }
+        worker.cond.notify_one();
+    }
+
+    void CallbackExecutor::run(Worker& worker)
+    {
+        std::unique_lock<std::mutex> lock(worker.mutex);
+        while (true)
+        {
+            worker.cond.wait(lock, [&worker] { return worker.stop || !worker.tasks.empty(); });
+            if (worker.tasks.empty())
+            {
+                // Stopped, with every posted callback run.
+                break;
+            }
+
+            Task task = std::move(worker.tasks.front());
+            worker.tasks.pop_front();
+
+            lock.unlock();
+            try
+            {
+                task();
+            }
+            catch (std::exception& e)
+            {
+                OIC_LOG_V(ERROR, TAG, "Exception in callback: %s", e.what());
+            }
+            lock.lock();
+        }
+    }
+}
@@ -31,6 +31,9 @@
 
 #define TAG "OIC_CLIENT_WRAPPER"
 
+// Longest time the listening thread sleeps in OCWaitForProcess before checking m_threadRun.
+#define PROCESS_MAX_WAIT_MS (1000)
+
 using namespace std;
 
 namespace OC
@@ -38,7 +41,9 @@ namespace OC
     InProcClientWrapper::InProcClientWrapper(
         std::weak_ptr<std::recursive_mutex> csdkLock, PlatformConfig cfg)
             : m_threadRun(false), m_csdkLock(csdkLock),
-              m_cfg { cfg }
+              m_cfg { cfg },
+              m_callbackExecutor(std::make_shared<CallbackExecutor>(cfg.callbackExecution,
+                                                                    cfg.callbackThreadCount))
     {
         // if the config type is server, we ought to never get called.  If the config type
         // is both, we count on the server to run the thread and do the initialize
@@ -79,6 +84,7 @@ namespace OC
         if (m_threadRun && m_listeningThread.joinable())
         {
             m_threadRun = false;
+            OCWakeUpProcess();
             m_listeningThread.join();
         }
         return OC_STACK_OK;
@@ -105,8 +111,11 @@ namespace OC
                 // TODO: do something with result if failed?
             }
 
-            // To minimize CPU utilization we may wish to do this with sleep
-            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            // Sleep until the stack has something to process, without holding m_csdkLock.
+            if (OC_STACK_OK != OCWaitForProcess(PROCESS_MAX_WAIT_MS))
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            }
         }
     }
 
@@ -215,8 +224,7 @@ namespace OC
 
             for(auto resource : container.Resources())
             {
-                std::thread exec(context->callback, resource);
-                exec.detach();
+                context->executor->post(std::bind(context->callback, resource));
             }
         }
         catch (std::exception &e)
@@ -267,16 +275,14 @@ namespace OC
             // loop to ensure valid construction of all resources
             for (auto resource : container.Resources())
             {
-                std::thread exec(context->callback, resource);
-                exec.detach();
+                context->executor->post(std::bind(context->callback, resource));
             }
             return OC_STACK_KEEP_TRANSACTION;
         }
 
         OIC_LOG_V(DEBUG, TAG, "%s: call response callback", __func__);
         std::string resourceURI = clientResponse->resourceUri;
-        std::thread exec(context->errorCallback, resourceURI, result);
-        exec.detach();
+        context->executor->post(std::bind(context->errorCallback, resourceURI, result));
         return OC_STACK_KEEP_TRANSACTION;
     }
 
@@ -296,7 +302,8 @@ namespace OC
         resourceUri << serviceUrl << resourceType;
 
         ClientCallbackContext::ListenContext* context =
-            new ClientCallbackContext::ListenContext(callback, shared_from_this());
+            new ClientCallbackContext::ListenContext(callback, shared_from_this(),
+                                                     m_callbackExecutor);
         OCCallbackData cbdata;
         cbdata.context = static_cast<void*>(context),
         cbdata.cb      = listenCallback;
@@ -338,7 +345,7 @@ namespace OC
 
         ClientCallbackContext::ListenErrorContext* context =
             new ClientCallbackContext::ListenErrorContext(callback, errorCallback,
-                                                          shared_from_this());
+                                                          shared_from_this(), m_callbackExecutor);
         if (!context)
         {
             return OC_STACK_ERROR;
@@ -415,8 +422,7 @@ namespace OC
                     reinterpret_cast< OCDiscoveryPayload* >(clientResponse->payload));
 
             OIC_LOG_V(DEBUG, TAG, "%s: call response callback", __func__);
-            std::thread exec(context->callback, container.Resources());
-            exec.detach();
+            context->executor->post(std::bind(context->callback, container.Resources()));
         }
         catch (std::exception &e)
         {
@@ -443,7 +449,8 @@ namespace OC
         resourceUri << serviceUrl << resourceType;
 
         ClientCallbackContext::ListenResListContext* context =
-            new ClientCallbackContext::ListenResListContext(callback, shared_from_this());
+            new ClientCallbackContext::ListenResListContext(callback, shared_from_this(),
+                                                            m_callbackExecutor);
         OCCallbackData cbdata;
         cbdata.context = static_cast<void*>(context),
         cbdata.cb      = listenResListCallback;
@@ -487,8 +494,7 @@ namespace OC
 
             //send the error callback
             std::string uri = clientResponse->resourceUri;
-            std::thread exec(context->errorCallback, uri, result);
-            exec.detach();
+            context->executor->post(std::bind(context->errorCallback, uri, result));
             return OC_STACK_KEEP_TRANSACTION;
         }
 
@@ -517,8 +523,7 @@ namespace OC
                     reinterpret_cast< OCDiscoveryPayload* >(clientResponse->payload));
 
             OIC_LOG_V(DEBUG, TAG, "%s: call response callback", __func__);
-            std::thread exec(context->callback, container.Resources());
-            exec.detach();
+            context->executor->post(std::bind(context->callback, container.Resources()));
         }
         catch (std::exception &e)
         {
@@ -547,7 +552,7 @@ namespace OC
 
         ClientCallbackContext::ListenResListWithErrorContext* context =
             new ClientCallbackContext::ListenResListWithErrorContext(callback, errorCallback,
-                                                          shared_from_this());
+                                                          shared_from_this(), m_callbackExecutor);
         if (!context)
         {
             return OC_STACK_ERROR;
@@ -596,9 +601,8 @@ namespace OC
                     << clientResponse->result
                     << std::flush;
 
-            std::thread exec(context->callback, clientResponse->result,
-                             resourceURI, nullptr);
-            exec.detach();
+            context->executor->post(std::bind(context->callback, clientResponse->result,
+                                              resourceURI, nullptr));
 
             return OC_STACK_DELETE_TRANSACTION;
         }
@@ -619,9 +623,8 @@ namespace OC
             // loop to ensure valid construction of all resources
             for (auto resource : container.Resources())
             {
-                std::thread exec(context->callback, clientResponse->result,
-                                 resourceURI, resource);
-                exec.detach();
+                context->executor->post(std::bind(context->callback, clientResponse->result,
+                                                  resourceURI, resource));
             }
         }
         catch (std::exception &e)
@@ -648,7 +651,8 @@ namespace OC
         }
 
         ClientCallbackContext::MQTopicContext* context =
-            new ClientCallbackContext::MQTopicContext(callback, shared_from_this());
+            new ClientCallbackContext::MQTopicContext(callback, shared_from_this(),
+                                                      m_callbackExecutor);
         OCCallbackData cbdata;
         cbdata.context = static_cast<void*>(context),
         cbdata.cb      = listenMQCallback;
@@ -692,8 +696,7 @@ namespace OC
         {
             OIC_LOG_V(DEBUG, TAG, "%s: call response callback", __func__);
             OCRepresentation rep = parseGetSetCallback(clientResponse);
-            std::thread exec(context->callback, rep);
-            exec.detach();
+            context->executor->post(std::bind(context->callback, rep));
         }
         catch(OC::OCException& e)
         {
@@ -720,7 +723,8 @@ namespace OC
         deviceUri << serviceUrl << deviceURI;
 
         ClientCallbackContext::DeviceListenContext* context =
-            new ClientCallbackContext::DeviceListenContext(callback, shared_from_this());
+            new ClientCallbackContext::DeviceListenContext(callback, shared_from_this(),
+                                                           m_callbackExecutor);
         OCCallbackData cbdata;
 
         cbdata.context = static_cast<void*>(context),
@@ -804,19 +808,17 @@ namespace OC
                                             createdUri);
                 for (auto resource : container.Resources())
                 {
-                    std::thread exec(context->callback, result,
-                                     createdUri,
-                                     resource);
-                    exec.detach();
+                    context->executor->post(std::bind(context->callback, result,
+                                                      createdUri,
+                                                      resource));
                 }
             }
             else
             {
                 OIC_LOG_V(DEBUG, TAG, "%s: call response callback", __func__);
-                std::thread exec(context->callback, result,
-                                 createdUri,
-                                 nullptr);
-                exec.detach();
+                context->executor->post(std::bind(context->callback, result,
+                                                  createdUri,
+                                                  nullptr));
             }
         }
         catch (std::exception &e)
@@ -840,7 +842,8 @@ namespace OC
         }
         OCStackResult result;
         ClientCallbackContext::MQTopicContext* ctx =
-                new ClientCallbackContext::MQTopicContext(callback, shared_from_this());
+                new ClientCallbackContext::MQTopicContext(callback, shared_from_this(),
+                                                          m_callbackExecutor);
         OCCallbackData cbdata;
         cbdata.context = static_cast<void*>(ctx),
         cbdata.cb      = createMQTopicCallback;
@@ -894,8 +897,7 @@ namespace OC
         }
 
         OIC_LOG_V(DEBUG, TAG, "%s: call response callback", __func__);
-        std::thread exec(context->callback, serverHeaderOptions, rep, result);
-        exec.detach();
+        context->executor->post(std::bind(context->callback, serverHeaderOptions, rep, result));
         return OC_STACK_DELETE_TRANSACTION;
     }
 
@@ -913,7 +915,7 @@ namespace OC
 
         OCStackResult result;
         ClientCallbackContext::GetContext* ctx =
-            new ClientCallbackContext::GetContext(callback);
+            new ClientCallbackContext::GetContext(callback, m_callbackExecutor);
 
         OCCallbackData cbdata;
         cbdata.context = static_cast<void*>(ctx);
@@ -947,6 +949,85 @@ namespace OC
         return result;
     }
 
+    OCStackApplicationResult getResourceViewCallback(void* ctx,
+                                                     OCDoHandle /*handle*/,
+        OCClientResponse* clientResponse)
+    {
+        ClientCallbackContext::GetViewContext* context =
+            static_cast<ClientCallbackContext::GetViewContext*>(ctx);
+        HeaderOptions serverHeaderOptions;
+        OCStackResult result = clientResponse->result;
+
+        parseServerHeaderOptions(clientResponse, serverHeaderOptions);
+
+        // The view copies the received bytes once, the callback may run after this returns.
+        OCCborView view;
+        if (OC_STACK_OK != OCGetResponsePayloadView(clientResponse, &view))
+        {
+            view.data = nullptr;
+            view.size = 0;
+        }
+        OCRepresentationView rep(view.data, view.size);
+
+        OIC_LOG_V(DEBUG, TAG, "%s: call response callback", __func__);
+        context->executor->post(std::bind(context->callback, serverHeaderOptions, rep, result));
+        return OC_STACK_DELETE_TRANSACTION;
+    }
+
+    OCStackResult InProcClientWrapper::GetResourceRepresentationView(
+        const OCDevAddr& devAddr,
+        const std::string& resourceUri,
+        const QueryParamsMap& queryParams, const HeaderOptions& headerOptions,
+        OCConnectivityType connectivityType,
+        GetViewCallback& callback, QualityOfService QoS)
+    {
+        if (!callback || (headerOptions.size() > MAX_HEADER_OPTIONS))
+        {
+            return OC_STACK_INVALID_PARAM;
+        }
+
+        OCStackResult result;
+        ClientCallbackContext::GetViewContext* ctx =
+            new ClientCallbackContext::GetViewContext(callback, m_callbackExecutor);
+
+        OCCallbackData cbdata;
+        cbdata.context = static_cast<void*>(ctx);
+        cbdata.cb      = getResourceViewCallback;
+        cbdata.cd      = [](void* c){delete (ClientCallbackContext::GetViewContext*)c;};
+
+        std::string uri = assembleSetResourceUri(resourceUri, queryParams);
+
+        auto cLock = m_csdkLock.lock();
+
+        if (cLock)
+        {
+            std::lock_guard<std::recursive_mutex> lock(*cLock);
+            OCHeaderOption options[MAX_HEADER_OPTIONS];
+            OCDoHandle handle = nullptr;
+
+            result = OCDoResource(
+                                  &handle, OC_REST_GET,
+                                  uri.c_str(),
+                                  &devAddr, nullptr,
+                                  connectivityType,
+                                  static_cast<OCQualityOfService>(QoS),
+                                  &cbdata,
+                                  assembleHeaderOptions(options, headerOptions),
+                                  (uint8_t)headerOptions.size());
+            // The responses are processed under the same lock, so none is decoded before.
+            // The view is still given if this fails, from a decoded response.
+            if (OC_STACK_OK == result && OC_STACK_OK != OCSetResponsePayloadViewOnly(handle, true))
+            {
+                oclog() << "Response of " << uri << " will be decoded" << std::flush;
+            }
+        }
+        else
+        {
+            delete ctx;
+            result = OC_STACK_ERROR;
+        }
+        return result;
+    }
 
     OCStackApplicationResult setResourceCallback(void* ctx,
                                                  OCDoHandle /*handle*/,
@@ -970,8 +1051,7 @@ namespace OC
         }
 
         OIC_LOG_V(DEBUG, TAG, "%s: call response callback", __func__);
-        std::thread exec(context->callback, serverHeaderOptions, attrs, result);
-        exec.detach();
+        context->executor->post(std::bind(context->callback, serverHeaderOptions, attrs, result));
         return OC_STACK_DELETE_TRANSACTION;
     }
 
@@ -1080,7 +1160,8 @@ namespace OC
         }
 
         OCStackResult result;
-        ClientCallbackContext::SetContext* ctx = new ClientCallbackContext::SetContext(callback);
+        ClientCallbackContext::SetContext* ctx =
+            new ClientCallbackContext::SetContext(callback, m_callbackExecutor);
         OCCallbackData cbdata;
         cbdata.context = static_cast<void*>(ctx),
         cbdata.cb      = setResourceCallback;
@@ -1127,7 +1208,8 @@ namespace OC
         }
 
         OCStackResult result;
-        ClientCallbackContext::SetContext* ctx = new ClientCallbackContext::SetContext(callback);
+        ClientCallbackContext::SetContext* ctx =
+            new ClientCallbackContext::SetContext(callback, m_callbackExecutor);
         OCCallbackData cbdata;
         cbdata.context = static_cast<void*>(ctx),
         cbdata.cb      = setResourceCallback;
@@ -1173,8 +1255,8 @@ namespace OC
         parseServerHeaderOptions(clientResponse, serverHeaderOptions);
 
         OIC_LOG_V(DEBUG, TAG, "%s: call response callback", __func__);
-        std::thread exec(context->callback, serverHeaderOptions, clientResponse->result);
-        exec.detach();
+        context->executor->post(std::bind(context->callback, serverHeaderOptions,
+                                          clientResponse->result));
         return OC_STACK_DELETE_TRANSACTION;
     }
 
@@ -1193,7 +1275,7 @@ namespace OC
 
         OCStackResult result;
         ClientCallbackContext::DeleteContext* ctx =
-            new ClientCallbackContext::DeleteContext(callback);
+            new ClientCallbackContext::DeleteContext(callback, m_callbackExecutor);
         OCCallbackData cbdata;
         cbdata.context = static_cast<void*>(ctx),
         cbdata.cb      = deleteResourceCallback;
@@ -1248,9 +1330,8 @@ namespace OC
         }
 
         OIC_LOG_V(DEBUG, TAG, "%s: call response callback", __func__);
-        std::thread exec(context->callback, serverHeaderOptions, attrs,
-                    result, sequenceNumber);
-        exec.detach();
+        context->executor->post(context, std::bind(context->callback, serverHeaderOptions, attrs,
+                                                   result, sequenceNumber));
         if (sequenceNumber == MAX_SEQUENCE_NUMBER + 1)
         {
             return OC_STACK_DELETE_TRANSACTION;
@@ -1273,7 +1354,7 @@ namespace OC
         OCStackResult result;
 
         ClientCallbackContext::ObserveContext* ctx =
-            new ClientCallbackContext::ObserveContext(callback);
+            new ClientCallbackContext::ObserveContext(callback, m_callbackExecutor);
         OCCallbackData cbdata;
         cbdata.context = static_cast<void*>(ctx),
         cbdata.cb      = observeResourceCallback;
@@ -1366,10 +1447,8 @@ namespace OC
         std::string url = clientResponse->devAddr.addr;
 
         OIC_LOG_V(DEBUG, TAG, "%s: call response callback", __func__);
-        std::thread exec(context->callback, clientResponse->result,
-                    clientResponse->sequenceNumber, url);
-
-        exec.detach();
+        context->executor->post(context, std::bind(context->callback, clientResponse->result,
+                                                   clientResponse->sequenceNumber, url));
 
         return OC_STACK_KEEP_TRANSACTION;
     }
@@ -1384,7 +1463,8 @@ namespace OC
         }
 
         ClientCallbackContext::SubscribePresenceContext* ctx =
-            new ClientCallbackContext::SubscribePresenceContext(presenceHandler);
+            new ClientCallbackContext::SubscribePresenceContext(presenceHandler,
+                                                                m_callbackExecutor);
         OCCallbackData cbdata;
         cbdata.context = static_cast<void*>(ctx),
         cbdata.cb      = subscribePresenceCallback;
@@ -1445,7 +1525,7 @@ namespace OC
         OCStackResult result;
 
         ClientCallbackContext::ObserveContext* ctx =
-            new ClientCallbackContext::ObserveContext(callback);
+            new ClientCallbackContext::ObserveContext(callback, m_callbackExecutor);
         OCCallbackData cbdata;
         cbdata.context = static_cast<void*>(ctx),
         cbdata.cb      = observeResourceCallback;
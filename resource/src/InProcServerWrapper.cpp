@@ -45,6 +45,9 @@
 
 #define TAG "OIC_SERVER_WRAPPER"
 
+// Longest time the process thread sleeps in OCWaitForProcess before checking m_threadRun.
+#define PROCESS_MAX_WAIT_MS (1000)
+
 using namespace std;
 using namespace OC;
 
@@ -284,6 +287,7 @@ namespace OC
         if(m_processThread.joinable())
         {
             m_threadRun = false;
+            OCWakeUpProcess();
             m_processThread.join();
         }
 
@@ -308,7 +312,11 @@ namespace OC
                 // ...the value of variable result is simply ignored for now.
             }
 
-            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            // Sleep until the stack has something to process, without holding m_csdkLock.
+            if (OC_STACK_OK != OCWaitForProcess(PROCESS_MAX_WAIT_MS))
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            }
         }
     }
 
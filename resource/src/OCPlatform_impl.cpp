@@ -102,6 +102,15 @@ namespace OC
                         static_cast<OCTransportFlags>(m_cfg.serverConnectivity & CT_MASK_FLAGS);
         OCTransportFlags clientFlags =
                         static_cast<OCTransportFlags>(m_cfg.clientConnectivity & CT_MASK_FLAGS);
+        if (0 != m_cfg.requestDispatchThreadCount)
+        {
+            res = OCSetRequestDispatchThreads(m_cfg.requestDispatchThreadCount);
+            if (OC_STACK_OK != res)
+            {
+                return res;
+            }
+        }
+
         res = OCInit2(m_modeType, serverFlags, clientFlags, m_cfg.transportType);
         if (OC_STACK_OK != res)
         {
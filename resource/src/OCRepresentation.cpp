@@ -31,6 +31,7 @@
 #include <boost/lexical_cast.hpp>
 #include <algorithm>
 #include <iomanip>
+#include <limits>
 #include "iotivity_config.h"
 #include "ocpayload.h"
 #include "experimental/ocrandom.h"
@@ -814,6 +815,94 @@ namespace OC
             throw OCException(OC::Exception::INVALID_ATTRIBUTE+ str);
         }
     }
+
+    bool OCRepresentationView::empty() const
+    {
+        return !m_view.data;
+    }
+
+    bool OCRepresentationView::hasAttribute(const std::string& str) const
+    {
+        return OCCborViewHasProp(&m_view, str.c_str());
+    }
+
+    bool OCRepresentationView::isNULL(const std::string& str) const
+    {
+        return OCCborViewIsNull(&m_view, str.c_str());
+    }
+
+    bool OCRepresentationView::getValue(const std::string& str, int& val) const
+    {
+        int64_t i;
+        if (!OCCborViewGetPropInt(&m_view, str.c_str(), &i) ||
+            i < std::numeric_limits<int>::min() || i > std::numeric_limits<int>::max())
+        {
+            val = int();
+            return false;
+        }
+        val = static_cast<int>(i);
+        return true;
+    }
+
+    bool OCRepresentationView::getValue(const std::string& str, double& val) const
+    {
+        if (!OCCborViewGetPropDouble(&m_view, str.c_str(), &val))
+        {
+            val = double();
+            return false;
+        }
+        return true;
+    }
+
+    bool OCRepresentationView::getValue(const std::string& str, bool& val) const
+    {
+        if (!OCCborViewGetPropBool(&m_view, str.c_str(), &val))
+        {
+            val = bool();
+            return false;
+        }
+        return true;
+    }
+
+    bool OCRepresentationView::getValue(const std::string& str, std::string& val) const
+    {
+        const char* value;
+        size_t len;
+        if (!OCCborViewGetPropString(&m_view, str.c_str(), &value, &len))
+        {
+            val.clear();
+            return false;
+        }
+        val.assign(value, len);
+        return true;
+    }
+
+    bool OCRepresentationView::getValue(const std::string& str, std::vector<uint8_t>& val) const
+    {
+        const uint8_t* value;
+        size_t len;
+        if (!OCCborViewGetPropByteString(&m_view, str.c_str(), &value, &len))
+        {
+            val.clear();
+            return false;
+        }
+        val.assign(value, value + len);
+        return true;
+    }
+
+    bool OCRepresentationView::getValue(const std::string& str, OCRepresentationView& val) const
+    {
+        OCCborView view;
+        if (!OCCborViewGetPropObject(&m_view, str.c_str(), &view))
+        {
+            val = OCRepresentationView();
+            return false;
+        }
+        // The nested view shares the received bytes.
+        val.m_buffer = m_buffer;
+        val.m_view = view;
+        return true;
+    }
 }
 
 namespace OC
@@ -469,6 +469,16 @@ OCStackResult OCResource::get(const QueryParamsMap& queryParametersMap,
                             attributeHandler, QoS);
 }
 
+OCStackResult OCResource::getView(const QueryParamsMap& queryParametersMap,
+                                  GetViewCallback attributeHandler, QualityOfService QoS)
+{
+    return checked_guard(m_clientWrapper.lock(),
+                            &IClientWrapper::GetResourceRepresentationView,
+                            m_devAddr, m_uri,
+                            queryParametersMap, m_headerOptions, CT_DEFAULT,
+                            attributeHandler, QoS);
+}
+
 OCStackResult OCResource::get(const QueryParamsMap& queryParametersMap,
                               GetCallback attributeHandler)
 {
@@ -0,0 +1,101 @@
+//******************************************************************
+//
+// Copyright 2017 Open Connectivity Foundation All Rights Reserved.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+
+#include <gtest/gtest.h>
+#include <CallbackExecutor.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
+namespace OC
+{
+    namespace test
+    {
+        namespace CallbackExecutorTests
+        {
+            using namespace OC;
+
+            TEST(CallbackExecutorTest, InlineRunsInCaller)
+            {
+                CallbackExecutor executor(CallbackExecution::Inline, 0);
+                std::thread::id id;
+                executor.post([&id] { id = std::this_thread::get_id(); });
+                EXPECT_EQ(std::this_thread::get_id(), id);
+            }
+
+            TEST(CallbackExecutorTest, ThreadRunsCallback)
+            {
+                CallbackExecutor executor(CallbackExecution::Thread, 0);
+                std::mutex mutex;
+                std::condition_variable cond;
+                bool called = false;
+
+                executor.post([&]
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    called = true;
+                    cond.notify_one();
+                });
+
+                std::unique_lock<std::mutex> lock(mutex);
+                EXPECT_TRUE(cond.wait_for(lock, std::chrono::seconds(5), [&] { return called; }));
+            }
+
+            TEST(CallbackExecutorTest, ThreadPoolKeepsOrderPerKey)
+            {
+                const int count = 1000;
+                int first = 0;
+                int second = 0;
+                std::vector<int> firstOrder;
+                std::vector<int> secondOrder;
+                std::atomic<int> done(0);
+                {
+                    CallbackExecutor executor(CallbackExecution::ThreadPool, 4);
+                    for (int i = 0; i < count; i++)
+                    {
+                        executor.post(&first, [&firstOrder, &done, i]
+                        {
+                            firstOrder.push_back(i);
+                            done++;
+                        });
+                        executor.post(&second, [&secondOrder, &done, i]
+                        {
+                            secondOrder.push_back(i);
+                            done++;
+                        });
+                    }
+                    // The destructor runs the posted callbacks before returning.
+                }
+
+                EXPECT_EQ(2 * count, done.load());
+                ASSERT_EQ(static_cast<size_t>(count), firstOrder.size());
+                ASSERT_EQ(static_cast<size_t>(count), secondOrder.size());
+                for (int i = 0; i < count; i++)
+                {
+                    EXPECT_EQ(i, firstOrder[i]);
+                    EXPECT_EQ(i, secondOrder[i]);
+                }
+            }
+        }
+    }
+}
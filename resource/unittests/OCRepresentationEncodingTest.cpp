@@ -1638,4 +1638,52 @@ namespace OCRepresentationEncodingTest
         OCRepPayloadDestroy(repPayload);
         OCPayloadDestroy(cparsed);
     }
+
+    TEST(RepresentationEncoding, ViewAttributeTypes)
+    {
+        OC::OCRepresentation subRep;
+        subRep.setValue("SubIntAttr", 8);
+        OC::OCRepresentation startRep;
+        startRep.setNULL("NullAttr");
+        startRep.setValue("IntAttr", 77);
+        startRep.setValue("DoubleAttr", 3.333);
+        startRep.setValue("BoolAttr", true);
+        startRep.setValue("StringAttr", std::string("String attr"));
+        startRep.setValue("RepAttr", subRep);
+
+        OC::MessageContainer mc1;
+        mc1.addRepresentation(startRep);
+        OCRepPayload* cstart = mc1.getPayload();
+
+        uint8_t* cborData;
+        size_t cborSize;
+        EXPECT_EQ(OC_STACK_OK, OCConvertPayload((OCPayload*)cstart, OC_FORMAT_CBOR, &cborData, &cborSize));
+        OCPayloadDestroy((OCPayload*)cstart);
+
+        OC::OCRepresentationView view(cborData, cborSize);
+        // The view keeps its own copy of the received bytes.
+        OICFree(cborData);
+
+        int i;
+        double d;
+        bool b;
+        std::string str;
+        OC::OCRepresentationView subView;
+        EXPECT_FALSE(view.empty());
+        EXPECT_TRUE(view.isNULL("NullAttr"));
+        EXPECT_TRUE(view.getValue("IntAttr", i));
+        EXPECT_EQ(77, i);
+        EXPECT_TRUE(view.getValue("DoubleAttr", d));
+        EXPECT_EQ(3.333, d);
+        EXPECT_TRUE(view.getValue("BoolAttr", b));
+        EXPECT_TRUE(b);
+        EXPECT_TRUE(view.getValue("StringAttr", str));
+        EXPECT_EQ("String attr", str);
+        EXPECT_FALSE(view.getValue("StringAttr", i));
+        EXPECT_FALSE(view.hasAttribute("MissingAttr"));
+        EXPECT_TRUE(view.getValue("RepAttr", subView));
+        EXPECT_TRUE(subView.getValue("SubIntAttr", i));
+        EXPECT_EQ(8, i);
+        EXPECT_TRUE(OC::OCRepresentationView().empty());
+    }
 }
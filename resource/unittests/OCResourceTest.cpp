@@ -40,6 +40,11 @@ namespace OCResourceTest
         EXPECT_EQ(eCode, OC_STACK_OK);
     }
 
+    void onGetView(const HeaderOptions&, const OCRepresentationView& , const int eCode)
+    {
+        EXPECT_EQ(eCode, OC_STACK_OK);
+    }
+
     void foundResource(std::shared_ptr<OCResource> )
     {
     }
@@ -220,6 +225,22 @@ namespace OCResourceTest
         EXPECT_EQ(OC_STACK_OK, resource->get("", DEFAULT_INTERFACE, QueryParamsMap(), &onGetPut));
     }
 
+    TEST(ResourceGetTest, DISABLED_ResourceGetView)
+    {
+        OCResource::Ptr resource = ConstructResourceObject("coap://192.168.1.2:5000", "/resource");
+        EXPECT_TRUE(resource != NULL);
+        EXPECT_EQ(OC_STACK_OK,
+                resource->getView(OC::QueryParamsMap(), &onGetView, QualityOfService::NaQos));
+    }
+
+    TEST(ResourceGetTest, ResourceGetViewWithNullCallback)
+    {
+        OCResource::Ptr resource = ConstructResourceObject("coap://192.168.1.2:5000", "/resource");
+        EXPECT_TRUE(resource != NULL);
+        EXPECT_THROW(resource->getView(OC::QueryParamsMap(), nullptr, QualityOfService::NaQos),
+                OC::OCException);
+    }
+
     //Post Test
     TEST(ResourcePostTest, DISABLED_ResourcePostValidConfiguration)
     {
@@ -21,6 +21,7 @@
 #include "ExpiryTimerImpl.h"
 
 #include "RCSException.h"
+#include "CallbackExecutor.h"
 
 namespace OIC
 {
@@ -39,7 +40,8 @@ namespace OIC
                 m_cond{ },
                 m_stop{ false },
                 m_mt{ std::random_device{ }() },
-                m_dist{ }
+                m_dist{ },
+                m_executor{ new OC::CallbackExecutor{ OC::CallbackExecution::ThreadPool, 0 } }
         {
             m_thread = std::thread(&ExpiryTimerImpl::run, this);
         }
@@ -172,7 +174,7 @@ namespace OIC
             auto it = m_tasks.begin();
             for (; it != m_tasks.end() && it->first <= now; ++it)
             {
-                it->second->execute();
+                it->second->execute(*m_executor);
             }
 
             m_tasks.erase(m_tasks.begin(), it);
@@ -217,7 +219,7 @@ namespace OIC
         {
         }
 
-        void TimerTask::execute()
+        void TimerTask::execute(OC::CallbackExecutor& executor)
         {
             if (isExecuted())
             {
@@ -227,7 +229,7 @@ namespace OIC
             ExpiryTimerImpl::Id id { m_id };
             m_id = INVALID_ID;
 
-            std::thread(std::move(m_callback), id).detach();
+            executor.post(std::bind(std::move(m_callback), id));
 
             m_callback = ExpiryTimerImpl::Callback{ };
         }
@@ -30,6 +30,12 @@
 #include <random>
 #include <unordered_set>
 #include <atomic>
+#include <memory>
+
+namespace OC
+{
+    class CallbackExecutor;
+}
 
 namespace OIC
 {
@@ -97,6 +103,8 @@ namespace OIC
             std::mt19937 m_mt;
             std::uniform_int_distribution< Id > m_dist;
 
+            std::unique_ptr< OC::CallbackExecutor > m_executor;
+
         };
 
         class TimerTask
@@ -114,7 +122,7 @@ namespace OIC
             ExpiryTimerImpl::Id getId() const;
 
         private:
-            void execute();
+            void execute(OC::CallbackExecutor&);
 
         private:
             std::atomic< ExpiryTimerImpl::Id > m_id;